@@ -29,8 +29,12 @@ extern "C" {
 #define KISS_FFT_MALLOC(nbytes) _mm_malloc(nbytes,16)
 #define KISS_FFT_FREE _mm_free
 #else	
-#define KISS_FFT_MALLOC malloc
-#define KISS_FFT_FREE free
+/* FNFT: Plans and temporary buffers are obtained from the allocator that has
+ been set with fnft_set_allocator. They are aligned to cache lines.
+ */
+#include "fnft__allocator.h"
+#define KISS_FFT_MALLOC fnft__aligned_malloc
+#define KISS_FFT_FREE fnft__aligned_free
 #endif	
 
 
@@ -99,7 +103,7 @@ void kiss_fft_stride(kiss_fft_cfg cfg,const kiss_fft_cpx *fin,kiss_fft_cpx *fout
 
 /* If kiss_fft_alloc allocated a buffer, it is one contiguous 
    buffer and can be simply free()d when no longer needed*/
-#define kiss_fft_free free
+#define kiss_fft_free KISS_FFT_FREE
 
 /*
  Cleans up some memory that gets managed internally. Not necessary to call, but it might clean up 
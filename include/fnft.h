@@ -22,6 +22,7 @@
 
 #include "fnft_config.h"
 #include "fnft_errwarn.h"
+#include "fnft_allocator.h"
 
 /* Doxygen main page */
 
@@ -56,6 +57,10 @@
  * \defgroup errwarn Error codes
  */
 
+/**
+ * \defgroup allocator Memory allocation
+ */
+
 /**
  * \defgroup data_types Data types
  */
@@ -87,6 +92,13 @@
  * \link fnft_errwarn_setprintf \endlink.
  */
 
+/**
+ * \defgroup private_allocator PRIVATE: Memory allocation
+ *
+ * FNFT allocates its internal memory with the routines in this module, which
+ * forward to the allocator set with \link fnft_set_allocator \endlink.
+ */
+
 /**
  * \defgroup poly PRIVATE: Polynomials
  */
@@ -109,4 +121,17 @@
  * \defgroup fft_wrapper PRIVATE: Wrapper for fast Fourier transform routines
  */
 
+/**
+ * \defgroup kernels PRIVATE: Array kernels with run time instruction set \
+ *  selection
+ */
+
+/**
+ * \defgroup parallel PRIVATE: Concurrent execution
+ */
+
+/**
+ * \defgroup file PRIVATE: Access to files
+ */
+
 #endif
@@ -0,0 +1,119 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+ */
+
+/**
+ * @file fnft_allocator.h
+ * @brief Controls how FNFT allocates memory.
+ *
+ * @ingroup allocator
+ *
+ * By default, FNFT obtains all its internal memory from malloc and free. The
+ * functions in this file allow to replace these by user-defined routines,
+ * e.g., an arena that is reset after each call or a pool of huge pages.
+ */
+
+#ifndef FNFT_ALLOCATOR_H
+#define FNFT_ALLOCATOR_H
+
+#include "fnft_numtypes.h"
+
+/**
+ * @brief Alignment in bytes of the numerical arrays that FNFT allocates.
+ * @ingroup allocator
+ *
+ * All numerical arrays that FNFT allocates internally start at an address
+ * that is a multiple of FNFT_ALIGNMENT, which is the size of a cache line and
+ * of an AVX-512 register, and their size is padded to a multiple of
+ * FNFT_ALIGNMENT.\n
+ * \n
+ * Arrays that are supplied by the user (e.g., the input signal q or the
+ * output array contspec of \link fnft_nsev \endlink) only have to be aligned
+ * as required by their element type. FNFT never assumes more, and never reads
+ * or writes beyond the documented number of elements. User arrays whose
+ * address is a multiple of FNFT_ALIGNMENT are however processed faster, since
+ * the vectorized loops then do not need to split accesses across cache lines.
+ */
+#define FNFT_ALIGNMENT 64
+
+/**
+ * @brief Set of memory allocation routines used by FNFT.
+ * @ingroup allocator
+ *
+ * All four function pointers have to be provided. Every routine is passed the
+ * value of user_data as its last argument.\n
+ * \n
+ * Memory obtained with malloc_ptr is released with free_ptr, memory obtained
+ * with aligned_malloc_ptr is released with aligned_free_ptr. FNFT never mixes
+ * the two. The routines are called with size > 0 only and must return NULL
+ * if an allocation fails. The free routines are never called with NULL.
+ * FNFT calls aligned_malloc_ptr with alignment \link FNFT_ALIGNMENT \endlink
+ * and sizes that are multiples of it, and uses it for all numerical arrays.
+ */
+typedef struct {
+    /// Allocates a block of size bytes.
+    void * (* malloc_ptr)(FNFT_UINT size, void * user_data);
+    /// Releases a block that has been allocated with malloc_ptr.
+    void (* free_ptr)(void * ptr, void * user_data);
+    /// Allocates a block of size bytes whose address is a multiple of
+    /// alignment, which is a power of two.
+    void * (* aligned_malloc_ptr)(FNFT_UINT alignment, FNFT_UINT size,
+                                  void * user_data);
+    /// Releases a block that has been allocated with aligned_malloc_ptr.
+    void (* aligned_free_ptr)(void * ptr, void * user_data);
+    /// Passed unchanged to the routines above.
+    void * user_data;
+} fnft_allocator_t;
+
+/**
+ * @brief Sets the memory allocation routines that FNFT uses internally.
+ * @ingroup allocator
+ *
+ * The allocator is shared by all threads of the process. It should be set
+ * before any other FNFT routine is called, and must not be changed while
+ * another FNFT routine is running or while memory that has been allocated by
+ * FNFT is still in use (e.g., an FFT plan).\n
+ * \n
+ * When FNFT has been built with OpenMP, a single call of an FNFT routine may
+ * run parts of its computation on several threads. The routines set here can
+ * then be called concurrently and have to be thread-safe (malloc and free
+ * are).\n
+ * \n
+ * When FNFT has been built with FFTW, FFTW allocates the internal memory of
+ * its plans itself. The input and output buffers of the FFTs are however
+ * allocated with the routines set here.
+ *
+ * @param[in] allocator Pointer to the new set of routines, which is copied.
+ *  Pass NULL to restore the default routines (based on malloc and free).
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft_set_allocator(fnft_allocator_t const * const allocator);
+
+/**
+ * @brief Returns the memory allocation routines that FNFT currently uses.
+ * @ingroup allocator
+ *
+ * @param[out] allocator Pointer to a \link fnft_allocator_t \endlink object
+ *  that is overwritten with the current set of routines.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft_get_allocator(fnft_allocator_t * const allocator);
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ */
+
+#ifndef FNFT_CONFIG_H
+#define FNFT_CONFIG_H
+
+#define FNFT_VERSION_MAJOR 0
+#define FNFT_VERSION_MINOR 4
+#define FNFT_VERSION_PATCH 1
+#define FNFT_VERSION_SUFFIX ""
+// The suffix should not exceed the length defined below (not counting the NULL
+// termination symbol)
+#define FNFT_VERSION_SUFFIX_MAXLEN 8
+
+/* #undef HAVE__THREAD_LOCAL */
+#define HAVE___THREAD 1
+/* #undef DEBUG */
+/* #undef HAVE_FFTW3 */
+#define HAVE_PRAGMA_GCC_OPTIMIZE_OFAST 1
+#define HAVE_ATTRIBUTE_TARGET_CLONES 1
+#define HAVE_OPENMP 1
+#define HAVE_MMAP 1
+
+#endif
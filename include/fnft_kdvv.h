@@ -31,6 +31,55 @@
 
 #include "fnft_kdv_discretization_t.h"
 
+/**
+ * Enum that specifies how the bound states are localized. Used in
+ * \link fnft_kdvv_opts_t \endlink. \n \n
+ * @ingroup data_types
+ *  fnft_kdvv_bsloc_GRIDSEARCH_AND_REFINE: The bound states of the KdV equation
+ *  are located on the positive imaginary axis, \f$ \lambda_k = j\kappa_k \f$,
+ *  where \f$ a(j\kappa) \f$ is real-valued and changes sign at every bound
+ *  state. The number of bound states is first determined by counting the
+ *  zeros of the solution of the discretized scattering problem for
+ *  \f$ \lambda=0 \f$. The polynomial transfer matrix is then evaluated on a
+ *  uniform grid of \f$ \kappa \f$ between zero and the square root of the
+ *  maximum of the signal, which corresponds to a segment of the real line
+ *  \f$ 0<z\leq 1 \f$, and the grid is refined until sufficiently many sign
+ *  changes have been found. The sign changes provide initial guesses, which
+ *  are refined using the NEWTON method on the full signal. The complexity is
+ *  \f$ O(D \log^2 D + niter K D) \f$, where \f$ K \f$ is the number of bound
+ *  states. \n \n
+ *  fnft_kdvv_bsloc_NEWTON: Newton's method is used to refine a given set of
+ *  initial guesses. The refinement uses the discretization
+ *  fnft_kdv_discretization_BO. The number of iterations is specified through
+ *  the field \link fnft_kdvv_opts_t::niter \endlink. The array bound_states
+ *  passed to \link fnft_kdvv \endlink should contain the initial guesses and
+ *  *K_ptr should specify the number of initial guesses. It is sufficient if
+ *  bound_states and normconsts_or_residues are of length *K_ptr in this case.
+ *  The complexity is \f$ O(niter (*K\_ptr) D) \f$.
+ */
+typedef enum {
+    fnft_kdvv_bsloc_GRIDSEARCH_AND_REFINE,
+    fnft_kdvv_bsloc_NEWTON
+} fnft_kdvv_bsloc_t;
+
+/**
+ * Enum that specifies the type of the discrete spectrum computed by the
+ * routine. Used in \link fnft_kdvv_opts_t \endlink.\n \n
+ * @ingroup data_types
+ *  fnft_kdvv_dstype_NORMING_CONSTANTS: The array is filled with the norming
+ *  constants \f$ b_k \f$. \n\n
+ *  fnft_kdvv_dstype_RESIDUES: The array is filled with the residues (aka
+ *  spectral amplitudes) \f$ b_k\big/ \frac{da(\lambda_k)}{d\lambda} \f$.\n\n
+ *  fnft_kdvv_dstype_BOTH: The array is filled with the norming constants
+ *  followed by the residues. Note that the length of the array passed by the
+ *  user has to be 2*(*K_ptr) in this case.
+ */
+typedef enum {
+    fnft_kdvv_dstype_NORMING_CONSTANTS,
+    fnft_kdvv_dstype_RESIDUES,
+    fnft_kdvv_dstype_BOTH
+} fnft_kdvv_dstype_t;
+
 /**
  * @struct fnft_kdvv_opts_t
  * @brief Stores additional options for the routine \link fnft_kdvv \endlink. 
@@ -39,11 +88,35 @@
  * Use the \link fnft_kdvv_default_opts \endlink routine in order to generate
  * a new variable of this type with default options and modify as needed.
  *
+ * @var fnft_kdvv_opts_t::bound_state_localization
+ *  Controls how \link fnft_kdvv \endlink localizes bound states. \n
+ *  Should be of type \link fnft_kdvv_bsloc_t \endlink.
+ *
+ * @var fnft_kdvv_opts_t::niter
+ *  Number of Newton iterations to be carried out when either the
+ *  fnft_kdvv_bsloc_NEWTON or the fnft_kdvv_bsloc_GRIDSEARCH_AND_REFINE method
+ *  is used.
+ *
+ * @var fnft_kdvv_opts_t::discspec_type
+ *  Controls how \link fnft_kdvv \endlink fills the array
+ *  normconsts_or_residues. \n
+ *  Should be of type \link fnft_kdvv_dstype_t \endlink.
+ *
+ * @var fnft_kdvv_opts_t::normalization_flag
+ *  Controls whether intermediate results during the fast forward scattering
+ *  step are normalized. This takes a bit longer but prevents overflows for
+ *  large or long signals. By default, normalization is enabled (i.e., the
+ *  flag is one). To disable, set the flag to zero.
+ *
  * @var fnft_kdvv_opts_t::discretization
  *  Controls which discretization is applied to the continuous-time scattering
  *  problem. See \link fnft_kdv_discretization_t \endlink.
  */
 typedef struct {
+    fnft_kdvv_bsloc_t bound_state_localization;
+    FNFT_UINT niter;
+    fnft_kdvv_dstype_t discspec_type;
+    FNFT_INT normalization_flag;
     fnft_kdv_discretization_t discretization;
 } fnft_kdvv_opts_t;
 
@@ -51,7 +124,12 @@ typedef struct {
  * @brief Creates a new options variable for \link fnft_kdvv \endlink with
  * default settings.
  *
- * @returns A \link fnft_kdvv_opts_t \endlink object with default options.
+ * @returns A \link fnft_kdvv_opts_t \endlink object with the following options.\n
+ *  bound_state_localization = fnft_kdvv_bsloc_GRIDSEARCH_AND_REFINE\n
+ *  niter = 10\n
+ *  discspec_type = fnft_kdvv_dstype_NORMING_CONSTANTS\n
+ *  normalization_flag = 1\n
+ *  discretization = fnft_kdv_discretization_2SPLIT8B\n
  *
  * @ingroup fnft
  */
@@ -69,6 +147,8 @@ fnft_kdvv_opts_t fnft_kdvv_default_opts();
  * for initial conditions with vanishing boundaries
  * \f[ \lim_{t\to \pm \infty }q(x_0,t) = 0 \text{ sufficiently rapidly.} \f]
  *
+ * @see \link FNFT_ALIGNMENT \endlink
+ *
  * @param[in] D Number of samples.
  * @param[in] q Array of length D, contains samples \f$ q(t_n)=q(x_0, t_n) \f$,
  * where \f$ t_n = T[0] + n(T[1]-T[0])/(D-1) \f$ and \f$n=0,1,\dots,D-1\f$, of
@@ -82,13 +162,32 @@ fnft_kdvv_opts_t fnft_kdvv_default_opts();
  * desired samples \f$ R(\xi_m) \f$ of the continuous spectrum (aka
  * reflection coefficient) in ascending order,
  * where \f$ \xi_m = XI[0]+m(XI[1]-XI[0])/(M-1) \f$ and \f$m=0,1,\dots,M-1\f$.
- * Has to be preallocated by the user.
+ * Has to be preallocated by the user. If NULL is passed instead, the
+ * continuous spectrum will not be computed.
  * @param[in] XI Array of length 2, contains the position of the first and the
  * last sample of the continuous spectrum. It should be XI[0]<XI[1]. Can also be
  * NULL if contspec==NULL.
- * @param[in,out] K_ptr Not yet implemented. Pass NULL.
- * @param[out] bound_states Not yet implemented. Pass NULL.
- * @param[out] normconsts_or_residues Not yet implemented. Pass NULL.
+ * @param[in,out] K_ptr Upon entry, *K_ptr should contain the length of the
+ *  array bound_states. Upon return, *K_ptr contains the number of actually
+ *  detected bound states. If the length of the array bound_states was not
+ *  sufficient to store all of the detected bound states, a warning is printed
+ *  and as many bound states as possible are returned instead. Can be NULL if
+ *  bound_states==NULL.
+ * @param[out] bound_states Array. Upon return, the routine has stored the
+ *  detected bound states (aka eigenvalues) \f$ \lambda_k = j\kappa_k \f$,
+ *  \f$ \kappa_k>0 \f$, in ascending order of \f$ \kappa_k \f$ in the first
+ *  *K_ptr entries of this array. If NULL is passed instead, the discrete
+ *  spectrum will not be computed. Has to be preallocated by the user. The user
+ *  can choose an arbitrary length. Typically, D is a good choice.
+ * @param[out] normconsts_or_residues Array of the same length as bound_states.
+ *  Upon return, the routine has stored the norming constants \f$ b_k \f$ in
+ *  the first *K_ptr entries of this array. Here, the solution of the
+ *  scattering problem with \f$ \phi(t)\sim e^{\kappa_k t} \f$ for
+ *  \f$ t\to-\infty \f$ satisfies \f$ \phi(t)\sim b_k e^{-\kappa_k t} \f$
+ *  for \f$ t\to\infty \f$. By passing a proper opts, it is also possible to
+ *  store the residues \f$ b_k\big/ \frac{da(\lambda_k)}{d\lambda} \f$ or
+ *  both. Has to be pre-allocated by the user. If NULL is passed instead, the
+ *  norming constants will not be computed.
  * @param[in] opts_ptr Pointer to a \link fnft_kdvv_opts_t \endlink object. The
  * object can be used to modify the behavior of the routine. Use
  * the routine \link fnft_kdvv_default_opts \endlink
@@ -110,6 +209,11 @@ FNFT_INT fnft_kdvv(const FNFT_UINT D, FNFT_COMPLEX * const q,
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define kdvv_opts_t fnft_kdvv_opts_t
+#define kdvv_bsloc_GRIDSEARCH_AND_REFINE fnft_kdvv_bsloc_GRIDSEARCH_AND_REFINE
+#define kdvv_bsloc_NEWTON fnft_kdvv_bsloc_NEWTON
+#define kdvv_dstype_NORMING_CONSTANTS fnft_kdvv_dstype_NORMING_CONSTANTS
+#define kdvv_dstype_RESIDUES fnft_kdvv_dstype_RESIDUES
+#define kdvv_dstype_BOTH fnft_kdvv_dstype_BOTH
 #endif
 
 #endif
@@ -0,0 +1,164 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+/**
+ * @file fnft_kdvv_inverse.h
+ * @brief Fast inverse nonlinear Fourier transform for the vanishing
+ *  Korteweg-de Vries equation.
+ * @ingroup fnft_inverse
+ */
+
+#ifndef FNFT_KDVV_INVERSE_H
+#define FNFT_KDVV_INVERSE_H
+
+#include "fnft_kdv_discretization_t.h"
+
+/**
+ * @struct fnft_kdvv_inverse_opts_t
+ * @brief Stores additional options for the routine
+ * \link fnft_kdvv_inverse \endlink.
+ * @ingroup fnft_inverse
+ * @ingroup data_types
+ *
+ * Use the \link fnft_kdvv_inverse_default_opts \endlink routine in order
+ * to generate a new variable of this type with default options and modify
+ * as needed.
+ *
+ * @var fnft_kdvv_inverse_opts_t::discretization
+ *  Controls which discretization is applied to the continuous-time
+ *  scattering problem. See \link fnft_kdv_discretization_t \endlink.
+ *  Currently, only 2SPLIT1B and 2SPLIT2A are supported.
+ */
+typedef struct {
+    fnft_kdv_discretization_t discretization;
+} fnft_kdvv_inverse_opts_t;
+
+/**
+ * @brief Creates a new options variable for \link fnft_kdvv_inverse \endlink
+ * with default settings.
+ *
+ * @returns A \link fnft_kdvv_inverse_opts_t \endlink object with the
+ *  following options.\n\n
+ *  discretization = fnft_kdv_discretization_2SPLIT2A
+ *
+ * @ingroup fnft_inverse
+ */
+fnft_kdvv_inverse_opts_t fnft_kdvv_inverse_default_opts();
+
+/**
+ * @brief Determines the locations of the first and last sample of
+ * the grid that has to be used when providing a continuous spectrum
+ * to \link fnft_kdvv_inverse \endlink.
+ *
+ * @param[in] D Number of samples of the to be generated signal u. Should be >=2.
+ * @param[in] T Array of length two. Contains the desired location
+ *  of the first and last sample of the signal u.
+ * @param[in] M Number of samples in the nonlinear frequency domain.
+ * @param[out] XI Array of length 2. Will be overwritten with the
+ *  desired values specifying the grid for the continuous spectrum.
+ * @param[in] discretization See \link fnft_kdvv_inverse_opts_t \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft_inverse
+ */
+FNFT_INT fnft_kdvv_inverse_XI(
+    const FNFT_UINT D,
+    FNFT_REAL const * const T,
+    const FNFT_UINT M,
+    FNFT_REAL * const XI,
+    const fnft_kdv_discretization_t discretization);
+
+/**
+ * @brief Fast inverse nonlinear Fourier transform for the Korteweg-de Vries
+ *  equation with vanishing boundary conditions.
+ *
+ * This routine is the counterpart to \link fnft_kdvv \endlink. It recovers
+ * a real signal without bound states from its continuous spectrum (aka
+ * reflection coefficient) in \f$ O(D\log^2 D) \f$ floating point operations.
+ *
+ * The given samples of the reflection coefficient are converted into samples
+ * of the reflection coefficient of the discretized scattering problem, which
+ * are expanded into a power series with a FFT. The power series determines
+ * the leading coefficients of the second column of the transfer matrix
+ * computed by \link fnft_kdvv \endlink, which is inverted with the
+ * fast layer peeling algorithm of \link fnft__kdv_finvscatter \endlink.
+ * The latter is the counterpart of the one used by
+ * \link fnft_nsev_inverse \endlink.
+ * The main references are\n
+ *
+ * - McClary, <a href="https://doi.org/10.1190/1.1441417">&quot;Fast
+ *   Seismic Inversion&quot;</a>, Geophysis 48(10), 1983.
+ * - Wahls and Poor, <a href="https://doi.org/10.1109/ISIT.2015.7282741">
+ *   &quot;Fast Inverse Nonlinear Fourier Transform For Generating
+ *   Multi-Solitons In Optical Fiber&quot;</a>, Proc. IEEE ISIT 2015.
+ *
+ * Layer peeling is ill-conditioned for signals with bound states, and
+ * becomes less accurate for strongly reflecting signals. Bound states are
+ * currently not supported.
+ *
+ * @see \link FNFT_ALIGNMENT \endlink
+ *
+ * @param[in] M Number of samples of the continuous spectrum. Should be even
+ *  and at least D. Choosing M larger than D reduces the aliasing errors of
+ *  the FFT.
+ * @param[in] contspec Array of length M, contains samples
+ *  \f$ \hat{q}(\xi_n) \f$, where \f$ \xi_n = XI[0] + n(XI[1]-XI[0])/(M-1) \f$
+ *  and \f$n=0,1,\dots,M-1\f$, of the to-be-inverted reflection coefficient
+ *  in ascending order (i.e.,
+ *  \f$ \hat{q}(\xi_0), \hat{q}(\xi_1), \dots, \hat{q}(\xi_{M-1}) \f$), as
+ *  computed by \link fnft_kdvv \endlink.
+ * @param[in] XI Array of length 2, contains the position of the first and the last
+ *  sample of the continuous spectrum. Currently, the positions returned
+ *  by \link fnft_kdvv_inverse_XI \endlink MUST be used. It is NOT checked
+ *  whether the user adheres to this requirement.
+ * @param[in] D Number of samples of the to be generated signal u. Should be a
+ *  positive power of two.
+ * @param[out] u Array of length D. Is filled with samples
+ *  \f$ u(t_n) \f$, where \f$ t_n = T[0] + n(T[1]-T[0])/(D-1) \f$
+ *  and \f$n=0,1,\dots,D-1\f$, of the to-be-generated signal in ascending order
+ *  (i.e., \f$ u(t_0), u(t_1), \dots, u(t_{D-1}) \f$). The imaginary parts
+ *  are zero.
+ * @param[in] T Array of length 2, contains the position in time of the first and
+ *  of the last sample of u. It should be T[0]<T[1].
+ * @param[in] opts_ptr Pointer to a \link fnft_kdvv_inverse_opts_t \endlink
+ *  object. The object  can be used to modify the behavior of the routine. Use
+ *  the routine \link fnft_kdvv_inverse_default_opts \endlink
+ *  to generate such an object and modify as desired. It is also possible to
+ *  pass NULL, in which case the routine will use the default options. The
+ *  user is reponsible to freeing the object after the routine has returned.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft_inverse
+ */
+FNFT_INT fnft_kdvv_inverse(
+    const FNFT_UINT M,
+    FNFT_COMPLEX const * const contspec,
+    FNFT_REAL const * const XI,
+    const FNFT_UINT D,
+    FNFT_COMPLEX * const u,
+    FNFT_REAL const * const T,
+    fnft_kdvv_inverse_opts_t *opts_ptr);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define kdvv_inverse_opts_t fnft_kdvv_inverse_opts_t
+#endif
+
+#endif
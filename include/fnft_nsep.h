@@ -131,11 +131,29 @@ typedef enum {
  *   is used during localization. See \link fnft_nsep_loc_t \endlink.
  *   When set to zero (default), the algorithm will choose Dsub automatically
  *   such that the complexity of finding initial guesses is O(D log^2 D).
+ *   The subsampled signal has to cover exactly one period, so the value is
+ *   replaced by the even factor of D that is closest to it.
  *
  * @var fnft_nsep_opts_t::tol
  *   Tolerance used to stop the refinement of main and auxiliary spectrum.
  *   Should be positive or -1. In latter case, the algorithm chooses the
  *   tolerance.
+ *
+ * @var fnft_nsep_opts_t::spine_tracing
+ *   Only used by SUBSAMPLE_AND_REFINE and MIXED localization if
+ *   \link fnft_nsep_opts_t::points_per_spine \endlink is larger than two.
+ *   If nonzero, the initial guesses are computed as usual only for the first
+ *   and the last value of rhs (see \link fnft_nsep_opts_t::floquet_range
+ *   \endlink). For the values in between, the refined points for the
+ *   previous value of rhs are used as initial guesses, i.e., the spines and
+ *   the points on the real line are traced by continuation. Spines that branch off the real line are picked
+ *   up at the critical points of Delta, which are located once. Points are
+ *   traced in a slightly enlarged bounding box, so that spines that enter the
+ *   bounding box are picked up as well. Points that do not converge are
+ *   dropped. This is much faster if points_per_spine is
+ *   large, but points can be lost if the steps between consecutive values of
+ *   rhs are large. If zero (default), the initial guesses are computed anew
+ *   for every value of rhs.
  */
 typedef struct {
     fnft_nsep_loc_t localization;
@@ -148,6 +166,7 @@ typedef struct {
     FNFT_UINT points_per_spine;
     FNFT_UINT Dsub;
     FNFT_REAL tol;
+    FNFT_INT spine_tracing;
 } fnft_nsep_opts_t;
 
 /**
@@ -167,7 +186,9 @@ typedef struct {
  *  discretization = fnft_nse_discretization_2SPLIT2A\n
  *  floquet_range = {-1, 1}\n
  *  floquet_nvals = 2\n
- *  Dsub = 0
+ *  Dsub = 0\n
+ *  tol = -1\n
+ *  spine_tracing = 0
  */
 fnft_nsep_opts_t fnft_nsep_default_opts();
 
@@ -211,7 +232,10 @@ fnft_nsep_opts_t fnft_nsep_default_opts();
  *       - fnft_nse_discretization_2SPLIT8B
  *       - fnft_nse_discretization_4SPLIT4A
  *
- * @param[in] D Number of samples. Should be power of two and \f$ D\geq 2\f$.
+ * @see \link FNFT_ALIGNMENT \endlink
+ *
+ * @param[in] D Number of samples. Has to be even and \f$ D\geq 2\f$. It does
+ *  not have to be a power of two.
  * @param[in] q Array of length D, contains samples \f$ q(t_n)=q(x_0, t_n) \f$,
  *  where \f$ t_n = T[0] + n*L/D \f$, where \f$L=T[1]-T[0]\f$ is the period and
  *  \f$n=0,1,\dots,D-1\f$, of the to-be-transformed signal in ascending order
@@ -78,7 +78,10 @@ typedef enum {
  *  between the other two. The method automatically finds initial guesses for
  *  the NEWTON method by first applying the FAST_EIGENVALUE method to a
  *  subsampled version of the signal. Second these initial guesses are refined
- *  using the NEWTON method. The number of samples of the subsampled signal can
+ *  with at most three iterations of the NEWTON method on a cascade of less
+ *  and less subsampled signals, whose number of samples grows by a factor of
+ *  four per level. Finally, the guesses are refined using the NEWTON method
+ *  on the full signal. The number of samples of the subsampled signal can
  *  be controlled using the parameter Dsub in \link fnft_nsev_opts_t \endlink.
  *  If Dsub=0, the routine automatically chooses this number such that the
  *  complexity is \f$ O(D \log^2 D + niter K D) \f$, where \f$ K \f$ is the
@@ -86,12 +89,35 @@ typedef enum {
  *  call to the fnft_nsev_bsloc_FAST_EIGENVALUE method w.r.t. the subsampled
  *  signal. By choosing Dsub between 2 and D, the user can be request a
  *  different number of samples. Note that algorithm uses this value only as an
- *  indication.
+ *  indication. If FNFT has been built with OpenMP, the continuous spectrum of
+ *  the full signal is computed on another thread while the bound states are
+ *  localized (this also applies to the TRACKING method). \n \n
+ *  fnft_nsev_bsloc_TRACKING: Meant for sequences of similar signals (e.g.,
+ *  consecutive frames of a measurement), where the bound states of the
+ *  previous signal are good initial guesses for the current one. The first
+ *  \link fnft_nsev_opts_t::K_tracked \endlink entries of the array
+ *  bound_states passed to \link fnft_nsev \endlink should contain these
+ *  guesses, which are refined using the NEWTON method. The number of refined
+ *  bound states is then compared with the number of roots of
+ *  \f$ a(\lambda) \f$ in the region allowed by the bounding box, which
+ *  is determined cheaply using the argument principle for a subsampled
+ *  version of the signal with Dsub samples (see
+ *  \link fnft_nsev_opts_t::Dsub \endlink). Only if the two
+ *  numbers disagree (i.e., if a bound state has been missed or a spurious one
+ *  has been found), the bound states are localized from scratch using the
+ *  SUBSAMPLE_AND_REFINE method. Unlike for the NEWTON method, *K_ptr should
+ *  specify the length of the arrays bound_states and normconsts_or_residues.
+ *  Upon return, \link fnft_nsev_opts_t::K_tracked \endlink is set to the number
+ *  of bound states found, so that the same options and arrays can be passed
+ *  directly with the next signal. The method requires a discretization with a
+ *  polynomial transfer matrix. If the guesses are good, its complexity is
+ *  \f$ O(D \log D + niter K D) \f$.
  */
 typedef enum {
     fnft_nsev_bsloc_FAST_EIGENVALUE,
     fnft_nsev_bsloc_NEWTON,
-    fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE
+    fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE,
+    fnft_nsev_bsloc_TRACKING
 } fnft_nsev_bsloc_t;
 
 /**
@@ -153,13 +179,20 @@ typedef enum {
  *
  * @var fnft_nsev_opts_t::Dsub
  *   Controls how many samples are used after subsampling when bound states are
- *   localized using the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE method. See
+ *   localized using the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE or the
+ *   fnft_nsev_bsloc_TRACKING method. See
  *   \link fnft_nsev_bsloc_t \endlink for details.
  *
  * @var fnft_nsev_opts_t::niter
  *  Number of Newton iterations to be carried out when either the
- *  fnft_nsev_bsloc_NEWTON or the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE method
- *  is used.
+ *  fnft_nsev_bsloc_NEWTON, the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE or the
+ *  fnft_nsev_bsloc_TRACKING method is used.
+ *
+ * @var fnft_nsev_opts_t::K_tracked
+ *  Number of bound states of the previous signal that are passed as initial
+ *  guesses when the fnft_nsev_bsloc_TRACKING method is used. Should not
+ *  exceed *K_ptr. Updated by \link fnft_nsev \endlink. See
+ *  \link fnft_nsev_bsloc_t \endlink for details.
  *
  * @var fnft_nsev_opts_t::discspec_type
  *  Controls how \link fnft_nsev \endlink fills the array
@@ -191,7 +224,9 @@ typedef enum {
  *  Fast Nonlinear Fourier Transform Algorithms Using Higher Order Exponential
  *  Integrators,&quot;</a> IEEE Access 7, 2019. Note that in certain situations
  *  such as discontinuous signals, applying Richardson extrapolation may result in
- *  worse accuracy compared to the first approximation.
+ *  worse accuracy compared to the first approximation. If FNFT has been built
+ *  with OpenMP, the second approximation of the continuous spectrum is
+ *  computed on a second thread while the first approximation is computed.
  *  By default, Richardson extrapolation is disabled (i.e., the
  *  flag is zero). To enable, set the flag to one.
  */
@@ -205,6 +240,7 @@ typedef struct {
     FNFT_INT normalization_flag;
     fnft_nse_discretization_t discretization;
     FNFT_UINT richardson_extrapolation_flag;
+    FNFT_UINT K_tracked;
 } fnft_nsev_opts_t;
 
 /**
@@ -220,6 +256,7 @@ typedef struct {
  *  normalization_flag = 1\n
  *  discretization = fnft_nse_discretization_2SPLIT4B\n
  *  richardson_extrapolation_flag = 0\n
+ *  K_tracked = 0\n
  *
   * @ingroup fnft
  */
@@ -316,6 +353,8 @@ FNFT_UINT fnft_nsev_max_K(const FNFT_UINT D,
  *       - Focusing case CF6_4, residues have order four instead of seven.
  *       - Focusing case TES4, residues have order two instead of five.
  *
+ * @see \link FNFT_ALIGNMENT \endlink
+ *
  * @param[in] D Number of samples
  * @param[in] q Array of length D, contains samples \f$ q(t_n)=q(x_0, t_n) \f$,
  *  where \f$ t_n = T[0] + n(T[1]-T[0])/(D-1) \f$ and \f$n=0,1,\dots,D-1\f$, of
@@ -375,6 +414,157 @@ FNFT_INT fnft_nsev(const FNFT_UINT D, FNFT_COMPLEX * const q,
     FNFT_COMPLEX * const normconsts_or_residues, const FNFT_INT kappa,
     fnft_nsev_opts_t *opts);
 
+/**
+ * @struct fnft_nsev_transfer_matrix_t
+ * @brief Polynomial transfer matrix of a signal, which allows to compute
+ * several spectra of the same signal without repeating the fast forward
+ * scattering step.
+ * @ingroup fnft
+ * @ingroup data_types
+ *
+ * Objects of this type are created with \link fnft_nsev_transfer_matrix
+ * \endlink, queried with \link fnft_nsev_from_transfer_matrix \endlink and
+ * released with \link fnft_nsev_transfer_matrix_free \endlink. The fields
+ * should not be modified by the user.
+ *
+ * @var fnft_nsev_transfer_matrix_t::D
+ *  Number of samples of the signal.
+ * @var fnft_nsev_transfer_matrix_t::T
+ *  Position in time of the first and of the last sample.
+ * @var fnft_nsev_transfer_matrix_t::eps_t
+ *  Step size (T[1]-T[0])/(D-1).
+ * @var fnft_nsev_transfer_matrix_t::kappa
+ *  =+1 for the focusing and =-1 for the defocusing case.
+ * @var fnft_nsev_transfer_matrix_t::discretization
+ *  Discretization that has been used to compute the transfer matrix.
+ * @var fnft_nsev_transfer_matrix_t::deg
+ *  Degree of the polynomials in the transfer matrix.
+ * @var fnft_nsev_transfer_matrix_t::W
+ *  The transfer matrix has to be multiplied by 2^W to obtain the actual one
+ *  (see \link fnft_nsev_opts_t::normalization_flag \endlink).
+ * @var fnft_nsev_transfer_matrix_t::transfer_matrix
+ *  Array of length 4*(deg+1) that contains the coefficients of the four
+ *  polynomials of the transfer matrix, see \link fnft__nse_fscatter
+ *  \endlink.
+ * @var fnft_nsev_transfer_matrix_t::q
+ *  Copy of the samples of the signal.
+ * @var fnft_nsev_transfer_matrix_t::D_effective
+ *  Number of samples of the preprocessed signal (see \link
+ *  fnft__nse_discretization_preprocess_signal \endlink).
+ * @var fnft_nsev_transfer_matrix_t::q_preprocessed
+ *  Array of length D_effective that contains the preprocessed signal.
+ * @var fnft_nsev_transfer_matrix_t::r_preprocessed
+ *  Array of length D_effective that contains the preprocessed second
+ *  component of the signal, or NULL if it is not needed by the
+ *  discretization.
+ * @var fnft_nsev_transfer_matrix_t::file_data
+ *  Contents of the file from which the object has been loaded with \link
+ *  fnft_nsev_transfer_matrix_load \endlink, or NULL. The arrays above then
+ *  point into this block. Modifying them does not change the file.
+ * @var fnft_nsev_transfer_matrix_t::file_size
+ *  Size of this file in bytes.
+ */
+typedef struct {
+    FNFT_UINT D;
+    FNFT_REAL T[2];
+    FNFT_REAL eps_t;
+    FNFT_INT kappa;
+    fnft_nse_discretization_t discretization;
+    FNFT_UINT deg;
+    FNFT_INT W;
+    FNFT_COMPLEX * transfer_matrix;
+    FNFT_COMPLEX * q;
+    FNFT_UINT D_effective;
+    FNFT_COMPLEX * q_preprocessed;
+    FNFT_COMPLEX * r_preprocessed;
+    void * file_data;
+    FNFT_UINT file_size;
+} fnft_nsev_transfer_matrix_t;
+
+/**
+ * @brief Computes the polynomial transfer matrix of a signal.
+ *
+ * Performs the preprocessing and the fast forward scattering step of \link
+ * fnft_nsev \endlink and stores the result in a \link
+ * fnft_nsev_transfer_matrix_t \endlink object. The spectrum can then be
+ * computed for different grids, types and filters with \link
+ * fnft_nsev_from_transfer_matrix \endlink, which is much cheaper than
+ * repeated calls of \link fnft_nsev \endlink.
+ *
+ * @param[in] D Number of samples, see \link fnft_nsev \endlink.
+ * @param[in] q Array of length D with the samples of the signal, see
+ *  \link fnft_nsev \endlink. It is copied.
+ * @param[in] T Array of length 2, see \link fnft_nsev \endlink.
+ * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
+ *  =-1 for the defocusing one.
+ * @param[out] tm Pointer to a \link fnft_nsev_transfer_matrix_t \endlink
+ *  object that is filled by the routine. Release it with \link
+ *  fnft_nsev_transfer_matrix_free \endlink after use, also if the routine
+ *  fails.
+ * @param[in] opts Pointer to a \link fnft_nsev_opts_t \endlink object, or
+ *  NULL for the default options. Only the fields discretization and
+ *  normalization_flag are used. The discretization has to be one of the
+ *  discretizations with a fast algorithm listed in \link fnft_nsev
+ *  \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_transfer_matrix(const FNFT_UINT D,
+    FNFT_COMPLEX const * const q, FNFT_REAL const * const T,
+    const FNFT_INT kappa, fnft_nsev_transfer_matrix_t * const tm,
+    fnft_nsev_opts_t const * opts);
+
+/**
+ * @brief Computes the nonlinear Fourier spectrum from a transfer matrix.
+ *
+ * Same as \link fnft_nsev \endlink, but for a signal whose transfer matrix
+ * has been computed with \link fnft_nsev_transfer_matrix \endlink. The
+ * continuous spectrum is obtained from the transfer matrix in
+ * \f$ O((D+M)\log(D+M)) \f$ operations. The bound states are localized with
+ * the method chosen in opts. The FAST_EIGENVALUE method uses the transfer
+ * matrix, the other methods work on the stored signal. The object tm is not
+ * modified, so several queries may run concurrently on the same object.\n
+ * \n
+ * The fields discretization and normalization_flag of opts are ignored, the
+ * values used to compute the transfer matrix apply. Richardson extrapolation
+ * is not supported.
+ *
+ * @param[in] tm Pointer to a \link fnft_nsev_transfer_matrix_t \endlink
+ *  object.
+ * @param[in] M See \link fnft_nsev \endlink.
+ * @param[out] contspec See \link fnft_nsev \endlink.
+ * @param[in] XI See \link fnft_nsev \endlink.
+ * @param[in,out] K_ptr See \link fnft_nsev \endlink.
+ * @param[in,out] bound_states See \link fnft_nsev \endlink.
+ * @param[out] normconsts_or_residues See \link fnft_nsev \endlink.
+ * @param[in,out] opts Pointer to a \link fnft_nsev_opts_t \endlink object,
+ *  or NULL for the default options. With the TRACKING method, the field
+ *  K_tracked is updated as in \link fnft_nsev \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_from_transfer_matrix(
+    fnft_nsev_transfer_matrix_t const * const tm, const FNFT_UINT M,
+    FNFT_COMPLEX * const contspec, FNFT_REAL const * const XI,
+    FNFT_UINT * const K_ptr, FNFT_COMPLEX * const bound_states,
+    FNFT_COMPLEX * const normconsts_or_residues, fnft_nsev_opts_t *opts);
+
+/**
+ * @brief Releases the memory of a transfer matrix.
+ *
+ * @param[in,out] tm Pointer to a \link fnft_nsev_transfer_matrix_t \endlink
+ *  object that has been passed to \link fnft_nsev_transfer_matrix
+ *  \endlink or \link fnft_nsev_transfer_matrix_load \endlink. Its arrays
+ *  are released and set to NULL. Passing the same object twice is harmless.
+ *
+ * @ingroup fnft
+ */
+void fnft_nsev_transfer_matrix_free(fnft_nsev_transfer_matrix_t * const tm);
+
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define nsev_bsfilt_NONE fnft_nsev_bsfilt_NONE
@@ -383,6 +573,7 @@ FNFT_INT fnft_nsev(const FNFT_UINT D, FNFT_COMPLEX * const q,
 #define nsev_bsloc_FAST_EIGENVALUE fnft_nsev_bsloc_FAST_EIGENVALUE
 #define nsev_bsloc_NEWTON fnft_nsev_bsloc_NEWTON
 #define nsev_bsloc_SUBSAMPLE_AND_REFINE fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE
+#define nsev_bsloc_TRACKING fnft_nsev_bsloc_TRACKING
 #define nsev_dstype_NORMING_CONSTANTS fnft_nsev_dstype_NORMING_CONSTANTS
 #define nsev_dstype_RESIDUES fnft_nsev_dstype_RESIDUES
 #define nsev_dstype_BOTH fnft_nsev_dstype_BOTH
@@ -0,0 +1,220 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+/**
+ * @file fnft_nsev_file.h
+ * @brief Saving and loading transfer matrices and spectra of
+ *  \link fnft_nsev \endlink.
+ * @ingroup fnft
+ *
+ * Transfer matrices (see \link fnft_nsev_transfer_matrix_t \endlink) and
+ * spectra are stored in a binary format that can be used without parsing
+ * or copying: if the platform supports it, a loaded file is mapped into
+ * memory and the arrays of the loaded object point directly into the
+ * mapping. Their entries are only read from disk when they are accessed.\n
+ * \n
+ * A file starts with a header of 256 bytes:
+ *
+ * | Offset | Type      | Content |
+ * |--------|-----------|---------|
+ * | 0      | char[8]   | "FNFTNSEV" |
+ * | 8      | uint32    | Version of the format, \link FNFT_NSEV_FILE_VERSION \endlink |
+ * | 12     | uint32    | 0x01020304 (detects the byte order) |
+ * | 16     | uint32    | Content: 1 = transfer matrix, 2 = spectrum |
+ * | 20     | uint32    | Reserved (0) |
+ * | 24     | uint64    | Size of the file in bytes |
+ * | 32     | uint64[4] | Offsets of up to four arrays from the start of the file in bytes, 0 if absent |
+ * | 64     | uint64[4] | Numbers of complex entries of these arrays |
+ * | 96     | int64[8]  | Integer metadata |
+ * | 160    | double[8] | Real metadata |
+ * | 224    | uint64[4] | Reserved (0) |
+ *
+ * The arrays follow the header. Each array starts at an offset that is a
+ * multiple of \link FNFT_ALIGNMENT \endlink (64) bytes and is zero-padded to
+ * such a multiple. A complex entry is stored as two doubles (real part,
+ * imaginary part). All values are stored in the byte order of the machine
+ * that has written the file. Files with another byte order or version are
+ * rejected.\n
+ * \n
+ * Transfer matrices (content 1): The arrays are transfer_matrix, q,
+ * q_preprocessed and r_preprocessed (absent if NULL). The integer metadata are
+ * D, D_effective, deg, kappa, W and discretization, the real metadata are
+ * T[0], T[1] and eps_t (see \link fnft_nsev_transfer_matrix_t \endlink).\n
+ * \n
+ * Spectra (content 2): The arrays are contspec, bound_states and
+ * normconsts_or_residues. The integer metadata are M, K, contspec_type and
+ * discspec_type, the real metadata are XI[0] and XI[1] (see
+ * \link fnft_nsev_spectrum_t \endlink).
+ */
+
+#ifndef FNFT_NSEV_FILE_H
+#define FNFT_NSEV_FILE_H
+
+#include "fnft_nsev.h"
+
+/**
+ * @brief Version of the file format written by this version of FNFT.
+ * @ingroup fnft
+ */
+#define FNFT_NSEV_FILE_VERSION 1
+
+/**
+ * @struct fnft_nsev_spectrum_t
+ * @brief Spectrum that has been loaded with \link fnft_nsev_spectrum_load
+ * \endlink.
+ * @ingroup fnft
+ * @ingroup data_types
+ *
+ * The arrays are read-only. Release the object with \link
+ * fnft_nsev_spectrum_free \endlink.
+ *
+ * @var fnft_nsev_spectrum_t::M
+ *  Number of points of the continuous spectrum, 0 if absent.
+ * @var fnft_nsev_spectrum_t::XI
+ *  Position of the first and the last point of the continuous spectrum.
+ * @var fnft_nsev_spectrum_t::contspec_type
+ *  Type of the continuous spectrum, see \link fnft_nsev_cstype_t \endlink.
+ * @var fnft_nsev_spectrum_t::contspec
+ *  Continuous spectrum as returned by \link fnft_nsev \endlink, or NULL.
+ * @var fnft_nsev_spectrum_t::K
+ *  Number of bound states.
+ * @var fnft_nsev_spectrum_t::discspec_type
+ *  Type of the array normconsts_or_residues, see \link fnft_nsev_dstype_t
+ *  \endlink.
+ * @var fnft_nsev_spectrum_t::bound_states
+ *  Array of length K with the bound states, or NULL.
+ * @var fnft_nsev_spectrum_t::normconsts_or_residues
+ *  Norming constants and/or residues as returned by \link fnft_nsev
+ *  \endlink, or NULL.
+ * @var fnft_nsev_spectrum_t::file_data
+ *  Contents of the file, into which the arrays above point.
+ * @var fnft_nsev_spectrum_t::file_size
+ *  Size of the file in bytes.
+ */
+typedef struct {
+    FNFT_UINT M;
+    FNFT_REAL XI[2];
+    fnft_nsev_cstype_t contspec_type;
+    FNFT_COMPLEX const * contspec;
+    FNFT_UINT K;
+    fnft_nsev_dstype_t discspec_type;
+    FNFT_COMPLEX const * bound_states;
+    FNFT_COMPLEX const * normconsts_or_residues;
+    void * file_data;
+    FNFT_UINT file_size;
+} fnft_nsev_spectrum_t;
+
+/**
+ * @brief Saves a transfer matrix to a file.
+ *
+ * @param[in] filename Name of the file, which is overwritten if it exists.
+ * @param[in] tm Pointer to a \link fnft_nsev_transfer_matrix_t \endlink
+ *  object.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_transfer_matrix_save(char const * const filename,
+    fnft_nsev_transfer_matrix_t const * const tm);
+
+/**
+ * @brief Loads a transfer matrix from a file.
+ *
+ * The arrays of the object point into the contents of the file, which are
+ * mapped into memory if the platform supports it. The object can be passed
+ * to \link fnft_nsev_from_transfer_matrix \endlink directly. It has to be
+ * released with \link fnft_nsev_transfer_matrix_free \endlink. If the
+ * routine fails, nothing remains mapped and the arrays are NULL.
+ *
+ * @param[in] filename Name of a file written by \link
+ *  fnft_nsev_transfer_matrix_save \endlink.
+ * @param[out] tm Pointer to a \link fnft_nsev_transfer_matrix_t \endlink
+ *  object that is filled by the routine.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_transfer_matrix_load(char const * const filename,
+    fnft_nsev_transfer_matrix_t * const tm);
+
+/**
+ * @brief Saves a spectrum computed by \link fnft_nsev \endlink or \link
+ * fnft_nsev_from_transfer_matrix \endlink to a file.
+ *
+ * The arguments are the same as for these routines. The lengths of contspec
+ * and normconsts_or_residues are determined from the fields contspec_type and
+ * discspec_type of opts.
+ *
+ * @param[in] filename Name of the file, which is overwritten if it exists.
+ * @param[in] M Number of points of the continuous spectrum.
+ * @param[in] contspec Continuous spectrum, or NULL.
+ * @param[in] XI Array of length 2. Can be NULL if contspec==NULL.
+ * @param[in] K Number of bound states.
+ * @param[in] bound_states Array of length K, or NULL.
+ * @param[in] normconsts_or_residues Norming constants and/or residues, or
+ *  NULL.
+ * @param[in] opts Pointer to the \link fnft_nsev_opts_t \endlink object that
+ *  has been used to compute the spectrum, or NULL for the default options.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_spectrum_save(char const * const filename,
+    const FNFT_UINT M, FNFT_COMPLEX const * const contspec,
+    FNFT_REAL const * const XI, const FNFT_UINT K,
+    FNFT_COMPLEX const * const bound_states,
+    FNFT_COMPLEX const * const normconsts_or_residues,
+    fnft_nsev_opts_t const * opts);
+
+/**
+ * @brief Loads a spectrum from a file.
+ *
+ * The arrays of the object point into the contents of the file, which are
+ * mapped into memory if the platform supports it. The object has to be
+ * released with \link fnft_nsev_spectrum_free \endlink. If the routine
+ * fails, nothing remains mapped and the arrays are NULL.
+ *
+ * @param[in] filename Name of a file written by \link fnft_nsev_spectrum_save
+ *  \endlink.
+ * @param[out] spectrum Pointer to a \link fnft_nsev_spectrum_t \endlink
+ *  object that is filled by the routine.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_spectrum_load(char const * const filename,
+    fnft_nsev_spectrum_t * const spectrum);
+
+/**
+ * @brief Releases a spectrum loaded with \link fnft_nsev_spectrum_load
+ * \endlink.
+ *
+ * @param[in,out] spectrum Pointer to a \link fnft_nsev_spectrum_t \endlink
+ *  object. Its arrays are set to NULL. Passing the same object twice is
+ *  harmless.
+ *
+ * @ingroup fnft
+ */
+void fnft_nsev_spectrum_free(fnft_nsev_spectrum_t * const spectrum);
+
+#endif
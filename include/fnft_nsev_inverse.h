@@ -234,6 +234,8 @@ FNFT_INT fnft_nsev_inverse_XI(
  *   data under the classical Darboux transform for su(2) soliton systems&quot;,</a>
  *   J. Acta Mathematicae Applicatae Sinica (1990) 6: 308.
  *
+ * @see \link FNFT_ALIGNMENT \endlink
+ *
  * @param[in] M Number of samples of the continuous spectrum.
  * @param[in,out] contspec Array of length M, contains samples
  *  \f$ \hat{q}(\xi_n) \f$, where \f$ \xi_n = XI[0] + n(XI[1]-XI[0])/(M-1) \f$
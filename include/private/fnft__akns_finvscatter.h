@@ -0,0 +1,125 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+/**
+ * \file fnft__akns_finvscatter.h
+ * @brief Divide-and-conquer algorithm that recovers the samples from a
+ * transfer matrix of an AKNS system.
+ * @ingroup akns
+ */
+
+#ifndef FNFT__AKNS_FINVSCATTER_H
+#define FNFT__AKNS_FINVSCATTER_H
+
+#include "fnft__fft_wrapper_plan_t.h"
+
+/**
+ * @brief Base case of \link fnft__akns_finvscatter \endlink.
+ *
+ * Determines the sample that corresponds to the 2x2 transfer matrix T(z) of
+ * degree one and stores the inverse of T(z), up to a power of z, in Ti(z).
+ * The polynomials are stored as in \link fnft__poly_fmult_two_polys2x2
+ * \endlink.
+ *
+ * @param[in] T_11 Coefficients of the upper left entry of T(z). The other
+ *  entries follow with the stride T_stride (row-wise).
+ * @param[in] T_stride See above.
+ * @param[out] Ti_11 Coefficients of the upper left entry of Ti(z). The
+ *  other entries follow with the stride Ti_stride (row-wise).
+ * @param[in] Ti_stride See above.
+ * @param[out] q Pointer to the sample.
+ * @param[in] params Parameters that have been passed to \link
+ *  fnft__akns_finvscatter \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup akns
+ */
+typedef FNFT_INT (* fnft__akns_finvscatter_base_case_t) (
+    FNFT_COMPLEX const * const T_11, const FNFT_UINT T_stride,
+    FNFT_COMPLEX * const Ti_11, const FNFT_UINT Ti_stride,
+    FNFT_COMPLEX * const q, void const * const params);
+
+/**
+ * @brief Routine that multiplies two 2x2 polynomial matrices in \link
+ * fnft__akns_finvscatter \endlink.
+ *
+ * Has the same arguments as \link fnft__poly_fmult_two_polys2x2 \endlink,
+ * which is one possible choice. \link fnft__poly_fmult_two_polys2x2_real
+ * \endlink can be used if all polynomials are real.
+ * @ingroup akns
+ */
+typedef FNFT_INT (* fnft__akns_finvscatter_mult2x2_t) (const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p1_11, const FNFT_UINT p1_stride,
+    FNFT_COMPLEX const * const p2_11, const FNFT_UINT p2_stride,
+    FNFT_COMPLEX * const result_11, const FNFT_UINT result_stride,
+    fnft__fft_wrapper_plan_t plan_fwd, fnft__fft_wrapper_plan_t plan_inv,
+    FNFT_COMPLEX * const buf0, FNFT_COMPLEX * const buf1,
+    FNFT_REAL * const soa_buf);
+
+/**
+ * @brief Recovers the samples that correspond to a transfer matrix with a
+ * divide-and-conquer algorithm.
+ *
+ * The transfer matrix T(z) is split into the transfer matrices of the first
+ * and the second half of the samples, T(z) = T2(z)*T1(z), which are
+ * recovered recursively. The recursion is implemented iteratively with a
+ * custom stack, which avoids stack overflows for large degrees. The samples
+ * are finally determined from transfer matrices of degree one by base_case,
+ * which also provides their inverses. The polynomial products are computed
+ * with mult2x2.\n
+ * \n
+ * If FNFT has been built with OpenMP, the products for large degrees are
+ * instead split into concurrent tasks, and the FFTs needed for the next
+ * product are computed while the recursion is running. The results do not
+ * depend on the number of threads.\n
+ * \n
+ * More information about the algorithm can be found in
+ * <a href="http://dx.doi.org/10.1109/ISIT.2015.7282741">Wahls and Poor (Proc.
+ * IEEE ISIT 2015)</a> and <a href="https://doi.org/10.1190/1.1441417">McClary
+ * (Geophysics 48(10), 1983)</a>. See \link fnft__nse_finvscatter \endlink
+ * and \link fnft__kdv_finvscatter \endlink for applications.
+ *
+ * @param[in] deg Degree of the polynomials in the transfer matrix. Has to be
+ *  a positive power of two.
+ * @param[in] transfer_matrix A transfer matrix in the same format as used by
+ *  \link fnft__nse_fscatter \endlink, i.e., the four polynomials of degree
+ *  deg are stored one after another (row-wise).
+ * @param[out] q Array with deg entries in which the samples are stored.
+ * @param[in] base_case See \link fnft__akns_finvscatter_base_case_t \endlink.
+ * @param[in] mult2x2 See \link fnft__akns_finvscatter_mult2x2_t \endlink.
+ * @param[in] params Passed to base_case.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup akns
+ */
+FNFT_INT fnft__akns_finvscatter(
+    const FNFT_UINT deg,
+    FNFT_COMPLEX const * const transfer_matrix,
+    FNFT_COMPLEX * const q,
+    fnft__akns_finvscatter_base_case_t base_case,
+    fnft__akns_finvscatter_mult2x2_t mult2x2,
+    void const * const params);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define akns_finvscatter(...) fnft__akns_finvscatter(__VA_ARGS__)
+#define akns_finvscatter_base_case_t fnft__akns_finvscatter_base_case_t
+#define akns_finvscatter_mult2x2_t fnft__akns_finvscatter_mult2x2_t
+#endif
+
+#endif
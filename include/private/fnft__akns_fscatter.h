@@ -89,9 +89,55 @@ FNFT_UINT fnft__akns_fscatter_numel(FNFT_UINT D,
 FNFT_INT fnft__akns_fscatter(const FNFT_UINT D, FNFT_COMPLEX const * const q, FNFT_COMPLEX const * const r, const FNFT_REAL eps_t, FNFT_COMPLEX * const result, FNFT_UINT * const deg_ptr,
                             FNFT_INT * const W_ptr, fnft__akns_discretization_t discretization);
 
+/**
+ * @brief Fast computation of polynomial approximation of the combined scattering
+ * matrix for real q and r.
+ *
+ * Same as \link fnft__akns_fscatter \endlink, but q and r are assumed to be
+ * real (e.g., for the KdV equation) and their imaginary parts are ignored.
+ * The matrix exponentials of the individual steps are computed in real
+ * arithmetic, and the scattering matrices are multiplied with
+ * \link fnft__poly_fmult2x2_real \endlink. The parameters are the same as for
+ * \link fnft__akns_fscatter \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup akns
+ */
+FNFT_INT fnft__akns_fscatter_real(const FNFT_UINT D, FNFT_COMPLEX const * const q, FNFT_COMPLEX const * const r, const FNFT_REAL eps_t, FNFT_COMPLEX * const result, FNFT_UINT * const deg_ptr,
+                            FNFT_INT * const W_ptr, fnft__akns_discretization_t discretization);
+
+/**
+ * @brief Fast computation of polynomial approximation of the combined scattering
+ * matrix for \f$ r=-\kappa q^* \f$.
+ *
+ * Same as \link fnft__akns_fscatter \endlink for the special case
+ * \f$ r(t_n)=-\kappa q^*(t_n) \f$ that arises for the nonlinear
+ * Schroedinger equation. The samples of r are computed on the fly, so that
+ * neither memory for them has to be allocated nor do they have to be read
+ * from memory.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, see \link fnft__akns_fscatter \endlink.
+ * @param[in] kappa =+1 or =-1.
+ * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
+ * @param[out] result See \link fnft__akns_fscatter \endlink.
+ * @param[out] deg_ptr See \link fnft__akns_fscatter \endlink.
+ * @param[in] W_ptr See \link fnft__akns_fscatter \endlink.
+ * @param[in] discretization See \link fnft__akns_fscatter \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup akns
+ */
+FNFT_INT fnft__akns_fscatter_nse(const FNFT_UINT D, FNFT_COMPLEX const * const q, const FNFT_INT kappa, const FNFT_REAL eps_t, FNFT_COMPLEX * const result, FNFT_UINT * const deg_ptr,
+                            FNFT_INT * const W_ptr, fnft__akns_discretization_t discretization);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define akns_fscatter_numel(...) fnft__akns_fscatter_numel(__VA_ARGS__)
 #define akns_fscatter(...) fnft__akns_fscatter(__VA_ARGS__)
+#define akns_fscatter_real(...) fnft__akns_fscatter_real(__VA_ARGS__)
+#define akns_fscatter_nse(...) fnft__akns_fscatter_nse(__VA_ARGS__)
 #endif
 
 #endif
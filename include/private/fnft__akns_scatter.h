@@ -75,8 +75,38 @@ FNFT_INT fnft__akns_scatter_matrix(const FNFT_UINT D, FNFT_COMPLEX const * const
     FNFT_COMPLEX * const result, fnft__akns_discretization_t discretization,
     const FNFT_UINT derivative_flag);
 
+/**
+ * @brief Computes the scattering matrix and its derivative for
+ * \f$ r=-\kappa q^* \f$.
+ *
+ * Same as \link fnft__akns_scatter_matrix \endlink for the special case
+ * \f$ r_n=-\kappa q_n^* \f$ that arises for the nonlinear Schroedinger
+ * equation. The samples of r are computed on the fly instead of being read
+ * from memory.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, see \link fnft__akns_scatter_matrix
+ *  \endlink.
+ * @param[in] kappa =+1 or =-1.
+ * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
+ * @param[in] K Number of values of \f$\lambda\f$.
+ * @param[in] lambda Array of length K, contains the values of \f$\lambda\f$.
+ * @param[out] result See \link fnft__akns_scatter_matrix \endlink.
+ * @param[in] discretization See \link fnft__akns_scatter_matrix \endlink.
+ * @param[in] derivative_flag See \link fnft__akns_scatter_matrix \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup akns
+ */
+FNFT_INT fnft__akns_scatter_matrix_nse(const FNFT_UINT D,
+    FNFT_COMPLEX const * const q, const FNFT_INT kappa, const FNFT_REAL eps_t,
+    const FNFT_UINT K, FNFT_COMPLEX const * const lambda,
+    FNFT_COMPLEX * const result, fnft__akns_discretization_t discretization,
+    const FNFT_UINT derivative_flag);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define akns_scatter_matrix(...) fnft__akns_scatter_matrix(__VA_ARGS__)
+#define akns_scatter_matrix_nse(...) fnft__akns_scatter_matrix_nse(__VA_ARGS__)
 #endif
 
 #endif
@@ -0,0 +1,164 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+/**
+ * @file fnft__allocator.h
+ * @brief Memory allocation routines used inside FNFT.
+ *
+ * @ingroup private_allocator
+ *
+ * All memory that FNFT allocates internally has to be obtained using the
+ * routines in this file instead of malloc, calloc and free, so that it is
+ * served by the allocator set with \link fnft_set_allocator \endlink.
+ * Numerical arrays (scratch buffers as well as results) are allocated with
+ * \link fnft__aligned_malloc \endlink or \link fnft__aligned_calloc
+ * \endlink, which guarantee alignment and padding suitable for vector loads
+ * and stores. The function bodies are declared as static inline and directly
+ * included in the header file for speed.
+ */
+
+#ifndef FNFT__ALLOCATOR_H
+#define FNFT__ALLOCATOR_H
+
+#include <string.h>
+#include "fnft_allocator.h"
+
+/**
+ * @brief Alignment in bytes of the blocks returned by
+ * \link fnft__aligned_malloc \endlink.
+ * @ingroup private_allocator
+ */
+#define FNFT__ALIGNMENT FNFT_ALIGNMENT
+
+/**
+ * @brief The allocator that is currently in use.
+ * @ingroup private_allocator
+ *
+ * Do not access directly. Use \link fnft_set_allocator \endlink and the
+ * routines in this file instead.
+ */
+extern fnft_allocator_t fnft__allocator;
+
+/**
+ * @brief Replacement for malloc.
+ * @ingroup private_allocator
+ *
+ * @param[in] size Number of bytes to be allocated.
+ * @return Pointer to the allocated block, or NULL if the allocation failed.
+ *  Release with \link fnft__free \endlink.
+ */
+static inline void * fnft__malloc(const FNFT_UINT size)
+{
+    return fnft__allocator.malloc_ptr(size > 0 ? size : 1,
+                                      fnft__allocator.user_data);
+}
+
+/**
+ * @brief Replacement for calloc.
+ * @ingroup private_allocator
+ *
+ * @param[in] nmemb Number of elements.
+ * @param[in] size Size of each element in bytes.
+ * @return Pointer to the allocated block, whose bytes are all zero, or NULL if
+ *  the allocation failed. Release with \link fnft__free \endlink.
+ */
+static inline void * fnft__calloc(const FNFT_UINT nmemb, const FNFT_UINT size)
+{
+    if (size > 0 && nmemb > (FNFT_UINT)-1 / size)
+        return NULL;
+    void * const ptr = fnft__malloc(nmemb*size);
+    if (ptr != NULL)
+        memset(ptr, 0, nmemb*size);
+    return ptr;
+}
+
+/**
+ * @brief Replacement for free.
+ * @ingroup private_allocator
+ *
+ * @param[in] ptr Pointer to a block allocated with \link fnft__malloc \endlink
+ *  or \link fnft__calloc \endlink, or NULL.
+ */
+static inline void fnft__free(void * const ptr)
+{
+    if (ptr != NULL)
+        fnft__allocator.free_ptr(ptr, fnft__allocator.user_data);
+}
+
+/**
+ * @brief Allocates a block that is aligned to \link FNFT__ALIGNMENT \endlink
+ * bytes.
+ * @ingroup private_allocator
+ *
+ * The size of the block is rounded up to the next multiple of
+ * \link FNFT__ALIGNMENT \endlink. Vectorized loops can therefore process
+ * the last elements of an array with full-width vector loads and stores
+ * without accessing memory outside of the block.
+ *
+ * @param[in] size Number of bytes to be allocated.
+ * @return Pointer to the allocated block, or NULL if the allocation failed.
+ *  Release with \link fnft__aligned_free \endlink.
+ */
+static inline void * fnft__aligned_malloc(const FNFT_UINT size)
+{
+    if (size > (FNFT_UINT)-1 - FNFT__ALIGNMENT)
+        return NULL;
+    const FNFT_UINT padded_size = size > 0 ?
+        (size + FNFT__ALIGNMENT - 1)/FNFT__ALIGNMENT*FNFT__ALIGNMENT :
+        FNFT__ALIGNMENT;
+    return fnft__allocator.aligned_malloc_ptr(FNFT__ALIGNMENT, padded_size,
+                                              fnft__allocator.user_data);
+}
+
+/**
+ * @brief Aligned replacement for calloc.
+ * @ingroup private_allocator
+ *
+ * @param[in] nmemb Number of elements.
+ * @param[in] size Size of each element in bytes.
+ * @return Pointer to a block allocated with \link fnft__aligned_malloc
+ *  \endlink whose first nmemb*size bytes are zero, or NULL if the allocation
+ *  failed. Release with \link fnft__aligned_free \endlink.
+ */
+static inline void * fnft__aligned_calloc(const FNFT_UINT nmemb,
+    const FNFT_UINT size)
+{
+    if (size > 0 && nmemb > (FNFT_UINT)-1 / size)
+        return NULL;
+    void * const ptr = fnft__aligned_malloc(nmemb*size);
+    if (ptr != NULL)
+        memset(ptr, 0, nmemb*size);
+    return ptr;
+}
+
+/**
+ * @brief Releases a block allocated with \link fnft__aligned_malloc \endlink.
+ * @ingroup private_allocator
+ *
+ * @param[in] ptr Pointer to a block allocated with
+ *  \link fnft__aligned_malloc \endlink or \link fnft__aligned_calloc
+ *  \endlink, or NULL.
+ */
+static inline void fnft__aligned_free(void * const ptr)
+{
+    if (ptr != NULL)
+        fnft__allocator.aligned_free_ptr(ptr, fnft__allocator.user_data);
+}
+
+#endif
@@ -25,11 +25,17 @@
  *
  * Wraps a FFT library (currently either KISS FFT or, if HAVE_FFTW3 is set by
  * cmake, FFTW3). The function bodies are all declared as static inline and
- * directly included in the header file for speed.
+ * directly included in the header file for speed.\n
+ * \n
+ * The routines can be called concurrently from several threads. (The
+ * planner of FFTW is not thread-safe and is therefore run in a critical
+ * section.)
  */
 
 #include "fnft__fft_wrapper_plan_t.h"
 #include "fnft__errwarn.h"
+#include "fnft__allocator.h"
+#include "fnft__parallel.h"
 
 /**
  * @brief Next valid number of samples for the FFT routines.
@@ -95,6 +101,7 @@ static inline FNFT_INT fnft__fft_wrapper_create_plan(
         return FNFT__E_INVALID_ARGUMENT(is_inverse);
 
 #ifdef HAVE_FFTW3
+    FNFT__OMP(critical(fnft__fftw_planner))
     *plan_ptr = fftw_plan_dft_1d(fft_length, in, out, is_inverse, FFTW_ESTIMATE);
 #else
     (void)in;
@@ -154,6 +161,7 @@ static inline FNFT_INT fnft__fft_wrapper_destroy_plan(
     if (plan_ptr == NULL)
         return FNFT__E_INVALID_ARGUMENT(plan_ptr);
 #ifdef HAVE_FFTW3    
+    FNFT__OMP(critical(fnft__fftw_planner))
     fftw_destroy_plan(*plan_ptr);
 #else
     KISS_FFT_FREE(*plan_ptr);
@@ -167,17 +175,14 @@ static inline FNFT_INT fnft__fft_wrapper_destroy_plan(
  * @ingroup fft_wrapper
  *
  * Use this routine to allocate memory for the input and output buffers. It
- * ensures proper alignment.
+ * ensures proper alignment. The memory is obtained from the allocator set
+ * with \link fnft_set_allocator \endlink.
  * @param[in] size Number of points to be allocated.
  * @return A pointer to the allocated buffer, or NULL if that failed.
  */
 static inline void * fnft__fft_wrapper_malloc(FNFT_UINT size)
 {
-#ifdef HAVE_FFTW3
-    return fftw_malloc(size);
-#else
-    return KISS_FFT_MALLOC(size);
-#endif
+    return fnft__aligned_malloc(size);
 }
 
 /**
@@ -191,11 +196,7 @@ static inline void * fnft__fft_wrapper_malloc(FNFT_UINT size)
  */
 static inline void fnft__fft_wrapper_free(void * ptr)
 {
-#ifdef HAVE_FFTW3
-    fftw_free(ptr);
-#else
-    KISS_FFT_FREE(ptr);
-#endif
+    fnft__aligned_free(ptr);
 }
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
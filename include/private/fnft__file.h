@@ -0,0 +1,69 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+/**
+ * @file fnft__file.h
+ * @brief Access to the contents of files.
+ *
+ * @ingroup file
+ *
+ * If cmake has set HAVE_MMAP, files are mapped into memory, so that their
+ * contents are only read from disk when they are accessed. Otherwise, the
+ * file is read into a block allocated with \link fnft__aligned_malloc
+ * \endlink. In both cases, the contents start at an address that is a
+ * multiple of \link FNFT__ALIGNMENT \endlink, and they can be modified
+ * without changing the file.
+ */
+
+#ifndef FNFT__FILE_H
+#define FNFT__FILE_H
+
+#include "fnft_numtypes.h"
+
+/**
+ * @brief Provides access to the contents of a file.
+ * @ingroup file
+ *
+ * @param[in] filename Name of the file.
+ * @param[out] data_ptr Upon return, *data_ptr points to the contents of the
+ *  file. Modifications are not written back to the file.
+ * @param[out] size_ptr Upon return, *size_ptr contains the size of the file
+ *  in bytes.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink. Empty files are rejected.
+ */
+FNFT_INT fnft__file_map(char const * const filename, void ** const data_ptr,
+    FNFT_UINT * const size_ptr);
+
+/**
+ * @brief Releases the contents of a file obtained with \link fnft__file_map
+ * \endlink.
+ * @ingroup file
+ *
+ * @param[in] data Pointer returned by \link fnft__file_map \endlink, or NULL.
+ * @param[in] size Size returned by \link fnft__file_map \endlink.
+ */
+void fnft__file_unmap(void * const data, const FNFT_UINT size);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define file_map(...) fnft__file_map(__VA_ARGS__)
+#define file_unmap(...) fnft__file_unmap(__VA_ARGS__)
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+/**
+ * \file fnft__kdv_finvscatter.h
+ * @brief Recovers the signal from a scattering matrix (KdV equation).
+ * @ingroup kdv
+ */
+
+#ifndef FNFT__KDV_FINVSCATTER_H
+#define FNFT__KDV_FINVSCATTER_H
+
+#include "fnft__kdv_discretization.h"
+
+/**
+ * @brief Recovers the samples that correspond to a transfer matrix fast.
+ *
+ * Recovers real samples u[0], u[1], ..., u[D-1] that, when applied to \link
+ * fnft__kdv_fscatter \endlink, reconstruct the transfer matrix provided by
+ * the user. This is the counterpart of \link fnft__nse_finvscatter \endlink
+ * for the AKNS system with r=-1 that is used for the KdV equation. Since the
+ * information about the last sample is contained in the leading coefficients
+ * of the second column of a transfer matrix of the KdV equation, the
+ * polynomials in the second column are reversed and swapped. The result
+ * has the same structure as a transfer matrix of the NSE, with q=-1 and r=u,
+ * and is inverted with the same divide-and-conquer algorithm, see \link
+ * fnft__akns_finvscatter \endlink.
+ *
+ * Only the second column of the transfer matrix is used. The polynomials in
+ * this column can furthermore be multiplied with any common polynomial
+ * factor whose leading coefficient is nonzero, since only the leading
+ * coefficients of their quotient matter. The transfer matrix has to be (at
+ * least close to) realizable and sufficiently nice to keep numerical errors
+ * tolerable, which typically means that the u[n] are "smooth enough" and
+ * such that |eps_t^2*u[n]|<<1 for all n. Only the real parts of the
+ * coefficients are used, since transfer matrices of real signals are real.
+ * The complexity is O(D log^2 D).
+ *
+ * @ingroup kdv
+ * @param deg Degree of the polynomials in the transfer matrix.
+ * @param [in] transfer_matrix A transfer matrix in the same format as used by
+ *   \link fnft__kdv_fscatter \endlink.
+ * @param [out] u Array with D=deg/base_deg entries in which the samples are
+ *   stored, where base_deg is the output of
+ *   \link fnft__kdv_discretization_degree \endlink.
+ * @param[in] eps_t See \link fnft__kdv_fscatter \endlink.
+ * @param[in] discretization See \link fnft__kdv_fscatter \endlink. Currently,
+ *   only the 2SPLIT1B and 2SPLIT2A discretizations are supported.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__kdv_finvscatter(
+    const FNFT_UINT deg,
+    FNFT_COMPLEX const * const transfer_matrix,
+    FNFT_COMPLEX * const u,
+    const FNFT_REAL eps_t,
+    const fnft_kdv_discretization_t discretization);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define kdv_finvscatter(...) fnft__kdv_finvscatter(__VA_ARGS__)
+#endif
+
+#endif
@@ -85,7 +85,9 @@ FNFT_INT fnft__kdv_fscatter_zero_freq_scatter_matrix(FNFT_COMPLEX *M,
  * @param[in] q Array of length D, contains samples \f$ q(t_n)=q(x_0, t_n) \f$,
  *  where \f$ t_n = T[0] + n(T[1]-T[0])/(D-1) \f$ and \f$n=0,1,\dots,D-1\f$, of
  *  the to-be-transformed signal in ascending order
- *  (i.e., \f$ q(t_0), q(t_1), \dots, q(t_{D-1}) \f$)
+ *  (i.e., \f$ q(t_0), q(t_1), \dots, q(t_{D-1}) \f$). The samples are
+ *  assumed to be real; their imaginary parts are ignored (see
+ *  \link fnft__akns_fscatter_real \endlink).
  * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
  * @param[out] result array of length `kdv_fscatter_numel(D,discretization)`,
  * will contain the combined scattering matrix. Result needs to be pre-allocated
@@ -69,8 +69,51 @@ FNFT_INT fnft__kdv_scatter_matrix(const FNFT_UINT D, FNFT_COMPLEX const * const
     FNFT_COMPLEX * const result, fnft_kdv_discretization_t discretization,
     const UINT derivative_flag);
 
+/**
+ * @brief Computes \f$a(\lambda)\f$, \f$a'(\lambda)\f$ and \f$b(\lambda)\f$
+ * at the bound states.
+ *
+ * The function performs slow direct scattering of the left Jost solution
+ * \f$ \phi(t,\lambda) = [2j\lambda;\ 1]e^{-j\lambda t} \f$ and of the right
+ * Jost solution \f$ \psi(t,\lambda) = [0;\ 1]e^{j\lambda t} \f$ through the
+ * signal. For \f$ t \f$ to the right of the signal, \f$ \phi(t,\lambda) =
+ * a(\lambda)[2j\lambda;\ 1]e^{-j\lambda t} + b(\lambda)[0;\ 1]e^{j\lambda t}\f$.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, contains samples \f$ q(t_n)=q(x_0, t_n) \f$,
+ *  where \f$ t_n = T[0] + n(T[1]-T[0])/(D-1) \f$ and \f$n=0,1,\dots,D-1\f$, of
+ *  the to-be-transformed signal in ascending order
+ *  (i.e., \f$ q(t_0), q(t_1), \dots, q(t_{D-1}) \f$)
+ * @param[in] T Array of length 2, contains the position in time of the first and
+ *  of the last sample. It should be T[0]<T[1].
+ * @param[in] K Number of bound-states.
+ * @param[in] bound_states Array of length K, contains the bound-states
+ *  \f$\lambda\f$. Should be non-zero.
+ * @param[out] a_vals Array of length K, contains the values of \f$a(\lambda)\f$.
+ * @param[out] aprime_vals Array of length K, contains the values of
+ * \f$ a'(\lambda) = \frac{\partial a(\lambda)}{\partial \lambda}\f$.
+ * @param[out] b Array of length K, contains the values of \f$b(\lambda)\f$.
+ * The \f$b(\lambda)\f$ are calculated using the criterion from
+ * Prins and Wahls, <a href="https://doi.org/10.1109/ACCESS.2019.2932256">&quot;
+ * Soliton Phase Shift Calculation for the Korteweg–De Vries Equation,&quot;</a>.
+ * @param[in] discretization The type of discretization to be used. Currently,
+ *  only fnft_kdv_discretization_BO is supported.
+ * @param[in] skip_b_flag If set to 1 the routine will not compute \f$b(\lambda)\f$.
+ *  In that case, b can be NULL.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup kdv
+ */
+FNFT_INT fnft__kdv_scatter_bound_states(const FNFT_UINT D,
+    FNFT_COMPLEX const * const q, FNFT_REAL const * const T,
+    const FNFT_UINT K, FNFT_COMPLEX const * const bound_states,
+    FNFT_COMPLEX * const a_vals, FNFT_COMPLEX * const aprime_vals,
+    FNFT_COMPLEX * const b, fnft_kdv_discretization_t discretization,
+    const FNFT_UINT skip_b_flag);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define kdv_scatter_matrix(...) fnft__kdv_scatter_matrix(__VA_ARGS__)
+#define kdv_scatter_bound_states(...) fnft__kdv_scatter_bound_states(__VA_ARGS__)
 #endif
 
 #endif
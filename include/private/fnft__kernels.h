@@ -0,0 +1,203 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+/**
+ * @file fnft__kernels.h
+ * @brief Array kernels that are compiled for several instruction sets.
+ *
+ * @ingroup kernels
+ *
+ * The routines in this file implement the elementwise loops that dominate the
+ * run time of the fast polynomial arithmetic (pointwise products of spectra,
+ * rescaling, chirps). If cmake has set HAVE_ATTRIBUTE_TARGET_CLONES, they are
+ * compiled several times for different instruction set extensions (see
+ * \link FNFT__TARGET_CLONES \endlink) and the best variant for the CPU at hand
+ * is selected once when the library is loaded. A library that has been built
+ * without -march=native thus still uses AVX2 or AVX-512 when available.
+ */
+
+#ifndef FNFT__KERNELS_H
+#define FNFT__KERNELS_H
+
+#include "fnft.h"
+
+/**
+ * @brief Attribute that compiles a function for several instruction sets.
+ * @ingroup kernels
+ *
+ * Functions whose definition is prefixed with this macro are compiled once
+ * per listed instruction set extension. The dynamic loader then resolves the
+ * symbol to the best variant supported by the CPU (GNU indirect functions).
+ * Expands to nothing if the compiler or platform does not support this.
+ */
+#ifdef HAVE_ATTRIBUTE_TARGET_CLONES
+#define FNFT__TARGET_CLONES \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define FNFT__TARGET_CLONES
+#endif
+
+/**
+ * @brief Pointwise product of two complex arrays.
+ * @ingroup kernels
+ *
+ * Computes c[i] = a[i]*b[i] for i=0,...,n-1. The array c may coincide with a
+ * or b, but must not overlap them otherwise.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] a Array of length n.
+ * @param[in] b Array of length n.
+ * @param[out] c Array of length n.
+ */
+void fnft__kernels_cmul(const FNFT_UINT n, FNFT_COMPLEX const * const a,
+    FNFT_COMPLEX const * const b, FNFT_COMPLEX * const c);
+
+/**
+ * @brief Pointwise product of two complex arrays plus a third one.
+ * @ingroup kernels
+ *
+ * Computes d[i] = a[i]*b[i] + c[i] for i=0,...,n-1. The array d may coincide
+ * with a, b or c, but must not overlap them otherwise.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] a Array of length n.
+ * @param[in] b Array of length n.
+ * @param[in] c Array of length n.
+ * @param[out] d Array of length n.
+ */
+void fnft__kernels_cmul_add(const FNFT_UINT n, FNFT_COMPLEX const * const a,
+    FNFT_COMPLEX const * const b, FNFT_COMPLEX const * const c,
+    FNFT_COMPLEX * const d);
+
+/**
+ * @brief Multiplication of a complex array with a real scalar.
+ * @ingroup kernels
+ *
+ * Computes y[i] = scl*x[i] for i=0,...,n-1. The array y may coincide with x.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] scl Real scaling factor.
+ * @param[in] x Array of length n.
+ * @param[out] y Array of length n.
+ */
+void fnft__kernels_cscale(const FNFT_UINT n, const FNFT_REAL scl,
+    FNFT_COMPLEX const * const x, FNFT_COMPLEX * const y);
+
+/**
+ * @brief Adds a scaled complex array to another one.
+ * @ingroup kernels
+ *
+ * Computes y[i] += scl*x[i] for i=0,...,n-1.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] scl Real scaling factor.
+ * @param[in] x Array of length n.
+ * @param[in,out] y Array of length n.
+ */
+void fnft__kernels_cscale_add(const FNFT_UINT n, const FNFT_REAL scl,
+    FNFT_COMPLEX const * const x, FNFT_COMPLEX * const y);
+
+/**
+ * @brief Largest real or imaginary part in magnitude.
+ * @ingroup kernels
+ *
+ * Returns the maximum of |Re x[i]| and |Im x[i]| over i=0,...,n-1. This
+ * quantity is within a factor of sqrt(2) of the largest absolute value of
+ * the elements, but in contrast to the latter can be computed without square
+ * roots and without the risk of overflow.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] x Array of length n.
+ * @return Largest real or imaginary part in magnitude (zero if n==0).
+ */
+FNFT_REAL fnft__kernels_max_abs_re_im(const FNFT_UINT n,
+    FNFT_COMPLEX const * const x);
+
+/**
+ * @brief Squared absolute values of a complex array.
+ * @ingroup kernels
+ *
+ * Computes y[i] = |x[i]|^2 for i=0,...,n-1. Comparisons of absolute values
+ * can be carried out with the squared values, which avoids square roots.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] x Complex array of length n.
+ * @param[out] y Real array of length n.
+ */
+void fnft__kernels_abs2(const FNFT_UINT n, FNFT_COMPLEX const * const x,
+    FNFT_REAL * const y);
+
+/**
+ * @brief Splits a complex array into its real and imaginary parts.
+ * @ingroup kernels
+ *
+ * Converts an array of complex numbers (interleaved real and imaginary parts)
+ * into the split ("structure of arrays") layout used by
+ * \link fnft__kernels_soa_cmul2_add \endlink.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] x Complex array of length n.
+ * @param[out] x_re Real array of length n. Is filled with the real parts of x.
+ * @param[out] x_im Real array of length n. Is filled with the imaginary parts
+ *  of x.
+ */
+void fnft__kernels_deinterleave(const FNFT_UINT n,
+    FNFT_COMPLEX const * const x, FNFT_REAL * const x_re,
+    FNFT_REAL * const x_im);
+
+/**
+ * @brief Sum of two pointwise products of complex arrays in split layout.
+ * @ingroup kernels
+ *
+ * Computes y[i] = a[i]*b[i] + c[i]*d[i] for i=0,...,n-1, where the inputs
+ * are given by their real and imaginary parts (see
+ * \link fnft__kernels_deinterleave \endlink) and the output is an ordinary
+ * complex array. In the split layout, the complex multiply-accumulates do not
+ * require any shuffling of vector registers.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] a_re Real parts of a, array of length n.
+ * @param[in] a_im Imaginary parts of a, array of length n.
+ * @param[in] b_re Real parts of b, array of length n.
+ * @param[in] b_im Imaginary parts of b, array of length n.
+ * @param[in] c_re Real parts of c, array of length n.
+ * @param[in] c_im Imaginary parts of c, array of length n.
+ * @param[in] d_re Real parts of d, array of length n.
+ * @param[in] d_im Imaginary parts of d, array of length n.
+ * @param[out] y Complex array of length n.
+ */
+void fnft__kernels_soa_cmul2_add(const FNFT_UINT n,
+    FNFT_REAL const * const a_re, FNFT_REAL const * const a_im,
+    FNFT_REAL const * const b_re, FNFT_REAL const * const b_im,
+    FNFT_REAL const * const c_re, FNFT_REAL const * const c_im,
+    FNFT_REAL const * const d_re, FNFT_REAL const * const d_im,
+    FNFT_COMPLEX * const y);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define kernels_cmul(...) fnft__kernels_cmul(__VA_ARGS__)
+#define kernels_cmul_add(...) fnft__kernels_cmul_add(__VA_ARGS__)
+#define kernels_cscale(...) fnft__kernels_cscale(__VA_ARGS__)
+#define kernels_cscale_add(...) fnft__kernels_cscale_add(__VA_ARGS__)
+#define kernels_max_abs_re_im(...) fnft__kernels_max_abs_re_im(__VA_ARGS__)
+#define kernels_abs2(...) fnft__kernels_abs2(__VA_ARGS__)
+#define kernels_deinterleave(...) fnft__kernels_deinterleave(__VA_ARGS__)
+#define kernels_soa_cmul2_add(...) fnft__kernels_soa_cmul2_add(__VA_ARGS__)
+#endif
+
+#endif
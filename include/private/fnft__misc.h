@@ -164,6 +164,10 @@ FNFT_INT fnft__misc_filter_inv(FNFT_UINT * const N_ptr, FNFT_COMPLEX * const val
  *
  * @ingroup misc
  * This function filters an array by merging elements if distance between the elements is less than tol.
+ * The elements are visited in order. An element is removed if its distance
+ * to one of the preceding elements that are still in the array is less than
+ * tol. Large arrays are processed in O(N*log(N)) operations by sorting the
+ * elements into a grid of cells of width 2*tol, the result is the same.
  * @param[in,out] N_ptr It is the pointer to the number of elements to be filtered. On exit *N_ptr is overwritten with
  * the number of values that have survived fitering. Their values will be
  * moved to the beginning of vals.
@@ -174,6 +178,30 @@ FNFT_INT fnft__misc_filter_inv(FNFT_UINT * const N_ptr, FNFT_COMPLEX * const val
 FNFT_INT fnft__misc_merge(FNFT_UINT *N_ptr, FNFT_COMPLEX * const vals,
     FNFT_REAL tol);
 
+/**
+ * @brief Finds the nearest element of a reference array for each element of
+ * an array.
+ *
+ * @ingroup misc
+ * For each vals[i], loc[i] is set to the index j of the element of vals_ref
+ * with the smallest relative distance |vals[i]-vals_ref[j]|/|vals[i]|,
+ * provided that this distance is less than rel_tol. Ties are resolved in
+ * favor of the lower index. If there is no such element, loc[i] is set to
+ * N_ref. Non-finite elements are never matched. Large arrays are processed in
+ * O((N+N_ref)*log(N_ref)) operations by sorting vals_ref into a grid of cells.
+ * @param[in] N Number of elements in vals.
+ * @param[in] vals Complex valued array with the elements to be matched.
+ * @param[in] N_ref Number of elements in vals_ref.
+ * @param[in] vals_ref Complex valued array with the reference elements.
+ * @param[in] rel_tol Real valued relative tolerance, rel_tol>=0.
+ * @param[out] loc Array of length N in which the indices are stored.
+ * @return Returns SUCCESS or an error code.
+ */
+FNFT_INT fnft__misc_match_nearest(const FNFT_UINT N,
+    FNFT_COMPLEX const * const vals, const FNFT_UINT N_ref,
+    FNFT_COMPLEX const * const vals_ref, const FNFT_REAL rel_tol,
+    FNFT_UINT * const loc);
+
 /**
  * @brief Downsamples an array.
  *
@@ -241,6 +269,53 @@ FNFT_UINT fnft__misc_nextpowerof2(const FNFT_UINT number);
 FNFT_INT fnft__misc_resample(const FNFT_UINT D, const FNFT_REAL eps_t, FNFT_COMPLEX const * const q,
     const FNFT_REAL delta, FNFT_COMPLEX *const q_new);
 
+/**
+ * @brief Computes the spectrum that is required for resampling.
+ *
+ * @ingroup misc
+ * Computes the discrete Fourier transform of q, which is the first step of
+ * \link fnft__misc_resample \endlink. The result can be passed to
+ * \link fnft__misc_resample_multi_shift \endlink any number of times, which
+ * avoids repeating the forward FFT when the same signal is resampled with
+ * several shifts. The bandlimitedness check and warning of
+ * \link fnft__misc_resample \endlink are performed here.
+ * @param[in] D Number of samples in array q.
+ * @param[in] eps_t Step-size of t.
+ * @param[in] q Complex valued array to be resampled.
+ * @param[out] q_spectrum Complex valued array of length D. Should be allocated
+ *  with \link fnft__fft_wrapper_malloc \endlink.
+ * @return Returns SUCCESS or an error code.
+ */
+FNFT_INT fnft__misc_resample_spectrum(const FNFT_UINT D, const FNFT_REAL eps_t,
+    FNFT_COMPLEX const * const q, FNFT_COMPLEX * const q_spectrum);
+
+/**
+ * @brief Resamples an array for several shifts at once.
+ *
+ * @ingroup misc
+ * Computes \f$q(t_{n\cdot nskip}+\delta_j)\f$ for \f$j=0,1,\dots,nshifts-1\f$
+ * and \f$n=0,1,\dots,\lceil D/nskip\rceil-1\f$ by bandlimited interpolation,
+ * starting from the spectrum computed by
+ * \link fnft__misc_resample_spectrum \endlink. The result for nshifts=1,
+ * nskip=1 is the same as that of \link fnft__misc_resample \endlink. If
+ * nskip divides D, the inverse FFTs are of length D/nskip instead of D.
+ * @param[in] D Number of samples of the original signal.
+ * @param[in] eps_t Step-size of t.
+ * @param[in] q_spectrum Array of length D computed with
+ *  \link fnft__misc_resample_spectrum \endlink.
+ * @param[in] nshifts Number of shifts.
+ * @param[in] delta Real valued array of length nshifts with the shifts.
+ * @param[in] nskip Only every nskip-th sample is computed, 1<=nskip<=D.
+ * @param[out] q_new Complex valued array of length
+ *  nshifts*\f$\lceil D/nskip\rceil\f$. The samples for the j-th shift start
+ *  at q_new[j*\f$\lceil D/nskip\rceil\f$].
+ * @return Returns SUCCESS or an error code.
+ */
+FNFT_INT fnft__misc_resample_multi_shift(const FNFT_UINT D,
+    const FNFT_REAL eps_t, FNFT_COMPLEX const * const q_spectrum,
+    const FNFT_UINT nshifts, FNFT_REAL const * const delta,
+    const FNFT_UINT nskip, FNFT_COMPLEX * const q_new);
+
 /**
  * @brief Multiples two square matrices of size N.
  *
@@ -353,10 +428,13 @@ static inline FNFT_REAL fnft__misc_legendre_poly(const FNFT_UINT n, const FNFT_R
 #define misc_filter_inv(...) fnft__misc_filter_inv(__VA_ARGS__)
 #define misc_filter_nonreal(...) fnft__misc_filter_nonreal(__VA_ARGS__)
 #define misc_merge(...) fnft__misc_merge(__VA_ARGS__)
+#define misc_match_nearest(...) fnft__misc_match_nearest(__VA_ARGS__)
 #define misc_downsample(...) fnft__misc_downsample(__VA_ARGS__)
 #define misc_CSINC(...) fnft__misc_CSINC(__VA_ARGS__)
 #define misc_nextpowerof2(...) fnft__misc_nextpowerof2(__VA_ARGS__)
 #define misc_resample(...) fnft__misc_resample(__VA_ARGS__)
+#define misc_resample_spectrum(...) fnft__misc_resample_spectrum(__VA_ARGS__)
+#define misc_resample_multi_shift(...) fnft__misc_resample_multi_shift(__VA_ARGS__)
 #define misc_mat_mult_proto(...) fnft__misc_mat_mult_proto(__VA_ARGS__)
 #define misc_mat_mult_2x2(...) fnft__misc_mat_mult_2x2(__VA_ARGS__)
 #define misc_mat_mult_4x4(...) fnft__misc_mat_mult_4x4(__VA_ARGS__)
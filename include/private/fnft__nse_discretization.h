@@ -251,6 +251,11 @@ FNFT_INT fnft__nse_discretization_phase_factor_b(const FNFT_REAL eps_t, const FN
  *  =-1 for the defocusing one 
  * @param[out] q_preprocessed_ptr Pointer to the starting location of preprocessed signal q_preprocessed.
  * @param[out] r_preprocessed_ptr Pointer to the starting location of preprocessed signal r_preprocessed.
+ *  Only the discretizations with complex weights (CF\f$^{[5]}_3\f$ and
+ *  CF\f$^{[6]}_4\f$) require an explicit r_preprocessed. For all others,
+ *  r_preprocessed equals \f$-\kappa\overline{q_{preprocessed}}\f$ and
+ *  *r_preprocessed_ptr is set to NULL. The scattering routines then compute
+ *  it on the fly.
  * @param[in,out] Dsub_ptr Pointer to number of processed samples. Upon entry, *Dsub_ptr
  *             should contain a desired number of samples. Upon exit, *Dsub_ptr
  *             has been overwritten with the actual number of samples that the
@@ -259,6 +264,16 @@ FNFT_INT fnft__nse_discretization_phase_factor_b(const FNFT_REAL eps_t, const FN
  *             the original index of the first and the last sample used to build
  *             q_preprocessed.
  * @param[in] discretization Discretization of type \link fnft_nse_discretization_t \endlink.
+ * @param[in,out] q_spectrum_ptr Optional (pass NULL if not needed). The
+ *             discretizations that require resampling (CF\f$^{[4]}_2\f$,
+ *             CF\f$^{[4]}_3\f$, CF\f$^{[5]}_3\f$, CF\f$^{[6]}_4\f$, 4SPLIT4A
+ *             and 4SPLIT4B) need the spectrum of q, see
+ *             \link fnft__misc_resample_spectrum \endlink. If *q_spectrum_ptr
+ *             is NULL upon entry, the spectrum is computed and returned in a
+ *             newly allocated array of length D, which has to be freed by the
+ *             caller with \link fnft__aligned_free \endlink. Otherwise, the
+ *             spectrum in *q_spectrum_ptr is reused. This allows to preprocess
+ *             the same q for different Dsub with only one forward FFT.
  * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
  *  defined in \link fnft_errwarn.h \endlink.
  *
@@ -267,7 +282,8 @@ FNFT_INT fnft__nse_discretization_phase_factor_b(const FNFT_REAL eps_t, const FN
 FNFT_INT fnft__nse_discretization_preprocess_signal(const FNFT_UINT D, FNFT_COMPLEX const * const q,
         FNFT_REAL const eps_t, const FNFT_INT kappa,
         FNFT_UINT * const Dsub_ptr, FNFT_COMPLEX **q_preprocessed_ptr, FNFT_COMPLEX **r_preprocessed_ptr,
-        FNFT_UINT * const first_last_index,  fnft_nse_discretization_t discretization);
+        FNFT_UINT * const first_last_index,  fnft_nse_discretization_t discretization,
+        FNFT_COMPLEX ** const q_spectrum_ptr);
 
 
 /**
@@ -44,6 +44,11 @@
  * IEEE ISIT 2015)</a> and <a href="https://doi.org/10.1190/1.1441417">McClary
  * (Geophysics 48(10), 1983)</a>.
  *
+ * If FNFT has been built with OpenMP, the polynomial products for large
+ * degrees are split into concurrent tasks, and the FFTs needed for the next
+ * product are computed while the recursion is running. The results do not
+ * depend on the number of threads.
+ *
  * @ingroup nse
  * @param deg Degree of the polynomials in the transfer matrix.
  * @param [in] transfer_matrix A transfer matrix in the same format as used by
@@ -50,10 +50,11 @@
  * @param[in] q Array of length D, contains samples \f$ q_n\f$ for \f$n=0,1,\dots,D-1\f$
  * in ascending order (i.e., \f$ q_0, q_1, \dots, q_{D-1} \f$). The values
  * should be specifically precalculated based on the chosen discretization.
- * @param[in,out] r Array of length D, contains samples \f$ r_n\f$ for \f$n=0,1,\dots,D-1\f$
+ * @param[in] r Array of length D, contains samples \f$ r_n\f$ for \f$n=0,1,\dots,D-1\f$
  * in ascending order (i.e., \f$ r_0, r_1, \dots, r_{D-1} \f$). The values
  * should be specifically precalculated based on the chosen discretization. Alternatively NULL can be 
- * passed. When NULL is passed the routine allocates memory, assigns it to the pointer and calculates \f$ r_n\f$ from \f$ q_n\f$.
+ * passed. In that case \f$ r_n = -\overline{q_n}\f$ is computed on the fly, which is
+ * correct for all discretizations whose preprocessing does not produce an explicit r.
  * @param[in] T Array of length 2, contains the position in time of the first and
  *  of the last sample. It should be T[0]<T[1].
  * @param[in] K Number of bound-states.
@@ -74,7 +75,7 @@
  * @ingroup nse
  */
 FNFT_INT fnft__nse_scatter_bound_states(const FNFT_UINT D, FNFT_COMPLEX const *const q,
-    FNFT_COMPLEX * r, FNFT_REAL const *const T, FNFT_UINT K,
+    FNFT_COMPLEX const *const r, FNFT_REAL const *const T, FNFT_UINT K,
     FNFT_COMPLEX *bound_states, FNFT_COMPLEX *a_vals,
     FNFT_COMPLEX *aprime_vals, FNFT_COMPLEX *b,
     fnft_nse_discretization_t discretization, FNFT_UINT skip_b_flag);
@@ -91,10 +92,11 @@ FNFT_INT fnft__nse_scatter_bound_states(const FNFT_UINT D, FNFT_COMPLEX const *c
  * @param[in] q Array of length D, contains samples \f$ q_n\f$ for \f$n=0,1,\dots,D-1\f$
  * in ascending order (i.e., \f$ q_0, q_1, \dots, q_{D-1} \f$). The values
  * should be specifically precalculated based on the chosen discretization.
- * @param[in,out] r Array of length D, contains samples \f$ r_n\f$ for \f$n=0,1,\dots,D-1\f$
+ * @param[in] r Array of length D, contains samples \f$ r_n\f$ for \f$n=0,1,\dots,D-1\f$
  * in ascending order (i.e., \f$ r_0, r_1, \dots, r_{D-1} \f$). The values
  * should be specifically precalculated based on the chosen discretization. Alternatively NULL can be 
- * passed. When NULL is passed the routine allocates memory, assigns it to the pointer and calculates \f$ r_n\f$ from \f$ q_n\f$.
+ * passed. In that case \f$ r_n = -\kappa\overline{q_n}\f$ is computed on the fly, which is
+ * correct for all discretizations whose preprocessing does not produce an explicit r.
  * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
  * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
  *  =-1 for the defocusing one.
@@ -116,7 +118,7 @@ FNFT_INT fnft__nse_scatter_bound_states(const FNFT_UINT D, FNFT_COMPLEX const *c
  *  defined in \link fnft_errwarn.h \endlink.
  * @ingroup nse
  */
-FNFT_INT fnft__nse_scatter_matrix(const FNFT_UINT D, FNFT_COMPLEX const * const q, FNFT_COMPLEX * r,
+FNFT_INT fnft__nse_scatter_matrix(const FNFT_UINT D, FNFT_COMPLEX const * const q, FNFT_COMPLEX const * const r,
     const FNFT_REAL eps_t, const FNFT_INT kappa, const FNFT_UINT K, 
     FNFT_COMPLEX const * const lambda,
     FNFT_COMPLEX * const result, fnft_nse_discretization_t discretization,
@@ -0,0 +1,59 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+/**
+ * @file fnft__parallel.h
+ * @brief Macros for running independent computations concurrently.
+ *
+ * @ingroup parallel
+ *
+ * If cmake has set HAVE_OPENMP, FNFT runs some independent parts of a
+ * transform (e.g., the two approximations that are combined by Richardson
+ * extrapolation) concurrently on several threads. The parallel code is
+ * written with the macros in this file, which expand to nothing otherwise, so
+ * that the same code runs sequentially on one thread.\n
+ * \n
+ * Code in a parallel region must not jump out of it. The concurrent parts are
+ * therefore written as functions that return an error code, which is checked
+ * after the region has been left.
+ */
+
+#ifndef FNFT__PARALLEL_H
+#define FNFT__PARALLEL_H
+
+#include "fnft_config.h"
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * @brief Places an OpenMP directive.
+ * @ingroup parallel
+ *
+ * FNFT__OMP(task) expands to _Pragma("omp task") if FNFT has been built with
+ * OpenMP, and to nothing otherwise.
+ */
+#ifdef HAVE_OPENMP
+#define FNFT__OMP(directive) FNFT__PRAGMA(omp directive)
+#define FNFT__PRAGMA(x) _Pragma(#x)
+#else
+#define FNFT__OMP(directive)
+#endif
+
+#endif
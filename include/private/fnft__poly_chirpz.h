@@ -27,6 +27,7 @@
 #define FNFT__POLY_CHIRPZ_H
 
 #include "fnft.h"
+#include "fnft__fft_wrapper_plan_t.h"
 
 /**
  * @brief Fast evaluation of a polynomial on a spiral in the complex plane.
@@ -62,8 +63,133 @@ FNFT_INT fnft__poly_chirpz(const FNFT_UINT deg, FNFT_COMPLEX const * const p, \
     const FNFT_COMPLEX A, const FNFT_COMPLEX W, const FNFT_UINT M, \
     FNFT_COMPLEX * const result);
 
+/**
+ * @brief Fast evaluation of a polynomial on several spirals with the same
+ * angular spacing.
+ *
+ * @ingroup poly
+ * Evaluates the polynomial \f$ p(z) \f$ at the points \f$ z=1/w_{j,m} \f$,
+ *
+ *  \f[ w_{j,m}=A_jW^{-m}, \quad j=0,1,\dots,nrings-1, \quad
+ *  m=0,1,\dots,M-1. \f]
+ *
+ * The result is the same as that of nrings calls of
+ * \link fnft__poly_chirpz \endlink, but the FFT of the chirp kernel, which
+ * only depends on \a W, is computed only once. The spirals are processed
+ * concurrently if FNFT has been built with OpenMP. The main application is
+ * the evaluation on three concentric rings in
+ * \link fnft__poly_roots_fftgridsearch \endlink.
+ *
+ * @param[in] deg Degree of the polynomial
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e., \f$ p_{deg}, p_{deg-1}, \dots, p_1, p_0 \f$).
+ * @param[in] nrings Number of spirals. Should be positive.
+ * @param[in] A Array of length nrings. The constants \f$ A_j \f$ defining
+ *  the spirals at which the polynomial will be evaluated.
+ * @param[in] W Second constant defining the spirals at which the polynomial
+ *  will be evaluated
+ * @param[in] M Number of points per spiral.
+ * @param[out] result Array of nrings*M points. The j-th block of M points
+ *  will be filled with \f$ p(1/w_{j,0}),...,p(1/w_{j,M-1}) \f$.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_chirpz_rings(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, const FNFT_UINT nrings,
+    FNFT_COMPLEX const * const A, const FNFT_COMPLEX W, const FNFT_UINT M,
+    FNFT_COMPLEX * const result);
+
+/**
+ * @brief Precomputed data for repeated evaluations with
+ * \link fnft__poly_chirpz_execute_plan \endlink.
+ *
+ * @ingroup poly
+ * Create with \link fnft__poly_chirpz_create_plan \endlink and release with
+ * \link fnft__poly_chirpz_destroy_plan \endlink. The fields should not be
+ * accessed directly.
+ */
+typedef struct {
+    FNFT_UINT deg;
+    FNFT_UINT nrings;
+    FNFT_UINT M;
+    FNFT_UINT L;
+    FNFT_UINT L_stride;
+    FNFT_COMPLEX * V;
+    FNFT_COMPLEX * chirp;
+    FNFT_COMPLEX * Y;
+    FNFT_COMPLEX * buf;
+    fnft__fft_wrapper_plan_t plan_fwd;
+    fnft__fft_wrapper_plan_t plan_inv;
+} fnft__poly_chirpz_plan_t;
+
+/**
+ * @brief Prepares the evaluation of polynomials on several spirals.
+ *
+ * @ingroup poly
+ * Computes everything in \link fnft__poly_chirpz_rings \endlink that does
+ * not depend on the polynomial or on the starting points of the spirals
+ * (the chirp, the FFT of the chirp kernel and the FFT plans), and allocates
+ * the work space. The plan can then be executed several times with
+ * \link fnft__poly_chirpz_execute_plan \endlink, e.g., for consecutive
+ * angular segments of a grid. It requires O(nrings*(deg+M)) memory.
+ *
+ * @param[in] deg Degree of the polynomials
+ * @param[in] nrings Number of spirals per execution. Should be positive.
+ * @param[in] W Constant defining the angular spacing of the spirals.
+ * @param[in] M Number of points per spiral.
+ * @param[out] plan Pointer to a \link fnft__poly_chirpz_plan_t \endlink
+ *  object that is initialized by the routine.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_chirpz_create_plan(const FNFT_UINT deg,
+    const FNFT_UINT nrings, const FNFT_COMPLEX W, const FNFT_UINT M,
+    fnft__poly_chirpz_plan_t * const plan);
+
+/**
+ * @brief Evaluates a polynomial on several spirals using a plan.
+ *
+ * @ingroup poly
+ * Has the same effect as \link fnft__poly_chirpz_rings \endlink with the
+ * values of deg, nrings, W and M that have been used to create the plan. The
+ * spirals are processed concurrently if FNFT has been built with OpenMP. A
+ * plan must not be executed by several threads at the same time.
+ *
+ * @param[in,out] plan Plan created with
+ *  \link fnft__poly_chirpz_create_plan \endlink. Its work space is
+ *  overwritten.
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order.
+ * @param[in] A Array of length nrings. The constants \f$ A_j \f$ defining
+ *  the spirals at which the polynomial will be evaluated.
+ * @param[out] result Array of nrings*M points, see
+ *  \link fnft__poly_chirpz_rings \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_chirpz_execute_plan(fnft__poly_chirpz_plan_t * const plan,
+    FNFT_COMPLEX const * const p, FNFT_COMPLEX const * const A,
+    FNFT_COMPLEX * const result);
+
+/**
+ * @brief Releases a plan created with
+ * \link fnft__poly_chirpz_create_plan \endlink.
+ *
+ * @ingroup poly
+ * Can be called several times. (If the creation of a plan fails, the plan
+ * is released automatically.)
+ *
+ * @param[in,out] plan Pointer to the plan.
+ */
+void fnft__poly_chirpz_destroy_plan(fnft__poly_chirpz_plan_t * const plan);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define poly_chirpz(...) fnft__poly_chirpz(__VA_ARGS__)
+#define poly_chirpz_rings(...) fnft__poly_chirpz_rings(__VA_ARGS__)
+#define poly_chirpz_plan_t fnft__poly_chirpz_plan_t
+#define poly_chirpz_create_plan(...) fnft__poly_chirpz_create_plan(__VA_ARGS__)
+#define poly_chirpz_execute_plan(...) fnft__poly_chirpz_execute_plan(__VA_ARGS__)
+#define poly_chirpz_destroy_plan(...) fnft__poly_chirpz_destroy_plan(__VA_ARGS__)
 #endif
 
 #endif
@@ -91,11 +91,32 @@ FNFT_INT fnft__poly_fmult_two_polys(
     FNFT_COMPLEX * const buf2,
     const FNFT_UINT mode);
 
+/**
+ * @brief Length of the buffer soa_buf used by
+ * \link fnft__poly_fmult_two_polys2x2 \endlink and
+ * \link fnft__poly_fmult_two_polys2x2_real \endlink.
+ *
+ * The buffer holds the FFTs of all eight polynomials in the two factors with
+ * split real and imaginary parts, i.e., 16*len real numbers, where len is the
+ * FFT length returned by \link fnft__poly_fmult_two_polys_len \endlink.
+ * This is the memory of eight complex arrays of length len in addition to
+ * buf0 and buf1. \link fnft__poly_fmult2x2 \endlink allocates it once for
+ * the largest product.
+ *
+ * @param deg The degree of the polynomials to be multiplied.
+ * @return The number of real elements that soa_buf has to provide.
+ * @ingroup poly
+ */
+FNFT_UINT fnft__poly_fmult_two_polys2x2_soa_buf_numel(const FNFT_UINT deg);
+
 /**
  * @brief Multiplies two 2x2 matrices of polynomials.
  *
  * @ingroup poly
- * Fast multiplication of two 2x2 matrices of polynomials using the FFT.
+ * Fast multiplication of two 2x2 matrices of polynomials using the FFT. The
+ * eight FFTs of the input polynomials are kept with split real and imaginary
+ * parts in soa_buf. The four entries of the product are formed in the
+ * frequency domain, so that only four inverse FFTs are required.
  * @param deg Degree of the polynomials.
  * @param [in] p1_11 Array of deg+1 coefficients for the upper left polynomial
  *   p1_11(z) of the first matrix p1(z).
@@ -115,21 +136,21 @@ FNFT_INT fnft__poly_fmult_two_polys(
  * @param [in] result_stride The 2*deg+1 coefficients of the other polynomials
  *   result_12(z), result_21(z) and result_22(z) in the resulting matrix are
  *   will be stored at result_11+result_stride, result_11+2*result_stride and
- *   result+3*result_stride, respectively.
+ *   result+3*result_stride, respectively. The result must not overlap with
+ *   the inputs.
  * @param plan_fwd Plan generated by \link fnft__fft_wrapper_create_plan
  *   \endlink for a forward FFT of the length returned by
- *   \link fnft__poly_fmult_two_polys_len \endlink.
+ *   \link fnft__poly_fmult_two_polys_len \endlink, from buf0 to buf1.
  * @param plan_inv Plan generated by \link fnft__fft_wrapper_create_plan
  *   \endlink for an inverse FFT of the length returned by
- *   \link fnft__poly_fmult_two_polys_len \endlink.
+ *   \link fnft__poly_fmult_two_polys_len \endlink, from buf0 to buf1.
  * @param [in,out] buf0 Buffer of the same length as the FFTs. Must be allocated
  *   allocated and free by the user using \link fnft__fft_wrapper_malloc
  *   \endlink and \link fnft__fft_wrapper_free \endlink, respectively.
  * @param [in,out] buf1 See buf0.
- * @param [in,out] buf2 See buf0.
- * @param [in] mode_offset Set to 2 if the arrays result_11+n*result_stride,
- *   where n=0,1,2,3, are long enough to store the FFT's. This allows improve
- *   performance by storing some intermediate values there. Otherwise, set to 0.
+ * @param [in,out] soa_buf Real buffer with the number of elements returned by
+ *   \link fnft__poly_fmult_two_polys2x2_soa_buf_numel \endlink. Should be
+ *   allocated with \link fnft__fft_wrapper_malloc \endlink.
  * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
  *   defined in \link fnft_errwarn.h \endlink.
  */
@@ -144,8 +165,35 @@ FNFT_INT fnft__poly_fmult_two_polys2x2(const FNFT_UINT deg,
     fnft__fft_wrapper_plan_t plan_inv,
     FNFT_COMPLEX * const buf0,
     FNFT_COMPLEX * const buf1,
-    FNFT_COMPLEX * const buf2,
-    const FNFT_UINT mode_offset);
+    FNFT_REAL * const soa_buf);
+
+/**
+ * @brief Multiplies two 2x2 matrices of polynomials with real coefficients.
+ *
+ * @ingroup poly
+ * Same as \link fnft__poly_fmult_two_polys2x2 \endlink, but for polynomials
+ * whose coefficients are real. The imaginary parts of the inputs are
+ * ignored and the imaginary parts of the result are zero. Since the FFTs of
+ * two real arrays are obtained from one complex FFT, and two real entries
+ * of the product from one complex inverse FFT, only four forward and two
+ * inverse FFTs are required. The two real arrays in each FFT are scaled to
+ * a similar magnitude, so that the accuracy is the same as for
+ * \link fnft__poly_fmult_two_polys2x2 \endlink. The parameters are the same.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *   defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_fmult_two_polys2x2_real(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p1_11,
+    const FNFT_UINT p1_stride,
+    FNFT_COMPLEX const * const p2_11,
+    const FNFT_UINT p2_stride,
+    FNFT_COMPLEX * const result_11,
+    const FNFT_UINT result_stride,
+    fnft__fft_wrapper_plan_t plan_fwd,
+    fnft__fft_wrapper_plan_t plan_inv,
+    FNFT_COMPLEX * const buf0,
+    FNFT_COMPLEX * const buf1,
+    FNFT_REAL * const soa_buf);
 
 /**
  * @brief Number of elements that the input p to
@@ -206,7 +254,13 @@ FNFT_UINT fnft__poly_fmult2x2_numel(const FNFT_UINT deg, const FNFT_UINT n);
  * Fast multiplication of n 2x2 matrix-valued polynomials of degree d. Their
  * coefficients are stored in the array p and will be overwritten. If
  * W_ptr != NULL, the result has been normalized by a factor 2^W. Upon exit,
- * W has been stored in *W_ptr.
+ * W has been stored in *W_ptr. The products are computed with
+ * \link fnft__poly_fmult_two_polys2x2 \endlink (see
+ * \link fnft__poly_fmult2x2_real \endlink for real coefficients).
+ * Besides p and result, the routine allocates a workspace of ten complex
+ * arrays whose length is the FFT length of the last product, i.e., up to
+ * about 20*d*n complex numbers (see
+ * \link fnft__poly_fmult_two_polys2x2_soa_buf_numel \endlink).
  * @param[in] d Pointer to a \link FNFT_UINT \endlink containing the degree of
  * the polynomials.
  * @param[in] n Number of 2x2 matrix-valued polynomials.
@@ -223,15 +277,40 @@ FNFT_UINT fnft__poly_fmult2x2_numel(const FNFT_UINT deg, const FNFT_UINT n);
 FNFT_INT fnft__poly_fmult2x2(FNFT_UINT *d, FNFT_UINT n, FNFT_COMPLEX * const p,
     FNFT_COMPLEX * const result, FNFT_INT * const W_ptr);
 
+/**
+ * @brief Fast multiplication of multiple 2x2 matrix-valued polynomials of the
+ *   same degree with real coefficients.
+ *
+ * @ingroup poly
+ * Same as \link fnft__poly_fmult2x2 \endlink, but the products are computed
+ * with \link fnft__poly_fmult_two_polys2x2_real \endlink, which requires
+ * half the number of FFTs. The imaginary parts of the coefficients in p are
+ * ignored. The caller has to ensure that the coefficients are real (e.g., for
+ * the KdV equation); the coefficients are not checked.
+ * @param[in] d See \link fnft__poly_fmult2x2 \endlink.
+ * @param[in] n See \link fnft__poly_fmult2x2 \endlink.
+ * @param[in,out] p See \link fnft__poly_fmult2x2 \endlink.
+ * @param[out] result See \link fnft__poly_fmult2x2 \endlink.
+ * @param[in] W_ptr See \link fnft__poly_fmult2x2 \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_fmult2x2_real(FNFT_UINT *d, FNFT_UINT n,
+    FNFT_COMPLEX * const p, FNFT_COMPLEX * const result,
+    FNFT_INT * const W_ptr);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define poly_fmult_two_polys_len(...) fnft__poly_fmult_two_polys_len(__VA_ARGS__)
 #define poly_fmult_two_polys_lenmen(...) fnft__poly_fmult_two_polys_lenmen(__VA_ARGS__)
 #define poly_fmult_two_polys(...) fnft__poly_fmult_two_polys(__VA_ARGS__)
+#define poly_fmult_two_polys2x2_soa_buf_numel(...) fnft__poly_fmult_two_polys2x2_soa_buf_numel(__VA_ARGS__)
 #define poly_fmult_two_polys2x2(...) fnft__poly_fmult_two_polys2x2(__VA_ARGS__)
+#define poly_fmult_two_polys2x2_real(...) fnft__poly_fmult_two_polys2x2_real(__VA_ARGS__)
 #define poly_fmult_numel(...) fnft__poly_fmult_numel(__VA_ARGS__)
 #define poly_fmult2x2_numel(...) fnft__poly_fmult2x2_numel(__VA_ARGS__)
 #define poly_fmult(...) fnft__poly_fmult(__VA_ARGS__)
 #define poly_fmult2x2(...) fnft__poly_fmult2x2(__VA_ARGS__)
+#define poly_fmult2x2_real(...) fnft__poly_fmult2x2_real(__VA_ARGS__)
 #endif
 
 #endif
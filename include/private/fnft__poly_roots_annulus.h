@@ -0,0 +1,84 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+/**
+ * @file fnft__poly_roots_annulus.h
+ * @brief Root finding of polynomials restricted to an annulus.
+ * @ingroup poly
+ */
+
+#ifndef FNFT__POLY_ROOTS_ANNULUS_H
+#define FNFT__POLY_ROOTS_ANNULUS_H
+
+#include "fnft.h"
+
+/**
+ * @brief Maximum number of roots that \link fnft__poly_roots_annulus \endlink
+ * computes from contour integrals before it falls back to
+ * \link fnft__poly_roots_fasteigen \endlink.
+ * @ingroup poly
+ */
+#define FNFT__POLY_ROOTS_ANNULUS_MAX_ROOTS 16
+
+/**
+ * @brief Computes the roots of a polynomial inside an annulus.
+ *
+ * @ingroup poly
+ * This routine computes the roots of the polynomial
+ *
+ *   \f[ p(z)=p_0+p_1 z^1+p_2 z^2+...+p_{deg} z^{deg} \f]
+ *
+ * that satisfy \f$ r_{min}<|z|<r_{max} \f$. The number K of these roots is
+ * first determined with \link fnft__poly_roots_count_annulus \endlink. Their
+ * power sums are then obtained from contour integrals of \f$p'(z)/p(z)\f$
+ * along the two boundary circles (Delves and Lyness, Math. Comp. 21(100),
+ * 1967), which are evaluated with FFTs. The roots of the degree K polynomial
+ * with the same power sums are finally refined with Newton's method on
+ * \f$p(z)\f$. The cost is \f$ O(deg \log deg + K~deg)\f$ floating point
+ * operations.\n
+ * \n
+ * If K exceeds \link FNFT__POLY_ROOTS_ANNULUS_MAX_ROOTS \endlink (in which
+ * case the contour integrals are not evaluated at all), if the contour
+ * integrals do not converge because roots are too close to the circles, or
+ * if the refined roots do not pass the sanity checks, the
+ * routine falls back to \link fnft__poly_roots_fasteigen \endlink and
+ * returns all deg roots. The caller therefore has to filter the result.
+ *
+ * @param[in] deg Degree of the polynomial
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e., \f$ p_{deg}, p_{deg-1}, \dots, p_1, p_0 \f$).
+ * @param[in] r_min Inner radius, \f$ 0\leq r_{min}<r_{max} \f$.
+ * @param[in] r_max Outer radius, \f$ r_{max}\leq 1 \f$.
+ * @param[out] K_ptr Pointer to the number of returned roots.
+ * @param[out] roots Array of deg points. The first *K_ptr entries are
+ *  filled with the roots.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_roots_annulus(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, const FNFT_REAL r_min,
+    const FNFT_REAL r_max, FNFT_UINT * const K_ptr,
+    FNFT_COMPLEX * const roots);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define poly_roots_annulus(...) fnft__poly_roots_annulus(__VA_ARGS__)
+#define POLY_ROOTS_ANNULUS_MAX_ROOTS FNFT__POLY_ROOTS_ANNULUS_MAX_ROOTS
+#endif
+
+#endif
@@ -0,0 +1,98 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+/**
+ * @file fnft__poly_roots_count.h
+ * @brief Counting the roots of polynomials inside the unit circle or annuli.
+ * @ingroup poly
+ */
+
+#ifndef FNFT__POLY_ROOTS_COUNT_H
+#define FNFT__POLY_ROOTS_COUNT_H
+
+#include "fnft.h"
+
+/**
+ * @brief Counts the roots of a polynomial inside the unit circle.
+ *
+ * @ingroup poly
+ * This routine counts the roots of the polynomial
+ *
+ *   \f[ p(z)=p_0+p_1 z^1+p_2 z^2+...+p_{deg} z^{deg} \f]
+ *
+ * with \f$|z|<1\f$ using the argument principle, i.e., the winding number of
+ * \f$p(e^{j\theta})\f$ around the origin for \f$0\leq\theta<2\pi\f$ is
+ * determined. The polynomial is evaluated on the unit circle using FFTs,
+ * which requires only \f$ O(deg \log deg)\f$ floating point operations. The
+ * number of evaluation points is increased until the phase changes by less
+ * than \f$\pi/2\f$ between neighbouring points.
+ *
+ * @param[in] deg Degree of the polynomial
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e., \f$ p_{deg}, p_{deg-1}, \dots, p_1, p_0 \f$).
+ * @param[out] count_ptr Pointer to the number of roots inside the unit
+ *  circle. If roots are too close to the unit circle to resolve the winding
+ *  reliably, *count_ptr is set to the trivial upper bound deg.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_roots_count_unit_disk(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, FNFT_UINT * const count_ptr);
+
+/**
+ * @brief Counts the roots of a polynomial inside an annulus or an annular
+ * sector.
+ *
+ * @ingroup poly
+ * This routine counts the roots of the polynomial p(z) (see
+ * \link fnft__poly_roots_count_unit_disk \endlink) with
+ * \f$r_{min}<|z|<r_{max}\f$ and \f$|\arg z|<\phi_{max}\f$. For
+ * \f$\phi_{max}\geq\pi\f$, the winding numbers of \f$p(z)\f$ on the two
+ * circles \f$|z|=r_{min}\f$ and \f$|z|=r_{max}\f$ are determined as in
+ * \link fnft__poly_roots_count_unit_disk \endlink and subtracted. The
+ * complexity is then \f$ O(deg \log deg)\f$. Otherwise, the winding number
+ * on the boundary of the annular sector is determined. The polynomial is
+ * then additionally evaluated at a few points on the two radial segments,
+ * which requires \f$ O(deg) \f$ floating point operations per point.
+ *
+ * @param[in] deg Degree of the polynomial
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e., \f$ p_{deg}, p_{deg-1}, \dots, p_1, p_0 \f$).
+ * @param[in] r_min Inner radius. Should be non-negative. If it is zero, the
+ *  roots inside the disk (or sector) with radius r_max are counted.
+ * @param[in] r_max Outer radius. Should be finite and larger than r_min.
+ * @param[in] phi_max Half of the opening angle of the sector. Should be
+ *  positive. Pass \f$\pi\f$ to count the roots inside the full annulus.
+ * @param[out] count_ptr Pointer to the number of roots inside the annulus or
+ *  sector. If roots are too close to its boundary to resolve the winding
+ *  reliably, *count_ptr is set to the trivial upper bound deg.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_roots_count_annulus(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, const FNFT_REAL r_min,
+    const FNFT_REAL r_max, const FNFT_REAL phi_max,
+    FNFT_UINT * const count_ptr);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define poly_roots_count_unit_disk(...) fnft__poly_roots_count_unit_disk(__VA_ARGS__)
+#define poly_roots_count_annulus(...) fnft__poly_roots_count_annulus(__VA_ARGS__)
+#endif
+
+#endif
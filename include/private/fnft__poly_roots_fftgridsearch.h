@@ -48,7 +48,9 @@
  *
  * \f[ r_k = 1 - k\epsilon, \ \ \ \ k=-1,0,1. \f]
  *
- * The evaluations are carried out using the Chirp transform. The grid points
+ * The evaluations are carried out using the Chirp transform (see
+ * \link fnft__poly_chirpz_rings \endlink, the three rings share the FFT of the
+ * chirp kernel and are evaluated concurrently). The grid points
  * on the unit circle where the absolute value of the polynomial is lower than
  * or equal to the absolute value at the eight neighboring grid points are
  * candidates for a root. (This is the first stage of the Lindsey-Fox
@@ -79,6 +81,49 @@ FNFT_INT fnft__poly_roots_fftgridsearch(const FNFT_UINT deg,
     FNFT_COMPLEX const * const p, FNFT_UINT * const M_ptr,
     FNFT_REAL const * const PHI, FNFT_COMPLEX * const roots);
 
+/**
+ * @brief Unit circle roots of a polynomial via grid search with bounded
+ *  memory.
+ * @ingroup poly
+ *
+ * Computes the same roots as \link fnft__poly_roots_fftgridsearch \endlink
+ * up to rounding errors, but processes the grid in angular segments of block_size test points
+ * instead of evaluating the polynomial on the whole grid at once. Each
+ * segment is evaluated on the three rings with a segmented Chirp transform
+ * that also covers one neighboring grid point on each side, so that the
+ * local minimum test does not depend on the segmentation. All segments share
+ * one plan (see \link fnft__poly_chirpz_create_plan \endlink). The roots
+ * are stored as soon as the segment in which they are detected has been
+ * processed, and the roots array only has to provide space for the roots
+ * that are actually found. The routine thus requires only
+ * O(deg + block_size) memory, whereas
+ * \link fnft__poly_roots_fftgridsearch \endlink requires O(deg + M). (The
+ * values of the polynomial on the grid are computed with Chirp transforms of
+ * different lengths, which is why the roots are not bitwise identical.)
+ *
+ * @param[in] deg The degree of the polynomial.
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e., \f$ p_{deg}, p_{deg-1}, \dots, p_{1}, p_{0} \f$).
+ * @param[in] M Number of points in the grid.
+ * @param[in] PHI Array with two entries, \f$ \Phi_0 \f$ and \f$ \Phi_1 \f$.
+ *  The first value should be lower than the second one.
+ * @param[in] block_size Number of test points per segment. If zero, the block
+ *  size is chosen such that the FFTs are about twice as long as the number of
+ *  coefficients. Larger blocks require more memory, but fewer FFTs.
+ * @param[in,out] K_ptr Upon entry, *K_ptr contains the number of entries in
+ *  the array roots. Upon return, *K_ptr has been overwritten with the number
+ *  of detected roots. If it is larger than the number of entries, only the
+ *  roots that have been detected first are stored.
+ * @param[out] roots Array of *K_ptr points. Will be filled with the detected
+ *  roots.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_roots_fftgridsearch_blocked(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, const FNFT_UINT M,
+    FNFT_REAL const * const PHI, FNFT_UINT block_size,
+    FNFT_UINT * const K_ptr, FNFT_COMPLEX * const roots);
+
 /**
  * @brief Unit circle roots of a parahermitian Laurent polynomial via grid
  *  search.
@@ -128,6 +173,7 @@ FNFT_INT fnft__poly_roots_fftgridsearch_paraherm(const FNFT_UINT deg,
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define poly_roots_fftgridsearch(...) fnft__poly_roots_fftgridsearch(__VA_ARGS__)
+#define poly_roots_fftgridsearch_blocked(...) fnft__poly_roots_fftgridsearch_blocked(__VA_ARGS__)
 #define poly_roots_fftgridsearch_paraherm(...) fnft__poly_roots_fftgridsearch_paraherm(__VA_ARGS__)
 #endif
 
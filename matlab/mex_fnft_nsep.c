@@ -127,6 +127,10 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             opts.points_per_spine = (FNFT_UINT)mxGetScalar(prhs[k+1]);
             k++;
 
+        } else if ( strcmp(str, "spine_tracing") == 0 ) {
+
+            opts.spine_tracing = 1;
+
         } else if ( strcmp(str, "phase_shift") == 0 ) {
 
             if ( k+1 == nrhs || !mxIsDouble(prhs[k+1])
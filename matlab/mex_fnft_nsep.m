@@ -45,6 +45,10 @@
 %                   non-negative integer. The default value is two, which
 %                   results in the usual main spectrum (= endpoints of spines).
 %                   Use higher values to visualize splines.
+%    'spine_tracing' Only compute initial guesses for the first and last
+%                   value of rhs and trace the spines in between by
+%                   continuation. Much faster for large points_per_spine,
+%                   but points can be lost if points_per_spine is small.
 %    'phase_shift'  For quasi-periodic signals the phase changes over one 
 %                   quasi-period. This argument must be followed by a real
 %                   scalar i.e. angle(q(T(2))/q(T(1))). The default value 
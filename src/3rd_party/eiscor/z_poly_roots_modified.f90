@@ -4,6 +4,9 @@
 !   - Residuals are not computed
 !   - The roots are no longer printed (forgotten printf?)
 !   - Always use QR since it is as good as QZ -> https://arxiv.org/pdf/1611.02435.pdf
+!   - The work arrays are provided by the caller instead of being allocated
+!     here, so that FNFT can obtain them from its allocator. The unused arrays
+!     D2, C2, B2 and W have been removed.
 !
 !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 !
@@ -27,6 +30,20 @@
 !                    coefficients of polynomial ordered from highest
 !                    degree coefficient to lowest degree
 !
+! WORK VARIABLES:
+!
+!  P               LOGICAL array of dimension (N-2)
+!
+!  ITS             INTEGER array of dimension (N-1)
+!
+!  Q               REAL(8) array of dimension (3*(N-1))
+!
+!  D1              REAL(8) array of dimension (2*(N+1))
+!
+!  C1, B1          REAL(8) arrays of dimension (3*N)
+!
+!  V               COMPLEX(8) array of dimension (N)
+!
 ! OUTPUT VARIABLES:
 !
 !  ROOTS           COMPLEX(8) array of dimension (N)
@@ -36,7 +53,7 @@
 !                    INFO = 1 implies companion QR algorithm failed
 !
 !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-subroutine z_poly_roots_modified(N,COEFFS,ROOTS,INFO)
+subroutine z_poly_roots_modified(N,COEFFS,ROOTS,P,ITS,Q,D1,C1,B1,V,INFO)
 
   implicit none
 
@@ -46,15 +63,15 @@ subroutine z_poly_roots_modified(N,COEFFS,ROOTS,INFO)
   complex(8), intent(in) :: COEFFS(N+1)
   complex(8), intent(inout) :: ROOTS(N)
 
+  ! work variables
+  logical, intent(inout) :: P(N-2)
+  integer, intent(inout) :: ITS(N-1)
+  real(8), intent(inout) :: Q(3*(N-1)),D1(2*(N+1)),C1(3*N),B1(3*N)
+  complex(8), intent(inout) :: V(N)
+
   ! compute variables
   integer :: ii
-  real(8) :: scl
-  logical, allocatable :: P(:)
-  integer, allocatable :: ITS(:)
-  real(8), allocatable :: Q(:),D1(:),C1(:),B1(:)
-  real(8), allocatable :: D2(:),C2(:),B2(:)
   complex(8) :: sclc
-  complex(8), allocatable :: V(:),W(:)
   interface
     function l_upr1fact_hess(m,flags)
       logical :: l_upr1fact_hess
@@ -84,10 +101,6 @@ subroutine z_poly_roots_modified(N,COEFFS,ROOTS,INFO)
     end function l_upr1fact_random
   end interface
 
-  ! allocate memory
-  allocate(P(N-2),ITS(N-1),Q(3*(N-1)),D1(2*(N+1)),C1(3*N),B1(3*N))
-  allocate(V(N),W(N),D2(2*(N+1)),C2(3*N),B2(3*N))
-
   ! initialize INFO
   INFO = 0
 
@@ -116,7 +129,4 @@ subroutine z_poly_roots_modified(N,COEFFS,ROOTS,INFO)
   ! extract roots
   call z_upr1utri_decompress(.TRUE.,N,D1,C1,B1,ROOTS)
 
-  ! free memory
-  deallocate(P,ITS,Q,D1,C1,B1,D2,C2,B2,V,W)
-
 end subroutine z_poly_roots_modified
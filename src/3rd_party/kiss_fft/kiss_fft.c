@@ -249,7 +249,11 @@ void kf_work(
     const int m=*factors++; /* stage's fft length/p */
     const kiss_fft_cpx * Fout_end = Fout + p*m;
 
-#ifdef _OPENMP
+    // FNFT runs independent computations concurrently itself. Parallelizing
+    // every single FFT would add the overhead of a parallel region to each
+    // of the many short FFTs, so the code below is only used if
+    // KISS_FFT_OPENMP has been defined.
+#if defined(_OPENMP) && defined(KISS_FFT_OPENMP)
     // use openmp extensions at the 
     // top-level (not recursive)
     if (fstride==1 && p<=5)
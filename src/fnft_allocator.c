@@ -0,0 +1,108 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "fnft_allocator.h"
+#include "fnft__allocator.h"
+#include "fnft__errwarn.h"
+
+static void * default_malloc(UINT size, void * user_data)
+{
+    (void)user_data;
+    return malloc(size);
+}
+
+static void default_free(void * ptr, void * user_data)
+{
+    (void)user_data;
+    free(ptr);
+}
+
+// C99 does not provide aligned allocations. We therefore allocate a slightly
+// larger block with malloc and store the pointer to it right in front of the
+// aligned address that is returned.
+static void * default_aligned_malloc(UINT alignment, UINT size,
+    void * user_data)
+{
+    (void)user_data;
+    if (size > (UINT)-1 - alignment - sizeof(void *))
+        return NULL;
+    void * const ptr = malloc(size + alignment + sizeof(void *));
+    if (ptr == NULL)
+        return NULL;
+    const uintptr_t addr = (uintptr_t)ptr + sizeof(void *);
+    void ** const aligned_ptr = (void **)(addr + alignment - 1
+                                          - (addr + alignment - 1)%alignment);
+    aligned_ptr[-1] = ptr;
+    return aligned_ptr;
+}
+
+static void default_aligned_free(void * ptr, void * user_data)
+{
+    (void)user_data;
+    free(((void **)ptr)[-1]);
+}
+
+static const fnft_allocator_t default_allocator = {
+    default_malloc,
+    default_free,
+    default_aligned_malloc,
+    default_aligned_free,
+    NULL
+};
+
+// Shared by all threads so that worker threads started inside FNFT use the
+// same allocator as the thread that called FNFT.
+fnft_allocator_t fnft__allocator = {
+    default_malloc,
+    default_free,
+    default_aligned_malloc,
+    default_aligned_free,
+    NULL
+};
+
+INT fnft_set_allocator(fnft_allocator_t const * const allocator)
+{
+    if (allocator == NULL) {
+        fnft__allocator = default_allocator;
+        return SUCCESS;
+    }
+    if (allocator->malloc_ptr == NULL)
+        return E_INVALID_ARGUMENT(allocator->malloc_ptr);
+    if (allocator->free_ptr == NULL)
+        return E_INVALID_ARGUMENT(allocator->free_ptr);
+    if (allocator->aligned_malloc_ptr == NULL)
+        return E_INVALID_ARGUMENT(allocator->aligned_malloc_ptr);
+    if (allocator->aligned_free_ptr == NULL)
+        return E_INVALID_ARGUMENT(allocator->aligned_free_ptr);
+
+    fnft__allocator = *allocator;
+    return SUCCESS;
+}
+
+INT fnft_get_allocator(fnft_allocator_t * const allocator)
+{
+    if (allocator == NULL)
+        return E_INVALID_ARGUMENT(allocator);
+    *allocator = fnft__allocator;
+    return SUCCESS;
+}
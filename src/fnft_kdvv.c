@@ -24,14 +24,21 @@
 #include "fnft__errwarn.h"
 #include "fnft__poly_roots_fasteigen.h"
 #include "fnft__poly_chirpz.h"
+#include "fnft__poly_eval.h"
 #include "fnft__kdv_fscatter.h"
+#include "fnft__kdv_scatter.h"
 #include "fnft__kdv_discretization.h"
 #include "fnft_kdvv.h"
+#include "fnft__allocator.h"
 
 /**
  * Stores additional options for the routine fnft_kdvv.
  */
 kdvv_opts_t default_opts = {
+    .bound_state_localization = kdvv_bsloc_GRIDSEARCH_AND_REFINE,
+    .niter = 10,
+    .discspec_type = kdvv_dstype_NORMING_CONSTANTS,
+    .normalization_flag = 1,
     .discretization = kdv_discretization_2SPLIT8B
 };
 
@@ -44,14 +51,25 @@ kdvv_opts_t fnft_kdvv_default_opts()
 }
 
 /**
- * Declare auxiliary routine used by the main routine fnft_kdvv.
- * Its body follows below.
+ * Declare auxiliary routines used by the main routine fnft_kdvv.
+ * Their bodies follow below.
  */
 static INT tf2contspec_negxi(UINT deg,
-    COMPLEX *transfer_matrix, REAL const * const T,
+    COMPLEX *transfer_matrix, const INT real_flag, REAL const * const T,
     const UINT D, REAL const * const XI, const UINT M,
     COMPLEX * result, fnft_kdvv_opts_t * opts_ptr);
 
+static inline INT kdvv_compute_boundstates(const UINT D,
+    COMPLEX const * const u, const REAL eps_t, const UINT deg,
+    COMPLEX const * const transfer_matrix, UINT * const K_ptr,
+    COMPLEX * const bound_states, fnft_kdvv_opts_t const * const opts_ptr);
+
+static inline INT kdvv_compute_normconsts_or_residues(const UINT D,
+    COMPLEX const * const u, REAL const * const T, const UINT K,
+    COMPLEX const * const bound_states,
+    COMPLEX * const normconsts_or_residues,
+    fnft_kdvv_opts_t const * const opts_ptr);
+
 /**
  * Fast nonlinear Fourier transform for the Korteweg-de Vries equation with
  * vanishing boundary conditions.
@@ -68,10 +86,9 @@ INT fnft_kdvv(const UINT D,
     fnft_kdvv_opts_t * opts_ptr) 
 {
     COMPLEX *transfer_matrix = NULL;
-    UINT deg;
+    UINT deg = 0, i;
     INT ret_code = SUCCESS;
     INT W = 0, *W_ptr = NULL;
-    (void) W; //To prevent complier warnings
 
     // Check inputs
     if (D < 2)
@@ -80,43 +97,74 @@ INT fnft_kdvv(const UINT D,
         return E_INVALID_ARGUMENT(u);
     if (T == NULL || T[0] >= T[1])
         return E_INVALID_ARGUMENT(T);
-    if (contspec == NULL)
-        return E_INVALID_ARGUMENT(contspec);
-    if (XI == NULL || XI[0] >= XI[1])
-        return E_INVALID_ARGUMENT(XI);
-    if (K_ptr != NULL)
-        return E_NOT_YET_IMPLEMENTED(K_ptr, Please pass "NULL".);
-    if (bound_states != NULL)
-        return E_NOT_YET_IMPLEMENTED(bound_states, Please pass "NULL".);
-    if (normconsts_or_residues != NULL)
-        return E_NOT_YET_IMPLEMENTED(normconsts_or_residues, Please pass "NULL".);
+    if (contspec != NULL) {
+        if (XI == NULL || XI[0] >= XI[1])
+            return E_INVALID_ARGUMENT(XI);
+    }
+    if (bound_states != NULL && K_ptr == NULL)
+        return E_INVALID_ARGUMENT(K_ptr);
+    if (normconsts_or_residues != NULL && bound_states == NULL)
+        return E_INVALID_ARGUMENT(bound_states);
 
     if (opts_ptr == NULL)
         opts_ptr = &default_opts;
 
-    // Allocate memory for the transfer matrix
-    transfer_matrix = malloc(kdv_fscatter_numel(D,opts_ptr->discretization)*sizeof(COMPLEX));
-    if (transfer_matrix == NULL) {
-        ret_code = E_NOMEM;
-        goto release_mem;
-    }
-
     // Determine step size
     const REAL eps_t = (T[1] - T[0])/(D - 1);
 
-    // Compute the transfer matrix 
-    ret_code = kdv_fscatter(D, u, eps_t, transfer_matrix, &deg,
-        W_ptr, opts_ptr->discretization);
-    CHECK_RETCODE(ret_code, release_mem);
+    // The coefficients of the transfer matrix are real if u is real
+    for (i = 0; i < D; i++) {
+        if (CIMAG(u[i]) != 0.0)
+            break;
+    }
+    const INT real_flag = (i == D);
+
+    // The transfer matrix is needed for the continuous spectrum and for the
+    // grid search for the bound states
+    if (contspec != NULL || (bound_states != NULL
+        && opts_ptr->bound_state_localization != kdvv_bsloc_NEWTON)) {
 
+        // Allocate memory for the transfer matrix
+        transfer_matrix = fnft__aligned_malloc(kdv_fscatter_numel(D,opts_ptr->discretization)*sizeof(COMPLEX));
+        if (transfer_matrix == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+
+        // Compute the transfer matrix. The transfer matrix has to be
+        // multiplied by 2^W to obtain the actual one if normalization is
+        // enabled. Neither the reflection coefficient nor the signs used
+        // in the grid search for the bound states depend on this positive
+        // factor, so that W is not needed afterwards.
+        if (opts_ptr->normalization_flag)
+            W_ptr = &W;
+        ret_code = kdv_fscatter(D, u, eps_t, transfer_matrix, &deg,
+            W_ptr, opts_ptr->discretization);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
 
     // Compute the continuous spectrum
-    ret_code = tf2contspec_negxi(deg, transfer_matrix, T, D, XI, M,
-                                     contspec, opts_ptr);
-    CHECK_RETCODE(ret_code, release_mem);
+    if (contspec != NULL) {
+        ret_code = tf2contspec_negxi(deg, transfer_matrix, real_flag, T, D,
+                                     XI, M, contspec, opts_ptr);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+    // Compute the discrete spectrum
+    if (bound_states != NULL) {
+        ret_code = kdvv_compute_boundstates(D, u, eps_t, deg,
+            transfer_matrix, K_ptr, bound_states, opts_ptr);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        if (normconsts_or_residues != NULL) {
+            ret_code = kdvv_compute_normconsts_or_residues(D, u, T, *K_ptr,
+                bound_states, normconsts_or_residues, opts_ptr);
+            CHECK_RETCODE(ret_code, release_mem);
+        }
+    }
 
 release_mem:
-    free(transfer_matrix);
+    fnft__aligned_free(transfer_matrix);
 
     return ret_code;
 }
@@ -124,7 +172,8 @@ release_mem:
 // Auxiliary funnction: Computes continuous spectrum on a frequency grid
 // from a given transfer matrix, using the negative frequencies.
 static INT tf2contspec_negxi(UINT deg,
-                                 COMPLEX *transfer_matrix, REAL const * const T,
+                                 COMPLEX *transfer_matrix, const INT real_flag,
+                                 REAL const * const T,
                                  const UINT D, REAL const * const XI, const UINT M,
                                  COMPLEX *result, fnft_kdvv_opts_t * opts_ptr)
 {
@@ -136,7 +185,7 @@ static INT tf2contspec_negxi(UINT deg,
     COMPLEX A, V, sqrt_z;
     REAL boundary_coeff, degree1step;
     REAL xi;
-    UINT i;
+    UINT i, M_eval;
     INT ret_code = SUCCESS;
 
     if (opts_ptr == NULL)
@@ -148,14 +197,22 @@ static INT tf2contspec_negxi(UINT deg,
     if (degree1step == NAN || boundary_coeff == NAN)
         return E_INVALID_ARGUMENT(opts_ptr->discretization);
 
+    // If the transfer matrix has real coefficients, its values at conj(z)
+    // are the conjugates of its values at z. The continuous spectrum then
+    // satisfies contspec(-xi)=conj(contspec(xi)). For grids that are
+    // symmetric around zero, only the first half of the grid is evaluated.
+    M_eval = M;
+    if (real_flag && XI[0] == -XI[1])
+        M_eval = (M + 1)/2;
+
     // Allocate memory
-    H_vals = malloc(4*M * sizeof(COMPLEX));
+    H_vals = fnft__aligned_malloc(4*M_eval * sizeof(COMPLEX));
     if (H_vals == NULL)
         return E_NOMEM;
     H11_vals = H_vals;
-    H12_vals = H11_vals + M;
-    H21_vals = H12_vals + M;
-    H22_vals = H21_vals + M;
+    H12_vals = H11_vals + M_eval;
+    H21_vals = H12_vals + M_eval;
+    H22_vals = H21_vals + M_eval;
     
     // Set step sizes
     const REAL eps_t = (T[1] - T[0])/(D - 1);
@@ -172,21 +229,22 @@ static INT tf2contspec_negxi(UINT deg,
 //    ret_code = poly_chirpz(deg, transfer_matrix, A, V, M, H11_vals);
 //    CHECK_RETCODE(ret_code, release_mem);
 
-    ret_code = poly_chirpz(deg, transfer_matrix + (deg+1), A, V, M, H12_vals);
+    ret_code = poly_chirpz(deg, transfer_matrix + (deg+1), A, V, M_eval,
+                           H12_vals);
     CHECK_RETCODE(ret_code, release_mem);
 
 //    ret_code = poly_chirpz(deg, transfer_matrix + 2*(deg+1), A, V, M,
 //                           H21_vals);
 //    CHECK_RETCODE(ret_code, release_mem);
 
-    ret_code = poly_chirpz(deg, transfer_matrix + 3*(deg+1), A, V, M,
+    ret_code = poly_chirpz(deg, transfer_matrix + 3*(deg+1), A, V, M_eval,
                            H22_vals);
     CHECK_RETCODE(ret_code, release_mem);
 
     if (opts_ptr->discretization==kdv_discretization_2SPLIT2A){
         // Correct H12_vals and H21_vals for trick that implements 2split2A with
         // first order polynomials instead of second order polynomials.
-        for (i=0; i<M; i++) {
+        for (i=0; i<M_eval; i++) {
             xi = -XI[0] - i*eps_xi;
             sqrt_z = CEXP( I*xi*eps_t / degree1step);
             H12_vals[i] /= sqrt_z;
@@ -195,15 +253,450 @@ static INT tf2contspec_negxi(UINT deg,
     }
     
     // Compute the continuous spectrum
-    for (i=0; i<M; i++) {
+    for (i=0; i<M_eval; i++) {
         xi = -XI[0] - i*eps_xi;
         result[i] = CEXP( 2.0*I*xi * (T[1] + boundary_coeff*eps_t) )
             * H12_vals[i];
         result[i] /= 2.0*I*xi * H22_vals[i] - H12_vals[i];
     }
+    for (i=M_eval; i<M; i++)
+        result[i] = CONJ(result[M-1-i]);
     
     // Release memory and return
 release_mem:
-    free(H_vals);
+    fnft__aligned_free(H_vals);
+    return ret_code;
+}
+
+// Auxiliary function: Counts the bound states of the Boffetta-Osborne
+// discretization, which is exact for piecewise constant signals. By the
+// oscillation theorem, the number of bound states equals the number of zeros
+// of the solution of the scattering problem for lambda=0 that is constant
+// to the left of the signal. For lambda=0, the second component of the
+// solution satisfies v2''=-u*v2 and v1=-v2'.
+static UINT kdvv_count_boundstates(const UINT D, COMPLEX const * const u,
+    const REAL eps_t)
+{
+    REAL v1 = 0.0, v2 = 1.0, v1_new, v2_new, w, c, s, th, nrm;
+    UINT n, K = 0;
+
+    for (n = 0; n < D; n++) {
+        const REAL un = CREAL(u[n]);
+        if (un > 0) {
+            // v2(t) = R*cos(w*t + th) has a zero whenever w*t + th hits
+            // pi/2 modulo pi. Zeros at the start of the step have already
+            // been counted in the previous step.
+            w = SQRT(un);
+            th = CARG(v2 + I*v1/w);
+            K += (UINT)(FLOOR((th + w*eps_t - 0.5*PI)/PI)
+                - FLOOR((th - 0.5*PI)/PI));
+            c = COS(w*eps_t);
+            s = SIN(w*eps_t);
+            v2_new = v2*c - v1*s/w;
+            v1_new = v2*w*s + v1*c;
+        } else {
+            // v2 is convex or concave here and has at most one zero
+            if (un < 0) {
+                w = SQRT(-un);
+                c = COSH(w*eps_t);
+                s = SINH(w*eps_t);
+                v2_new = v2*c - v1*s/w;
+                v1_new = -v2*w*s + v1*c;
+            } else {
+                v2_new = v2 - v1*eps_t;
+                v1_new = v1;
+            }
+            if (v2 != 0.0 && (v2_new == 0.0 || (v2 < 0) != (v2_new < 0)))
+                K++;
+        }
+        v1 = v1_new;
+        v2 = v2_new;
+
+        // Only the signs matter, so we rescale to avoid overflows
+        nrm = FABS(v1) + FABS(v2);
+        if (nrm > 1e100) {
+            v1 /= nrm;
+            v2 /= nrm;
+        }
+    }
+
+    // To the right of the signal, v2 is linear with slope -v1
+    if (v1*v2 > 0)
+        K++;
+
+    return K;
+}
+
+// Auxiliary function: Evaluates the real-valued function
+// f(kappa) = H12(z) - 2*kappa*H11(z), where z is the value of the
+// discretization-specific variable z that corresponds to lambda=j*kappa. The
+// sign of f(kappa) agrees with the sign of a(j*kappa), since H(z) is
+// proportional to the scattering matrix with a positive factor for these
+// lambda. If transfer_matrix is NULL, the scattering matrix of the
+// Boffetta-Osborne discretization is used instead of H(z). The array buf
+// should be of length 5*n.
+static INT kdvv_gridfun(const UINT D, COMPLEX const * const u,
+    const UINT deg, COMPLEX const * const transfer_matrix, const REAL eps_t,
+    const UINT n, REAL const * const kappa, REAL * const f,
+    COMPLEX * const buf, kdv_discretization_t discretization)
+{
+    COMPLEX * const H11_vals = buf;
+    COMPLEX * const H12_vals = buf + n;
+    REAL degree1step;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    if (n == 0)
+        return SUCCESS;
+
+    if (transfer_matrix == NULL) {
+        COMPLEX * const lambda = buf + 4*n;
+        for (i = 0; i < n; i++)
+            lambda[i] = I*kappa[i];
+        ret_code = kdv_scatter_matrix(D, u, eps_t, n, lambda, buf,
+            kdv_discretization_BO, 0);
+        CHECK_RETCODE(ret_code, leave_fun);
+        for (i = 0; i < n; i++)
+            f[i] = CREAL(buf[4*i + 1] - 2.0*kappa[i]*buf[4*i]);
+        return SUCCESS;
+    }
+
+    for (i = 0; i < n; i++)
+        H11_vals[i] = I*kappa[i];
+    ret_code = kdv_discretization_lambda_to_z(n, eps_t, H11_vals,
+        discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    memcpy(H12_vals, H11_vals, n*sizeof(COMPLEX));
+
+    ret_code = poly_eval(deg, transfer_matrix, n, H11_vals);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = poly_eval(deg, transfer_matrix + (deg+1), n, H12_vals);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    if (discretization == kdv_discretization_2SPLIT2A) {
+        // Correct H12_vals for trick that implements 2split2A with first
+        // order polynomials instead of second order polynomials.
+        degree1step = kdv_discretization_degree(discretization);
+        for (i = 0; i < n; i++)
+            H12_vals[i] /= CEXP(-kappa[i]*eps_t / degree1step);
+    }
+
+    for (i = 0; i < n; i++)
+        f[i] = CREAL(H12_vals[i] - 2.0*kappa[i]*H11_vals[i]);
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Refines the bound states using Newton's method on the
+// Boffetta-Osborne discretization. Since a(j*kappa) is real-valued for real
+// signals, the iterates are kept on the imaginary axis. If brackets is not
+// NULL, it should contain for every bound state j*kappa an interval
+// [brackets[3*i], brackets[3*i+1]] that contains kappa together with the
+// value of f (see kdvv_gridfun) at its left end in brackets[3*i+2]. Iterates
+// that leave the interval are then replaced by bisection steps.
+static INT kdvv_refine_bound_states_newton(const UINT D,
+    COMPLEX const * const u, const REAL eps_t, const UINT K,
+    COMPLEX * const bound_states, REAL const * const brackets,
+    const UINT niter)
+{
+    INT ret_code = SUCCESS;
+    UINT i, iter;
+    COMPLEX S[8], g, gprime, error, l;
+    REAL lo = 0.0, hi = 0.0, kappa;
+    const REAL eprecision = EPSILON * 100;
+
+    for (i = 0; i < K; i++) {
+        l = bound_states[i];
+        if (brackets != NULL) {
+            lo = brackets[3*i];
+            hi = brackets[3*i + 1];
+        }
+        iter = 0;
+        while (iter < niter) {
+            // Evaluate g(l) = 2*j*l*S11(l) + S12(l), which is proportional
+            // to a(l), and its derivative
+            ret_code = kdv_scatter_matrix(D, u, eps_t, 1, &l, S,
+                kdv_discretization_BO, 1);
+            CHECK_RETCODE(ret_code, leave_fun);
+            g = 2.0*I*l*S[0] + S[1];
+            gprime = 2.0*I*S[0] + 2.0*I*l*S[4] + S[5];
+
+            // Perform some checks
+            if (g == 0.0) // we found a zero, stop here
+                break;
+            if (gprime == 0.0 && brackets == NULL)
+                return E_DIV_BY_ZERO;
+
+            // Perform Newton updates: l <- l - g(l)/g'(l)
+            if (brackets != NULL) {
+                // g(j*kappa) = f(kappa)
+                if ((CREAL(g) < 0) == (brackets[3*i + 2] < 0))
+                    lo = CIMAG(l);
+                else
+                    hi = CIMAG(l);
+                error = (gprime == 0.0) ? INFINITY : g/gprime;
+                kappa = CIMAG(l - error);
+                if (!(CABS(error) <= eprecision)
+                    && !(kappa > lo && kappa < hi)) {
+                    kappa = 0.5*(lo + hi);
+                    error = I*(CIMAG(l) - kappa);
+                }
+                l = I*kappa;
+            } else {
+                error = g / gprime;
+                l = I*CIMAG(l - error);
+            }
+            iter++;
+            if (!(CIMAG(l) > 0) || CABS(error) <= eprecision)
+                break;
+        }
+        bound_states[i] = l;
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Localizes the bound states on the imaginary axis.
+static inline INT kdvv_compute_boundstates(const UINT D,
+    COMPLEX const * const u, const REAL eps_t, const UINT deg,
+    COMPLEX const * const transfer_matrix, UINT * const K_ptr,
+    COMPLEX * const bound_states, fnft_kdvv_opts_t const * const opts_ptr)
+{
+    REAL *kappa = NULL, *f = NULL, *kappa_new = NULL, *f_new = NULL;
+    REAL *brackets = NULL;
+    COMPLEX *buf = NULL;
+    COMPLEX const * tm;
+    REAL kappa_max, tol, tmp;
+    UINT i, j, K, K_count, N, nsc, doublings, pass;
+    INT ret_code = SUCCESS;
+
+    // Number of grid intervals per bound state and maximum number of times
+    // the grid is refined if too few bound states have been found
+    const UINT oversampling_factor = 8;
+    const UINT max_doublings = 4;
+
+    if (opts_ptr->bound_state_localization == kdvv_bsloc_NEWTON) {
+        ret_code = kdvv_refine_bound_states_newton(D, u, eps_t, *K_ptr,
+            bound_states, NULL, opts_ptr->niter);
+        CHECK_RETCODE(ret_code, leave_fun);
+        return SUCCESS;
+    }
+    if (opts_ptr->bound_state_localization
+        != kdvv_bsloc_GRIDSEARCH_AND_REFINE)
+        return E_INVALID_ARGUMENT(opts_ptr->bound_state_localization);
+    if (transfer_matrix == NULL)
+        return E_INVALID_ARGUMENT(transfer_matrix);
+
+    // Determine the number of bound states
+    K_count = kdvv_count_boundstates(D, u, eps_t);
+    if (K_count == 0) {
+        *K_ptr = 0;
+        return SUCCESS;
+    }
+
+    // Bound states j*kappa satisfy kappa^2 < max(u)
+    kappa_max = 0.0;
+    for (i = 0; i < D; i++) {
+        if (CREAL(u[i]) > kappa_max)
+            kappa_max = CREAL(u[i]);
+    }
+    kappa_max = SQRT(kappa_max);
+
+    // Evaluate the sign of a(j*kappa) on a uniform grid in [0, kappa_max]
+    // and refine the grid until the number of sign changes matches the
+    // number of bound states. The transfer matrix is fast to evaluate, but
+    // its values can span too many orders of magnitude for large signals.
+    // The Boffetta-Osborne discretization is used if it fails.
+    for (pass = 0; pass < 2; pass++) {
+        tm = (pass == 0) ? transfer_matrix : NULL;
+        fnft__aligned_free(kappa);
+        fnft__aligned_free(f);
+        fnft__aligned_free(buf);
+        N = oversampling_factor*(K_count + 1);
+        kappa = fnft__aligned_malloc((N+1) * sizeof(REAL));
+        f = fnft__aligned_malloc((N+1) * sizeof(REAL));
+        buf = fnft__aligned_malloc(5*(N+1) * sizeof(COMPLEX));
+        if (kappa == NULL || f == NULL || buf == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+        for (i = 0; i <= N; i++)
+            kappa[i] = (kappa_max*i)/N;
+        ret_code = kdvv_gridfun(D, u, deg, tm, eps_t, N+1, kappa, f, buf,
+            opts_ptr->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Only the new midpoints have to be evaluated when the grid is
+        // refined
+        doublings = 0;
+        while (1) {
+            nsc = 0;
+            for (i = 0; i < N; i++) {
+                if ((f[i] < 0) != (f[i+1] < 0))
+                    nsc++;
+            }
+            if (nsc == K_count || doublings >= max_doublings)
+                break;
+
+            fnft__aligned_free(buf);
+            buf = fnft__aligned_malloc(5*N * sizeof(COMPLEX));
+            kappa_new = fnft__aligned_malloc((3*N+1) * sizeof(REAL));
+            f_new = fnft__aligned_malloc((3*N+1) * sizeof(REAL));
+            if (buf == NULL || kappa_new == NULL || f_new == NULL) {
+                ret_code = E_NOMEM;
+                goto leave_fun;
+            }
+            // The midpoints are evaluated in the last N entries and then
+            // interleaved with the old grid
+            REAL * const kappa_mid = kappa_new + 2*N + 1;
+            REAL * const f_mid = f_new + 2*N + 1;
+            for (i = 0; i < N; i++)
+                kappa_mid[i] = 0.5*(kappa[i] + kappa[i+1]);
+            ret_code = kdvv_gridfun(D, u, deg, tm, eps_t, N, kappa_mid,
+                f_mid, buf, opts_ptr->discretization);
+            CHECK_RETCODE(ret_code, leave_fun);
+            for (i = 0; i < N; i++) {
+                kappa_new[2*i] = kappa[i];
+                f_new[2*i] = f[i];
+                kappa_new[2*i + 1] = kappa_mid[i];
+                f_new[2*i + 1] = f_mid[i];
+            }
+            kappa_new[2*N] = kappa[N];
+            f_new[2*N] = f[N];
+            fnft__aligned_free(kappa);
+            fnft__aligned_free(f);
+            kappa = kappa_new;
+            f = f_new;
+            kappa_new = NULL;
+            f_new = NULL;
+            N *= 2;
+            doublings++;
+        }
+        if (nsc == K_count)
+            break;
+    }
+    if (nsc != K_count)
+        WARN("Number of sign changes on the grid does not match the number of bound states. Results may be inaccurate.");
+
+    // Initial guesses by linear interpolation between the grid points
+    // around the sign changes. The brackets for the refinement are extended
+    // by the neighboring intervals without sign change, since the zeros of
+    // the transfer matrix and of the Boffetta-Osborne discretization differ
+    // slightly.
+    brackets = fnft__aligned_malloc(3*nsc * sizeof(REAL));
+    if (brackets == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    K = 0;
+    for (i = 0; i < N; i++) {
+        if ((f[i] < 0) != (f[i+1] < 0)) {
+            if (K >= *K_ptr || K >= nsc) {
+                WARN("Found more than *K_ptr bound states. Returning as many as possible.");
+                break;
+            }
+            bound_states[K] = I*(kappa[i] - f[i]*(kappa[i+1] - kappa[i])
+                /(f[i+1] - f[i]));
+            j = (i > 0 && (f[i-1] < 0) == (f[i] < 0)) ? i-1 : i;
+            brackets[3*K] = kappa[j];
+            j = (i+1 < N && (f[i+2] < 0) == (f[i+1] < 0)) ? i+2 : i+1;
+            brackets[3*K + 1] = kappa[j];
+            brackets[3*K + 2] = f[i];
+            K++;
+        }
+    }
+
+    // Refine the bound states on the full signal
+    ret_code = kdvv_refine_bound_states_newton(D, u, eps_t, K, bound_states,
+        brackets, opts_ptr->niter);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Sort the refined bound states and remove those that have left the
+    // admissible range or converged to the same bound state
+    for (i = 1; i < K; i++) {
+        for (j = i; j > 0 && CIMAG(bound_states[j-1])
+            > CIMAG(bound_states[j]); j--) {
+            tmp = CIMAG(bound_states[j]);
+            bound_states[j] = bound_states[j-1];
+            bound_states[j-1] = I*tmp;
+        }
+    }
+    tol = SQRT(EPSILON)*kappa_max;
+    j = 0;
+    for (i = 0; i < K; i++) {
+        tmp = CIMAG(bound_states[i]);
+        if (!(tmp > 0 && tmp <= kappa_max))
+            continue;
+        if (j > 0 && tmp - CIMAG(bound_states[j-1]) <= tol)
+            continue;
+        bound_states[j++] = I*tmp;
+    }
+    *K_ptr = j;
+
+leave_fun:
+    fnft__aligned_free(kappa);
+    fnft__aligned_free(f);
+    fnft__aligned_free(kappa_new);
+    fnft__aligned_free(f_new);
+    fnft__aligned_free(brackets);
+    fnft__aligned_free(buf);
+    return ret_code;
+}
+
+// Auxiliary function: Computes the norming constants and/or residues of the
+// given bound states.
+static inline INT kdvv_compute_normconsts_or_residues(const UINT D,
+    COMPLEX const * const u, REAL const * const T, const UINT K,
+    COMPLEX const * const bound_states,
+    COMPLEX * const normconsts_or_residues,
+    fnft_kdvv_opts_t const * const opts_ptr)
+{
+    COMPLEX *a_vals = NULL, *aprime_vals = NULL;
+    UINT i, offset = 0;
+    INT ret_code = SUCCESS;
+
+    if (K == 0) // no bound states
+        return SUCCESS;
+
+    a_vals = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    aprime_vals = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    if (a_vals == NULL || aprime_vals == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    ret_code = kdv_scatter_bound_states(D, u, T, K, bound_states, a_vals,
+        aprime_vals, normconsts_or_residues, kdv_discretization_BO, 0);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Update to or add residues if requested
+    if (opts_ptr->discspec_type != kdvv_dstype_NORMING_CONSTANTS) {
+
+        if (opts_ptr->discspec_type == kdvv_dstype_RESIDUES) {
+            offset = 0;
+        } else if (opts_ptr->discspec_type == kdvv_dstype_BOTH) {
+            offset = K;
+            memcpy(normconsts_or_residues + offset, normconsts_or_residues,
+                offset*sizeof(COMPLEX));
+        } else {
+            ret_code = E_INVALID_ARGUMENT(opts_ptr->discspec_type);
+            goto leave_fun;
+        }
+
+        // Divide norming constants by derivatives to get residues
+        for (i = 0; i < K; i++) {
+            if (aprime_vals[i] == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto leave_fun;
+            }
+            normconsts_or_residues[offset + i] /= aprime_vals[i];
+        }
+    }
+
+leave_fun:
+    fnft__aligned_free(a_vals);
+    fnft__aligned_free(aprime_vals);
     return ret_code;
 }
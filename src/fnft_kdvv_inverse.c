@@ -0,0 +1,196 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft_kdvv_inverse.h"
+#include "fnft__errwarn.h"
+#include "fnft__kdv_discretization.h"
+#include "fnft__kdv_finvscatter.h"
+#include "fnft__fft_wrapper.h"
+#include "fnft__allocator.h"
+#include "fnft__misc.h"
+
+static fnft_kdvv_inverse_opts_t default_opts = {
+    .discretization = kdv_discretization_2SPLIT2A
+};
+
+fnft_kdvv_inverse_opts_t fnft_kdvv_inverse_default_opts()
+{
+    return default_opts;
+}
+
+INT fnft_kdvv_inverse_XI(const UINT D, REAL const * const T,
+        const UINT M, REAL * const XI,
+        const kdv_discretization_t discretization)
+{
+    if (D<2)
+        return E_INVALID_ARGUMENT(D);
+    if (M == 0)
+        return E_INVALID_ARGUMENT(M);
+    if (XI == NULL)
+        return E_INVALID_ARGUMENT(XI);
+    if (T == NULL || !(T[0] < T[1]))
+        return E_INVALID_ARGUMENT(T);
+
+    INT ret_code = SUCCESS;
+    COMPLEX XIC[2];
+    // Note that z = exp(2.0*PI*I*i/M) = exp(2*I*xi*eps_t/degree1step). The
+    // range below results the same values as a normal M-point FFT, but in a
+    // different order.
+    const REAL eps_t = (T[1] - T[0]) / (D - 1);
+    XIC[0] = CEXP(2.0*FNFT_PI*I * (M/2 + 1)/M);
+    XIC[1] = -1.0;
+    ret_code = kdv_discretization_z_to_lambda(2, eps_t, XIC, discretization);
+    XI[0] = CREAL(XIC[0]);
+    XI[1] = CREAL(XIC[1]);
+    return ret_code;
+}
+
+INT fnft_kdvv_inverse(
+        const UINT M,
+        COMPLEX const * const contspec,
+        REAL const * const XI,
+        const UINT D,
+        COMPLEX * const u,
+        REAL const * const T,
+        fnft_kdvv_inverse_opts_t *opts_ptr)
+{
+    if (contspec == NULL)
+        return E_INVALID_ARGUMENT(contspec);
+    if (M%2 != 0 || M < D)
+        return E_INVALID_ARGUMENT(M);
+    if (XI == NULL || !(XI[0] < XI[1]))
+        return E_INVALID_ARGUMENT(XI);
+    if (D < 2 || (D&(D - 1)) != 0)
+        return E_INVALID_ARGUMENT(D);
+    if (u == NULL)
+        return E_INVALID_ARGUMENT(u);
+    if (T == NULL || !(T[0] < T[1]))
+        return E_INVALID_ARGUMENT(T);
+    if (opts_ptr == NULL)
+        opts_ptr = &default_opts;
+    if (opts_ptr->discretization != kdv_discretization_2SPLIT1B
+            && opts_ptr->discretization != kdv_discretization_2SPLIT2A)
+        return E_INVALID_ARGUMENT(opts_ptr->discretization);
+
+    INT ret_code = SUCCESS;
+    fft_wrapper_plan_t plan = fft_wrapper_safe_plan_init();
+    COMPLEX *transfer_matrix = NULL, *rho_reordered = NULL;
+    COMPLEX *rho_coeffs = NULL;
+    UINT i;
+
+    const UINT degree1step = kdv_discretization_degree(
+        opts_ptr->discretization);
+    const REAL boundary_coeff = kdv_discretization_boundary_coeff(
+        opts_ptr->discretization);
+    const UINT deg = D*degree1step;
+    const REAL eps_t = (T[1] - T[0]) / (D - 1);
+    const REAL eps_xi = (XI[1] - XI[0]) / (M - 1);
+
+    transfer_matrix = fnft__aligned_calloc(4*(deg+1), sizeof(COMPLEX));
+    rho_reordered = fft_wrapper_malloc(M * sizeof(COMPLEX));
+    rho_coeffs = fft_wrapper_malloc(M * sizeof(COMPLEX));
+    if (transfer_matrix == NULL || rho_reordered == NULL || rho_coeffs == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Step 1: Compute the reflection coefficient of the discretized problem
+    // on the unit circle. The reflection coefficient computed by fnft_kdvv is
+    //
+    //   contspec(xi) = exp(-2*j*xi*T1)*Rc/(-2*j*xi - Rc),
+    //
+    // where T1 = T[1] + boundary_coeff*eps_t, R(z) = H12(z)/H22(z) is the
+    // quotient of the polynomials in the second column of the transfer matrix,
+    // Rc = R(z)/sqrt(z) for the discretization 2SPLIT2A and Rc = R(z) else,
+    // and z = exp(-2*j*xi*d) with d = eps_t/degree1step.
+    //
+    // The power series of R(z) in 1/z converges too slowly on the unit
+    // circle. We therefore express the second column in the basis
+    // [(z-1)/d; 1], [0; 1] of the eigenvectors of the transfer matrix
+    // [1, 0; -d, z] of a zero sample. The quotient of the two coefficients is
+    //
+    //   rho(z) = d*R(z)/(z - 1 - d*R(z)),
+    //
+    // whose denominator has no zeros outside of the unit circle if there are
+    // no bound states. With P = contspec(xi)*exp(2*j*xi*T1), s = sqrt(z) for
+    // 2SPLIT2A and s = 1 else, and Q = (z - 1)/(-2*j*xi*d), this simplifies
+    // to rho = s*P/(Q*(1 + P) - s*P), which is also well-defined at z=1. The
+    // values are reordered as in fnft_nsev_inverse to match the ordering used
+    // by the FFT.
+
+    const REAL T1 = T[1] + boundary_coeff*eps_t;
+    const REAL d = eps_t/degree1step;
+    for (i=0; i<M; i++) {
+        const REAL xi = XI[0] + i*eps_xi;
+        const COMPLEX P = contspec[i]*CEXP(2.0*I*xi*T1);
+        const COMPLEX Q = CEXP(-I*xi*d)*misc_CSINC(xi*d);
+        COMPLEX sP = P;
+        if (opts_ptr->discretization == kdv_discretization_2SPLIT2A)
+            sP *= CEXP(-I*xi*d);
+        const COMPLEX rho = sP/(Q*(1.0 + P) - sP);
+        if (!(CABS(rho) < INFINITY)) {
+            ret_code = E_DIV_BY_ZERO;
+            goto leave_fun;
+        }
+        if (i >= M/2 - 1)
+            rho_reordered[i - (M/2 - 1)] = rho;
+        else
+            rho_reordered[i + (M/2 + 1)] = rho;
+    }
+
+    // Step 2: Expand rho(z) into the power series rho(z) = p[1]/z + p[2]/z^2
+    // + ... using a M-point FFT. (The coefficient p[0] vanishes.) With
+    // B(z) = p[1]*z^deg + ... + p[deg+1] and A(z) = z^(deg+1), a second
+    // column whose quotient has the same leading coefficients as R(z) is
+    //
+    //   H12(z) = B(z)/d, H22(z) = (A(z) + B(z))/(z - 1).
+    //
+    // The leading coefficients of H22(z) are the cumulative sums of the
+    // ones of A(z) + B(z). The first column is not needed.
+
+    ret_code = fft_wrapper_create_plan(&plan, M, rho_reordered, rho_coeffs,
+                                       -1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fft_wrapper_execute_plan(plan, rho_reordered, rho_coeffs);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    COMPLEX * const H12 = transfer_matrix + 1*(deg+1);
+    COMPLEX * const H22 = transfer_matrix + 3*(deg+1);
+    H22[0] = 1.0;
+    for (i=0; i<=deg; i++) {
+        H12[i] = (i+1 < M) ? rho_coeffs[i+1]/(M*d) : 0.0;
+        if (i > 0)
+            H22[i] = H22[i-1] + d*H12[i-1];
+    }
+
+    // Step 3: Recover the time domain signal from the transfer matrix.
+
+    ret_code = kdv_finvscatter(deg, transfer_matrix, u, eps_t,
+                               opts_ptr->discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    fft_wrapper_destroy_plan(&plan);
+    fft_wrapper_free(rho_reordered);
+    fft_wrapper_free(rho_coeffs);
+    fnft__aligned_free(transfer_matrix);
+    return ret_code;
+}
@@ -23,6 +23,8 @@
 
 
 #include "fnft_nsep.h"
+#include "fnft__allocator.h"
+#include "fnft__parallel.h"
 
 static fnft_nsep_opts_t default_opts = {
     .localization = fnft_nsep_loc_MIXED,
@@ -37,11 +39,21 @@ static fnft_nsep_opts_t default_opts = {
     .floquet_range = {-1, 1},
     .points_per_spine = 2,
     .Dsub = 0, // => the algorithm chooses Dsub automatically
-    .tol = -1 // negative tol => the algorithm chooses tol automatically
+    .tol = -1, // negative tol => the algorithm chooses tol automatically
+    .spine_tracing = 0
 };
 
 static const UINT oversampling_factor = 32;
 
+// Number of spectral estimates that are passed together to
+// nse_scatter_matrix during the Newton refinement (one block per thread)
+static const UINT refine_block_size = 8;
+
+// Number of Newton steps with which the critical points of the Floquet
+// discriminant are polished on the full signal (see
+// nsep_spine_critical_points)
+static const UINT crit_newton_steps = 2;
+
 // Returns an options object for the main routine with default settings.
 // See the header file for a detailed description.
 fnft_nsep_opts_t fnft_nsep_default_opts()
@@ -50,11 +62,17 @@ fnft_nsep_opts_t fnft_nsep_default_opts()
 }
 
 // Auxiliary routines.
+static INT refine_scatter_matrices(
+        const UINT D, COMPLEX const * const q, COMPLEX const * const r,
+        const REAL eps_t, const INT kappa, const UINT K,
+        COMPLEX const * const lambda, COMPLEX * const result,
+        nse_discretization_t discretization);
 static inline INT refine_mainspec(
         const UINT D, COMPLEX const * const q, COMPLEX * r,
         const REAL eps_t, const UINT K,
         COMPLEX * const mainspec, const UINT max_evals,
-        REAL rhs, const REAL tol, INT kappa, nse_discretization_t discretization);
+        REAL rhs, const REAL tol, INT kappa, nse_discretization_t discretization,
+        INT * const converged);
 static inline INT refine_auxspec(
         const UINT D, COMPLEX const * const q, COMPLEX * r,
         const REAL eps_t, const UINT K,
@@ -76,6 +94,14 @@ static inline INT gridsearch(const UINT D,
         INT warn_flags[2]);
 static inline void update_bounding_box_if_auto(const REAL eps_t,
         const REAL map_coeff, fnft_nsep_opts_t * const opts_ptr);
+static UINT nsep_choose_Dsub(const UINT D, const UINT Dsub_desired);
+static INT nsep_spine_critical_points(const UINT D,
+        COMPLEX const * const q, COMPLEX const * const r, const REAL eps_t,
+        const REAL eps_t_sub, const UINT deg, COMPLEX const * const p,
+        const INT kappa, REAL const * const box,
+        nse_discretization_t discretization,
+        nse_discretization_t refine_discretization, UINT * const K_crit_ptr,
+        COMPLEX * const crit, REAL * const crit_val, COMPLEX * const crit_h2);
 
 
 // Main routine.
@@ -92,11 +118,12 @@ INT fnft_nsep(const UINT D, COMPLEX const * const q,
     COMPLEX *q_preprocessed = NULL;
     
     // Check inputs
-    // D (and Dsub in line 493) only need to be even to ensure that deg in line 279 and 537 are also even for all discretizations. 
-    // deg is required to be even so that its use in lines 321, 355 and 587 make sense. 
-    // Due to the periodic boundary conditions, Dsub has to be an even factor of D. For some choices like D=514, this means Dsub can only be 514 as D=514=2*257.
-    // This makes the idea of subsampling unintuitive. Hence at this stage D is restricted to powers of two for which subsampling still makes sense. 
-    if (D < 2 || (D & (D-1)) != 0 )
+    // D (and Dsub in subsample_and_refine) only need to be even to ensure
+    // that the degrees of the polynomials are also even for all
+    // discretizations, which is required when the center coefficient p[deg/2]
+    // is modified. Due to the periodic boundary conditions, Dsub is chosen
+    // among the even factors of D (see nsep_choose_Dsub).
+    if (D < 2 || D%2 != 0)
         return E_INVALID_ARGUMENT(D);
     if (q == NULL)
         return E_INVALID_ARGUMENT(q);
@@ -117,7 +144,7 @@ INT fnft_nsep(const UINT D, COMPLEX const * const q,
       
         REAL Lam_shift = phase_shift/(-2*(T[1] - T[0]));
         const REAL eps_t = (T[1] - T[0])/D;
-        q_preprocessed = malloc(D * sizeof(COMPLEX));
+        q_preprocessed = fnft__aligned_malloc(D * sizeof(COMPLEX));
         if (q_preprocessed == NULL) {
             ret_code = E_NOMEM;
             goto leave_fun;
@@ -212,7 +239,7 @@ INT fnft_nsep(const UINT D, COMPLEX const * const q,
         opts_ptr->bounding_box[1] += Lam_shift;
     }
         leave_fun:
-            free(q_preprocessed);
+            fnft__aligned_free(q_preprocessed);
             return ret_code;
             
 }
@@ -257,7 +284,7 @@ static inline INT gridsearch(const UINT D,
 
     Dsub = D;
     ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &q_preprocessed, &r_preprocessed,
-            first_last_index, opts_ptr->discretization);
+            first_last_index, opts_ptr->discretization, NULL);
     CHECK_RETCODE(ret_code, release_mem);
     
 
@@ -267,7 +294,7 @@ static inline INT gridsearch(const UINT D,
         ret_code = E_INVALID_ARGUMENT(opts_ptr->discretization);
         goto release_mem;
     }
-    transfer_matrix = malloc(i*sizeof(COMPLEX));
+    transfer_matrix = fnft__aligned_malloc(i*sizeof(COMPLEX));
     if (transfer_matrix == NULL) {
         ret_code = E_NOMEM;
         goto release_mem;
@@ -294,7 +321,12 @@ static inline INT gridsearch(const UINT D,
         PHI[1] = tmp;
     }
     
-    roots = malloc(oversampling_factor*deg*sizeof(COMPLEX));
+    // A polynomial of degree deg has at most deg roots. The grid search is
+    // carried out in blocks, so that the grid of oversampling_factor*deg
+    // points is never stored as a whole. More than deg candidates can still
+    // be reported, e.g. if the grid wraps around the unit circle because the
+    // bounding box is large. The additional ones are dropped with a warning.
+    roots = fnft__aligned_malloc(deg*sizeof(COMPLEX));
     if (roots == NULL) {
         ret_code = E_NOMEM;
         goto release_mem;
@@ -309,7 +341,7 @@ static inline INT gridsearch(const UINT D,
         
         // Allocate memory for the polynomial p(z) approx z^{D/2} Delta(z)+/-2
         // and its roots
-        p = malloc((deg + 1)*sizeof(COMPLEX));
+        p = fnft__aligned_malloc((deg + 1)*sizeof(COMPLEX));
         if (p == NULL) {
             ret_code = E_NOMEM;
             goto release_mem;
@@ -322,13 +354,17 @@ static inline INT gridsearch(const UINT D,
         // nse_fscatter rescales
         
         // Find the roots of p(z)
-        K = oversampling_factor*deg;
-        ret_code = poly_roots_fftgridsearch(deg, p, &K, PHI, roots);
+        K = deg;
+        ret_code = poly_roots_fftgridsearch_blocked(deg, p,
+                oversampling_factor*deg, PHI, 0, &K, roots);
         CHECK_RETCODE(ret_code, release_mem);
 
         if (K > deg) {
-            ret_code = E_OTHER("Found more roots than memory is available.");
-            goto release_mem;
+            if (warn_flags[0] == 0) {
+                WARN("Found more main spectrum candidates than memory is available. Returning as many as possible.");
+                warn_flags[0] = 1;
+            }
+            K = deg;
         }
         
         // Coordinate transform (from discrete-time to continuous-time domain)
@@ -356,14 +392,17 @@ static inline INT gridsearch(const UINT D,
         
         
         // Find the roots of the new p(z)
-        K_filtered = oversampling_factor*deg;
-        ret_code = poly_roots_fftgridsearch(deg, p, &K_filtered, PHI,
-                roots);
+        K_filtered = deg;
+        ret_code = poly_roots_fftgridsearch_blocked(deg, p,
+                oversampling_factor*deg, PHI, 0, &K_filtered, roots);
         CHECK_RETCODE(ret_code, release_mem);
 
         if (K_filtered > deg) {
-            ret_code = E_OTHER("Found more roots than memory is available.");
-            goto release_mem;
+            if (warn_flags[0] == 0) {
+                WARN("Found more main spectrum candidates than memory is available. Returning as many as possible.");
+                warn_flags[0] = 1;
+            }
+            K_filtered = deg;
         }
         
         // Coordinate transform of the new roots
@@ -396,10 +435,18 @@ static inline INT gridsearch(const UINT D,
     // Compute auxiliary spectrum (real line only)
     if (aux_spec != NULL) {
         
-        M = oversampling_factor*deg;
-        ret_code = poly_roots_fftgridsearch(deg, transfer_matrix+(deg+1), &M,
-                PHI, roots);
+        M = deg;
+        ret_code = poly_roots_fftgridsearch_blocked(deg,
+                transfer_matrix+(deg+1), oversampling_factor*deg, PHI, 0, &M,
+                roots);
         CHECK_RETCODE(ret_code, release_mem);
+        if (M > deg) {
+            if (warn_flags[1] == 0) {
+                WARN("Found more aux spectrum candidates than memory is available. Returning as many as possible.");
+                warn_flags[1] = 1;
+            }
+            M = deg;
+        }
 
         // Coordinate transform (from discrete-time to continuous-time domain)
         ret_code = nse_discretization_z_to_lambda(M, eps_t, roots, opts_ptr->discretization);
@@ -426,11 +473,11 @@ static inline INT gridsearch(const UINT D,
     *M_ptr = M;
     
     release_mem:
-        free(transfer_matrix);
-        free(p);
-        free(roots);
-        free(q_preprocessed);
-        free(r_preprocessed);
+        fnft__aligned_free(transfer_matrix);
+        fnft__aligned_free(p);
+        fnft__aligned_free(roots);
+        fnft__aligned_free(q_preprocessed);
+        fnft__aligned_free(r_preprocessed);
         
         return ret_code;
 }
@@ -449,6 +496,13 @@ static inline INT subsample_and_refine(const UINT D,
     COMPLEX * transfer_matrix = NULL;
     COMPLEX * p = NULL;
     COMPLEX * roots = NULL;
+    COMPLEX * traced = NULL;
+    COMPLEX * trace_buf = NULL;
+    INT * trace_converged = NULL;
+    COMPLEX * crit = NULL;
+    REAL * crit_val = NULL;
+    COMPLEX * crit_h2 = NULL;
+    UINT K_traced = 0;
     REAL degree1step, map_coeff;
     REAL tol_im;
     REAL refine_tol;
@@ -464,6 +518,7 @@ static inline INT subsample_and_refine(const UINT D,
     COMPLEX *rsub_preprocessed = NULL;
     COMPLEX *q_preprocessed = NULL;
     COMPLEX *r_preprocessed = NULL;
+    COMPLEX *q_spectrum = NULL;
     UINT first_last_index[2];
     UINT nskip_per_step;
     nse_discretization_t nse_discretization = 0;
@@ -484,25 +539,26 @@ static inline INT subsample_and_refine(const UINT D,
     // Create the signal required for refinement of the initial guesses.
     Dsub = D;
     ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &q_preprocessed, &r_preprocessed,
-            first_last_index, opts_ptr->discretization);
+            first_last_index, opts_ptr->discretization, &q_spectrum);
     CHECK_RETCODE(ret_code, release_mem);
     
     // Create a subsampled/resampled version of q for computing initial guesses.
     Dsub = opts_ptr->Dsub;
     if (Dsub == 0) // users wants Dsub to be chosen automatically
         Dsub = POW(2.0, CEIL( 0.5 * LOG2(D * LOG2(D) * LOG2(D)) ));
-    else
-        Dsub = POW(2.0, ROUND(LOG2(Dsub))); 
+    Dsub = nsep_choose_Dsub(D, Dsub);
     
     ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &qsub_preprocessed, &rsub_preprocessed,
-            first_last_index, opts_ptr->discretization);
+            first_last_index, opts_ptr->discretization, &q_spectrum);
     CHECK_RETCODE(ret_code, release_mem);
 
+    // Since Dsub is a factor of D, the subsampled signal again covers exactly
+    // one period, i.e., Dsub*eps_t_sub = T[1]-T[0]
     nskip_per_step = D/Dsub;
-    if ( first_last_index[0] != 0 || first_last_index[1]+nskip_per_step != D )
-        return E_ASSERTION_FAILED; // Correct update of T for general
-                                   // downsampling still needs to be
-                                 // implemented
+    if ( first_last_index[0] != 0 || first_last_index[1]+nskip_per_step != D ) {
+        ret_code = E_ASSERTION_FAILED;
+        goto release_mem;
+    }
     
     if (upsampling_factor == 2) {        
         nse_discretization = nse_discretization_CF4_2;
@@ -522,7 +578,7 @@ static inline INT subsample_and_refine(const UINT D,
         ret_code = E_INVALID_ARGUMENT(opts_ptr->discretization);
         goto release_mem;
     }
-    transfer_matrix = malloc(i*sizeof(COMPLEX));
+    transfer_matrix = fnft__aligned_malloc(i*sizeof(COMPLEX));
     if (transfer_matrix == NULL) {
         ret_code = E_NOMEM;
         goto release_mem;
@@ -557,7 +613,7 @@ static inline INT subsample_and_refine(const UINT D,
         // where Delta(z)=trace{monodromy matrix(z)}is the Floquet discriminant
         
         // Allocate memory for the polynomial p(z) approx z^{D/2} Delta(z)+/-2
-        p = malloc((deg + 1)*sizeof(COMPLEX));
+        p = fnft__aligned_malloc((deg + 1)*sizeof(COMPLEX));
         if (p == NULL) {
             ret_code = E_NOMEM;
             goto release_mem;
@@ -579,49 +635,155 @@ static inline INT subsample_and_refine(const UINT D,
         if (nvals>1)
             rhs_step /= nvals - 1;
         const COMPLEX p_center_coeff = p[deg/2];
+
+        // In spine tracing mode, the roots of p(z)-rhs are only computed for
+        // the first and the last value of rhs. For the values in between,
+        // the points found for the previous value of rhs are the initial
+        // guesses (continuation along the spines and along the bands on the
+        // real line). New spines leave the real line at critical points of
+        // Delta, which are computed once (see nsep_spine_critical_points).
+        // Spines and bands can also enter the bounding box from outside.
+        // Since the spines are symmetric w.r.t. the real line, the traced
+        // points are filtered with a box whose imaginary range is mirrored
+        // at the real line. The box is furthermore enlarged by a tenth of
+        // its width in each direction.
+        const INT tracing = opts_ptr->spine_tracing != 0 && nvals > 2;
+        REAL trace_box[4];
+        UINT K_crit = 0;
+        if (tracing) {
+            const REAL margin_re = 0.1*FABS(opts_ptr->bounding_box[1]
+                    - opts_ptr->bounding_box[0]);
+            trace_box[0] = opts_ptr->bounding_box[0] - margin_re;
+            trace_box[1] = opts_ptr->bounding_box[1] + margin_re;
+            trace_box[3] = FABS(opts_ptr->bounding_box[2]);
+            if (FABS(opts_ptr->bounding_box[3]) > trace_box[3])
+                trace_box[3] = FABS(opts_ptr->bounding_box[3]);
+            trace_box[3] *= 1.2;
+            trace_box[2] = -trace_box[3];
+
+            crit = fnft__aligned_malloc(deg * sizeof(COMPLEX));
+            crit_val = fnft__aligned_malloc(deg * sizeof(REAL));
+            crit_h2 = fnft__aligned_malloc(deg * sizeof(COMPLEX));
+            if (crit == NULL || crit_val == NULL || crit_h2 == NULL) {
+                ret_code = E_NOMEM;
+                goto release_mem;
+            }
+            ret_code = nsep_spine_critical_points(D_effective, q_preprocessed,
+                    r_preprocessed, eps_t, eps_t_sub, deg, p, kappa, trace_box,
+                    opts_ptr->discretization, nse_discretization, &K_crit, crit,
+                    crit_val, crit_h2);
+            CHECK_RETCODE(ret_code, release_mem);
+
+            traced = fnft__aligned_malloc((deg + 2*K_crit) * sizeof(COMPLEX));
+            trace_buf = fnft__aligned_malloc((deg + 2*K_crit) * sizeof(COMPLEX));
+            trace_converged = fnft__aligned_malloc((deg + 2*K_crit) * sizeof(INT));
+            if (traced == NULL || trace_buf == NULL || trace_converged == NULL) {
+                ret_code = E_NOMEM;
+                goto release_mem;
+            }
+        }
         
         for (UINT nval=0; nval<nvals; nval++) {
             
             const REAL rhs = 2.0*(rhs_0 + nval*rhs_step);
+            const INT traced_step = tracing && nval > 0 && nval+1 < nvals;
+            COMPLEX * const pts = traced_step ? trace_buf : roots;
             
-            p[deg/2] = p_center_coeff - rhs * POW(2.0, -W); // the pow arises
-            // because nse_fscatter rescales
-            
-            // Find the roots of p(z)-rhs
-            ret_code = poly_roots_fasteigen(deg, p, roots);
-            CHECK_RETCODE(ret_code, release_mem);
-            
-            // Coordinate transform (from discrete-time to continuous-time domain)
-            ret_code = nse_discretization_z_to_lambda(deg, eps_t_sub, roots,
-                    opts_ptr->discretization);
-            CHECK_RETCODE(ret_code, release_mem);
-            
-            // Filter the roots
-            K_new = deg;
-            if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-                ret_code = misc_filter(&K_new, roots, NULL,
-                        opts_ptr->bounding_box);
+            if (traced_step) {
 
+                // Continue from the points for the previous value of rhs and
+                // start the spines that leave the real line in between. Near a
+                // critical point lam_c, Delta(lam) is approximately
+                // Delta(lam_c) + Delta''(lam_c)/2*(lam-lam_c)^2. Points on
+                // the real line close to a critical point cannot be continued
+                // with Newton's method since Delta' almost vanishes there,
+                // which is why the critical points whose value is up to one
+                // step away from the current interval are used as well.
+                // Duplicates are merged below.
+                const REAL rhs_prev = rhs - 2.0*rhs_step;
+                const REAL crit_lo = (rhs_prev < rhs ? rhs_prev : rhs)
+                    - FABS(rhs - rhs_prev);
+                const REAL crit_hi = (rhs_prev < rhs ? rhs : rhs_prev)
+                    + FABS(rhs - rhs_prev);
+                K_new = K_traced;
+                memcpy(pts, traced, K_new * sizeof(COMPLEX));
+                for (i=0; i<K_crit && K_new+2<=deg+2*K_crit; i++) {
+                    if (crit_val[i] >= crit_lo && crit_val[i] <= crit_hi) {
+                        const COMPLEX h = CSQRT((rhs - crit_val[i])*crit_h2[i]);
+                        pts[K_new++] = crit[i] + h;
+                        pts[K_new++] = crit[i] - h;
+                    }
+                }
+
+            } else {
+
+                p[deg/2] = p_center_coeff - rhs * POW(2.0, -W); // the pow
+                // arises because nse_fscatter rescales
+
+                // Find the roots of p(z)-rhs
+                ret_code = poly_roots_fasteigen(deg, p, roots);
                 CHECK_RETCODE(ret_code, release_mem);
-            }
-            if (skip_real_flag != 0) {
-                ret_code = misc_filter_nonreal(&K_new, roots, tol_im);
+
+                // Coordinate transform (from discrete-time to continuous-time domain)
+                ret_code = nse_discretization_z_to_lambda(deg, eps_t_sub, roots,
+                        opts_ptr->discretization);
                 CHECK_RETCODE(ret_code, release_mem);
+
+                // Filter the roots
+                K_new = deg;
+                if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
+                    ret_code = misc_filter(&K_new, roots, NULL,
+                            tracing ? trace_box : opts_ptr->bounding_box);
+
+                    CHECK_RETCODE(ret_code, release_mem);
+                }
+                if (skip_real_flag != 0) {
+                    ret_code = misc_filter_nonreal(&K_new, roots, tol_im);
+                    CHECK_RETCODE(ret_code, release_mem);
+                }
             }
 
-            // Refine the remaining roots
-            ret_code = refine_mainspec(D_effective, q_preprocessed, r_preprocessed, eps_t, K_new, roots,
-                    opts_ptr->max_evals, -rhs, refine_tol, kappa, nse_discretization);
+            // Refine the remaining roots. Traced points that did not converge
+            // have left their spine and are removed.
+            ret_code = refine_mainspec(D_effective, q_preprocessed, r_preprocessed, eps_t, K_new, pts,
+                    opts_ptr->max_evals, -rhs, refine_tol, kappa, nse_discretization,
+                    traced_step ? trace_converged : NULL);
             CHECK_RETCODE(ret_code, release_mem);
+            if (traced_step) {
+                UINT K_converged = 0;
+                for (i=0; i<K_new; i++) {
+                    if (trace_converged[i])
+                        pts[K_converged++] = pts[i];
+                }
+                K_new = K_converged;
+            }
+
+            // Keep the refined roots for the next value of rhs. The real
+            // ones are continued along the bands. Initial guesses that
+            // converged to the same point are merged.
+            if (tracing && nval+1 < nvals) {
+                K_traced = K_new;
+                memcpy(traced, pts, K_traced * sizeof(COMPLEX));
+                if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
+                    ret_code = misc_filter(&K_traced, traced, NULL, trace_box);
+                    CHECK_RETCODE(ret_code, release_mem);
+                }
+                ret_code = misc_merge(&K_traced, traced, refine_tol);
+                CHECK_RETCODE(ret_code, release_mem);
+                if (traced_step) {
+                    K_new = K_traced;
+                    memcpy(pts, traced, K_new * sizeof(COMPLEX));
+                }
+            }
             
             // Filter the refined roots
             if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-                ret_code = misc_filter(&K_new, roots, NULL,
+                ret_code = misc_filter(&K_new, pts, NULL,
                         opts_ptr->bounding_box);
                 CHECK_RETCODE(ret_code, release_mem);
             }
             if (skip_real_flag != 0) {
-                ret_code = misc_filter_nonreal(&K_new, roots, tol_im);
+                ret_code = misc_filter_nonreal(&K_new, pts, tol_im);
                 CHECK_RETCODE(ret_code, release_mem);
             }
             
@@ -635,7 +797,7 @@ static inline INT subsample_and_refine(const UINT D,
                 K_new = *K_ptr-K;
             }
 
-            memcpy(main_spec+K, roots, K_new * sizeof(COMPLEX));
+            memcpy(main_spec+K, pts, K_new * sizeof(COMPLEX));
             K += K_new;
             if (warn_flags[0] == 1)
                 break; // user-provided array for main spectrum is full
@@ -695,143 +857,281 @@ static inline INT subsample_and_refine(const UINT D,
     *M_ptr = M;
     
     release_mem:
-        free(transfer_matrix);
-        free(p);
-        free(q_preprocessed);
-        free(r_preprocessed);
-        free(qsub_preprocessed);
-        free(rsub_preprocessed);
+        fnft__aligned_free(transfer_matrix);
+        fnft__aligned_free(p);
+        fnft__aligned_free(traced);
+        fnft__aligned_free(trace_buf);
+        fnft__aligned_free(trace_converged);
+        fnft__aligned_free(crit);
+        fnft__aligned_free(crit_val);
+        fnft__aligned_free(crit_h2);
+        fnft__aligned_free(q_preprocessed);
+        fnft__aligned_free(r_preprocessed);
+        fnft__aligned_free(q_spectrum);
+        fnft__aligned_free(qsub_preprocessed);
+        fnft__aligned_free(rsub_preprocessed);
         return ret_code;
 }
 
+// Auxiliary function: Evaluates the monodromy matrices and their derivatives
+// w.r.t. lambda for the K values in lambda. The result has the same format as
+// for nse_scatter_matrix with derivative_flag=1. The values of lambda are
+// split into blocks that are processed concurrently (OpenMP). Each block is
+// passed to nse_scatter_matrix, which still walks over q once per value.
+static INT refine_scatter_matrices(
+        const UINT D, COMPLEX const * const q, COMPLEX const * const r,
+        const REAL eps_t, const INT kappa, const UINT K,
+        COMPLEX const * const lambda, COMPLEX * const result,
+        nse_discretization_t discretization)
+{
+    const UINT nblocks = (K + refine_block_size - 1) / refine_block_size;
+    INT ret_code = SUCCESS;
+    INT b;
+
+    FNFT__OMP(parallel for schedule(dynamic) if(nblocks > 1))
+    for (b = 0; b < (INT)nblocks; b++) {
+        const UINT offset = b*refine_block_size;
+        const UINT len = (K - offset < refine_block_size) ?
+            K - offset : refine_block_size;
+        const INT ret_code_block = nse_scatter_matrix(D, q, r,
+                eps_t, kappa, len, lambda + offset, result + 8*offset,
+                discretization, 1);
+        if (ret_code_block != SUCCESS) {
+            FNFT__OMP(critical)
+            ret_code = ret_code_block;
+        }
+    }
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    return SUCCESS;
+}
+
 // Auxiliary function: Uses Newton's method for roots of higher order to refine the main spectrum.
+// All main spectrum estimates that have not yet converged are refined
+// simultaneously. Per iteration and tested root order m, the monodromy
+// matrices for all estimates that still need this m are computed in one call
+// of refine_scatter_matrices. The iterates and the number of evaluations are
+// the same as if the estimates were refined one after another. If converged
+// is not NULL, converged[k] is set to 1 if |f| < tol has been reached for the
+// k-th estimate and to 0 else.
 static inline INT refine_mainspec(
         const UINT D, COMPLEX const * const q, COMPLEX * r,
         const REAL eps_t, const UINT K,
         COMPLEX * const mainspec,
         const UINT max_evals, const REAL rhs, const REAL tol,
-        const INT kappa, nse_discretization_t discretization)
+        const INT kappa, nse_discretization_t discretization,
+        INT * const converged)
 {
-    UINT k;
-    COMPLEX M[8];
-    COMPLEX lam, f, f_prime, incr, tmp, next_f, next_f_prime;
-    REAL cur_abs, min_abs;
-    UINT nevals;
-    INT ret_code;
-    UINT m, best_m;
+    UINT k, i, K_active, K_search;
+    COMPLEX f, f_prime, tmp;
+    REAL cur_abs;
+    INT ret_code = SUCCESS;
+    UINT m;
     const UINT max_m = 2; // roots might be single or double
-    
-    if (max_evals == 0)
+    COMPLEX * lambda = NULL;
+    COMPLEX * M = NULL;
+    COMPLEX * next_f = NULL;
+    COMPLEX * next_f_prime = NULL;
+    COMPLEX * incr = NULL;
+    REAL * min_abs = NULL;
+    UINT * best_m = NULL;
+    UINT * active = NULL;
+    UINT * search = NULL;
+    UINT * nevals = NULL;
+
+    if (max_evals == 0 || K == 0)
         return SUCCESS;
 
-    for (k=0; k<K; k++) { // Iterate over the provided main spectrum estimates.
-        
-        // Initilization. Computes the monodromy matrix at the current main
-        // spectrum estimate lam and determines the value of
-        // f=a(lam)+a~(lam)+rhs as well as of f' = df/dlam. (The main spectrum
-        // consists of the roots of f for rhs=+/- 2.0.)
-        
-        ret_code = nse_scatter_matrix(D, q, r, eps_t, kappa, 1,
-                &mainspec[k], M, discretization, 1);
-        if (ret_code != SUCCESS)
-            return E_SUBROUTINE(ret_code);
-        next_f = M[0] + M[3] + rhs; // f = a(lam) + atil(lam) + rhs
-        next_f_prime = M[4] + M[7] ; // f' = a'(lam) + atil'(lam)
-        
-        // Iteratively refine the current main spectrum point by applying
-
-        // Newton's method for higher order roots: next_x=x-m*f/f', where
-        // m is the order of the root. Since we do not know m, several values
-        // are tested in a line search-like procedure. Per iterion, max_m
-        // values of m are tested, leading to max_m monodromoy mat evaluations.
-        for (nevals=1; nevals<=max_evals;) {
-            // The current values of f and f' at lam = mainspec[k]
-            f = next_f;
-            f_prime = next_f_prime;
-            if (f_prime == 0.0)
-                return E_DIV_BY_ZERO;
-            incr = f / f_prime;
-            // Test different increments to deal with the many higher order
-            // roots (Newton's method for a root of order m is x<-x-m*f/f').
-            min_abs = INFINITY;
-            best_m = 1;
-            for (m=1; m<=max_m; m++) {
-                lam = mainspec[k] - m*incr;
-                ret_code = nse_scatter_matrix(D, q, r, eps_t, kappa, 1, &lam, M, discretization, 1);
-
-                if (ret_code != SUCCESS)
-                    return E_SUBROUTINE(ret_code);
-                nevals++;
-                tmp = M[0] + M[3] + rhs;
+    lambda = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    M = fnft__aligned_malloc(8*K * sizeof(COMPLEX));
+    next_f = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    next_f_prime = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    incr = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    min_abs = fnft__aligned_malloc(K * sizeof(REAL));
+    best_m = fnft__aligned_malloc(K * sizeof(UINT));
+    active = fnft__aligned_malloc(K * sizeof(UINT));
+    search = fnft__aligned_malloc(K * sizeof(UINT));
+    nevals = fnft__aligned_malloc(K * sizeof(UINT));
+    if (lambda == NULL || M == NULL || next_f == NULL || next_f_prime == NULL
+            || incr == NULL || min_abs == NULL || best_m == NULL
+            || active == NULL || search == NULL || nevals == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Initilization. Computes the monodromy matrices at the provided main
+    // spectrum estimates lam and determines the values of
+    // f=a(lam)+a~(lam)+rhs as well as of f' = df/dlam. (The main spectrum
+    // consists of the roots of f for rhs=+/- 2.0.)
+    ret_code = refine_scatter_matrices(D, q, r, eps_t, kappa, K, mainspec, M,
+            discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (k=0; k<K; k++) {
+        next_f[k] = M[8*k] + M[8*k+3] + rhs; // f = a(lam) + atil(lam) + rhs
+        next_f_prime[k] = M[8*k+4] + M[8*k+7] ; // f' = a'(lam) + atil'(lam)
+        nevals[k] = 1;
+        active[k] = k;
+        if (converged != NULL)
+            converged[k] = 0;
+    }
+    K_active = K;
+
+    // Iteratively refine the main spectrum points by applying
+    // Newton's method for higher order roots: next_x=x-m*f/f', where
+    // m is the order of the root. Since we do not know m, several values
+    // are tested in a line search-like procedure. Per iterion, up to max_m
+    // values of m are tested, leading to up to max_m monodromoy mat
+    // evaluations.
+    while (K_active > 0) {
+
+        // The current values of f and f' at lam = mainspec[k]
+        for (i=0; i<K_active; i++) {
+            k = active[i];
+            f = next_f[k];
+            f_prime = next_f_prime[k];
+            if (f_prime == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto leave_fun;
+            }
+            incr[k] = f / f_prime;
+            min_abs[k] = INFINITY;
+            best_m[k] = 1;
+            search[i] = k;
+        }
+        K_search = K_active;
+
+        // Test different increments to deal with the many higher order
+        // roots (Newton's method for a root of order m is x<-x-m*f/f').
+        // Estimates for which |f| < tol has been reached are not tested
+        // for the remaining values of m.
+        for (m=1; m<=max_m && K_search>0; m++) {
+            for (i=0; i<K_search; i++)
+                lambda[i] = mainspec[search[i]] - m*incr[search[i]];
+            ret_code = refine_scatter_matrices(D, q, r, eps_t, kappa,
+                    K_search, lambda, M, discretization);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            UINT K_still_searching = 0;
+            for (i=0; i<K_search; i++) {
+                k = search[i];
+                nevals[k]++;
+                tmp = M[8*i] + M[8*i+3] + rhs;
                 cur_abs = CABS(tmp);
                 // keep this m if the new value of |f| would be lower than the
                 // ones for the previously tested values of m
-                if ( cur_abs < min_abs ) {
-                    min_abs = cur_abs;
-                    best_m = m;
-                    next_f = tmp;
-                    next_f_prime = M[4] + M[7];
+                if ( cur_abs < min_abs[k] ) {
+                    min_abs[k] = cur_abs;
+                    best_m[k] = m;
+                    next_f[k] = tmp;
+                    next_f_prime[k] = M[8*i+4] + M[8*i+7];
                     if ( cur_abs < tol )
-                        break;
+                        continue;
                 }
-            }            
-            mainspec[k] -= best_m*incr; // Newton step
-            //printf("MAIN k=%zu, nevals=%zu: lam=%e+%ej, |f|=%e, |f_prime|=%e, |incr|=%e, best_m=%d\n", k, nevals, CREAL(mainspec[k]), CIMAG(mainspec[k]), CABS(f), CABS(f_prime),CABS(incr),best_m);
+                search[K_still_searching++] = k;
+            }
+            K_search = K_still_searching;
+        }
 
-            if ( min_abs < tol ) {
+        UINT K_still_active = 0;
+        for (i=0; i<K_active; i++) {
+            k = active[i];
+            mainspec[k] -= best_m[k]*incr[k]; // Newton step
+
+            if ( min_abs[k] < tol ) {
                 // We already know f and f_prime at the new mainspec[k], so
                 // let's use that for a final first-order Newton step.
-                if (next_f_prime == 0.0)
-                    return E_DIV_BY_ZERO;
-                mainspec[k] -= next_f / next_f_prime;
-                break;
+                if (next_f_prime[k] == 0.0) {
+                    ret_code = E_DIV_BY_ZERO;
+                    goto leave_fun;
+                }
+                mainspec[k] -= next_f[k] / next_f_prime[k];
+                if (converged != NULL)
+                    converged[k] = 1;
+            } else if (nevals[k] <= max_evals) {
+                active[K_still_active++] = k;
             }
-        };
-        //printf("==> used %zu evaluations\n", nevals);
+        }
+        K_active = K_still_active;
     }
-    return SUCCESS;
+
+leave_fun:
+    fnft__aligned_free(lambda);
+    fnft__aligned_free(M);
+    fnft__aligned_free(next_f);
+    fnft__aligned_free(next_f_prime);
+    fnft__aligned_free(incr);
+    fnft__aligned_free(min_abs);
+    fnft__aligned_free(best_m);
+    fnft__aligned_free(active);
+    fnft__aligned_free(search);
+    fnft__aligned_free(nevals);
+    return ret_code;
 }
 
 // Auxiliary function: Uses Newton's method to refine the aux spectrum.
+// All aux spectrum estimates that have not yet converged are refined
+// simultaneously, as in refine_mainspec.
 static inline INT refine_auxspec(
         const UINT D, COMPLEX const * const q, COMPLEX * r,
         const REAL eps_t, const UINT K,
         COMPLEX * const auxspec, const UINT max_evals, const REAL tol,
         const INT kappa, nse_discretization_t discretization)
 {
-    UINT k, nevals;
-    COMPLEX M[8];
+    UINT k, i, K_active, nevals;
     COMPLEX f, f_prime;
-    INT ret_code;
-    
-    if (max_evals == 0)
+    INT ret_code = SUCCESS;
+    COMPLEX * lambda = NULL;
+    COMPLEX * M = NULL;
+    UINT * active = NULL;
+
+    if (max_evals == 0 || K == 0)
         return SUCCESS;
-    
-    for (k=0; k<K; k++) {
-        
-        for (nevals=0; nevals<max_evals;) {
-            
-            ret_code = nse_scatter_matrix(D, q, r, eps_t, kappa, 1,
-                    &auxspec[k], M, discretization, 1);
-            if (ret_code != SUCCESS)
-                return E_SUBROUTINE(ret_code);
-            nevals++;
-            f = M[1]; // f = b(lam)
-            f_prime = M[5]; // f' = b'(lam)
-            if (f_prime == 0.0)
-                return E_DIV_BY_ZERO;
-            
-            //printf("AUX k=%zu, iter=%zu: lam=%g+%gj, |f|=%g, |f_prime|=%g\n", k, iter, CREAL(auxspec[k]), CIMAG(auxspec[k]), CABS(f), CABS(f_prime));
-            
+
+    lambda = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    M = fnft__aligned_malloc(8*K * sizeof(COMPLEX));
+    active = fnft__aligned_malloc(K * sizeof(UINT));
+    if (lambda == NULL || M == NULL || active == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    for (k=0; k<K; k++)
+        active[k] = k;
+    K_active = K;
+
+    // All active estimates have used the same number of evaluations
+    for (nevals=0; nevals<max_evals && K_active>0;) {
+
+        for (i=0; i<K_active; i++)
+            lambda[i] = auxspec[active[i]];
+        ret_code = refine_scatter_matrices(D, q, r, eps_t, kappa, K_active,
+                lambda, M, discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+        nevals++;
+
+        UINT K_still_active = 0;
+        for (i=0; i<K_active; i++) {
+            k = active[i];
+            f = M[8*i+1]; // f = b(lam)
+            f_prime = M[8*i+5]; // f' = b'(lam)
+            if (f_prime == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto leave_fun;
+            }
 
             auxspec[k] -= f / f_prime;
-            if ( CABS(f) < tol ) // Intentionally put after the previous line
+            if ( !(CABS(f) < tol) ) // Intentionally put after the previous line
                 // => we use the already known values for f and f_prime for a
                 // last Newton step even if already |f|<tol.
-                break;
+                active[K_still_active++] = k;
         }
+        K_active = K_still_active;
     }
-    return SUCCESS;
+
+leave_fun:
+    fnft__aligned_free(lambda);
+    fnft__aligned_free(M);
+    fnft__aligned_free(active);
+    return ret_code;
 }
 
 static inline void update_bounding_box_if_auto(const REAL eps_t,
@@ -862,3 +1162,134 @@ static inline void update_bounding_box_if_auto(const REAL eps_t,
         opts_ptr->bounding_box[2] = -opts_ptr->bounding_box[3];
     }
 }
+
+// Auxiliary function: Returns the even factor of D that is closest to
+// Dsub_desired on a logarithmic scale (the larger one in case of a tie). The
+// subsampled signal q[0], q[D/Dsub], q[2*D/Dsub], ... then covers exactly one
+// period. D has to be even, so that D itself is always a candidate.
+static UINT nsep_choose_Dsub(const UINT D, const UINT Dsub_desired)
+{
+    UINT nskip, Dsub = D;
+    REAL dist, min_dist = INFINITY;
+    const REAL target = Dsub_desired < 2 ? 2.0 : (REAL)Dsub_desired;
+
+    for (nskip = 1; nskip <= D/2; nskip++) {
+        if (D%nskip != 0 || (D/nskip)%2 != 0)
+            continue;
+        dist = FABS(LOG((D/nskip)/target));
+        if (dist < min_dist) {
+            min_dist = dist;
+            Dsub = D/nskip;
+        }
+    }
+    return Dsub;
+}
+
+// Auxiliary function: Finds the real critical points lam_c of the Floquet
+// discriminant, i.e., the real lam_c in the real range of box with
+// Delta'(lam_c)=0. Spines leave (or reach) the real line at these points.
+// On the unit circle, z^(-deg/2)*p(z) is a real multiple of Delta, so that the
+// critical points are the unit circle roots of z*p'(z)-deg/2*p(z). They are
+// located using the subsampled polynomial p, whose center coefficient does
+// not matter here, and then refined with the full signal. The values
+// crit_val = 2*Delta(lam_c) (the trace of the monodromy matrix) and
+// crit_h2 = 2/(2*Delta''(lam_c)) are computed with the full signal as well.
+// crit, crit_val and crit_h2 have to provide space for deg values.
+static INT nsep_spine_critical_points(const UINT D,
+        COMPLEX const * const q, COMPLEX const * const r, const REAL eps_t,
+        const REAL eps_t_sub, const UINT deg, COMPLEX const * const p,
+        const INT kappa, REAL const * const box,
+        nse_discretization_t discretization,
+        nse_discretization_t refine_discretization, UINT * const K_crit_ptr,
+        COMPLEX * const crit, REAL * const crit_val, COMPLEX * const crit_h2)
+{
+    UINT i, iter, K_crit;
+    REAL PHI[2], tmp, delta;
+    COMPLEX * c = NULL;
+    COMPLEX * lambda = NULL;
+    COMPLEX * M = NULL;
+    INT ret_code = SUCCESS;
+
+    c = fnft__aligned_malloc((deg + 1) * sizeof(COMPLEX));
+    if (c == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    for (i=0; i<=deg; i++) // p is stored in descending order
+        c[i] = (deg/2.0 - i) * p[i];
+
+    // Search the part of the unit circle that corresponds to the real range
+    // of the box
+    const REAL map_coeff = 2/nse_discretization_degree(discretization);
+    PHI[0] = map_coeff*eps_t_sub*box[0];
+    PHI[1] = map_coeff*eps_t_sub*box[1];
+    if (PHI[0] > PHI[1]) {
+        tmp = PHI[0];
+        PHI[0] = PHI[1];
+        PHI[1] = tmp;
+    }
+    if (!(PHI[0] > -PI))
+        PHI[0] = -PI;
+    if (!(PHI[1] < PI))
+        PHI[1] = PI;
+
+    K_crit = deg;
+    ret_code = poly_roots_fftgridsearch_blocked(deg, c, oversampling_factor*deg,
+            PHI, 0, &K_crit, crit);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K_crit > deg) {
+        WARN("Found more critical points than memory is available. Ignoring the remaining ones.");
+        K_crit = deg;
+    }
+    ret_code = nse_discretization_z_to_lambda(K_crit, eps_t_sub, crit,
+            discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (i=0; i<K_crit; i++)
+        crit[i] = CREAL(crit[i]);
+    ret_code = misc_filter(&K_crit, crit, NULL, box);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The critical points of the subsampled signal are polished with a few
+    // Newton steps on Delta' of the full signal. Delta'' is approximated by a
+    // finite difference of Delta' in the direction of the imaginary axis,
+    // where the step is scaled with the critical point. The values of the
+    // last evaluation provide crit_val and crit_h2.
+    lambda = fnft__aligned_malloc(2*K_crit * sizeof(COMPLEX));
+    M = fnft__aligned_malloc(16*K_crit * sizeof(COMPLEX));
+    if (lambda == NULL || M == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    for (iter=0; iter<=crit_newton_steps && K_crit>0; iter++) {
+        for (i=0; i<K_crit; i++) {
+            delta = SQRT(EPSILON) * (FABS(CREAL(crit[i])) > 1.0 ?
+                FABS(CREAL(crit[i])) : 1.0);
+            lambda[2*i] = crit[i];
+            lambda[2*i + 1] = crit[i] + I*delta;
+        }
+        ret_code = refine_scatter_matrices(D, q, r, eps_t, kappa, 2*K_crit,
+                lambda, M, refine_discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+        for (i=0; i<K_crit; i++) {
+            COMPLEX const * const M0 = M + 16*i;
+            COMPLEX const * const M1 = M0 + 8;
+            const COMPLEX d1 = M0[4] + M0[7];
+            const COMPLEX d2 = ((M1[4] + M1[7]) - d1)
+                / (lambda[2*i + 1] - lambda[2*i]);
+            if (iter < crit_newton_steps) {
+                if (d2 != 0.0 && isfinite(CREAL(d1/d2)))
+                    crit[i] -= CREAL(d1/d2); // Newton step
+            } else {
+                crit_val[i] = CREAL(M0[0] + M0[3]);
+                crit_h2[i] = (d2 != 0.0) ? 2.0/d2 : 0.0;
+            }
+        }
+    }
+    *K_crit_ptr = K_crit;
+
+leave_fun:
+    fnft__aligned_free(c);
+    fnft__aligned_free(lambda);
+    fnft__aligned_free(M);
+    return ret_code;
+}
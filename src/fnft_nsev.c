@@ -22,6 +22,11 @@
 #define FNFT_ENABLE_SHORT_NAMES
 
 #include "fnft_nsev.h"
+#include "fnft__allocator.h"
+#include "fnft__poly_roots_count.h"
+#include "fnft__poly_roots_annulus.h"
+#include "fnft__parallel.h"
+#include "fnft__file.h"
 
 static fnft_nsev_opts_t default_opts = {
     .bound_state_filtering = nsev_bsfilt_FULL,
@@ -32,7 +37,8 @@ static fnft_nsev_opts_t default_opts = {
     .contspec_type = nsev_cstype_REFLECTION_COEFFICIENT,
     .normalization_flag = 1,
     .discretization = nse_discretization_2SPLIT4B,
-    .richardson_extrapolation_flag = 0
+    .richardson_extrapolation_flag = 0,
+    .K_tracked = 0
 };
 
 /**
@@ -66,7 +72,7 @@ static inline INT nsev_compute_boundstates(
         COMPLEX const * const q,
         COMPLEX * r,
         const UINT deg,
-        COMPLEX * const transfer_matrix,
+        COMPLEX const * const transfer_matrix,
         REAL const * const T,
         const REAL eps_t,
         UINT * const K_ptr,
@@ -90,7 +96,7 @@ static inline INT fnft_nsev_base(
 static inline INT nsev_compute_contspec(
         const UINT deg,
         const INT W,
-        COMPLEX * const transfer_matrix,
+        COMPLEX const * const transfer_matrix,
         COMPLEX const * const q,
         COMPLEX * r,
         REAL const * const T,
@@ -111,6 +117,47 @@ static inline INT nsev_compute_normconsts_or_residues(
         COMPLEX * const normconsts_or_residues,
         fnft_nsev_opts_t * const opts);
 
+static inline INT nsev_count_boundstates(
+        const UINT D,
+        COMPLEX * const q,
+        REAL const * const T,
+        REAL * const bounding_box,
+        UINT * const count_ptr,
+        fnft_nsev_opts_t const * const opts);
+
+static INT nsev_first_approximation(
+        const UINT D,
+        COMPLEX * const q,
+        REAL const * const T,
+        const UINT D_effective,
+        COMPLEX * const q_preprocessed,
+        COMPLEX * r_preprocessed,
+        COMPLEX ** const q_spectrum_ptr,
+        const UINT M,
+        COMPLEX * const contspec,
+        REAL const * const XI,
+        UINT * const K_ptr,
+        COMPLEX * const bound_states,
+        COMPLEX * const normconsts_or_residues,
+        const INT kappa,
+        const INT tracking,
+        fnft_nsev_opts_t * const opts);
+
+static INT nsev_second_approximation(
+        const UINT D,
+        COMPLEX * const q,
+        REAL const * const T,
+        const INT kappa,
+        COMPLEX * q_spectrum,
+        UINT * const Dsub_ptr,
+        COMPLEX ** const qsub_preprocessed_ptr,
+        COMPLEX ** const rsub_preprocessed_ptr,
+        REAL * const Tsub,
+        const UINT M,
+        COMPLEX * const contspec_sub,
+        REAL const * const XI,
+        fnft_nsev_opts_t * const opts);
+
 static inline INT nsev_refine_bound_states_newton(const UINT D,
         COMPLEX const * const q,
         COMPLEX * r,
@@ -147,17 +194,26 @@ INT fnft_nsev(
     COMPLEX *rsub_preprocessed = NULL;
     COMPLEX *q_preprocessed = NULL;
     COMPLEX *r_preprocessed = NULL;
+    COMPLEX *q_spectrum = NULL;
     UINT Dsub = 0;
     REAL Tsub[2] = {0.0 ,0.0};
     UINT first_last_index[2] = {0};
-    UINT K_sub;
+    UINT K_sub = 0;
     COMPLEX *contspec_sub = NULL;
     COMPLEX *bound_states_sub = NULL;
     COMPLEX *normconsts_or_residues_sub = NULL;
     COMPLEX *normconsts_or_residues_reserve = NULL;
-    INT bs_loc_opt = 0, ds_type_opt = 0;
-    INT ret_code = SUCCESS;
-    UINT i, j, upsampling_factor, D_effective, nskip_per_step;
+    UINT *loc = NULL;
+    INT ds_type_opt = 0;
+    INT tracking = 0;
+    INT richardson = 0;
+    UINT contspec_len = 0;
+    UINT method_order = 0;
+    INT separate_contspec = 0;
+    UINT nthreads = 1;
+    fnft_nsev_opts_t opts_sub, opts_contspec;
+    INT ret_code = SUCCESS, ret_code_sub = SUCCESS, ret_code_contspec = SUCCESS;
+    UINT i, j, upsampling_factor, D_effective;
 
     // Check inputs
     if (D < 2)
@@ -178,6 +234,14 @@ INT fnft_nsev(
     }
     if (opts == NULL)
         opts = &default_opts;
+    if (kappa == +1 && bound_states != NULL
+            && opts->bound_state_localization == nsev_bsloc_TRACKING) {
+        if (opts->K_tracked > *K_ptr)
+            return E_INVALID_ARGUMENT(opts->K_tracked);
+        tracking = 1;
+    }
+    richardson = (opts->richardson_extrapolation_flag == 1);
+    ds_type_opt = opts->discspec_type;
 
     // This switch checks for incompatible bound_state_localization options
     switch (opts->discretization) {
@@ -249,11 +313,10 @@ INT fnft_nsev(
     // Richardson extrpolation is applied on normconsts(b) and aprimes separately
     // before combining the results to get the residues=normconsts/aprimes.
     // Hence double the memory is necessary even if the user requests only residues.
-    if (opts->richardson_extrapolation_flag == 1){
-        ds_type_opt = opts->discspec_type;
+    if (richardson){
         if (ds_type_opt == nsev_dstype_RESIDUES){
             opts->discspec_type = nsev_dstype_BOTH;
-            normconsts_or_residues_reserve = malloc(*K_ptr*2 * sizeof(COMPLEX));
+            normconsts_or_residues_reserve = fnft__aligned_malloc(*K_ptr*2 * sizeof(COMPLEX));
             if (normconsts_or_residues_reserve == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
@@ -270,52 +333,11 @@ INT fnft_nsev(
     // the auxiliary functions thus helping efficiency.
     Dsub = D;
     ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &q_preprocessed, &r_preprocessed,
-            first_last_index, opts->discretization);
+            first_last_index, opts->discretization, &q_spectrum);
     CHECK_RETCODE(ret_code, leave_fun);
 
-    if (kappa == +1 && bound_states != NULL && opts->bound_state_localization == nsev_bsloc_SUBSAMPLE_AND_REFINE) {
-        // the mixed method gets special treatment
-
-        // First step: Find initial guesses for the bound states using the
-        // fast eigenvalue method. To bound the complexity, a subsampled
-        // version of q, qsub, will be passed to the fast eigenroutine.
-        Dsub = opts->Dsub;
-        if (Dsub == 0) // The user wants us to determine Dsub
-            Dsub = SQRT(D * LOG2(D) * LOG2(D));
-        nskip_per_step = ROUND((REAL)D / Dsub);
-        Dsub = ROUND((REAL)D / nskip_per_step); // actual Dsub
-
-        ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &qsub_preprocessed, &rsub_preprocessed,
-                first_last_index, opts->discretization);
-        CHECK_RETCODE(ret_code, leave_fun);
-
-        Tsub[0] = T[0] + first_last_index[0] * eps_t;
-        Tsub[1] = T[0] + first_last_index[1] * eps_t;
-
-        // Fixed bound states of qsub using the fast eigenvalue method
-        opts->bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
-        ret_code = fnft_nsev_base(Dsub * upsampling_factor, qsub_preprocessed, rsub_preprocessed, Tsub, 0, NULL, XI, K_ptr,
-                bound_states, NULL, kappa, opts);
-        CHECK_RETCODE(ret_code, leave_fun);
-
-        // Second step: Refine the found bound states using Newton's method
-        // on the full signal and compute continuous spectrum
-        opts->bound_state_localization = nsev_bsloc_NEWTON;
-        ret_code = fnft_nsev_base(D_effective, q_preprocessed, r_preprocessed, T, M, contspec, XI, K_ptr,
-                bound_states, normconsts_or_residues_reserve, kappa, opts);
-        CHECK_RETCODE(ret_code, leave_fun);
-
-        // Restore original state of opts
-        opts->bound_state_localization = nsev_bsloc_SUBSAMPLE_AND_REFINE;
-    } else {
-        ret_code = fnft_nsev_base(D_effective, q_preprocessed, r_preprocessed, T, M, contspec, XI, K_ptr,
-                    bound_states, normconsts_or_residues, kappa, opts);
-        CHECK_RETCODE(ret_code, leave_fun);
-    }
-
-    if (opts->richardson_extrapolation_flag == 1){
+    if (richardson){
         // Allocating memory
-        UINT contspec_len = 0;
         if (contspec != NULL && M > 0){
             switch (opts->contspec_type) {
                 case nsev_cstype_BOTH:
@@ -331,17 +353,93 @@ INT fnft_nsev(
                     ret_code = E_INVALID_ARGUMENT(opts->contspec_type);
                     goto leave_fun;
             }
-            contspec_sub = malloc(contspec_len * sizeof(COMPLEX));
+            contspec_sub = fnft__aligned_malloc(contspec_len * sizeof(COMPLEX));
             if (contspec_sub == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
             }
         }
-        UINT discspec_len = 0;
+        method_order = nse_discretization_method_order(opts->discretization);
+        if (method_order == 0){
+            ret_code =  E_INVALID_ARGUMENT(discretization);
+            goto leave_fun;
+        }
+
+        // The second approximation uses its own copy of the options since
+        // the first approximation changes opts temporarily
+        opts_sub = *opts;
+        opts_sub.bound_state_localization = nsev_bsloc_NEWTON;
+    }
+
+    // The TRACKING and SUBSAMPLE_AND_REFINE methods localize the bound
+    // states of the full signal with Newton's method, which does not need
+    // the transfer matrix. The continuous spectrum of the full signal is
+    // then computed separately (with a copy of the options, since the
+    // localization changes opts temporarily).
+    if (contspec != NULL && M > 0 && kappa == +1 && bound_states != NULL
+            && (tracking || opts->bound_state_localization
+                    == nsev_bsloc_SUBSAMPLE_AND_REFINE)) {
+        separate_contspec = 1;
+        opts_contspec = *opts;
+    }
+
+    // The following computations do not depend on each other and are run
+    // concurrently: the first approximation of the spectrum, which uses all
+    // samples, the continuous spectrum of the full signal if it is computed
+    // separately (see above), and the continuous spectrum of the second
+    // approximation for Richardson extrapolation, which uses about half of
+    // the samples. The bound states of the second approximation are
+    // obtained by refining those of the first approximation and are
+    // therefore computed afterwards.
+    // The first approximation writes q_spectrum, which is why the second
+    // approximation works on its own copy of the pointer.
+    nthreads = 1 + richardson + separate_contspec;
+#ifdef HAVE_OPENMP
+    if (nthreads > (UINT)omp_get_max_threads())
+        nthreads = omp_get_max_threads();
+#endif
+    FNFT__OMP(parallel num_threads(nthreads) if(nthreads > 1))
+    FNFT__OMP(single)
+    {
+        FNFT__OMP(task firstprivate(q_spectrum))
+        if (richardson) {
+            ret_code_sub = nsev_second_approximation(D, q, T, kappa, q_spectrum,
+                    &Dsub, &qsub_preprocessed, &rsub_preprocessed, Tsub,
+                    M, contspec_sub, XI, &opts_sub);
+        }
+
+        FNFT__OMP(task)
+        if (separate_contspec) {
+            ret_code_contspec = fnft_nsev_base(D_effective, q_preprocessed,
+                    r_preprocessed, T, M, contspec, XI, NULL, NULL, NULL,
+                    kappa, &opts_contspec);
+        }
+
+        ret_code = nsev_first_approximation(D, q, T, D_effective, q_preprocessed,
+                r_preprocessed, &q_spectrum, separate_contspec ? 0 : M,
+                separate_contspec ? NULL : contspec, XI, K_ptr, bound_states,
+                normconsts_or_residues_reserve, kappa, tracking, opts);
+
+        FNFT__OMP(taskwait)
+    }
+    if (ret_code == SUCCESS)
+        ret_code = ret_code_contspec;
+    if (ret_code == SUCCESS)
+        ret_code = ret_code_sub;
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    if (tracking) {
+        opts->bound_state_localization = nsev_bsloc_TRACKING;
+        opts->K_tracked = *K_ptr;
+    }
+
+    if (richardson){
+        // Refine the bound states of the first approximation using Newton's
+        // method on the subsampled signal
         if (kappa == +1 && bound_states != NULL && *K_ptr != 0) {
             K_sub = *K_ptr;
-            bound_states_sub = malloc(K_sub * sizeof(COMPLEX));
-            discspec_len = K_sub;
+            bound_states_sub = fnft__aligned_malloc(K_sub * sizeof(COMPLEX));
+            UINT discspec_len = K_sub;
             switch (opts->discspec_type) {
                 case nsev_dstype_BOTH:
                 case nsev_dstype_RESIDUES:
@@ -354,49 +452,26 @@ INT fnft_nsev(
                     ret_code = E_INVALID_ARGUMENT(opts->discspec_type);
                     goto leave_fun;
             }
-            normconsts_or_residues_sub = malloc(discspec_len * sizeof(COMPLEX));
+            normconsts_or_residues_sub = fnft__aligned_malloc(discspec_len * sizeof(COMPLEX));
             if (normconsts_or_residues_sub == NULL || bound_states_sub == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
             }
             for (i=0; i<K_sub; i++)
                 bound_states_sub[i] = bound_states[i];
-        }
-        UINT method_order;
-        method_order = nse_discretization_method_order(opts->discretization);
-        if (method_order == 0){
-            ret_code =  E_INVALID_ARGUMENT(discretization);
-            goto leave_fun;
-        }
-
-        // The signal q is now subsampled(approx. half the samples) and 
-        // preprocessed as required for the discretization. This is
-        // required for obtaining a second approximation of the spectrum
-        // which will be used for Richardson extrapolation.
-        Dsub = CEIL(D/2);        
-        ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &qsub_preprocessed, &rsub_preprocessed,
-                first_last_index, opts->discretization);
-        CHECK_RETCODE(ret_code, leave_fun);
-
-        Tsub[0] = T[0] + first_last_index[0]*eps_t;
-        Tsub[1] = T[0] + first_last_index[1]*eps_t;
-        const REAL eps_t_sub = (Tsub[1] - Tsub[0])/(Dsub - 1);
-
-        // Calling fnft_nsev_base with subsampled signal
-        bs_loc_opt = opts->bound_state_localization;
-        opts->bound_state_localization = nsev_bsloc_NEWTON;
 
-        ret_code = fnft_nsev_base(Dsub * upsampling_factor, qsub_preprocessed, rsub_preprocessed, Tsub, M, contspec_sub, XI, &K_sub,
-                bound_states_sub, normconsts_or_residues_sub, kappa, opts);
-        CHECK_RETCODE(ret_code, leave_fun);
-        opts->bound_state_localization = bs_loc_opt;
+            ret_code = fnft_nsev_base(Dsub * upsampling_factor, qsub_preprocessed, rsub_preprocessed, Tsub, 0, NULL, XI, &K_sub,
+                    bound_states_sub, normconsts_or_residues_sub, kappa, &opts_sub);
+            CHECK_RETCODE(ret_code, leave_fun);
+        }
         opts->discspec_type = ds_type_opt;
+        const REAL eps_t_sub = (Tsub[1] - Tsub[0])/(Dsub - 1);
         
         // Richardson extrapolation of the continuous spectrum
         REAL const scl_num = POW(eps_t_sub/eps_t,method_order);
         REAL const scl_den = scl_num - 1.0;
-        REAL const dxi = (XI[1]-XI[0])/(M-1);
         if (contspec != NULL && M > 0){
+            REAL const dxi = (XI[1]-XI[0])/(M-1);
             for (i=0; i<M; i++){
                 if (FABS(XI[0]+dxi*i) < 0.9*PI/(2.0*eps_t_sub)){
                     for (j=0; j<contspec_len; j+=M)
@@ -406,29 +481,26 @@ INT fnft_nsev(
         }
         // Richardson extrapolation of the discrete spectrum
         if (kappa == +1 && bound_states != NULL && *K_ptr != 0 && K_sub != 0) {
-            UINT loc = K_sub;
-            REAL bs_err_thres = eps_t;
-            REAL bs_err = eps_t;
             UINT K = *K_ptr;            
             
+            loc = fnft__malloc(K * sizeof(UINT));
+            if (loc == NULL) {
+                ret_code = E_NOMEM;
+                goto leave_fun;
+            }
+            ret_code = misc_match_nearest(K, bound_states, K_sub,
+                    bound_states_sub, eps_t, loc);
+            CHECK_RETCODE(ret_code, leave_fun);
+
             for (i=0; i<K; i++){
-                loc = K_sub;
-                bs_err_thres = eps_t;
-                for (j=0; j<K_sub; j++){
-                    bs_err = CABS(bound_states[i]-bound_states_sub[j])/CABS(bound_states[i]);
-                    if (bs_err < bs_err_thres){
-                        bs_err_thres = bs_err;
-                        loc = j;
-                    }
-                }
-                if (loc < K_sub){
-                    bound_states[i] = (scl_num*bound_states[i] - bound_states_sub[loc])/scl_den;
+                if (loc[i] < K_sub){
+                    bound_states[i] = (scl_num*bound_states[i] - bound_states_sub[loc[i]])/scl_den;
                     if (ds_type_opt == nsev_dstype_RESIDUES || ds_type_opt == nsev_dstype_BOTH){
                         // Computing aprimes from residues and norming constants
                         normconsts_or_residues_reserve[K+i] = normconsts_or_residues_reserve[i]/normconsts_or_residues_reserve[K+i];
-                        normconsts_or_residues_sub[K_sub+loc] = normconsts_or_residues_sub[loc]/normconsts_or_residues_sub[K_sub+loc];
+                        normconsts_or_residues_sub[K_sub+loc[i]] = normconsts_or_residues_sub[loc[i]]/normconsts_or_residues_sub[K_sub+loc[i]];
                         // Richardson step on aprime
-                        normconsts_or_residues_reserve[K+i] = (scl_num*normconsts_or_residues_reserve[K+i] - normconsts_or_residues_sub[loc+K_sub])/scl_den;
+                        normconsts_or_residues_reserve[K+i] = (scl_num*normconsts_or_residues_reserve[K+i] - normconsts_or_residues_sub[loc[i]+K_sub])/scl_den;
                         // Computing residue
                         normconsts_or_residues_reserve[K+i] = normconsts_or_residues_reserve[i]/normconsts_or_residues_reserve[K+i];
                     }
@@ -442,16 +514,443 @@ INT fnft_nsev(
     }
 
     leave_fun:
-        free(qsub_preprocessed);
-        free(rsub_preprocessed);
-        free(q_preprocessed);
-        free(r_preprocessed);
-        free(contspec_sub);
-        free(bound_states_sub);
-        free(normconsts_or_residues_sub);
+        if (tracking)
+            opts->bound_state_localization = nsev_bsloc_TRACKING;
+        if (richardson)
+            opts->discspec_type = ds_type_opt;
+        if (normconsts_or_residues_reserve != normconsts_or_residues)
+            fnft__aligned_free(normconsts_or_residues_reserve);
+        fnft__aligned_free(qsub_preprocessed);
+        fnft__aligned_free(rsub_preprocessed);
+        fnft__aligned_free(q_preprocessed);
+        fnft__aligned_free(r_preprocessed);
+        fnft__aligned_free(q_spectrum);
+        fnft__aligned_free(contspec_sub);
+        fnft__aligned_free(bound_states_sub);
+        fnft__aligned_free(normconsts_or_residues_sub);
+        fnft__free(loc);
         return ret_code;
 }
 
+INT fnft_nsev_transfer_matrix(
+        const UINT D,
+        COMPLEX const * const q,
+        REAL const * const T,
+        const INT kappa,
+        fnft_nsev_transfer_matrix_t * const tm,
+        fnft_nsev_opts_t const * opts)
+{
+    UINT Dsub = 0;
+    UINT first_last_index[2] = {0};
+    INT ret_code = SUCCESS;
+    UINT i, upsampling_factor;
+
+    // Check inputs
+    if (tm == NULL)
+        return E_INVALID_ARGUMENT(tm);
+    tm->transfer_matrix = NULL;
+    tm->q = NULL;
+    tm->q_preprocessed = NULL;
+    tm->r_preprocessed = NULL;
+    tm->file_data = NULL;
+    tm->file_size = 0;
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    if (opts == NULL)
+        opts = &default_opts;
+
+    upsampling_factor = nse_discretization_upsampling_factor(opts->discretization);
+    if (upsampling_factor == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+    // Only discretizations with a polynomial transfer matrix are supported
+    i = nse_fscatter_numel(D * upsampling_factor, opts->discretization);
+    if (i == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+
+    tm->D = D;
+    tm->T[0] = T[0];
+    tm->T[1] = T[1];
+    tm->eps_t = (T[1] - T[0])/(D - 1);
+    tm->kappa = kappa;
+    tm->discretization = opts->discretization;
+    tm->deg = 0;
+    tm->W = 0;
+    tm->D_effective = D * upsampling_factor;
+
+    tm->q = fnft__aligned_malloc(D * sizeof(COMPLEX));
+    tm->transfer_matrix = fnft__aligned_malloc(i * sizeof(COMPLEX));
+    if (tm->q == NULL || tm->transfer_matrix == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    memcpy(tm->q, q, D * sizeof(COMPLEX));
+
+    // Preprocess the signal as in fnft_nsev
+    Dsub = D;
+    ret_code = nse_discretization_preprocess_signal(D, q, tm->eps_t, kappa,
+            &Dsub, &tm->q_preprocessed, &tm->r_preprocessed, first_last_index,
+            opts->discretization, NULL);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Compute the transfer matrix
+    ret_code = nse_fscatter(tm->D_effective, tm->q_preprocessed, tm->eps_t,
+            kappa, tm->transfer_matrix, &tm->deg,
+            opts->normalization_flag ? &tm->W : NULL, opts->discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        fnft_nsev_transfer_matrix_free(tm);
+    return ret_code;
+}
+
+INT fnft_nsev_from_transfer_matrix(
+        fnft_nsev_transfer_matrix_t const * const tm,
+        const UINT M,
+        COMPLEX * const contspec,
+        REAL const * const XI,
+        UINT * const K_ptr,
+        COMPLEX * const bound_states,
+        COMPLEX * const normconsts_or_residues,
+        fnft_nsev_opts_t *opts)
+{
+    COMPLEX *q_spectrum = NULL;
+    fnft_nsev_opts_t opts_tm;
+    INT tracking = 0;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (tm == NULL || tm->transfer_matrix == NULL || tm->q == NULL
+            || tm->q_preprocessed == NULL)
+        return E_INVALID_ARGUMENT(tm);
+    if (contspec != NULL) {
+        if (XI == NULL || XI[0] >= XI[1])
+            return E_INVALID_ARGUMENT(XI);
+    }
+    if (bound_states != NULL) {
+        if (K_ptr == NULL)
+            return E_INVALID_ARGUMENT(K_ptr);
+    }
+    if (opts == NULL)
+        opts = &default_opts;
+    if (opts->richardson_extrapolation_flag != 0)
+        return E_INVALID_ARGUMENT(opts->richardson_extrapolation_flag);
+    if (tm->kappa == +1 && bound_states != NULL
+            && opts->bound_state_localization == nsev_bsloc_TRACKING) {
+        if (opts->K_tracked > *K_ptr)
+            return E_INVALID_ARGUMENT(opts->K_tracked);
+        tracking = 1;
+    }
+
+    // The routines below change the options temporarily, which is done on
+    // a copy so that the transfer matrix can be queried concurrently with
+    // the same options
+    opts_tm = *opts;
+    opts_tm.discretization = tm->discretization;
+
+    // Compute the continuous spectrum
+    if (contspec != NULL && M > 0) {
+        ret_code = nsev_compute_contspec(tm->deg, tm->W, tm->transfer_matrix,
+                tm->q_preprocessed, tm->r_preprocessed, tm->T, tm->D_effective,
+                XI, M, contspec, tm->kappa, &opts_tm);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+    // Compute the discrete spectrum
+    if (tm->kappa == +1 && bound_states != NULL) {
+        switch (opts_tm.bound_state_localization) {
+            case nsev_bsloc_FAST_EIGENVALUE:
+            case nsev_bsloc_NEWTON:
+                ret_code = nsev_compute_boundstates(tm->D_effective,
+                        tm->q_preprocessed, tm->r_preprocessed, tm->deg,
+                        tm->transfer_matrix, tm->T, tm->eps_t, K_ptr,
+                        bound_states, &opts_tm);
+                CHECK_RETCODE(ret_code, leave_fun);
+                if (normconsts_or_residues != NULL && *K_ptr != 0) {
+                    ret_code = nsev_compute_normconsts_or_residues(
+                            tm->D_effective, tm->q_preprocessed,
+                            tm->r_preprocessed, tm->T, *K_ptr, bound_states,
+                            normconsts_or_residues, &opts_tm);
+                    CHECK_RETCODE(ret_code, leave_fun);
+                }
+                break;
+            case nsev_bsloc_SUBSAMPLE_AND_REFINE:
+            case nsev_bsloc_TRACKING:
+                // These methods work on subsampled versions of the signal
+                // and on the signal itself, the transfer matrix is not
+                // needed
+                ret_code = nsev_first_approximation(tm->D, tm->q, tm->T,
+                        tm->D_effective, tm->q_preprocessed,
+                        tm->r_preprocessed, &q_spectrum, 0, NULL, XI, K_ptr,
+                        bound_states, normconsts_or_residues, tm->kappa,
+                        tracking, &opts_tm);
+                CHECK_RETCODE(ret_code, leave_fun);
+                if (tracking)
+                    opts->K_tracked = *K_ptr;
+                break;
+            default:
+                ret_code = E_INVALID_ARGUMENT(opts->bound_state_localization);
+                goto leave_fun;
+        }
+    } else if (K_ptr != NULL) {
+        *K_ptr = 0;
+    }
+
+leave_fun:
+    fnft__aligned_free(q_spectrum);
+    return ret_code;
+}
+
+void fnft_nsev_transfer_matrix_free(fnft_nsev_transfer_matrix_t * const tm)
+{
+    if (tm == NULL)
+        return;
+    if (tm->file_data != NULL) {
+        // The arrays point into the contents of a file
+        file_unmap(tm->file_data, tm->file_size);
+    } else {
+        fnft__aligned_free(tm->transfer_matrix);
+        fnft__aligned_free(tm->q);
+        fnft__aligned_free(tm->q_preprocessed);
+        fnft__aligned_free(tm->r_preprocessed);
+    }
+    tm->transfer_matrix = NULL;
+    tm->q = NULL;
+    tm->q_preprocessed = NULL;
+    tm->r_preprocessed = NULL;
+    tm->file_data = NULL;
+    tm->file_size = 0;
+}
+
+// Auxiliary function: Computes the first approximation of the spectrum,
+// which uses all samples, with the bound state localization method chosen
+// in opts. The signal has already been preprocessed by fnft_nsev. The
+// subsampled signals that are needed by the TRACKING and
+// SUBSAMPLE_AND_REFINE methods are preprocessed here.
+static INT nsev_first_approximation(
+        const UINT D,
+        COMPLEX * const q,
+        REAL const * const T,
+        const UINT D_effective,
+        COMPLEX * const q_preprocessed,
+        COMPLEX * r_preprocessed,
+        COMPLEX ** const q_spectrum_ptr,
+        const UINT M,
+        COMPLEX * const contspec,
+        REAL const * const XI,
+        UINT * const K_ptr,
+        COMPLEX * const bound_states,
+        COMPLEX * const normconsts_or_residues,
+        const INT kappa,
+        const INT tracking,
+        fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *qsub_preprocessed = NULL;
+    COMPLEX *rsub_preprocessed = NULL;
+    UINT Dsub = 0;
+    REAL Tsub[2] = {0.0 ,0.0};
+    UINT first_last_index[2] = {0};
+    UINT K_max = 0, count = 0;
+    REAL bounding_box[4] = { NAN };
+    INT ret_code = SUCCESS;
+    UINT i, j, upsampling_factor, nskip_per_step = 1;
+
+    upsampling_factor = nse_discretization_upsampling_factor(opts->discretization);
+    if (upsampling_factor == 0) {
+        ret_code = E_INVALID_ARGUMENT(opts->discretization);
+        goto leave_fun;
+    }
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    if (tracking) {
+        // Count the bound states using the argument principle. As in the
+        // first step of the SUBSAMPLE_AND_REFINE method below, a subsampled
+        // version of q is sufficient for this purpose.
+        Dsub = opts->Dsub;
+        if (Dsub == 0) // The user wants us to determine Dsub
+            Dsub = SQRT(D * LOG2(D) * LOG2(D));
+        nskip_per_step = ROUND((REAL)D / Dsub);
+        Dsub = ROUND((REAL)D / nskip_per_step); // actual Dsub
+
+        ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &qsub_preprocessed, &rsub_preprocessed,
+                first_last_index, opts->discretization, q_spectrum_ptr);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        Tsub[0] = T[0] + first_last_index[0] * eps_t;
+        Tsub[1] = T[0] + first_last_index[1] * eps_t;
+
+        ret_code = nsev_count_boundstates(Dsub * upsampling_factor, qsub_preprocessed, Tsub,
+                bounding_box, &count, opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Refine the bound states of the previous signal using Newton's
+        // method on the full signal and compute the continuous spectrum
+        K_max = *K_ptr;
+        *K_ptr = opts->K_tracked;
+        opts->bound_state_localization = nsev_bsloc_NEWTON;
+        ret_code = fnft_nsev_base(D_effective, q_preprocessed, r_preprocessed, T, M, contspec, XI, K_ptr,
+                bound_states, normconsts_or_residues, kappa, opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // If the number of refined bound states in the bounding box of the
+        // subsampled signal differs from the count, a bound state has been
+        // missed or a spurious one has been found. The bound states are
+        // then localized from scratch.
+        for (i = 0, j = 0; i < *K_ptr; i++) {
+            if (CIMAG(bound_states[i]) > 0
+                    && CIMAG(bound_states[i]) <= bounding_box[3]
+                    && CREAL(bound_states[i]) >= bounding_box[0]
+                    && CREAL(bound_states[i]) <= bounding_box[1])
+                j++;
+        }
+        if (j != count) {
+            *K_ptr = K_max;
+            opts->bound_state_localization = nsev_bsloc_SUBSAMPLE_AND_REFINE;
+        }
+    }
+
+    if (kappa == +1 && bound_states != NULL && opts->bound_state_localization == nsev_bsloc_SUBSAMPLE_AND_REFINE) {
+        // the mixed method gets special treatment. The different steps use
+        // a copy of the options in which the localization method and the
+        // number of iterations are changed, so that the options of the
+        // caller are left untouched even if an error occurs.
+        fnft_nsev_opts_t opts_sar = *opts;
+
+        // First step: Find initial guesses for the bound states using the
+        // fast eigenvalue method. To bound the complexity, a subsampled
+        // version of q, qsub, will be passed to the fast eigenroutine.
+        // (The tracking method has computed qsub already.)
+        if (!tracking) {
+            Dsub = opts->Dsub;
+            if (Dsub == 0) // The user wants us to determine Dsub
+                Dsub = SQRT(D * LOG2(D) * LOG2(D));
+            nskip_per_step = ROUND((REAL)D / Dsub);
+            Dsub = ROUND((REAL)D / nskip_per_step); // actual Dsub
+
+            ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &qsub_preprocessed, &rsub_preprocessed,
+                    first_last_index, opts->discretization, q_spectrum_ptr);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            Tsub[0] = T[0] + first_last_index[0] * eps_t;
+            Tsub[1] = T[0] + first_last_index[1] * eps_t;
+        }
+
+        // Fixed bound states of qsub using the fast eigenvalue method
+        opts_sar.bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
+        ret_code = fnft_nsev_base(Dsub * upsampling_factor, qsub_preprocessed, rsub_preprocessed, Tsub, 0, NULL, XI, K_ptr,
+                bound_states, NULL, kappa, &opts_sar);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Intermediate steps: Refine the bound states with a few Newton
+        // iterations on a cascade of less and less subsampled signals. The
+        // number of samples grows by a fixed factor of four per level instead
+        // of being chosen from a cost model. One Newton iteration on level l
+        // costs O(K D_l), so the cost of all levels is at most 4/3 of the
+        // cost of one iteration on the full signal. The initial guesses for
+        // the full signal are however much better than those from the first
+        // step, so that only few of the expensive iterations are needed and
+        // fewer guesses leave the bounding box.
+        opts_sar.bound_state_localization = nsev_bsloc_NEWTON;
+        if (opts_sar.niter > 3)
+            opts_sar.niter = 3;
+        for (nskip_per_step /= 4; nskip_per_step >= 2 && *K_ptr > 0;
+                nskip_per_step /= 4) {
+            Dsub = ROUND((REAL)D / nskip_per_step);
+            fnft__aligned_free(qsub_preprocessed);
+            fnft__aligned_free(rsub_preprocessed);
+            qsub_preprocessed = NULL;
+            rsub_preprocessed = NULL;
+            ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, &Dsub, &qsub_preprocessed, &rsub_preprocessed,
+                    first_last_index, opts->discretization, q_spectrum_ptr);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            Tsub[0] = T[0] + first_last_index[0] * eps_t;
+            Tsub[1] = T[0] + first_last_index[1] * eps_t;
+
+            ret_code = fnft_nsev_base(Dsub * upsampling_factor, qsub_preprocessed, rsub_preprocessed, Tsub, 0, NULL, XI, K_ptr,
+                    bound_states, NULL, kappa, &opts_sar);
+            CHECK_RETCODE(ret_code, leave_fun);
+        }
+        opts_sar.niter = opts->niter;
+
+        // Last step: Refine the found bound states using Newton's method
+        // on the full signal and compute continuous spectrum (unless it
+        // has been computed already by the tracking method)
+        ret_code = fnft_nsev_base(D_effective, q_preprocessed, r_preprocessed, T,
+                tracking ? 0 : M, tracking ? NULL : contspec, XI, K_ptr,
+                bound_states, normconsts_or_residues, kappa, &opts_sar);
+        CHECK_RETCODE(ret_code, leave_fun);
+    } else if (!tracking) {
+        ret_code = fnft_nsev_base(D_effective, q_preprocessed, r_preprocessed, T, M, contspec, XI, K_ptr,
+                    bound_states, normconsts_or_residues, kappa, opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+leave_fun:
+    fnft__aligned_free(qsub_preprocessed);
+    fnft__aligned_free(rsub_preprocessed);
+    return ret_code;
+}
+
+// Auxiliary function: Preprocesses a subsampled version of q with about half
+// of the samples and computes the continuous spectrum of the resulting
+// second approximation for Richardson extrapolation. The spectrum of q that
+// has been computed when q was preprocessed by fnft_nsev is only read, so
+// that this function can run concurrently with nsev_first_approximation.
+static INT nsev_second_approximation(
+        const UINT D,
+        COMPLEX * const q,
+        REAL const * const T,
+        const INT kappa,
+        COMPLEX * q_spectrum,
+        UINT * const Dsub_ptr,
+        COMPLEX ** const qsub_preprocessed_ptr,
+        COMPLEX ** const rsub_preprocessed_ptr,
+        REAL * const Tsub,
+        const UINT M,
+        COMPLEX * const contspec_sub,
+        REAL const * const XI,
+        fnft_nsev_opts_t * const opts)
+{
+    UINT first_last_index[2] = {0};
+    INT ret_code = SUCCESS;
+    UINT upsampling_factor;
+
+    upsampling_factor = nse_discretization_upsampling_factor(opts->discretization);
+    if (upsampling_factor == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    // The signal q is now subsampled(approx. half the samples) and
+    // preprocessed as required for the discretization. This is
+    // required for obtaining a second approximation of the spectrum
+    // which will be used for Richardson extrapolation.
+    *Dsub_ptr = CEIL(D/2);
+    ret_code = nse_discretization_preprocess_signal(D, q, eps_t, kappa, Dsub_ptr,
+            qsub_preprocessed_ptr, rsub_preprocessed_ptr, first_last_index,
+            opts->discretization, q_spectrum == NULL ? NULL : &q_spectrum);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    Tsub[0] = T[0] + first_last_index[0]*eps_t;
+    Tsub[1] = T[0] + first_last_index[1]*eps_t;
+
+    if (contspec_sub != NULL) {
+        ret_code = fnft_nsev_base(*Dsub_ptr * upsampling_factor, *qsub_preprocessed_ptr,
+                *rsub_preprocessed_ptr, Tsub, M, contspec_sub, XI, NULL, NULL,
+                NULL, kappa, opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+leave_fun:
+    return ret_code;
+}
+
 // Auxiliary function: Base routine for fnft_nsev. fnft_nsev preprocesses the signals
 // and calls this function with different options as needed. This prevents
 // code doubling while being efficient.
@@ -512,10 +1011,17 @@ static inline INT fnft_nsev_base(
     // to a slow method. Incorrect discretizations will have been checked for
     // in fnft_nsev main
 
+    // Newton's method does not need the transfer matrix. Skip it if the
+    // continuous spectrum is not requested either (e.g., on the intermediate
+    // levels of the SUBSAMPLE_AND_REFINE method).
+    if ((contspec == NULL || M == 0)
+            && opts->bound_state_localization == nsev_bsloc_NEWTON)
+        i = 0;
+
     if (i != 0){
     //This corresponds to methods based on polynomial transfer matrix
        // Allocate memory for the transfer matrix.
-        transfer_matrix = malloc(i*sizeof(COMPLEX));
+        transfer_matrix = fnft__aligned_malloc(i*sizeof(COMPLEX));
         if (transfer_matrix == NULL) {
             ret_code = E_NOMEM;
             goto leave_fun;
@@ -560,7 +1066,7 @@ static inline INT fnft_nsev_base(
     }
 
     leave_fun:
-        free(transfer_matrix);
+        fnft__aligned_free(transfer_matrix);
         return ret_code;
 }
 
@@ -591,40 +1097,28 @@ static inline REAL im_bound(const UINT D, COMPLEX const * const q,
     return 1.5 * 0.25 * misc_l2norm2(D, q, T[0], T[1]);
 }
 
-// Auxiliary function: Computes the bound states.
-static inline INT nsev_compute_boundstates(
+// Auxiliary function: Sets up the bounding box for the bound states based on
+// the choice of filtering.
+static inline INT nsev_bounding_box(
         const UINT D,
         COMPLEX const * const q,
-        COMPLEX * r,
-        const UINT deg,
-        COMPLEX * const transfer_matrix,
         REAL const * const T,
         const REAL eps_t,
-        UINT * const K_ptr,
-        COMPLEX * const bound_states,
-        fnft_nsev_opts_t * const opts)
+        fnft_nsev_opts_t const * const opts,
+        REAL * const bounding_box)
 {
-    REAL degree1step = 0.0 , map_coeff = 2.0;
-    UINT K, upsampling_factor, i, j, D_given;
-    REAL bounding_box[4] = { NAN };
-    COMPLEX * buffer = NULL;
-    INT ret_code = SUCCESS;
+    REAL degree1step, map_coeff = 2.0;
+    UINT upsampling_factor, i, j, D_given;
     COMPLEX * q_tmp = NULL;
-    nse_discretization_t discretization;
 
     degree1step = nse_discretization_degree(opts->discretization);
-    // degree1step == 0 here indicates a valid slow method. Incorrect
-    // discretizations should have been caught earlier.
     upsampling_factor = nse_discretization_upsampling_factor(opts->discretization);
-    if (upsampling_factor == 0) {
-        ret_code = E_INVALID_ARGUMENT(opts->discretization);
-        goto leave_fun;
-    }
+    if (upsampling_factor == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
     if (degree1step != 0)
         map_coeff = 2/(degree1step);
     D_given = D/upsampling_factor;
-    
-    // Set-up bounding_box based on choice of filtering
+
     if (opts->bound_state_filtering == nsev_bsfilt_BASIC) {        
         bounding_box[0] = -INFINITY;
         bounding_box[1] = INFINITY;
@@ -639,17 +1133,16 @@ static inline INT nsev_compute_boundstates(
         if (upsampling_factor == 1){
             bounding_box[3] = im_bound(D_given, q, T);
         } else {
-            q_tmp = malloc(D_given * sizeof(COMPLEX));
-            if (q_tmp == NULL) {
-                ret_code = E_NOMEM;
-                goto leave_fun;
-            }
+            q_tmp = fnft__aligned_malloc(D_given * sizeof(COMPLEX));
+            if (q_tmp == NULL)
+                return E_NOMEM;
             j = 1;
             for (i = 0; i < D_given; i++) {
                 q_tmp[i] = upsampling_factor*q[j];
                 j = j+upsampling_factor;
             }
             bounding_box[3] = im_bound(D_given, q_tmp, T);
+            fnft__aligned_free(q_tmp);
         }
     }else{
         bounding_box[0] = -INFINITY;
@@ -657,6 +1150,135 @@ static inline INT nsev_compute_boundstates(
         bounding_box[2] = -INFINITY;
         bounding_box[3] = INFINITY;
     }
+    return SUCCESS;
+}
+
+// Auxiliary function: Maps the upper half of the bounding box to the annular
+// sector r_min<|z|<1, |arg z|<phi_max in the z-domain of a discretization
+// with polynomial transfer matrix.
+static inline INT nsev_bounding_box_to_z(
+        const REAL eps_t,
+        REAL const * const bounding_box,
+        const nse_discretization_t discretization,
+        REAL * const r_min_ptr,
+        REAL * const phi_max_ptr)
+{
+    COMPLEX z;
+    INT ret_code = SUCCESS;
+
+    *r_min_ptr = 0.0;
+    *phi_max_ptr = PI;
+    if (bounding_box[3] < INFINITY) {
+        z = I*bounding_box[3];
+        ret_code = nse_discretization_lambda_to_z(1, eps_t, &z, discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+        *r_min_ptr = CABS(z);
+    }
+    if (bounding_box[1] < INFINITY) {
+        z = bounding_box[1];
+        ret_code = nse_discretization_lambda_to_z(1, eps_t, &z, discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+        *phi_max_ptr = FABS(CARG(z));
+    }
+
+    leave_fun:
+        return ret_code;
+}
+
+// Auxiliary function: Counts the bound states in the upper half of the
+// bounding box using the argument principle. Also returns the bounding box.
+static inline INT nsev_count_boundstates(
+        const UINT D,
+        COMPLEX * const q,
+        REAL const * const T,
+        REAL * const bounding_box,
+        UINT * const count_ptr,
+        fnft_nsev_opts_t const * const opts)
+{
+    COMPLEX *transfer_matrix = NULL;
+    UINT deg, i, upsampling_factor;
+    INT W = 0;
+    REAL r_min, phi_max;
+    INT ret_code = SUCCESS;
+
+    upsampling_factor = nse_discretization_upsampling_factor(opts->discretization);
+    if (upsampling_factor == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+    const REAL eps_t = (T[1] - T[0])/(D/upsampling_factor - 1);
+
+    i = nse_fscatter_numel(D, opts->discretization);
+    if (i == 0) // slow discretization
+        return E_INVALID_ARGUMENT(opts->discretization);
+    transfer_matrix = fnft__aligned_malloc(i*sizeof(COMPLEX));
+    if (transfer_matrix == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    ret_code = nse_fscatter(D, q, eps_t, +1, transfer_matrix, &deg, &W,
+            opts->discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = nsev_bounding_box(D, q, T, eps_t, opts, bounding_box);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = nsev_bounding_box_to_z(eps_t, bounding_box,
+            opts->discretization, &r_min, &phi_max);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = poly_roots_count_annulus(deg, transfer_matrix, r_min, 1.0,
+            phi_max, count_ptr);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    leave_fun:
+        fnft__aligned_free(transfer_matrix);
+        return ret_code;
+}
+
+// Auxiliary function: Computes the bound states.
+static inline INT nsev_compute_boundstates(
+        const UINT D,
+        COMPLEX const * const q,
+        COMPLEX * r,
+        const UINT deg,
+        COMPLEX const * const transfer_matrix,
+        REAL const * const T,
+        const REAL eps_t,
+        UINT * const K_ptr,
+        COMPLEX * const bound_states,
+        fnft_nsev_opts_t * const opts)
+{
+    REAL degree1step = 0.0;
+    UINT K, upsampling_factor;
+    REAL bounding_box[4] = { NAN };
+    COMPLEX * buffer = NULL;
+    INT ret_code = SUCCESS;
+    nse_discretization_t discretization;
+
+    degree1step = nse_discretization_degree(opts->discretization);
+    // degree1step == 0 here indicates a valid slow method. Incorrect
+    // discretizations should have been caught earlier.
+    upsampling_factor = nse_discretization_upsampling_factor(opts->discretization);
+    if (upsampling_factor == 0) {
+        ret_code = E_INVALID_ARGUMENT(opts->discretization);
+        goto leave_fun;
+    }
+
+    // Set-up bounding_box based on choice of filtering
+    ret_code = nsev_bounding_box(D, q, T, eps_t, opts, bounding_box);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Bound states are the roots of a(lambda) in the upper half-plane, i.e.,
+    // roots of the polynomial S11(z) inside the unit circle. Counting them
+    // with the argument principle is much cheaper than localizing them, and
+    // signals without solitons are common. Skip the localization if there
+    // are none. (Without filtering, roots in the lower half-plane are
+    // returned as well, so the check is not applied then.)
+    if (deg > 0 && opts->bound_state_filtering != nsev_bsfilt_NONE) {
+        ret_code = poly_roots_count_unit_disk(deg, transfer_matrix, &K);
+        CHECK_RETCODE(ret_code, leave_fun);
+        if (K == 0) {
+            *K_ptr = 0;
+            goto leave_fun;
+        }
+    }
 
     // Localize bound states ...
     switch (opts->bound_state_localization) {
@@ -691,16 +1313,36 @@ static inline INT nsev_compute_boundstates(
             if (*K_ptr >= K) {
                 buffer = bound_states;
             } else {
-                // Store intermediate results in unused part of transfer matrix.
-                // This buffer is large enough to store all deg roots of the
+                // Store intermediate results in a separate buffer. This
+                // buffer is large enough to store all deg roots of the
                 // polynomial, while bound_states provided by the user might be
                 // smaller. The latter only needs to store the bound states that
-                // survive the filtering.
-                buffer = transfer_matrix + (deg+1);
+                // survive the filtering. (The transfer matrix is not used as
+                // buffer since it may be shared, see
+                // fnft_nsev_from_transfer_matrix.)
+                buffer = fnft__aligned_malloc(deg * sizeof(COMPLEX));
+                if (buffer == NULL) {
+                    ret_code = E_NOMEM;
+                    goto leave_fun;
+                }
             }
 
-            ret_code = poly_roots_fasteigen(deg, transfer_matrix, buffer);
-            CHECK_RETCODE(ret_code, leave_fun);
+            if (opts->bound_state_filtering == nsev_bsfilt_NONE) {
+                ret_code = poly_roots_fasteigen(deg, transfer_matrix, buffer);
+                CHECK_RETCODE(ret_code, leave_fun);
+            } else {
+                // Only roots in the upper half-plane, i.e., inside the unit
+                // circle, can pass the filter. If the imaginary parts are
+                // bounded, the bounding box is mapped to an annulus and only
+                // the roots inside it are computed.
+                REAL r_min, phi_max;
+                ret_code = nsev_bounding_box_to_z(eps_t, bounding_box,
+                        opts->discretization, &r_min, &phi_max);
+                CHECK_RETCODE(ret_code, leave_fun);
+                ret_code = poly_roots_annulus(deg, transfer_matrix, r_min, 1.0,
+                        &K, buffer);
+                CHECK_RETCODE(ret_code, leave_fun);
+            }
             // Roots are returned in discrete-time domain -> coordinate
             // transform (from discrete-time to continuous-time domain).
             ret_code = nse_discretization_z_to_lambda(K, eps_t, buffer, opts->discretization);
@@ -736,7 +1378,8 @@ static inline INT nsev_compute_boundstates(
     *K_ptr = K;
 
     leave_fun:
-        free(q_tmp);
+        if (buffer != bound_states)
+            fnft__aligned_free(buffer);
         return ret_code;
 }
 
@@ -744,7 +1387,7 @@ static inline INT nsev_compute_boundstates(
 static inline INT nsev_compute_contspec(
         const UINT deg,
         const INT W,
-        COMPLEX * const transfer_matrix,
+        COMPLEX const * const transfer_matrix,
         COMPLEX const * const q,
         COMPLEX * r,
         REAL const * const T,
@@ -776,7 +1419,7 @@ static inline INT nsev_compute_contspec(
     const REAL eps_xi = (XI[1] - XI[0])/(M - 1);
 
     // Build xi-grid which is required for applying boundary conditions
-    xi = malloc(M * sizeof(COMPLEX));
+    xi = fnft__aligned_malloc(M * sizeof(COMPLEX));
     if (xi == NULL) {
         ret_code = E_NOMEM;
         goto leave_fun;
@@ -785,7 +1428,7 @@ static inline INT nsev_compute_contspec(
         xi[i] = XI[0] + eps_xi*i;
 
     // Allocate memory for transfer matrix values
-    H11_vals = malloc(2*M * sizeof(COMPLEX));
+    H11_vals = fnft__aligned_malloc(2*M * sizeof(COMPLEX));
     if (H11_vals == NULL){
         return E_NOMEM;
         goto leave_fun;}
@@ -795,7 +1438,7 @@ static inline INT nsev_compute_contspec(
     if (deg == 0 && transfer_matrix == NULL && W == 0){
 
         // Allocate memory for call to nse_scatter_matrix
-        scatter_coeffs = malloc(4 * M * sizeof(COMPLEX));
+        scatter_coeffs = fnft__aligned_malloc(4 * M * sizeof(COMPLEX));
         if (scatter_coeffs == NULL) {
             ret_code = E_NOMEM;
             goto leave_fun;
@@ -884,9 +1527,9 @@ static inline INT nsev_compute_contspec(
     }
 
     leave_fun:
-        free(H11_vals);
-        free(scatter_coeffs);
-        free(xi);
+        fnft__aligned_free(H11_vals);
+        fnft__aligned_free(scatter_coeffs);
+        fnft__aligned_free(xi);
         return ret_code;
 }
 
@@ -914,8 +1557,8 @@ static inline INT nsev_compute_normconsts_or_residues(
     if (q == NULL)
         return E_INVALID_ARGUMENT(q);
 
-    a_vals = malloc(K * sizeof(COMPLEX));
-    aprime_vals = malloc(K * sizeof(COMPLEX));
+    a_vals = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    aprime_vals = fnft__aligned_malloc(K * sizeof(COMPLEX));
     if (a_vals == NULL || aprime_vals == NULL) {
         ret_code = E_NOMEM;
         goto leave_fun;
@@ -964,8 +1607,8 @@ static inline INT nsev_compute_normconsts_or_residues(
     }
 
     leave_fun:
-        free(a_vals);
-        free(aprime_vals);
+        fnft__aligned_free(a_vals);
+        fnft__aligned_free(aprime_vals);
         return ret_code;
 }
 
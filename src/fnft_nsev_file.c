@@ -0,0 +1,409 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "fnft_nsev_file.h"
+#include "fnft__errwarn.h"
+#include "fnft__file.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__nse_fscatter.h"
+
+// Header of the files, see fnft_nsev_file.h for the description. All fields
+// are naturally aligned, so that there is no padding.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t content;
+    uint32_t reserved;
+    uint64_t file_size;
+    uint64_t offsets[4];
+    uint64_t lengths[4];
+    int64_t ints[8];
+    double reals[8];
+    uint64_t reserved2[4];
+} nsev_file_header_t;
+
+// Compilation fails if the header does not have the documented size
+typedef char nsev_file_header_size_check[
+    sizeof(nsev_file_header_t) == 256 ? 1 : -1];
+
+#define NSEV_FILE_MAGIC "FNFTNSEV"
+#define NSEV_FILE_BYTE_ORDER 0x01020304
+#define NSEV_FILE_TRANSFER_MATRIX 1
+#define NSEV_FILE_SPECTRUM 2
+
+static inline void nsev_file_init_header(nsev_file_header_t * const header,
+    const uint32_t content)
+{
+    memset(header, 0, sizeof(nsev_file_header_t));
+    memcpy(header->magic, NSEV_FILE_MAGIC, 8);
+    header->version = FNFT_NSEV_FILE_VERSION;
+    header->byte_order = NSEV_FILE_BYTE_ORDER;
+    header->content = content;
+}
+
+// Auxiliary function: Writes the header and the arrays with non-zero length
+// in header->lengths. The offsets and the file size are set here.
+static INT nsev_file_write(char const * const filename,
+    nsev_file_header_t * const header, COMPLEX const * const * const arrays)
+{
+    static const char zeros[FNFT_ALIGNMENT] = { 0 };
+    FILE *fp = NULL;
+    uint64_t offset, size;
+    UINT k;
+    INT ret_code = SUCCESS;
+
+    offset = sizeof(nsev_file_header_t);
+    for (k = 0; k < 4; k++) {
+        if (header->lengths[k] == 0)
+            continue;
+        if (arrays[k] == NULL)
+            return E_INVALID_ARGUMENT(arrays);
+        header->offsets[k] = offset;
+        size = header->lengths[k] * sizeof(COMPLEX);
+        offset += (size + FNFT_ALIGNMENT - 1)/FNFT_ALIGNMENT*FNFT_ALIGNMENT;
+    }
+    header->file_size = offset;
+
+    fp = fopen(filename, "wb");
+    if (fp == NULL)
+        return E_OTHER("Could not open file.");
+    if (fwrite(header, sizeof(nsev_file_header_t), 1, fp) != 1) {
+        ret_code = E_OTHER("Could not write file.");
+        goto leave_fun;
+    }
+    for (k = 0; k < 4; k++) {
+        if (header->lengths[k] == 0)
+            continue;
+        size = header->lengths[k] * sizeof(COMPLEX);
+        if (fwrite(arrays[k], sizeof(COMPLEX), header->lengths[k], fp)
+                != header->lengths[k]
+            || fwrite(zeros, 1, (FNFT_ALIGNMENT - size%FNFT_ALIGNMENT)
+                      % FNFT_ALIGNMENT, fp)
+                != (FNFT_ALIGNMENT - size%FNFT_ALIGNMENT) % FNFT_ALIGNMENT) {
+            ret_code = E_OTHER("Could not write file.");
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    if (fclose(fp) != 0 && ret_code == SUCCESS)
+        ret_code = E_OTHER("Could not write file.");
+    return ret_code;
+}
+
+// Auxiliary function: Provides access to the contents of a file and checks
+// the header. Upon success, *header_ptr points to the header in the
+// contents, and the arrays in the file are stored in arrays (NULL if
+// absent).
+static INT nsev_file_read(char const * const filename, const uint32_t content,
+    void ** const data_ptr, UINT * const size_ptr,
+    nsev_file_header_t const ** const header_ptr,
+    COMPLEX ** const arrays)
+{
+    nsev_file_header_t const * header;
+    UINT k;
+    INT ret_code = SUCCESS;
+
+    if (filename == NULL)
+        return E_INVALID_ARGUMENT(filename);
+    ret_code = file_map(filename, data_ptr, size_ptr);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    header = *data_ptr;
+    if (*size_ptr < sizeof(nsev_file_header_t)
+        || memcmp(header->magic, NSEV_FILE_MAGIC, 8) != 0) {
+        ret_code = E_OTHER("Not an FNFT file.");
+        goto leave_fun;
+    }
+    if (header->byte_order != NSEV_FILE_BYTE_ORDER) {
+        ret_code = E_OTHER("File has been written on a machine with another byte order.");
+        goto leave_fun;
+    }
+    if (header->version != FNFT_NSEV_FILE_VERSION) {
+        ret_code = E_OTHER("Unsupported version of the file format.");
+        goto leave_fun;
+    }
+    if (header->content != content) {
+        ret_code = E_OTHER("File has unexpected content.");
+        goto leave_fun;
+    }
+    if (header->file_size != *size_ptr) {
+        ret_code = E_OTHER("File is truncated.");
+        goto leave_fun;
+    }
+    for (k = 0; k < 4; k++) {
+        arrays[k] = NULL;
+        if (header->lengths[k] == 0)
+            continue;
+        if (header->offsets[k] < sizeof(nsev_file_header_t)
+            || header->offsets[k] % FNFT_ALIGNMENT != 0
+            || header->offsets[k] > *size_ptr
+            || header->lengths[k] > (*size_ptr - header->offsets[k])
+                                    / sizeof(COMPLEX)) {
+            ret_code = E_OTHER("File is corrupted.");
+            goto leave_fun;
+        }
+        arrays[k] = (COMPLEX *)((char *)*data_ptr + header->offsets[k]);
+    }
+    *header_ptr = header;
+
+leave_fun:
+    if (ret_code != SUCCESS) {
+        file_unmap(*data_ptr, *size_ptr);
+        *data_ptr = NULL;
+        *size_ptr = 0;
+    }
+    return ret_code;
+}
+
+INT fnft_nsev_transfer_matrix_save(char const * const filename,
+    fnft_nsev_transfer_matrix_t const * const tm)
+{
+    nsev_file_header_t header;
+    COMPLEX const * arrays[4];
+
+    if (filename == NULL)
+        return E_INVALID_ARGUMENT(filename);
+    if (tm == NULL || tm->transfer_matrix == NULL || tm->q == NULL
+            || tm->q_preprocessed == NULL)
+        return E_INVALID_ARGUMENT(tm);
+
+    nsev_file_init_header(&header, NSEV_FILE_TRANSFER_MATRIX);
+    header.lengths[0] = 4*(tm->deg + 1);
+    header.lengths[1] = tm->D;
+    header.lengths[2] = tm->D_effective;
+    header.lengths[3] = tm->r_preprocessed != NULL ? tm->D_effective : 0;
+    arrays[0] = tm->transfer_matrix;
+    arrays[1] = tm->q;
+    arrays[2] = tm->q_preprocessed;
+    arrays[3] = tm->r_preprocessed;
+    header.ints[0] = tm->D;
+    header.ints[1] = tm->D_effective;
+    header.ints[2] = tm->deg;
+    header.ints[3] = tm->kappa;
+    header.ints[4] = tm->W;
+    header.ints[5] = tm->discretization;
+    header.reals[0] = tm->T[0];
+    header.reals[1] = tm->T[1];
+    header.reals[2] = tm->eps_t;
+
+    return nsev_file_write(filename, &header, arrays);
+}
+
+INT fnft_nsev_transfer_matrix_load(char const * const filename,
+    fnft_nsev_transfer_matrix_t * const tm)
+{
+    nsev_file_header_t const * header = NULL;
+    COMPLEX *arrays[4];
+    UINT upsampling_factor;
+    INT ret_code = SUCCESS;
+
+    if (tm == NULL)
+        return E_INVALID_ARGUMENT(tm);
+    tm->transfer_matrix = NULL;
+    tm->q = NULL;
+    tm->q_preprocessed = NULL;
+    tm->r_preprocessed = NULL;
+    tm->file_data = NULL;
+    tm->file_size = 0;
+
+    ret_code = nsev_file_read(filename, NSEV_FILE_TRANSFER_MATRIX,
+            &tm->file_data, &tm->file_size, &header, arrays);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Check that the metadata are consistent with the arrays
+    tm->D = header->ints[0];
+    tm->D_effective = header->ints[1];
+    tm->deg = header->ints[2];
+    tm->kappa = header->ints[3];
+    tm->W = header->ints[4];
+    tm->discretization = header->ints[5];
+    tm->T[0] = header->reals[0];
+    tm->T[1] = header->reals[1];
+    tm->eps_t = header->reals[2];
+    upsampling_factor = nse_discretization_upsampling_factor(tm->discretization);
+    // The lengths of the arrays have been checked against the size of the
+    // file, while the ints are arbitrary. They are therefore compared with
+    // the lengths before they are used in products that could wrap around.
+    if (header->ints[0] < 2 || header->ints[2] < 1
+        || (uint64_t)header->ints[0] != header->lengths[1]
+        || (uint64_t)header->ints[1] != header->lengths[2]
+        || (uint64_t)header->ints[2] >= header->lengths[0]/4
+        || (header->ints[3] != 1 && header->ints[3] != -1)
+        || !(tm->T[0] < tm->T[1])
+        || upsampling_factor == 0
+        || tm->D_effective / upsampling_factor != tm->D
+        || tm->D_effective % upsampling_factor != 0
+        || nse_fscatter_numel(tm->D_effective, tm->discretization) == 0
+        || header->lengths[0] != 4*(tm->deg + 1)
+        || (header->lengths[3] != 0 && header->lengths[3] != tm->D_effective)) {
+        ret_code = E_OTHER("File is corrupted.");
+        goto leave_fun;
+    }
+    tm->transfer_matrix = arrays[0];
+    tm->q = arrays[1];
+    tm->q_preprocessed = arrays[2];
+    tm->r_preprocessed = arrays[3];
+
+leave_fun:
+    if (ret_code != SUCCESS) {
+        file_unmap(tm->file_data, tm->file_size);
+        tm->file_data = NULL;
+        tm->file_size = 0;
+    }
+    return ret_code;
+}
+
+INT fnft_nsev_spectrum_save(char const * const filename, const UINT M,
+    COMPLEX const * const contspec, REAL const * const XI, const UINT K,
+    COMPLEX const * const bound_states,
+    COMPLEX const * const normconsts_or_residues,
+    fnft_nsev_opts_t const * opts)
+{
+    nsev_file_header_t header;
+    COMPLEX const * arrays[4] = { contspec, bound_states,
+                                  normconsts_or_residues, NULL };
+    fnft_nsev_opts_t default_opts;
+
+    if (filename == NULL)
+        return E_INVALID_ARGUMENT(filename);
+    if (contspec != NULL && M > 0 && XI == NULL)
+        return E_INVALID_ARGUMENT(XI);
+    if (opts == NULL) {
+        default_opts = fnft_nsev_default_opts();
+        opts = &default_opts;
+    }
+
+    nsev_file_init_header(&header, NSEV_FILE_SPECTRUM);
+    if (contspec != NULL && M > 0) {
+        switch (opts->contspec_type) {
+            case nsev_cstype_REFLECTION_COEFFICIENT:
+                header.lengths[0] = M;
+                break;
+            case nsev_cstype_AB:
+                header.lengths[0] = 2*M;
+                break;
+            case nsev_cstype_BOTH:
+                header.lengths[0] = 3*M;
+                break;
+            default:
+                return E_INVALID_ARGUMENT(opts->contspec_type);
+        }
+        header.ints[0] = M;
+        header.reals[0] = XI[0];
+        header.reals[1] = XI[1];
+    }
+    if (bound_states != NULL && K > 0) {
+        header.lengths[1] = K;
+        header.ints[1] = K;
+        if (normconsts_or_residues != NULL) {
+            switch (opts->discspec_type) {
+                case nsev_dstype_NORMING_CONSTANTS:
+                case nsev_dstype_RESIDUES:
+                    header.lengths[2] = K;
+                    break;
+                case nsev_dstype_BOTH:
+                    header.lengths[2] = 2*K;
+                    break;
+                default:
+                    return E_INVALID_ARGUMENT(opts->discspec_type);
+            }
+        }
+    }
+    header.ints[2] = opts->contspec_type;
+    header.ints[3] = opts->discspec_type;
+
+    return nsev_file_write(filename, &header, arrays);
+}
+
+INT fnft_nsev_spectrum_load(char const * const filename,
+    fnft_nsev_spectrum_t * const spectrum)
+{
+    nsev_file_header_t const * header = NULL;
+    COMPLEX *arrays[4];
+    UINT factor;
+    INT ret_code = SUCCESS;
+
+    if (spectrum == NULL)
+        return E_INVALID_ARGUMENT(spectrum);
+    memset(spectrum, 0, sizeof(fnft_nsev_spectrum_t));
+
+    ret_code = nsev_file_read(filename, NSEV_FILE_SPECTRUM,
+            &spectrum->file_data, &spectrum->file_size, &header, arrays);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Check that the metadata are consistent with the arrays
+    if (header->ints[0] < 0 || header->ints[1] < 0
+        || header->ints[2] < nsev_cstype_REFLECTION_COEFFICIENT
+        || header->ints[2] > nsev_cstype_BOTH
+        || header->ints[3] < nsev_dstype_NORMING_CONSTANTS
+        || header->ints[3] > nsev_dstype_BOTH) {
+        ret_code = E_OTHER("File is corrupted.");
+        goto leave_fun;
+    }
+    spectrum->M = header->ints[0];
+    spectrum->K = header->ints[1];
+    spectrum->contspec_type = header->ints[2];
+    spectrum->discspec_type = header->ints[3];
+    spectrum->XI[0] = header->reals[0];
+    spectrum->XI[1] = header->reals[1];
+    factor = spectrum->contspec_type == nsev_cstype_BOTH ? 3 :
+             (spectrum->contspec_type == nsev_cstype_AB ? 2 : 1);
+    // The products are only formed once the factors are known to be bounded
+    // by the lengths of the arrays, which have been checked against the size
+    // of the file
+    if ((uint64_t)header->ints[0] > header->lengths[0]/factor
+        || header->lengths[0] != factor*spectrum->M
+        || (uint64_t)header->ints[1] != header->lengths[1]
+        || (header->lengths[2] != 0 && header->lengths[2] != spectrum->K
+            * (spectrum->discspec_type == nsev_dstype_BOTH ? 2 : 1))
+        || header->lengths[3] != 0) {
+        ret_code = E_OTHER("File is corrupted.");
+        goto leave_fun;
+    }
+    spectrum->contspec = arrays[0];
+    spectrum->bound_states = arrays[1];
+    spectrum->normconsts_or_residues = arrays[2];
+
+leave_fun:
+    if (ret_code != SUCCESS) {
+        file_unmap(spectrum->file_data, spectrum->file_size);
+        spectrum->file_data = NULL;
+        spectrum->file_size = 0;
+    }
+    return ret_code;
+}
+
+void fnft_nsev_spectrum_free(fnft_nsev_spectrum_t * const spectrum)
+{
+    if (spectrum == NULL)
+        return;
+    file_unmap(spectrum->file_data, spectrum->file_size);
+    spectrum->contspec = NULL;
+    spectrum->bound_states = NULL;
+    spectrum->normconsts_or_residues = NULL;
+    spectrum->file_data = NULL;
+    spectrum->file_size = 0;
+}
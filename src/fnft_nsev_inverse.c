@@ -21,6 +21,7 @@
 #define FNFT_ENABLE_SHORT_NAMES
 
 #include "fnft_nsev_inverse.h"
+#include "fnft__allocator.h"
 
 
 static fnft_nsev_inverse_opts_t default_opts = {
@@ -183,7 +184,7 @@ INT fnft_nsev_inverse(
         if (deg == 0)
             return E_INVALID_ARGUMENT(discretization);
 
-        transfer_matrix = malloc(4*(deg+1) * sizeof(COMPLEX));
+        transfer_matrix = fnft__aligned_malloc(4*(deg+1) * sizeof(COMPLEX));
         if (transfer_matrix == NULL) {
             ret_code = E_NOMEM;
             goto leave_fun;
@@ -240,7 +241,7 @@ INT fnft_nsev_inverse(
     }
 
     leave_fun:
-        free(transfer_matrix);
+        fnft__aligned_free(transfer_matrix);
         return ret_code;
 }
 
@@ -708,12 +709,12 @@ static INT add_discrete_spectrum(
     INT ret_code = SUCCESS;
     REAL * t = NULL;
     REAL const eps_t = (T[1] - T[0])/(D-1);
-    t = malloc(D * sizeof(REAL));
-    bnd_states = malloc(K * sizeof(COMPLEX));
-    norm_consts = malloc(K * sizeof(COMPLEX));
-    bnd_states_conj = malloc(K * sizeof(COMPLEX));
-    bnd_states_diff = malloc(K * sizeof(COMPLEX));
-    acoeff_cs = malloc(3*K * sizeof(COMPLEX));
+    t = fnft__aligned_malloc(D * sizeof(REAL));
+    bnd_states = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    norm_consts = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    bnd_states_conj = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    bnd_states_diff = fnft__aligned_malloc(K * sizeof(COMPLEX));
+    acoeff_cs = fnft__aligned_malloc(3*K * sizeof(COMPLEX));
     if (t == NULL || bnd_states == NULL ||
             bnd_states_conj == NULL || bnd_states_diff == NULL ||
             norm_consts == NULL || acoeff_cs == NULL) {
@@ -849,8 +850,8 @@ static INT add_discrete_spectrum(
         //Here in C phi = [phi(1,1,1),phi(1,2,1),...,phi(1,D,1),phi(1,1,2),...
         // phi(1,D,K), phi(2,1,1),phi(2,2,1),...,phi(2,D,1),phi(2,1,2),...
         // phi(2,D,K)]
-        phi = malloc((D*K*2) * sizeof(COMPLEX));
-        psi = malloc((D*K*2) * sizeof(COMPLEX));
+        phi = fnft__aligned_malloc((D*K*2) * sizeof(COMPLEX));
+        psi = fnft__aligned_malloc((D*K*2) * sizeof(COMPLEX));
         if (phi == NULL || psi == NULL) {
             ret_code = E_NOMEM;
             goto leave_fun;
@@ -893,15 +894,15 @@ static INT add_discrete_spectrum(
         return E_INVALID_ARGUMENT(opts_ptr->contspec_inversion_method);
 
     leave_fun:
-        free(t);
-        free(phi);
-        free(psi);
-        free(bnd_states);
-        free(bnd_states_conj);
-        free(bnd_states_diff);
-        free(norm_consts);
-        free(acoeff_cs);
-        free(r);
+        fnft__aligned_free(t);
+        fnft__aligned_free(phi);
+        fnft__aligned_free(psi);
+        fnft__aligned_free(bnd_states);
+        fnft__aligned_free(bnd_states_conj);
+        fnft__aligned_free(bnd_states_diff);
+        fnft__aligned_free(norm_consts);
+        fnft__aligned_free(acoeff_cs);
+        fnft__aligned_free(r);
         return ret_code;
 }
 
@@ -21,6 +21,7 @@
 #define FNFT_ENABLE_SHORT_NAMES
 
 #include "fnft__akns_discretization.h"
+#include "fnft__allocator.h"
 
 /**
  * This routine returns the max degree d of the polynomials in a single
@@ -272,7 +273,7 @@ INT fnft__akns_discretization_method_weights(COMPLEX **weights_ptr,
         case akns_discretization_2SPLIT8A:
         case akns_discretization_2SPLIT8B:
         case akns_discretization_2SPLIT2_MODAL:
-            weights = malloc(1 * sizeof(COMPLEX));
+            weights = fnft__aligned_malloc(1 * sizeof(COMPLEX));
             if (weights == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
@@ -284,7 +285,7 @@ INT fnft__akns_discretization_method_weights(COMPLEX **weights_ptr,
         case akns_discretization_CF4_2:
         case akns_discretization_4SPLIT4A:
         case akns_discretization_4SPLIT4B:
-            weights = malloc(4 * sizeof(COMPLEX));
+            weights = fnft__aligned_malloc(4 * sizeof(COMPLEX));
             if (weights == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
@@ -297,7 +298,7 @@ INT fnft__akns_discretization_method_weights(COMPLEX **weights_ptr,
             
             break;
         case akns_discretization_CF4_3:
-            weights = malloc(9 * sizeof(COMPLEX));
+            weights = fnft__aligned_malloc(9 * sizeof(COMPLEX));
             if (weights == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
@@ -328,7 +329,7 @@ INT fnft__akns_discretization_method_weights(COMPLEX **weights_ptr,
             
             break;
         case akns_discretization_CF5_3:
-            weights = malloc(9 * sizeof(COMPLEX));
+            weights = fnft__aligned_malloc(9 * sizeof(COMPLEX));
             if (weights == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
@@ -346,7 +347,7 @@ INT fnft__akns_discretization_method_weights(COMPLEX **weights_ptr,
             
             break;
         case akns_discretization_CF6_4:
-            weights = malloc(12 * sizeof(COMPLEX));
+            weights = fnft__aligned_malloc(12 * sizeof(COMPLEX));
             if (weights == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
@@ -0,0 +1,491 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__errwarn.h"
+#include "fnft__poly_fmult.h"
+#include "fnft__akns_finvscatter.h"
+#include "fnft__misc.h"
+#include "fnft__fft_wrapper.h"
+#include "fnft__allocator.h"
+#include "fnft__kernels.h"
+#include "fnft__parallel.h"
+#include <string.h>
+
+// Products of polynomial matrices whose degree is at least this value are
+// split into concurrent tasks. Without OpenMP, all products are computed
+// with the routine passed by the caller.
+#ifdef HAVE_OPENMP
+#define AKNS_FINVSCATTER_PARALLEL_DEG 1024
+#else
+#define AKNS_FINVSCATTER_PARALLEL_DEG ((UINT)-1)
+#endif
+
+static inline INT create_fft_plans(const UINT deg,
+    fft_wrapper_plan_t * const plan_fwd_ptr,
+    fft_wrapper_plan_t * const plan_inv_ptr,
+    COMPLEX * const buf0, COMPLEX * const buf1)
+{
+    INT ret_code = SUCCESS;
+    const UINT len = poly_fmult_two_polys_len(deg);
+
+    ret_code = fft_wrapper_create_plan(plan_fwd_ptr, len, buf0, buf1, -1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fft_wrapper_create_plan(plan_inv_ptr, len, buf0, buf1, 1);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    return ret_code;
+}
+
+// Computes the FFT of the polynomial p of degree deg, zero-padded to length
+// len, and stores it with split real and imaginary parts in re and im.
+static inline INT akns_finvscatter_fft(const UINT deg, const UINT len,
+    COMPLEX const * const p, fft_wrapper_plan_t plan_fwd,
+    COMPLEX * const buf0, COMPLEX * const buf1,
+    REAL * const re, REAL * const im)
+{
+    INT ret_code = SUCCESS;
+
+    memcpy(buf0, p, (deg+1)*sizeof(COMPLEX));
+    memset(&buf0[deg+1], 0, (len - (deg+1))*sizeof(COMPLEX));
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, buf1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    kernels_deinterleave(len, buf1, re, im);
+
+leave_fun:
+    return ret_code;
+}
+
+// Computes the FFTs of the four polynomials in the 2x2 matrix p, which is
+// stored as in poly_fmult_two_polys2x2, one after another. They are stored
+// in soa (8*len elements) in the layout expected by akns_finvscatter_mult2x2.
+// The buffer buf has to provide 2*len elements.
+static INT akns_finvscatter_fft2x2(const UINT deg,
+    COMPLEX const * const p_11, const UINT p_stride,
+    fft_wrapper_plan_t plan_fwd, COMPLEX * const buf, REAL * const soa)
+{
+    INT ret_code = SUCCESS;
+    const UINT len = poly_fmult_two_polys_len(deg);
+    UINT j;
+
+    for (j=0; j<4; j++) {
+        ret_code = akns_finvscatter_fft(deg, len, p_11 + j*p_stride, plan_fwd,
+                                        buf, buf + len, soa + 2*j*len,
+                                        soa + (2*j+1)*len);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Computes the same product result(z) = p1(z)*p2(z) as
+// poly_fmult_two_polys2x2, but the FFTs of p2(z) have been computed in
+// advance with akns_finvscatter_fft2x2 and are passed in p2_soa. The four
+// FFTs of p1(z) and then the four entries of the result are computed in
+// concurrent tasks. The k-th task uses the elements work[2*k*len], ...,
+// work[(2*k+2)*len-1] of the buffer work. The FFTs of p1(z) are stored in
+// p1_soa (8*len elements).
+static INT akns_finvscatter_mult2x2(const UINT deg,
+    COMPLEX const * const p1_11, const UINT p1_stride,
+    REAL const * const p2_soa,
+    COMPLEX * const result_11, const UINT result_stride,
+    fft_wrapper_plan_t plan_fwd, fft_wrapper_plan_t plan_inv,
+    COMPLEX * const work, REAL * const p1_soa)
+{
+    INT ret_code = SUCCESS;
+    const UINT len = poly_fmult_two_polys_len(deg);
+    UINT k;
+
+    FNFT__OMP(taskgroup)
+    {
+        for (k=0; k<4; k++) {
+            FNFT__OMP(task shared(ret_code))
+            {
+                COMPLEX * const buf = work + 2*k*len;
+                const INT ret_code_k = akns_finvscatter_fft(deg, len,
+                    p1_11 + k*p1_stride, plan_fwd, buf, buf + len,
+                    p1_soa + 2*k*len, p1_soa + (2*k+1)*len);
+                if (ret_code_k != SUCCESS) {
+                    FNFT__OMP(critical)
+                    ret_code = ret_code_k;
+                }
+            }
+        }
+    }
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The entry in row i and column j of the product is
+    // p1_i1*p2_1j + p1_i2*p2_2j.
+    FNFT__OMP(taskgroup)
+    {
+        for (k=0; k<4; k++) {
+            FNFT__OMP(task shared(ret_code))
+            {
+                const UINT i = k/2, j = k%2;
+                REAL const * const x = p1_soa + 4*i*len;
+                REAL const * const y = x + 2*len;
+                REAL const * const u = p2_soa + 2*j*len;
+                REAL const * const v = u + 4*len;
+                COMPLEX * const buf = work + 2*k*len;
+                kernels_soa_cmul2_add(len, x, x + len, u, u + len, y, y + len,
+                                      v, v + len, buf);
+                const INT ret_code_k = fft_wrapper_execute_plan(plan_inv, buf,
+                                                                buf + len);
+                if (ret_code_k == SUCCESS) {
+                    kernels_cscale(2*deg + 1, 1.0/len, buf + len,
+                                   result_11 + k*result_stride);
+                } else {
+                    FNFT__OMP(critical)
+                    ret_code = ret_code_k;
+                }
+            }
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+struct fnft__akns_finvscatter_stack_elem {
+    // Inputs
+    UINT deg;
+    COMPLEX const * T;
+    UINT T_stride;
+    COMPLEX * Ti;
+    UINT Ti_stride;
+    COMPLEX * q;
+    // Local variables
+    COMPLEX * T1;
+    COMPLEX * T1i;
+    COMPLEX * T2i;
+    fft_wrapper_plan_t plan_fwd;
+    fft_wrapper_plan_t plan_inv;
+    // FFTs of the second factor of the next product and a buffer for the
+    // task that computes them (only if deg >= AKNS_FINVSCATTER_PARALLEL_DEG)
+    REAL * soa;
+    COMPLEX * buf;
+    INT ret_code;
+    // Other
+    UINT start_pos;
+};
+
+// This is an iterative implementation of a recursive algorithm. We use our own
+// custom stack to simulate what the routine would do when implemented using
+// straight-forward recursion. This lets us avoid stack overflows that can
+// happen for (very?) large degrees if recursion is implemented naively.
+//
+// For degrees of at least AKNS_FINVSCATTER_PARALLEL_DEG, the FFTs of the
+// second factors of the products in Steps 2 and 4 are computed in a task
+// while the preceding recursive call is running, since they do not depend on
+// its result. The products are then split into concurrent tasks with
+// akns_finvscatter_mult2x2, which needs the additional buffer work. All tasks
+// that compute FFTs in advance are siblings. Before a product, only the task
+// that computes the FFTs for this product is waited for, with an undeferred
+// empty task that depends on it, so that the tasks of the outer levels keep
+// running meanwhile.
+static INT akns_finvscatter_recurse(
+    struct fnft__akns_finvscatter_stack_elem * const s,
+    akns_finvscatter_base_case_t base_case,
+    akns_finvscatter_mult2x2_t mult2x2,
+    void const * const params,
+    COMPLEX * const buf0,
+    COMPLEX * const buf1,
+    REAL * const soa_buf,
+    COMPLEX * const work)
+{
+    INT ret_code = SUCCESS;
+    INT i = 0;
+
+    while (i >= 0) { // repeat until level zero of the recursion is finished
+
+        // Jump to the appropriate location if we return from a higher level
+        if (s[i].start_pos == 1)
+            goto start_pos_1;
+        else if (s[i].start_pos == 2)
+            goto start_pos_2;
+
+        if (s[i].deg > 1) { // recursive case
+
+            // The transfer matrix for all samples is
+            //
+            //   T(z) = T2(z)*T1(z), where
+            //
+            // T1(z) is built from the samples
+            //
+            //   q[0],...,q[D/2-1]
+            //
+            // and T2(z) is build from
+            //
+            //   q[D/2],...,q[D-1],
+            //
+            // respectively. The inverse of T(z), up to some power of z, is
+            //
+            //   Ti(z) = T1i(z)*T2i(z),
+            //
+            // where Tni(z) is the inverse of Tn(z), also up to a power of z.
+
+            // Step 1: Determine T2i(z) and the samples q[D/2],...,q[D-1] from
+            // the lower part of T(z) with a recursive call. Meanwhile, the
+            // FFTs of T(z) for Step 2 are computed.
+
+            if (s[i].deg >= AKNS_FINVSCATTER_PARALLEL_DEG) {
+                FNFT__OMP(task depend(out: s[i].soa))
+                s[i].ret_code = akns_finvscatter_fft2x2(s[i].deg, s[i].T,
+                    s[i].T_stride, s[i].plan_fwd, s[i].buf, s[i].soa);
+            }
+
+            s[i+1].deg = s[i].deg/2;
+            s[i+1].T = s[i].T + s[i].deg/2;
+            s[i+1].T_stride = s[i].T_stride;
+            s[i+1].Ti = s[i].T2i + s[i].deg/2;
+            s[i+1].Ti_stride = s[i].deg+1;
+            s[i+1].q = s[i].q + s[i].deg/2;
+            s[i+1].start_pos = 0;
+            s[i].start_pos = 1;
+            i++;
+            continue;
+
+start_pos_1:
+
+            // Step 2: Determine T1(z) = T2i(z)*T(z).
+
+            if (s[i].deg >= AKNS_FINVSCATTER_PARALLEL_DEG) {
+                FNFT__OMP(task if(0) depend(in: s[i].soa))
+                {}
+                ret_code = s[i].ret_code;
+                CHECK_RETCODE(ret_code, leave_fun);
+                ret_code = akns_finvscatter_mult2x2(s[i].deg, s[i].T2i,
+                                                    s[i].deg+1, s[i].soa,
+                                                    s[i].T1, 2*s[i].deg+1,
+                                                    s[i].plan_fwd,
+                                                    s[i].plan_inv,
+                                                    work, soa_buf);
+            } else {
+                ret_code = mult2x2(s[i].deg, s[i].T2i, s[i].deg+1, s[i].T,
+                                   s[i].T_stride, s[i].T1, 2*s[i].deg+1,
+                                   s[i].plan_fwd, s[i].plan_inv,
+                                   buf0, buf1, soa_buf);
+            }
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            // Step 3: Determine T1i(z) and q[0],...,q[D/2-1] from T1(z) with
+            // a recursive call. Meanwhile, the FFTs of T2i(z) for Step 4 are
+            // computed.
+
+            if (s[i].Ti != NULL
+                    && s[i].deg/2 >= AKNS_FINVSCATTER_PARALLEL_DEG) {
+                FNFT__OMP(task depend(out: s[i].soa))
+                s[i].ret_code = akns_finvscatter_fft2x2(s[i].deg/2,
+                    s[i].T2i+s[i].deg/2, s[i].deg+1, s[i+1].plan_fwd,
+                    s[i].buf, s[i].soa);
+            }
+
+            s[i+1].deg = s[i].deg/2;
+            s[i+1].T = s[i].T1 + s[i].deg;
+            s[i+1].T_stride = 2*s[i].deg + 1;
+            s[i+1].Ti = s[i].T1i;
+            s[i+1].Ti_stride = s[i].deg/2+1;
+            s[i+1].q = s[i].q;
+            s[i+1].start_pos = 0;
+            s[i].start_pos = 2;
+            i++;
+            continue;
+
+start_pos_2:
+
+            // Step 4: Determine Ti(z) = T1i(z)*T2i(z) if requested
+
+            if (s[i].Ti != NULL
+                    && s[i].deg/2 >= AKNS_FINVSCATTER_PARALLEL_DEG) {
+                FNFT__OMP(task if(0) depend(in: s[i].soa))
+                {}
+                ret_code = s[i].ret_code;
+                CHECK_RETCODE(ret_code, leave_fun);
+                ret_code = akns_finvscatter_mult2x2(s[i].deg/2,
+                                                    s[i].T1i, s[i].deg/2+1,
+                                                    s[i].soa, s[i].Ti,
+                                                    s[i].Ti_stride,
+                                                    s[i+1].plan_fwd,
+                                                    s[i+1].plan_inv,
+                                                    work, soa_buf);
+                CHECK_RETCODE(ret_code, leave_fun);
+            } else if (s[i].Ti != NULL) {
+                ret_code = mult2x2(s[i].deg/2, s[i].T1i, s[i].deg/2+1,
+                                   s[i].T2i+s[i].deg/2, s[i].deg+1, s[i].Ti,
+                                   s[i].Ti_stride, s[i+1].plan_fwd,
+                                   s[i+1].plan_inv, buf0, buf1, soa_buf);
+                CHECK_RETCODE(ret_code, leave_fun);
+            }
+
+        } else if (s[i].deg == 1) { // base case
+
+            ret_code = base_case(s[i].T, s[i].T_stride, s[i].Ti,
+                                 s[i].Ti_stride, s[i].q, params);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+        } else { // deg == 0
+
+            ret_code = E_ASSERTION_FAILED;
+            goto leave_fun;
+
+        }
+
+        i--;
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+INT akns_finvscatter(
+    const UINT deg,
+    COMPLEX const * const transfer_matrix,
+    COMPLEX * const q,
+    akns_finvscatter_base_case_t base_case,
+    akns_finvscatter_mult2x2_t mult2x2,
+    void const * const params)
+{
+    if (deg < 2 || (deg&(deg-1)) != 0)
+        return E_INVALID_ARGUMENT(deg);
+    if (transfer_matrix == NULL)
+        return E_INVALID_ARGUMENT(transfer_matrix);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (base_case == NULL)
+        return E_INVALID_ARGUMENT(base_case);
+    if (mult2x2 == NULL)
+        return E_INVALID_ARGUMENT(mult2x2);
+
+    INT ret_code = SUCCESS;
+    UINT i = 0;
+
+    // This routine implements a recursive algorithm in an iterative manner
+    // using a custom call stack.
+
+    // Allocate buffers that are reused in all levels of the recursion
+    // as well as our custom stack
+
+    const UINT max_len = poly_fmult_two_polys_len(deg);
+    COMPLEX * const buf0 = fft_wrapper_malloc(max_len*sizeof(COMPLEX));
+    COMPLEX * const buf1 = fft_wrapper_malloc(max_len*sizeof(COMPLEX));
+    REAL * const soa_buf = fft_wrapper_malloc(
+        poly_fmult_two_polys2x2_soa_buf_numel(deg)*sizeof(REAL));
+    COMPLEX * const work = (deg >= AKNS_FINVSCATTER_PARALLEL_DEG) ?
+        fft_wrapper_malloc(8*max_len*sizeof(COMPLEX)) : NULL;
+
+    const UINT stack_size = LOG2(deg) + 1;
+    struct fnft__akns_finvscatter_stack_elem * const s = fnft__malloc(
+        stack_size * sizeof(struct fnft__akns_finvscatter_stack_elem));
+
+    if (buf0 == NULL || buf1 == NULL || soa_buf == NULL || s == NULL
+            || (work == NULL && deg >= AKNS_FINVSCATTER_PARALLEL_DEG)) {
+        ret_code = E_NOMEM;
+        goto leave_fun_1;
+    }
+
+    // Initialize stack at level zero, which in particular contains some
+    // arguments that we initially pass to the recursive function
+
+    s[0].deg = deg;
+    s[0].T = transfer_matrix;
+    s[0].T_stride = deg+1;
+    s[0].Ti = NULL; // Currently, it is not possible to use another value than
+                    // NULL because akns_finvscattter_recurse will otherwise
+                    // try to access s[i+1].plan_fwd and s[i+1].plan_inv with
+                    // i==stack_size-1 in Step 4.
+    s[0].Ti_stride = 0;
+    s[0].q = q;
+    s[0].start_pos = 0;
+    s[0].ret_code = SUCCESS;
+
+    // Initialize all pointers in the stack to safe values
+
+    for (i=0; i<stack_size; i++) {
+        s[i].T1 = NULL;
+        s[i].T1i = NULL;
+        s[i].T2i = NULL;
+        s[i].soa = NULL;
+        s[i].buf = NULL;
+        s[i].plan_fwd = fft_wrapper_safe_plan_init();
+        s[i].plan_inv = fft_wrapper_safe_plan_init();
+    }
+
+    // Pre-allocate memory and FFT plans for the different levels of the
+    // recursion
+
+    UINT deg_on_level_i = deg;
+    for (i=0; i<stack_size; i++) {
+        s[i].T1 = fnft__aligned_malloc(4*(2*deg_on_level_i + 1) * sizeof(COMPLEX));
+        s[i].T1i = fnft__aligned_malloc(4*(deg_on_level_i/2 + 1) * sizeof(COMPLEX));
+        s[i].T2i = fnft__aligned_calloc(4*(deg_on_level_i + 1), sizeof(COMPLEX));
+        if (s[i].T1 == NULL || s[i].T1i == NULL || s[i].T2i == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun_2;
+        }
+        ret_code = create_fft_plans(deg_on_level_i, &s[i].plan_fwd,
+                                    &s[i].plan_inv, buf0, buf1);
+        CHECK_RETCODE(ret_code, leave_fun_2);
+        if (deg_on_level_i >= AKNS_FINVSCATTER_PARALLEL_DEG) {
+            const UINT len = poly_fmult_two_polys_len(deg_on_level_i);
+            s[i].soa = fft_wrapper_malloc(8*len*sizeof(REAL));
+            s[i].buf = fft_wrapper_malloc(2*len*sizeof(COMPLEX));
+            if (s[i].soa == NULL || s[i].buf == NULL) {
+                ret_code = E_NOMEM;
+                goto leave_fun_2;
+            }
+        }
+
+        deg_on_level_i /= 2;
+    }
+
+    // Run the recursion. The tasks that it creates for large degrees are
+    // run by the other threads of the team.
+
+    FNFT__OMP(parallel if(deg >= AKNS_FINVSCATTER_PARALLEL_DEG))
+    FNFT__OMP(single)
+    ret_code = akns_finvscatter_recurse(s, base_case, mult2x2, params, buf0,
+        buf1, soa_buf, work);
+    CHECK_RETCODE(ret_code, leave_fun_2);
+
+leave_fun_2:
+
+    // Clean up
+
+    for (i=0; i<stack_size; i++) {
+        fnft__aligned_free(s[i].T1);
+        fnft__aligned_free(s[i].T1i);
+        fnft__aligned_free(s[i].T2i);
+        fft_wrapper_free(s[i].soa);
+        fft_wrapper_free(s[i].buf);
+        fft_wrapper_destroy_plan(&s[i].plan_fwd);
+        fft_wrapper_destroy_plan(&s[i].plan_inv);
+    }
+
+leave_fun_1:
+
+    fft_wrapper_free(buf0);
+    fft_wrapper_free(buf1);
+    fft_wrapper_free(soa_buf);
+    fft_wrapper_free(work);
+    fnft__free(s);
+    return ret_code;
+}
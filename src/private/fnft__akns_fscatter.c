@@ -24,6 +24,8 @@
 
 
 #include "fnft__akns_fscatter.h"
+#include "fnft__kernels.h"
+#include "fnft__allocator.h"
 
 
 /**
@@ -44,11 +46,34 @@ UINT akns_fscatter_numel(UINT D, akns_discretization_t discretization)
  * Returns the scattering matrix for a single step at frequency zero.
  */
 static inline void akns_fscatter_zero_freq_scatter_matrix(COMPLEX * const M,
-                                                const REAL eps_t, const COMPLEX q, const COMPLEX r)
+                                                const REAL eps_t, const COMPLEX q, const COMPLEX r,
+                                                const INT real)
 {   
     // This function computes the matrix exponential
     //   M = expm([0,q;r,0]*eps_t);
     COMPLEX Delta, del;
+
+    // Real arithmetic suffices if the caller guarantees that q and r are
+    // real (e.g., for the KdV equation). Then Delta is either real or purely
+    // imaginary, and cos(j*x)=cosh(x) and sinc(j*x)=sinh(x)/x.
+    if (real) {
+        const REAL qr = -CREAL(q)*CREAL(r);
+        REAL x, c, d;
+        if (qr >= 0.0) {
+            x = eps_t * SQRT(qr);
+            c = COS(x);
+            d = (x == 0.0) ? eps_t : eps_t*SIN(x)/x;
+        } else {
+            x = eps_t * SQRT(-qr);
+            c = COSH(x);
+            d = eps_t*SINH(x)/x;
+        }
+        M[0] = c;
+        M[2] = CREAL(r) * d;
+        M[1] = CREAL(q) * d;
+        return;
+    }
+
     Delta = eps_t * CSQRT(-q*r);
     del = eps_t * misc_CSINC(Delta);
     M[0] = CCOS(Delta);
@@ -56,12 +81,25 @@ static inline void akns_fscatter_zero_freq_scatter_matrix(COMPLEX * const M,
     M[1] = q * del;
     
 
+}
+/**
+ * Returns the i-th sample of r. If no samples of r are given, r is derived
+ * on the fly from q as in the nonlinear Schroedinger equation.
+ */
+static inline COMPLEX akns_fscatter_r(COMPLEX const * const q,
+                                      COMPLEX const * const r,
+                                      const INT kappa, const INT i)
+{
+    return r != NULL ? r[i] : -kappa*CONJ(q[i]);
 }
 /**
  * Fast computation of polynomial approximation of the combined scattering
- * matrix.
+ * matrix. If r is NULL, r = -kappa*conj(q). If real is non-zero, q and r are
+ * assumed to be real and the computations are carried out in real arithmetic.
  */
-INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r,
+FNFT__TARGET_CLONES
+static INT akns_fscatter_base(const UINT D, COMPLEX const * const q,
+                 COMPLEX const * const r, const INT kappa, const INT real,
                  const REAL eps_t, COMPLEX * const result, UINT * const deg_ptr,
                  INT * const W_ptr, akns_discretization_t discretization)
 {
@@ -81,8 +119,6 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
         return E_INVALID_ARGUMENT(D);
     if (q == NULL)
         return E_INVALID_ARGUMENT(q);
-    if (r == NULL)
-        return E_INVALID_ARGUMENT(r);
     if (eps_t <= 0.0)
         return E_INVALID_ARGUMENT(eps_t);
     if (result == NULL)
@@ -95,7 +131,7 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
     if (len == 0) { // size D>0, this means unknown discretization
         return E_INVALID_ARGUMENT(discretization);
     }
-    p = malloc(len*sizeof(COMPLEX));
+    p = fnft__aligned_malloc(len*sizeof(COMPLEX));
     
     // degree 1 polynomials
     if (p == NULL)
@@ -118,15 +154,16 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
         case akns_discretization_2SPLIT2_MODAL: // Modified Ablowitz-Ladik discretization
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 scl = eps_t*CABS(q[i]);
-		if (CREAL(q[i]) == CREAL(r[i])) {
+		if (CREAL(q[i]) == CREAL(ri)) {
                     if ((double)scl >= 1.0) {
                         ret_code = E_OTHER("kappa == -1 but eps_t*|q[i]|>=1 ... decrease step size");
                         goto release_mem;
                     }
-                    scl = 1.0/CSQRT(1-eps_t*q[i]*eps_t*r[i]);
+                    scl = 1.0/CSQRT(1-eps_t*q[i]*eps_t*ri);
                 } else
-                    scl = 1.0/CSQRT(1-eps_t*q[i]*eps_t*r[i]);
+                    scl = 1.0/CSQRT(1-eps_t*q[i]*eps_t*ri);
               
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -134,7 +171,7 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
                 p12[0] = scl*eps_t*q[i];
                 p12[1] = 0.0;
                 p21[0] = 0.0;
-                p21[1] = scl*eps_t*r[i];
+                p21[1] = scl*eps_t*ri;
                 p22[0] = scl;
                 p22[1] = 0.0;
 
@@ -152,9 +189,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[0];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
                 //e_1B = expm([0,q[i];r[i],0]*1*eps_t/deg)
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
                 
                 
                 // construct the scattering matrix for the i-th sample
@@ -181,8 +219,9 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[0];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -206,8 +245,9 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_0_5B = &e_Bstorage[0];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 //e_0_5B = expm([0,q[i];r[i],0]*0.5*eps_t/deg)
-                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = e_0_5B[1]*e_0_5B[2];
@@ -232,8 +272,9 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[0];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -260,10 +301,11 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_3B = &e_Bstorage[6];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -298,10 +340,11 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_3B = &e_Bstorage[6];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -334,9 +377,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_2B = &e_Bstorage[3];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 2*e_1B[1]*e_1B[2]/3;
@@ -366,9 +410,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_4B = &e_Bstorage[3];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -406,9 +451,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[3];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = (4*e_1B[0]*e_0_5B[1]*e_0_5B[2] - e_1B[1]*e_1B[2])/3;
@@ -444,12 +490,13 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_15B = &e_Bstorage[12];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -497,12 +544,13 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_15B = &e_Bstorage[12];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -548,10 +596,11 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_12B = &e_Bstorage[6];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
                 //p11
@@ -599,11 +648,12 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_3B = &e_Bstorage[9];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
 
@@ -657,14 +707,15 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_105B = &e_Bstorage[18];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -726,14 +777,15 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_105B = &e_Bstorage[18];
             
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, q[i], ri, real);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -792,11 +844,12 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_24B = &e_Bstorage[9];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_8B, 8*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_24B, 24*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_8B, 8*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_24B, 24*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
  
@@ -858,12 +911,13 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_6B = &e_Bstorage[12];
 
             for (i=D-1; i>=0; i--) {
+                const COMPLEX ri = akns_fscatter_r(q, r, kappa, i);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], ri, real);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], ri, real);
 
                 // construct the scattering matrix for the i-th sample
                 
@@ -916,10 +970,44 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             goto release_mem;
     }
     // Multiply the individual scattering matrices
-    ret_code = poly_fmult2x2(deg_ptr, D, p, result, W_ptr);
+    if (real)
+        ret_code = poly_fmult2x2_real(deg_ptr, D, p, result, W_ptr);
+    else
+        ret_code = poly_fmult2x2(deg_ptr, D, p, result, W_ptr);
     CHECK_RETCODE(ret_code, release_mem);
 
 release_mem:
-    free(p);
+    fnft__aligned_free(p);
     return ret_code;
 }
+
+INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r,
+                 const REAL eps_t, COMPLEX * const result, UINT * const deg_ptr,
+                 INT * const W_ptr, akns_discretization_t discretization)
+{
+    if (r == NULL)
+        return E_INVALID_ARGUMENT(r);
+    return akns_fscatter_base(D, q, r, 0, 0, eps_t, result, deg_ptr, W_ptr,
+                              discretization);
+}
+
+INT akns_fscatter_real(const UINT D, COMPLEX const * const q,
+                 COMPLEX const * const r, const REAL eps_t,
+                 COMPLEX * const result, UINT * const deg_ptr,
+                 INT * const W_ptr, akns_discretization_t discretization)
+{
+    if (r == NULL)
+        return E_INVALID_ARGUMENT(r);
+    return akns_fscatter_base(D, q, r, 0, 1, eps_t, result, deg_ptr, W_ptr,
+                              discretization);
+}
+
+INT akns_fscatter_nse(const UINT D, COMPLEX const * const q, const INT kappa,
+                 const REAL eps_t, COMPLEX * const result, UINT * const deg_ptr,
+                 INT * const W_ptr, akns_discretization_t discretization)
+{
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    return akns_fscatter_base(D, q, NULL, kappa, 0, eps_t, result, deg_ptr, W_ptr,
+                              discretization);
+}
@@ -21,6 +21,18 @@
 
 
 #include "fnft__akns_scatter.h"
+#include "fnft__kernels.h"
+#include "fnft__allocator.h"
+
+/**
+ * Returns the n-th sample of r. If no samples of r are given, r is derived
+ * on the fly from q as in the nonlinear Schroedinger equation.
+ */
+static inline COMPLEX akns_scatter_r(COMPLEX const * const q,
+        COMPLEX const * const r, const INT kappa, const UINT n)
+{
+    return r != NULL ? r[n] : -kappa*CONJ(q[n]);
+}
 
 /**
  * If derivative_flag=0 returns [S11 S12 S21 S22] in result where
@@ -29,9 +41,11 @@
  * If derivative_flag=1 returns [S11 S12 S21 S22 S11' S12' S21' S22'] in
  * result where S11' is the derivative of S11 w.r.t to lambda.
  * Result should be preallocated with size 4*K or 8*K accordingly.
+ * If r is NULL, r = -kappa*conj(q).
  */
-INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
-        COMPLEX const * const r, const REAL eps_t,
+FNFT__TARGET_CLONES
+static INT akns_scatter_matrix_base(const UINT D, COMPLEX const * const q,
+        COMPLEX const * const r, const INT kappa, const REAL eps_t,
         const UINT K, COMPLEX const * const lambda,
         COMPLEX * const result, akns_discretization_t discretization,
         const UINT derivative_flag)
@@ -45,8 +59,6 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
         return E_INVALID_ARGUMENT(D);
     if (q == NULL)
         return E_INVALID_ARGUMENT(q);
-    if (r == NULL)
-        return E_INVALID_ARGUMENT(r);
     if (!(eps_t > 0))
         return E_INVALID_ARGUMENT(eps_t);
     if (K <= 0.0)
@@ -64,7 +76,7 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
     COMPLEX a1, a2, a3, s, c, w;
     COMPLEX *tmp1 = NULL, *tmp2 = NULL;
     
-    l = malloc(D*sizeof(COMPLEX));
+    l = fnft__aligned_malloc(D*sizeof(COMPLEX));
     if (l == NULL) {
         ret_code = E_NOMEM;
         goto leave_fun;
@@ -171,8 +183,8 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
             
             for (n = 0; n < D; n++){
                 qn = q[n];
-                rn = r[n];
-                ks = ((q[n]*r[n])-(l[n]*l[n]));
+                rn = akns_scatter_r(q, r, kappa, n);
+                ks = ((q[n]*rn)-(l[n]*l[n]));
                 k = CSQRT(ks);
                 ch = CCOSH(k*eps_t);
                 chi = ch/ks;
@@ -216,8 +228,8 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
             for (n = 0; n < D; n++){
                 
                 qn = q[n];
-                rn = r[n];
-                ks = ((q[n]*r[n])-(l[n]*l[n]));
+                rn = akns_scatter_r(q, r, kappa, n);
+                ks = ((q[n]*rn)-(l[n]*l[n]));
                 k = CSQRT(ks);
                 ch = CCOSH(k*eps_t);
                 if (ks != 0)
@@ -258,25 +270,29 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
             // in terms of Pauli matrices.
             case akns_discretization_ES4:
                 scl_factor = 1;
-                tmp1 = malloc(D*sizeof(COMPLEX));
+                tmp1 = fnft__aligned_malloc(D*sizeof(COMPLEX));
                 if (tmp1 == NULL) {
                     ret_code = E_NOMEM;
                     goto leave_fun;
                 }
                 for (n = 0; n < D; n=n+3){
-                    tmp1[n] = eps_t_3*(q[n+2]+r[n+2])/48.0 + (eps_t*(q[n]+r[n]))*0.5;
-                    tmp1[n+1] = (eps_t*(q[n]-r[n])*I)*0.5 + (eps_t_3*(q[n+2]-r[n+2])*I)/48.0;
-                    tmp1[n+2] = -eps_t_3*(q[n]*r[n+1]- q[n+1]*r[n])/12.0;
+                    const COMPLEX r0 = akns_scatter_r(q, r, kappa, n);
+                    const COMPLEX r1 = akns_scatter_r(q, r, kappa, n+1);
+                    const COMPLEX r2 = akns_scatter_r(q, r, kappa, n+2);
+                    tmp1[n] = eps_t_3*(q[n+2]+r2)/48.0 + (eps_t*(q[n]+r0))*0.5;
+                    tmp1[n+1] = (eps_t*(q[n]-r0)*I)*0.5 + (eps_t_3*(q[n+2]-r2)*I)/48.0;
+                    tmp1[n+2] = -eps_t_3*(q[n]*r1- q[n+1]*r0)/12.0;
                 }
                 if (derivative_flag == 1){
-                    tmp2 = malloc(D*sizeof(COMPLEX));
+                    tmp2 = fnft__aligned_malloc(D*sizeof(COMPLEX));
                     if (tmp2 == NULL) {
                         ret_code = E_NOMEM;
                         goto leave_fun;
                     }
                     for (n = 0; n < D; n=n+3){
-                        tmp2[n] = I*eps_t_3*(q[n+1]-r[n+1])/12.0;
-                        tmp2[n+1] = -eps_t_3*(q[n+1]+r[n+1])/12.0;
+                        const COMPLEX r1 = akns_scatter_r(q, r, kappa, n+1);
+                        tmp2[n] = I*eps_t_3*(q[n+1]-r1)/12.0;
+                        tmp2[n+1] = -eps_t_3*(q[n+1]+r1)/12.0;
                         tmp2[n+2] = -I*eps_t;
                     }
                     
@@ -289,17 +305,19 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
                 // in terms of Pauli matrices.
             case akns_discretization_TES4:
                 scl_factor = 1;
-                tmp1 = malloc(D*sizeof(COMPLEX));
-                tmp2 = malloc(D*sizeof(COMPLEX));
+                tmp1 = fnft__aligned_malloc(D*sizeof(COMPLEX));
+                tmp2 = fnft__aligned_malloc(D*sizeof(COMPLEX));
                 if (tmp1 == NULL || tmp2 == NULL) {
                     ret_code = E_NOMEM;
                     goto leave_fun;
                 }
                 for (n = 0; n < D; n=n+3){
-                    tmp1[n] = (eps_t_3*(q[n+2]+r[n+2]))/96.0 - (eps_t_2*(q[n+1]+r[n+1]))/24.0;
-                    tmp1[n+1] = (eps_t_3*(q[n+2]-r[n+2])*I)/96.0 + (eps_t_2*(r[n+1]-q[n+1])*I)/24.0;
-                    tmp2[n] = (eps_t_3*(q[n+2]+r[n+2]))/96.0 + (eps_t_2*(q[n+1]+r[n+1]))/24.0;
-                    tmp2[n+1] = (eps_t_3*(q[n+2]-r[n+2])*I)/96.0 + (eps_t_2*(q[n+1]-r[n+1])*I)/24.0;
+                    const COMPLEX r1 = akns_scatter_r(q, r, kappa, n+1);
+                    const COMPLEX r2 = akns_scatter_r(q, r, kappa, n+2);
+                    tmp1[n] = (eps_t_3*(q[n+2]+r2))/96.0 - (eps_t_2*(q[n+1]+r1))/24.0;
+                    tmp1[n+1] = (eps_t_3*(q[n+2]-r2)*I)/96.0 + (eps_t_2*(r1-q[n+1])*I)/24.0;
+                    tmp2[n] = (eps_t_3*(q[n+2]+r2))/96.0 + (eps_t_2*(q[n+1]+r1))/24.0;
+                    tmp2[n+1] = (eps_t_3*(q[n+2]-r2)*I)/96.0 + (eps_t_2*(q[n+1]-r1)*I)/24.0;
                 }
                 break;
             default: // Unknown discretization
@@ -324,8 +342,9 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
                     // in terms of Pauli matrices.
                     case akns_discretization_ES4:
                         for (n = 0; n < D; n=n+3){
-                            a1 = tmp1[n]+ eps_t_3*(l_curr*I*(q[n+1]-r[n+1]))/12.0;
-                            a2 = tmp1[n+1] - eps_t_3*l_curr*(q[n+1]+r[n+1])/12.0;
+                            const COMPLEX r1 = akns_scatter_r(q, r, kappa, n+1);
+                            a1 = tmp1[n]+ eps_t_3*(l_curr*I*(q[n+1]-r1))/12.0;
+                            a2 = tmp1[n+1] - eps_t_3*l_curr*(q[n+1]+r1)/12.0;
                             a3 = - eps_t*I*l_curr +tmp1[n+2];
                             w = CSQRT(-(a1*a1)-(a2*a2)-(a3*a3));
                             if (w != 0)
@@ -375,8 +394,9 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
                             TMD[1][0] = TM[1][0];
                             TMD[1][1] = TM[1][1];
                             
-                            a1 = (eps_t*(q[n] + r[n]))*0.5;
-                            a2 = (eps_t*(q[n]*I - r[n]*I))*0.5;
+                            rn = akns_scatter_r(q, r, kappa, n);
+                            a1 = (eps_t*(q[n] + rn))*0.5;
+                            a2 = (eps_t*(q[n]*I - rn*I))*0.5;
                             a3 = -eps_t*l_curr*I;
                             w = CSQRT(-(a1*a1)-(a2*a2)-(a3*a3));
                             if (w != 0)
@@ -393,7 +413,7 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
                             w_d = l_curr*(eps_t*w*CCOS(w*eps_t)-CSIN(w*eps_t))/(w*w*w);
                             UD[0][0] = c_d-I*s_d;
                             UD[0][1] = w_d*q[n];
-                            UD[1][0] = w_d*r[n];
+                            UD[1][0] = w_d*rn;
                             UD[1][1] = c_d+I*s_d;
                             
                             misc_mat_mult_2x2(&UN[0][0], &TM[0][0]);
@@ -463,8 +483,9 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
                     // in terms of Pauli matrices.
                     case akns_discretization_ES4:
                         for (n = 0; n < D; n=n+3){
-                            a1 = tmp1[n]+ eps_t_3*(l_curr*I*(q[n+1]-r[n+1]))/12.0;
-                            a2 = tmp1[n+1] - eps_t_3*l_curr*(q[n+1]+r[n+1])/12.0;
+                            const COMPLEX r1 = akns_scatter_r(q, r, kappa, n+1);
+                            a1 = tmp1[n]+ eps_t_3*(l_curr*I*(q[n+1]-r1))/12.0;
+                            a2 = tmp1[n+1] - eps_t_3*l_curr*(q[n+1]+r1)/12.0;
                             a3 = - eps_t*I*l_curr +tmp1[n+2];
                             w = CSQRT(-(a1*a1)-(a2*a2)-(a3*a3));
                             if (w != 0)
@@ -490,8 +511,9 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
                                 a3 = 0;
                                 j++;
                             }else if (j == 1){
-                                a1 = (eps_t*(q[n-1] + r[n-1]))*0.5;
-                                a2 = (eps_t*(q[n-1]*I - r[n-1]*I))*0.5;
+                                rn = akns_scatter_r(q, r, kappa, n-1);
+                                a1 = (eps_t*(q[n-1] + rn))*0.5;
+                                a2 = (eps_t*(q[n-1]*I - rn*I))*0.5;
                                 a3 = -eps_t*l_curr*I;
                                 j++;
                             }else{
@@ -530,9 +552,33 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
     }
     
     leave_fun:
-        free(l);
-        free(tmp1);
-        free(tmp2);
-        free(weights);
+        fnft__aligned_free(l);
+        fnft__aligned_free(tmp1);
+        fnft__aligned_free(tmp2);
+        fnft__aligned_free(weights);
         return ret_code;
 }
+
+INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
+        COMPLEX const * const r, const REAL eps_t,
+        const UINT K, COMPLEX const * const lambda,
+        COMPLEX * const result, akns_discretization_t discretization,
+        const UINT derivative_flag)
+{
+    if (r == NULL)
+        return E_INVALID_ARGUMENT(r);
+    return akns_scatter_matrix_base(D, q, r, 0, eps_t, K, lambda, result,
+                                    discretization, derivative_flag);
+}
+
+INT akns_scatter_matrix_nse(const UINT D, COMPLEX const * const q,
+        const INT kappa, const REAL eps_t,
+        const UINT K, COMPLEX const * const lambda,
+        COMPLEX * const result, akns_discretization_t discretization,
+        const UINT derivative_flag)
+{
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    return akns_scatter_matrix_base(D, q, NULL, kappa, eps_t, K, lambda,
+                                    result, discretization, derivative_flag);
+}
@@ -0,0 +1,133 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+// Required for open, fstat, mmap and munmap since FNFT is compiled with
+// -std=c99
+#define _POSIX_C_SOURCE 200112L
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft_config.h"
+#include <stdio.h>
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "fnft__file.h"
+#include "fnft__errwarn.h"
+#include "fnft__allocator.h"
+
+#ifdef HAVE_MMAP
+
+INT file_map(char const * const filename, void ** const data_ptr,
+    UINT * const size_ptr)
+{
+    struct stat st;
+    void *data;
+    int fd;
+
+    if (filename == NULL)
+        return E_INVALID_ARGUMENT(filename);
+    if (data_ptr == NULL)
+        return E_INVALID_ARGUMENT(data_ptr);
+    if (size_ptr == NULL)
+        return E_INVALID_ARGUMENT(size_ptr);
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return E_OTHER("Could not open file.");
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return E_OTHER("Could not determine size of file or file is empty.");
+    }
+    // The mapping starts at a page boundary and is hence suitably aligned.
+    // Writes to the private mapping go to copies of the affected pages
+    // (copy-on-write), so that the contents can be modified as if they had
+    // been read into memory, while the file remains unchanged.
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+        fd, 0);
+    close(fd); // the mapping stays valid
+    if (data == MAP_FAILED)
+        return E_OTHER("Could not map file into memory.");
+
+    *data_ptr = data;
+    *size_ptr = (UINT)st.st_size;
+    return SUCCESS;
+}
+
+void file_unmap(void * const data, const UINT size)
+{
+    if (data != NULL)
+        munmap(data, size);
+}
+
+#else
+
+INT file_map(char const * const filename, void ** const data_ptr,
+    UINT * const size_ptr)
+{
+    FILE *fp = NULL;
+    void *data = NULL;
+    long size;
+    INT ret_code = SUCCESS;
+
+    if (filename == NULL)
+        return E_INVALID_ARGUMENT(filename);
+    if (data_ptr == NULL)
+        return E_INVALID_ARGUMENT(data_ptr);
+    if (size_ptr == NULL)
+        return E_INVALID_ARGUMENT(size_ptr);
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL)
+        return E_OTHER("Could not open file.");
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) <= 0
+        || fseek(fp, 0, SEEK_SET) != 0) {
+        ret_code = E_OTHER("Could not determine size of file or file is empty.");
+        goto leave_fun;
+    }
+    data = fnft__aligned_malloc((UINT)size);
+    if (data == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    if (fread(data, 1, (size_t)size, fp) != (size_t)size) {
+        ret_code = E_OTHER("Could not read file.");
+        goto leave_fun;
+    }
+
+    *data_ptr = data;
+    *size_ptr = (UINT)size;
+    data = NULL;
+
+leave_fun:
+    fnft__aligned_free(data);
+    fclose(fp);
+    return ret_code;
+}
+
+void file_unmap(void * const data, const UINT size)
+{
+    (void)size;
+    fnft__aligned_free(data);
+}
+
+#endif
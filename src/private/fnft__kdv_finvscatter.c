@@ -0,0 +1,201 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__errwarn.h"
+#include "fnft__poly_fmult.h"
+#include "fnft__kdv_finvscatter.h"
+#include "fnft__akns_finvscatter.h"
+#include "fnft__allocator.h"
+
+// Evaluates g(s) = sqrt(s)*tan(sqrt(s)) and its derivative. For s<0, this is
+// g(s) = -sqrt(-s)*tanh(sqrt(-s)).
+static inline void kdv_finvscatter_g(const REAL s, REAL * const g_ptr,
+    REAL * const dg_ptr)
+{
+    REAL x, t;
+
+    if (s > 0.0) {
+        x = SQRT(s);
+        t = SIN(x)/COS(x);
+        *g_ptr = x*t;
+        *dg_ptr = 0.5*(t/x + 1.0 + t*t);
+    } else if (s < 0.0) {
+        x = SQRT(-s);
+        t = (x > 20.0) ? 1.0 : SINH(x)/COSH(x);
+        *g_ptr = -x*t;
+        *dg_ptr = 0.5*(t/x + 1.0 - t*t);
+    } else {
+        *g_ptr = 0.0;
+        *dg_ptr = 1.0;
+    }
+}
+
+// Solves g(s) = y0, where g is the function above. The function g is
+// increasing and convex on (-inf, pi^2/4) and maps this interval onto the
+// real line. Since g(s)>=s, the iterations are started at the right end of
+// a bracket of the solution and safeguarded by bisection.
+static REAL kdv_finvscatter_solve(const REAL y0)
+{
+    REAL s, s_new, lo, hi, g, dg;
+    UINT iter;
+
+    if (y0 == 0.0)
+        return 0.0;
+    if (y0 > 0.0) {
+        lo = 0.0;
+        hi = (y0 < 0.25*PI*PI) ? y0 : 0.25*PI*PI;
+    } else {
+        // Uses y*tanh(y) >= y-1 for y>=0
+        lo = -(1.0 - y0)*(1.0 - y0);
+        hi = y0;
+    }
+
+    s = hi;
+    for (iter = 0; iter < 100; iter++) {
+        kdv_finvscatter_g(s, &g, &dg);
+        if (g > y0)
+            hi = s;
+        else if (g < y0)
+            lo = s;
+        else
+            break;
+
+        s_new = s - (g - y0)/dg;
+        if (!(s_new > lo && s_new < hi))
+            s_new = 0.5*(lo + hi);
+        if (FABS(s_new - s) <= EPSILON*FABS(s_new)) {
+            s = s_new;
+            break;
+        }
+        s = s_new;
+    }
+    return s;
+}
+
+// Base case of the recursion in akns_finvscatter. The matrices T(z)
+// processed there are the reversed and swapped transfer matrices
+//
+//   Tr(z) = P*z^deg*T(1/z)*P, where P = [0, 1; 1, 0],
+//
+// which are products of the matrices [c, -d*z; u*d, c*z] with
+// c = cos(eps_t*sqrt(u)) and d = eps_t*sinc(eps_t*sqrt(u)). These matrices
+// have the determinant z, and all polynomials are real. The parameter is a
+// pointer to eps_t.
+static INT kdv_finvscatter_base_case(
+    COMPLEX const * const T_11, const UINT T_stride,
+    COMPLEX * const Ti_11, const UINT Ti_stride,
+    COMPLEX * const u_ptr, void const * const params)
+{
+    const REAL eps_t = *(REAL const *)params;
+    COMPLEX const * const T_21 = T_11 + 2*T_stride;
+
+    if (CREAL(T_11[1]) == 0.0)
+        return E_DIV_BY_ZERO;
+
+    // The lower left entry of the matrix for the last sample divided
+    // by the upper left one is u*d/c = g(eps_t^2*u)/eps_t, where g
+    // is the function that is inverted by kdv_finvscatter_solve.
+    const REAL ratio = CREAL(T_21[1]) / CREAL(T_11[1]);
+    const REAL s_val = kdv_finvscatter_solve(eps_t*ratio);
+    const REAL u = s_val/(eps_t*eps_t);
+    REAL x, c, d;
+    if (s_val >= 0.0) {
+        x = SQRT(s_val);
+        c = COS(x);
+        d = (x == 0.0) ? eps_t : eps_t*SIN(x)/x;
+    } else {
+        x = SQRT(-s_val);
+        c = COSH(x);
+        d = eps_t*SINH(x)/x;
+    }
+    *u_ptr = u;
+
+    // The adjugate of [c, -d*z; u*d, c*z], which satisfies
+    // Ti(z)*[c, -d*z; u*d, c*z] = z*I since c^2+u*d^2=1.
+    COMPLEX * const Ti_12 = Ti_11 + Ti_stride;
+    COMPLEX * const Ti_21 = Ti_12 + Ti_stride;
+    COMPLEX * const Ti_22 = Ti_21 + Ti_stride;
+    Ti_11[0] = c;
+    Ti_11[1] = 0.0;
+    Ti_12[0] = d;
+    Ti_12[1] = 0.0;
+    Ti_21[0] = 0.0;
+    Ti_21[1] = -u*d;
+    Ti_22[0] = 0.0;
+    Ti_22[1] = c;
+
+    return SUCCESS;
+}
+
+INT kdv_finvscatter(
+    const UINT deg,
+    COMPLEX const * const transfer_matrix,
+    COMPLEX * const u,
+    const REAL eps_t,
+    const kdv_discretization_t discretization)
+{
+    if (deg == 0)
+        return E_INVALID_ARGUMENT(deg);
+    if (transfer_matrix == NULL)
+        return E_INVALID_ARGUMENT(transfer_matrix);
+    if (u == NULL)
+        return E_INVALID_ARGUMENT(u);
+    if (!(eps_t > 0.0))
+        return E_INVALID_ARGUMENT(eps_t);
+    if (discretization != kdv_discretization_2SPLIT1B
+        && discretization != kdv_discretization_2SPLIT2A)
+        return E_INVALID_ARGUMENT(discretization);
+    const UINT discretization_degree = kdv_discretization_degree(
+        discretization);
+    const UINT D = deg / discretization_degree;
+    if (D < 2 || (D&(D-1)) != 0)
+        return E_OTHER("Number of samples D used to build the transfer matrix was no positive power of two.");
+
+    INT ret_code = SUCCESS;
+    UINT i;
+
+    COMPLEX * const Tr = fnft__aligned_calloc(4*(deg+1), sizeof(COMPLEX));
+    if (Tr == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // The first column of the reversed and swapped transfer matrix Tr(z)
+    // consists of the reversed polynomials in the second column of T(z). The
+    // second column of Tr(z) is not needed and stays zero.
+
+    COMPLEX const * const T_12 = transfer_matrix + (deg+1);
+    COMPLEX const * const T_22 = transfer_matrix + 3*(deg+1);
+    for (i=0; i<=deg; i++) {
+        Tr[i] = CREAL(T_22[deg - i]);
+        Tr[2*(deg+1) + i] = CREAL(T_12[deg - i]);
+    }
+
+    // Run the recursion. All polynomials are real.
+
+    ret_code = akns_finvscatter(deg, Tr, u, kdv_finvscatter_base_case,
+        fnft__poly_fmult_two_polys2x2_real, &eps_t);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    fnft__aligned_free(Tr);
+    return ret_code;
+}
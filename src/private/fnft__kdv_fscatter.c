@@ -28,6 +28,7 @@
 #include "fnft__kdv_discretization.h"
 #include "fnft__akns_discretization.h"
 #include "fnft__misc.h"
+#include "fnft__allocator.h"
 
 /**
  * Returns the length of array to be allocated based on the number
@@ -66,7 +67,7 @@ INT kdv_fscatter(const UINT D, COMPLEX const * const q,
     CHECK_RETCODE(ret_code, leave_fun);   
     
     
-    r = malloc(D*sizeof(COMPLEX));
+    r = fnft__aligned_malloc(D*sizeof(COMPLEX));
     if (r == NULL) {
         ret_code = E_NOMEM;
         goto leave_fun;
@@ -75,9 +76,11 @@ INT kdv_fscatter(const UINT D, COMPLEX const * const q,
     for (i = 0; i < D; i++)
         r[i] = -1;
     
-    ret_code = akns_fscatter(D, q, r, eps_t, result, deg_ptr, W_ptr, akns_discretization);
+    // KdV signals are real, so the combined scattering matrix can be
+    // computed in real arithmetic
+    ret_code = akns_fscatter_real(D, q, r, eps_t, result, deg_ptr, W_ptr, akns_discretization);
 
 leave_fun:
-    free(r);
+    fnft__aligned_free(r);
     return ret_code;
 }
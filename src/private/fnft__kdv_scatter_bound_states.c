@@ -0,0 +1,184 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__errwarn.h"
+#include "fnft__kdv_scatter.h"
+#include "fnft__allocator.h"
+
+// Computes the Boffetta-Osborne step matrix U=expm(eps_t*[-j*l, q; -1, j*l])
+// in U[0..1][0..1] and its derivative with respect to l in U[2..3][0..1].
+static inline void bo_step(const COMPLEX qn, const COMPLEX l,
+    const REAL eps_t, COMPLEX U[4][2])
+{
+    const COMPLEX ks = -qn - l*l;
+    const COMPLEX k = CSQRT(ks);
+    const COMPLEX ch = CCOSH(k*eps_t);
+    COMPLEX sh, u1, ud1, ud2;
+
+    if (ks != 0) {
+        sh = CSINH(k*eps_t)/k;
+        ud1 = eps_t*l*l*(ch/ks)*I;
+        ud2 = l*(eps_t*ch - sh)/ks;
+        U[2][0] = ud1 - (l*eps_t + I + (l*l*I)/ks)*sh;
+        U[3][1] = -ud1 - (l*eps_t - I - (l*l*I)/ks)*sh;
+    } else {
+        // Limits of the expressions above for ks -> 0
+        sh = eps_t;
+        ud2 = l*eps_t*eps_t*eps_t/3.0;
+        U[2][0] = -(l*eps_t + I)*eps_t + l*l*eps_t*eps_t*eps_t*I/3.0;
+        U[3][1] = -(l*eps_t - I)*eps_t - l*l*eps_t*eps_t*eps_t*I/3.0;
+    }
+    u1 = l*sh*I;
+
+    U[0][0] = ch - u1;
+    U[0][1] = qn*sh;
+    U[1][0] = -sh;
+    U[1][1] = ch + u1;
+    U[2][1] = -qn*ud2;
+    U[3][0] = ud2;
+}
+
+/**
+ * Returns the a, a_prime and b computed using the chosen scheme.
+ */
+INT kdv_scatter_bound_states(const UINT D, COMPLEX const * const q,
+        REAL const * const T, const UINT K,
+        COMPLEX const * const bound_states, COMPLEX * const a_vals,
+        COMPLEX * const aprime_vals, COMPLEX * const b,
+        kdv_discretization_t discretization, const UINT skip_b_flag)
+{
+    INT ret_code = SUCCESS;
+    COMPLEX *PHI1 = NULL, *PHI2 = NULL, *PSI1 = NULL, *PSI2 = NULL;
+    COMPLEX U[4][2], phi1, phi2, phi1_d, phi2_d, c, l, e;
+    REAL eps_t, t_left, t_right, boundary_coeff, error_metric, tmp;
+    UINT n, neig;
+
+    // Check inputs
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || !(T[0] < T[1]))
+        return E_INVALID_ARGUMENT(T);
+    if (K == 0)
+        return E_INVALID_ARGUMENT(K);
+    if (bound_states == NULL)
+        return E_INVALID_ARGUMENT(bound_states);
+    if (a_vals == NULL)
+        return E_INVALID_ARGUMENT(a_vals);
+    if (aprime_vals == NULL)
+        return E_INVALID_ARGUMENT(aprime_vals);
+    if (b == NULL && skip_b_flag == 0)
+        return E_INVALID_ARGUMENT(b);
+    if (discretization != kdv_discretization_BO)
+        return E_INVALID_ARGUMENT(discretization);
+
+    // The solutions are stored at all D+1 boundaries of the steps as they
+    // are required to find the right value of b
+    if (skip_b_flag == 0) {
+        PHI1 = fnft__aligned_malloc((D+1) * sizeof(COMPLEX));
+        PHI2 = fnft__aligned_malloc((D+1) * sizeof(COMPLEX));
+        PSI1 = fnft__aligned_malloc((D+1) * sizeof(COMPLEX));
+        PSI2 = fnft__aligned_malloc((D+1) * sizeof(COMPLEX));
+        if (PHI1 == NULL || PHI2 == NULL || PSI1 == NULL || PSI2 == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+
+    eps_t = (T[1] - T[0])/(D - 1);
+    boundary_coeff = kdv_discretization_boundary_coeff(discretization);
+    t_left = T[0] - boundary_coeff*eps_t;
+    t_right = T[1] + boundary_coeff*eps_t;
+
+    for (neig = 0; neig < K; neig++) { // iterate over bound states
+        l = bound_states[neig];
+        if (l == 0.0) {
+            ret_code = E_DIV_BY_ZERO;
+            goto leave_fun;
+        }
+
+        // Scatter the left Jost solution phi=[2*j*l; 1]*exp(-j*l*t) and its
+        // derivative w.r.t. l from t_left to t_right
+        e = CEXP(-I*l*t_left);
+        phi1 = 2.0*I*l*e;
+        phi2 = e;
+        phi1_d = (2.0*I + 2.0*l*t_left)*e;
+        phi2_d = -I*t_left*e;
+        if (skip_b_flag == 0) {
+            PHI1[0] = phi1;
+            PHI2[0] = phi2;
+        }
+        for (n = 0; n < D; n++) {
+            bo_step(q[n], l, eps_t, U);
+
+            c = U[2][0]*phi1 + U[2][1]*phi2 + U[0][0]*phi1_d + U[0][1]*phi2_d;
+            phi2_d = U[3][0]*phi1 + U[3][1]*phi2 + U[1][0]*phi1_d
+                + U[1][1]*phi2_d;
+            phi1_d = c;
+
+            c = U[1][0]*phi1 + U[1][1]*phi2;
+            phi1 = U[0][0]*phi1 + U[0][1]*phi2;
+            phi2 = c;
+            if (skip_b_flag == 0) {
+                PHI1[n+1] = phi1;
+                PHI2[n+1] = phi2;
+            }
+        }
+
+        // For t>t_right, phi = a*[2*j*l; 1]*exp(-j*l*t) + b*[0; 1]*exp(j*l*t)
+        e = CEXP(I*l*t_right);
+        a_vals[neig] = phi1*e/(2.0*I*l);
+        aprime_vals[neig] = (phi1_d + I*t_right*phi1)*e/(2.0*I*l)
+            - a_vals[neig]/l;
+
+        if (skip_b_flag == 0) {
+            // Scatter the right Jost solution psi=[0; 1]*exp(j*l*t) from
+            // t_right back to t_left. The step matrices have determinant one.
+            PSI1[D] = 0.0;
+            PSI2[D] = e;
+            for (n = D; n-- > 0; ) {
+                bo_step(q[n], l, eps_t, U);
+                PSI1[n] = U[1][1]*PSI1[n+1] - U[0][1]*PSI2[n+1];
+                PSI2[n] = -U[1][0]*PSI1[n+1] + U[0][0]*PSI2[n+1];
+            }
+
+            // Calculation of b assuming a=0
+            // Uses the metric from DOI: 10.1109/ACCESS.2019.2932256 for
+            // choosing the computation point
+            error_metric = INFINITY;
+            b[neig] = NAN;
+            for (n = 0; n <= D; n++) {
+                tmp = FABS(0.5*LOG(CABS((PHI2[n]/PSI2[n])/(PHI1[n]/PSI1[n]))));
+                if (tmp < error_metric) {
+                    b[neig] = PHI1[n]/PSI1[n];
+                    error_metric = tmp;
+                }
+            }
+        }
+    }
+
+leave_fun:
+    fnft__aligned_free(PHI1);
+    fnft__aligned_free(PHI2);
+    fnft__aligned_free(PSI1);
+    fnft__aligned_free(PSI2);
+    return ret_code;
+}
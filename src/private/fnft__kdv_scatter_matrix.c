@@ -21,6 +21,7 @@
 
 #include "fnft__errwarn.h"
 #include "fnft__kdv_scatter.h"
+#include "fnft__allocator.h"
 
 /**
  * If derivative_flag=0 returns [S11 S12 S21 S22] in result where
@@ -60,7 +61,7 @@ INT kdv_scatter_matrix(const UINT D, COMPLEX const * const q,
             &akns_discretization);
     CHECK_RETCODE(ret_code, leave_fun);
         
-    r = malloc(D*sizeof(COMPLEX));
+    r = fnft__aligned_malloc(D*sizeof(COMPLEX));
     if (r == NULL) {
         ret_code = E_NOMEM;
         goto leave_fun;
@@ -139,5 +140,6 @@ INT kdv_scatter_matrix(const UINT D, COMPLEX const * const q,
             akns_discretization, derivative_flag);
     
     leave_fun:
+        fnft__aligned_free(r);
         return ret_code;
 }
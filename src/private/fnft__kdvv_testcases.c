@@ -41,10 +41,6 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
     
     // Avoid not used warnings. Not yet used, but will be in the future.
     (void) ab_ptr;
-    (void) K_ptr;
-    (void) bound_states_ptr;
-    (void) normconsts_ptr;
-    (void) residues_ptr;
 
     // Check inputs
     if (D < 2)
@@ -57,15 +53,30 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         return E_INVALID_ARGUMENT(M_ptr);
     if (contspec_ptr == NULL)
         return E_INVALID_ARGUMENT(contspec_ptr);
+    if (K_ptr == NULL)
+        return E_INVALID_ARGUMENT(K_ptr);
+    if (bound_states_ptr == NULL)
+        return E_INVALID_ARGUMENT(bound_states_ptr);
+    if (normconsts_ptr == NULL)
+        return E_INVALID_ARGUMENT(normconsts_ptr);
+    if (residues_ptr == NULL)
+        return E_INVALID_ARGUMENT(residues_ptr);
 
     // Set the number of points in the continuous spectrum *M_ptr and the
     // number of bound states *K_ptr (needed for proper allocation)
     switch (tc) {
 
     case kdvv_testcases_SECH:
+        *M_ptr = 16;
+        *K_ptr = 2;
+        break;
     case kdvv_testcases_RECT:
+        *M_ptr = 16;
+        *K_ptr = 1;
+        break;
     case kdvv_testcases_NEGATIVE_RECT:
         *M_ptr = 16;
+        *K_ptr = 0;
         break;
 
     default:
@@ -83,6 +94,20 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         ret_code = E_NOMEM;
         goto release_mem_2;
     }
+    if (*K_ptr > 0) {
+        *bound_states_ptr = malloc((*K_ptr) * sizeof(COMPLEX));
+        *normconsts_ptr = malloc((*K_ptr) * sizeof(COMPLEX));
+        *residues_ptr = malloc((*K_ptr) * sizeof(COMPLEX));
+        if (*bound_states_ptr == NULL || *normconsts_ptr == NULL
+            || *residues_ptr == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem_3;
+        }
+    } else {
+        *bound_states_ptr = NULL;
+        *normconsts_ptr = NULL;
+        *residues_ptr = NULL;
+    }
 
     // generate test case
     switch (tc) {
@@ -138,6 +163,23 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         (*contspec_ptr)[14] =  0.00002748286948200803407581026489337631688606 - 0.00002228910643157474631983979506634092581568*I;
         (*contspec_ptr)[15] =0.000005195158073745829592578906521934403128604 - 0.000005207592023284621408556242469680129799988*I;
 
+        // The bound states are j*kappa_k with kappa_k = s - 1/2 - k, where
+        // s = sqrt(A + 1/4) and k = 0, 1, ... as long as kappa_k > 0. The
+        // bound states are even or odd functions, so that the norming
+        // constants are (-1)^k. The residues follow from the transmission
+        // coefficient 1/a given above:
+        /*
+        s = sqrt(A + 0.25);
+        kappa = s - 0.5 - (0:floor(s-0.5));
+        residues = 1j*gamma(2*s-(0:1))./(factorial(0:1).*gamma(kappa).*gamma(kappa+1))
+        */
+        (*bound_states_ptr)[0] = 1.357417562100671*I;
+        (*bound_states_ptr)[1] = 0.357417562100671*I;
+        (*normconsts_ptr)[0] = 1.0;
+        (*normconsts_ptr)[1] = -1.0;
+        (*residues_ptr)[0] = 3.943032222028475*I;
+        (*residues_ptr)[1] = 0.7046544820409046*I;
+
         break;
     case kdvv_testcases_RECT:
         
@@ -203,6 +245,20 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         (*contspec_ptr)[13] = - 0.07904675065447655160606575367154906844081 + 0.2208632106193342065286853347418631953582*I;
         (*contspec_ptr)[14] = - 0.06579630203367370114917406544589095133598 + 0.1969199678363887603437522689507922888574*I;
         (*contspec_ptr)[15] = - 0.05487470411329939736278578609268675453902 + 0.1750134338640520324045894423655821274481*I;
+
+        // The single bound state j*kappa is given by the root of
+        // k*tan(k/2) = kappa with k^2 + kappa^2 = ampl. It is even, so that
+        // the norming constant is one. The residue has been computed by
+        // differentiating 1/T given above.
+        /*
+        k = fzero(@(k) k*tan(k/2) - sqrt(1 - k^2), [0 1]);
+        kappa = sqrt(1 - k^2);
+        a = @(z) 1./subs(T, zeta, z);
+        residue = 1/subs(diff(a(zeta), zeta), zeta, 1j*kappa)
+        */
+        (*bound_states_ptr)[0] = 0.4351308590367095*I;
+        (*normconsts_ptr)[0] = 1.0;
+        (*residues_ptr)[0] = 0.447653370915589*I;
        
         break;
         case kdvv_testcases_NEGATIVE_RECT:
@@ -274,13 +330,17 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
     default: // unknown test case
 
         ret_code = E_INVALID_ARGUMENT(tc);
-        goto release_mem_1;
+        goto release_mem_3;
     }
 
     return SUCCESS;
 
     // the code below is only executed if an error occurs
 
+release_mem_3:
+    free(*bound_states_ptr);
+    free(*normconsts_ptr);
+    free(*residues_ptr);
 release_mem_2:
     free(*contspec_ptr);
 release_mem_1:
@@ -289,42 +349,106 @@ release_mem_1:
     return ret_code;
 }
 
+// Relative error of the norming constants or residues vals_1, where the
+// reference value is the one of the closest exact bound state
+static REAL kdvv_discspec_rel_err(const UINT K1, const UINT K2,
+    COMPLEX const * const bound_states_1,
+    COMPLEX const * const bound_states_2,
+    COMPLEX const * const vals_1, COMPLEX const * const vals_2)
+{
+    UINT i, j, min_j = 0;
+    REAL dist, min_dist, err = 0.0, nrm = 0.0;
+
+    for (i=0; i<K1; i++) {
+        min_dist = INFINITY;
+        for (j=0; j<K2; j++) {
+            dist = CABS(bound_states_1[i] - bound_states_2[j]);
+            if (dist < min_dist) {
+                min_dist = dist;
+                min_j = j;
+            }
+        }
+        err += CABS(vals_1[i] - vals_2[min_j]);
+        nrm += CABS(vals_2[min_j]);
+    }
+    if (nrm > 0)
+        err /= nrm;
+    return err;
+}
+
 INT kdvv_testcases_test_fnft(kdvv_testcases_t tc, UINT D,
     const REAL eb[6], fnft_kdvv_opts_t * const opts) {
     COMPLEX * q = NULL;
     COMPLEX * contspec = NULL;
+    COMPLEX * bound_states = NULL;
+    COMPLEX * normconsts_and_residues = NULL;
     REAL T[2], XI[2];
     COMPLEX * contspec_exact = NULL;
     COMPLEX * ab_exact = NULL;
     COMPLEX * bound_states_exact = NULL;
     COMPLEX * normconsts_exact = NULL;
     COMPLEX * residues_exact = NULL;
-    UINT M, K;
+    UINT M, K, K_exact = 0;
     REAL errs[6];
     INT ret_code;
 
+    // Check inputs
+    if (opts == NULL)
+        return E_INVALID_ARGUMENT(opts);
+
     // Load test case
     ret_code = kdvv_testcases(tc, D, &q, T, &M, &contspec_exact, &ab_exact,
-        XI, &K, &bound_states_exact, &normconsts_exact, &residues_exact);
+        XI, &K_exact, &bound_states_exact, &normconsts_exact, &residues_exact);
     CHECK_RETCODE(ret_code, release_mem);
  
     // Allocate memory
     contspec = malloc(M * sizeof(COMPLEX));
-    if ( q == NULL || contspec == NULL ) {
+    K = D;
+    bound_states = malloc(K * sizeof(COMPLEX));
+    normconsts_and_residues = malloc(2*K * sizeof(COMPLEX));
+    if ( q == NULL || contspec == NULL || bound_states == NULL
+        || normconsts_and_residues == NULL ) {
         ret_code = E_NOMEM;
         goto release_mem;
     }
 
+    if (opts->bound_state_localization == kdvv_bsloc_NEWTON) {
+        K = K_exact;
+        for (UINT i=0; i<K; i++)
+            bound_states[i] = bound_states_exact[i];
+    }
+
     // Compute the NFT
-    ret_code = fnft_kdvv(D, q, T, M, contspec, XI, NULL, NULL, NULL, opts);
+    opts->discspec_type = kdvv_dstype_BOTH;
+    ret_code = fnft_kdvv(D, q, T, M, contspec, XI, &K, bound_states,
+        normconsts_and_residues, opts);
     CHECK_RETCODE(ret_code, release_mem);
 
-    // Compute the error(s). So far, only the error in the continuous spectrum
-    // is computed.
+    // Compute the error(s). A wrong number of bound states results in
+    // infinite errors for the discrete spectrum.
     errs[0] = misc_rel_err(M, contspec, contspec_exact);
-    for (UINT i=1; i<6; i++)
+    for (UINT i=1; i<3; i++)
         errs[i] = FNFT_INF;
+    if (K != K_exact) {
+        for (UINT i=3; i<6; i++)
+            errs[i] = FNFT_INF;
+    } else if (K == 0) {
+        for (UINT i=3; i<6; i++)
+            errs[i] = 0.0;
+    } else {
+        errs[3] = misc_hausdorff_dist(K, bound_states, K_exact,
+            bound_states_exact);
+        errs[4] = kdvv_discspec_rel_err(K, K_exact, bound_states,
+            bound_states_exact, normconsts_and_residues, normconsts_exact);
+        errs[5] = kdvv_discspec_rel_err(K, K_exact, bound_states,
+            bound_states_exact, normconsts_and_residues + K, residues_exact);
+    }
     printf("kdvv_testcases_test_fnft: %2.1e <= %2.1e\n", errs[0], eb[0]);
+    for (UINT i=3; i<6; i++) {
+        if (eb[i] < FNFT_INF)
+            printf("kdvv_testcases_test_fnft: %2.1e <= %2.1e\n", errs[i],
+                eb[i]);
+    }
     //print_buf2(M, contspec, "contspec_test");
     //print_buf2(M, contspec_exact, "contspec_exact");
 
@@ -362,6 +486,11 @@ release_mem:
     free(q);
     free(contspec);
     free(contspec_exact);
+    free(bound_states);
+    free(normconsts_and_residues);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
 
     return ret_code;
 }
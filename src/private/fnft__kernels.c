@@ -0,0 +1,150 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__kernels.h"
+
+// The complex arrays are accessed as arrays of reals with interleaved real and
+// imaginary parts (C99 guarantees this layout). Writing out the complex
+// arithmetic by hand lets the compiler vectorize the loops without relying on
+// -fcx-limited-range.
+
+FNFT__TARGET_CLONES
+void kernels_cmul(const UINT n, COMPLEX const * const a,
+    COMPLEX const * const b, COMPLEX * const c)
+{
+    REAL const * const x = (REAL const *)a;
+    REAL const * const y = (REAL const *)b;
+    REAL * const z = (REAL *)c;
+    UINT i;
+
+    for (i=0; i<2*n; i+=2) {
+        const REAL re = x[i]*y[i] - x[i+1]*y[i+1];
+        const REAL im = x[i]*y[i+1] + x[i+1]*y[i];
+        z[i] = re;
+        z[i+1] = im;
+    }
+}
+
+FNFT__TARGET_CLONES
+void kernels_cmul_add(const UINT n, COMPLEX const * const a,
+    COMPLEX const * const b, COMPLEX const * const c, COMPLEX * const d)
+{
+    REAL const * const x = (REAL const *)a;
+    REAL const * const y = (REAL const *)b;
+    REAL const * const u = (REAL const *)c;
+    REAL * const z = (REAL *)d;
+    UINT i;
+
+    for (i=0; i<2*n; i+=2) {
+        const REAL re = x[i]*y[i] - x[i+1]*y[i+1] + u[i];
+        const REAL im = x[i]*y[i+1] + x[i+1]*y[i] + u[i+1];
+        z[i] = re;
+        z[i+1] = im;
+    }
+}
+
+FNFT__TARGET_CLONES
+void kernels_cscale(const UINT n, const REAL scl, COMPLEX const * const x,
+    COMPLEX * const y)
+{
+    REAL const * const u = (REAL const *)x;
+    REAL * const v = (REAL *)y;
+    UINT i;
+
+    for (i=0; i<2*n; i++)
+        v[i] = scl*u[i];
+}
+
+FNFT__TARGET_CLONES
+void kernels_cscale_add(const UINT n, const REAL scl,
+    COMPLEX const * const x, COMPLEX * const y)
+{
+    REAL const * const u = (REAL const *)x;
+    REAL * const v = (REAL *)y;
+    UINT i;
+
+    for (i=0; i<2*n; i++)
+        v[i] += scl*u[i];
+}
+
+FNFT__TARGET_CLONES
+void kernels_abs2(const UINT n, COMPLEX const * const x, REAL * const y)
+{
+    REAL const * const u = (REAL const *)x;
+    UINT i;
+
+    for (i=0; i<n; i++)
+        y[i] = u[2*i]*u[2*i] + u[2*i+1]*u[2*i+1];
+}
+
+FNFT__TARGET_CLONES
+void kernels_deinterleave(const UINT n, COMPLEX const * const x,
+    REAL * const x_re, REAL * const x_im)
+{
+    REAL const * const u = (REAL const *)x;
+    UINT i;
+
+    for (i=0; i<n; i++) {
+        x_re[i] = u[2*i];
+        x_im[i] = u[2*i+1];
+    }
+}
+
+FNFT__TARGET_CLONES
+void kernels_soa_cmul2_add(const UINT n,
+    REAL const * const a_re, REAL const * const a_im,
+    REAL const * const b_re, REAL const * const b_im,
+    REAL const * const c_re, REAL const * const c_im,
+    REAL const * const d_re, REAL const * const d_im,
+    COMPLEX * const y)
+{
+    REAL * const v = (REAL *)y;
+    UINT i;
+
+    for (i=0; i<n; i++) {
+        const REAL re = a_re[i]*b_re[i] - a_im[i]*b_im[i]
+                        + (c_re[i]*d_re[i] - c_im[i]*d_im[i]);
+        const REAL im = a_re[i]*b_im[i] + a_im[i]*b_re[i]
+                        + (c_re[i]*d_im[i] + c_im[i]*d_re[i]);
+        v[2*i] = re;
+        v[2*i+1] = im;
+    }
+}
+
+// The maximum does not depend on the order in which the elements are
+// processed, so it is safe to let the compiler reorder the reduction.
+#ifdef HAVE_PRAGMA_GCC_OPTIMIZE_OFAST
+#pragma GCC optimize("Ofast")
+#endif
+
+FNFT__TARGET_CLONES
+REAL kernels_max_abs_re_im(const UINT n, COMPLEX const * const x)
+{
+    REAL const * const u = (REAL const *)x;
+    REAL max_abs = 0.0;
+    UINT i;
+
+    for (i=0; i<2*n; i++) {
+        const REAL cur_abs = FABS(u[i]);
+        max_abs = cur_abs > max_abs ? cur_abs : max_abs;
+    }
+    return max_abs;
+}
@@ -22,8 +22,11 @@
 
 #include "fnft__errwarn.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "fnft__misc.h"
 #include "fnft__fft_wrapper.h"
+#include "fnft__allocator.h"
 
 void misc_print_buf(const INT len, COMPLEX const * const buf,
                     char const * const varname)
@@ -225,10 +228,108 @@ INT misc_filter_nonreal(UINT *N_ptr, COMPLEX * const vals, const REAL tol_im)
     return SUCCESS;
 }
 
+// Auxiliary type and functions for misc_merge and misc_match_nearest. Finite
+// values are assigned to the cells of a square grid with cell width h.
+// Values whose distance is less than h/2 lie in the same or in neighbouring
+// cells. The entries of the grid are sorted by cell and by index, so that the
+// values in a given cell can be found by binary search.
+typedef struct {
+    REAL cx;
+    REAL cy;
+    UINT idx;
+} misc_grid_entry_t;
+
+// The grid is only used for arrays with at least this many elements.
+// Smaller arrays are processed by direct comparison.
+#define MISC_GRID_MIN_N 32
+
+// Cell coordinates are integers stored as REAL. They must be small enough
+// to be represented exactly, also after adding +/-1.
+#define MISC_GRID_MAX_CELL 1125899906842624.0 // 2^50
+
+static int misc_grid_compare(const void *a, const void *b)
+{
+    misc_grid_entry_t const * const x = a;
+    misc_grid_entry_t const * const y = b;
+    if (x->cx != y->cx)
+        return x->cx < y->cx ? -1 : 1;
+    if (x->cy != y->cy)
+        return x->cy < y->cy ? -1 : 1;
+    return (x->idx > y->idx) - (x->idx < y->idx);
+}
+
+static inline INT misc_grid_isfinite(const COMPLEX val)
+{
+    return isfinite(CREAL(val)) && isfinite(CIMAG(val));
+}
+
+// Returns 1 if the cells of all finite values can be represented exactly.
+static inline INT misc_grid_usable(const UINT N, COMPLEX const * const vals,
+    const REAL h)
+{
+    UINT i;
+    if (!(h > 0.0) || !isfinite(h))
+        return 0;
+    for (i = 0; i < N; i++) {
+        if (misc_grid_isfinite(vals[i])
+            && !(FABS(CREAL(vals[i]))/h < MISC_GRID_MAX_CELL
+                 && FABS(CIMAG(vals[i]))/h < MISC_GRID_MAX_CELL))
+            return 0;
+    }
+    return 1;
+}
+
+// Allocates and fills the grid for the finite values in vals. The number of
+// entries is stored in *n_ptr.
+static INT misc_grid_build(const UINT N, COMPLEX const * const vals,
+    const REAL h, misc_grid_entry_t ** const grid_ptr, UINT * const n_ptr)
+{
+    misc_grid_entry_t *grid;
+    UINT i, n = 0;
+
+    grid = fnft__malloc(N * sizeof(misc_grid_entry_t));
+    if (grid == NULL)
+        return E_NOMEM;
+    for (i = 0; i < N; i++) {
+        if (misc_grid_isfinite(vals[i])) {
+            grid[n].cx = FLOOR(CREAL(vals[i])/h);
+            grid[n].cy = FLOOR(CIMAG(vals[i])/h);
+            grid[n].idx = i;
+            n++;
+        }
+    }
+    qsort(grid, n, sizeof(misc_grid_entry_t), misc_grid_compare);
+
+    *grid_ptr = grid;
+    *n_ptr = n;
+    return SUCCESS;
+}
+
+// Returns the position of the first entry of the grid in the cell (cx, cy),
+// or of the entry where this cell would start if it is empty.
+static inline UINT misc_grid_find(misc_grid_entry_t const * const grid,
+    const UINT n, const REAL cx, const REAL cy)
+{
+    UINT lo = 0, hi = n, mid;
+    while (lo < hi) {
+        mid = lo + (hi - lo)/2;
+        if (grid[mid].cx < cx || (grid[mid].cx == cx && grid[mid].cy < cy))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
 INT misc_merge(UINT *N_ptr, COMPLEX * const vals, REAL tol)
 {
     REAL dist = -1.0;
-    UINT i, j, N, N_filtered;
+    UINT i, j, k, N, N_filtered, n;
+    INT dx, dy, drop;
+    misc_grid_entry_t *grid = NULL;
+    COMPLEX *orig = NULL;
+    unsigned char *kept = NULL;
+    INT ret_code = SUCCESS;
 
     if (N_ptr == NULL)
         return E_INVALID_ARGUMENT(N_ptr);
@@ -238,24 +339,160 @@ INT misc_merge(UINT *N_ptr, COMPLEX * const vals, REAL tol)
         return E_INVALID_ARGUMENT(vals);
     if (tol < 0.0)
         return E_INVALID_ARGUMENT(tol);
+    // No distance is less than zero, so nothing is merged
+    if (!(tol > 0.0))
+        return SUCCESS;
 
     N = *N_ptr;
-    N_filtered = 1;
-    for (i=1; i<N; i++) {
-        for (j = 0; j < i; j++) {
-            dist = CABS(vals[j] - vals[i]);
+    if (N < MISC_GRID_MIN_N || !misc_grid_usable(N, vals, 2*tol)) {
+        N_filtered = 1;
+        for (i=1; i<N; i++) {
+            for (j = 0; j < i; j++) {
+                dist = CABS(vals[j] - vals[i]);
+                if (dist < tol)
+                    break;
+            }
             if (dist < tol)
-                break;
+                continue;
+
+            // Keep bound value since it is not close to previous values
+            vals[N_filtered++] = vals[i];
         }
-        if (dist < tol)
+        *N_ptr = N_filtered;
+        return SUCCESS;
+    }
+
+    // The result is the same as above. A value is compared with all earlier
+    // values that are still in the array when it is visited: the values that
+    // have been kept, and the values that have been dropped but not yet been
+    // overwritten by kept ones (i.e., whose index is at least N_filtered).
+    // Only values in neighbouring cells can be closer than tol.
+    orig = fnft__malloc(N * sizeof(COMPLEX));
+    kept = fnft__calloc(N, sizeof(unsigned char));
+    if (orig == NULL || kept == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    memcpy(orig, vals, N * sizeof(COMPLEX));
+    ret_code = misc_grid_build(N, orig, 2*tol, &grid, &n);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    N_filtered = 0;
+    for (i=0; i<N; i++) {
+        drop = 0;
+        if (misc_grid_isfinite(orig[i])) {
+            const REAL cx = FLOOR(CREAL(orig[i])/(2*tol));
+            const REAL cy = FLOOR(CIMAG(orig[i])/(2*tol));
+            for (dx = -1; dx <= 1 && !drop; dx++) {
+                for (dy = -1; dy <= 1 && !drop; dy++) {
+                    k = misc_grid_find(grid, n, cx + dx, cy + dy);
+                    for (; k < n && grid[k].cx == cx + dx
+                         && grid[k].cy == cy + dy && grid[k].idx < i; k++) {
+                        j = grid[k].idx;
+                        if ((kept[j] || j >= N_filtered)
+                            && CABS(orig[j] - orig[i]) < tol) {
+                            drop = 1;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        if (drop)
             continue;
 
         // Keep bound value since it is not close to previous values
-        vals[N_filtered++] = vals[i];
+        kept[i] = 1;
+        vals[N_filtered++] = orig[i];
     }
     *N_ptr = N_filtered;
 
-    return SUCCESS;
+leave_fun:
+    fnft__free(grid);
+    fnft__free(kept);
+    fnft__free(orig);
+    return ret_code;
+}
+
+INT misc_match_nearest(const UINT N, COMPLEX const * const vals,
+    const UINT N_ref, COMPLEX const * const vals_ref, const REAL rel_tol,
+    UINT * const loc)
+{
+    REAL abs_val, err, err_thres, h, max_abs = 0.0;
+    UINT i, j, k, n;
+    INT dx, dy;
+    misc_grid_entry_t *grid = NULL;
+    INT ret_code = SUCCESS;
+
+    if (N == 0)
+        return SUCCESS;
+    if (vals == NULL)
+        return E_INVALID_ARGUMENT(vals);
+    if (N_ref > 0 && vals_ref == NULL)
+        return E_INVALID_ARGUMENT(vals_ref);
+    if (loc == NULL)
+        return E_INVALID_ARGUMENT(loc);
+    if (!(rel_tol >= 0.0))
+        return E_INVALID_ARGUMENT(rel_tol);
+
+    // All matches of vals[i] are closer than rel_tol*|vals[i]|, so cells of
+    // width h contain all candidates
+    for (i = 0; i < N; i++) {
+        if (misc_grid_isfinite(vals[i]) && CABS(vals[i]) > max_abs)
+            max_abs = CABS(vals[i]);
+    }
+    h = 2*rel_tol*max_abs;
+
+    if (N_ref < MISC_GRID_MIN_N || !misc_grid_usable(N, vals, h)
+        || !misc_grid_usable(N_ref, vals_ref, h)) {
+        for (i = 0; i < N; i++) {
+            abs_val = CABS(vals[i]);
+            err_thres = rel_tol;
+            loc[i] = N_ref;
+            for (j = 0; j < N_ref; j++) {
+                err = CABS(vals[i] - vals_ref[j])/abs_val;
+                if (err < err_thres) {
+                    err_thres = err;
+                    loc[i] = j;
+                }
+            }
+        }
+        return SUCCESS;
+    }
+
+    ret_code = misc_grid_build(N_ref, vals_ref, h, &grid, &n);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (i = 0; i < N; i++) {
+        loc[i] = N_ref;
+        abs_val = CABS(vals[i]);
+        if (!misc_grid_isfinite(vals[i]) || !(abs_val > 0.0))
+            continue;
+        const REAL cx = FLOOR(CREAL(vals[i])/h);
+        const REAL cy = FLOOR(CIMAG(vals[i])/h);
+        err_thres = rel_tol;
+        for (dx = -1; dx <= 1; dx++) {
+            for (dy = -1; dy <= 1; dy++) {
+                k = misc_grid_find(grid, n, cx + dx, cy + dy);
+                for (; k < n && grid[k].cx == cx + dx
+                     && grid[k].cy == cy + dy; k++) {
+                    j = grid[k].idx;
+                    err = CABS(vals[i] - vals_ref[j])/abs_val;
+                    // Cells are not visited in the order of the indices, so
+                    // ties are resolved explicitly in favor of the lower index
+                    if (err < err_thres || (err == err_thres
+                                            && loc[i] < N_ref && j < loc[i])) {
+                        err_thres = err;
+                        loc[i] = j;
+                    }
+                }
+            }
+        }
+    }
+
+leave_fun:
+    fnft__free(grid);
+    return ret_code;
 }
 
 INT misc_downsample(const UINT D, COMPLEX const * const q,
@@ -281,7 +518,7 @@ INT misc_downsample(const UINT D, COMPLEX const * const q,
     const UINT nskip_per_step = ROUND((REAL)D / Dsub);
     Dsub = ROUND((REAL)D / nskip_per_step); // actual Dsub
 
-    COMPLEX * const qsub = malloc(Dsub * sizeof(COMPLEX));
+    COMPLEX * const qsub = fnft__aligned_malloc(Dsub * sizeof(COMPLEX));
     if (qsub == NULL)
         return E_NOMEM;
 
@@ -335,73 +572,144 @@ INT misc_resample(const UINT D, const REAL eps_t, COMPLEX const * const q,
     if (eps_t == 0)
         return E_INVALID_ARGUMENT(eps_t);
 
+    INT ret_code;
+    COMPLEX * const q_spectrum = fft_wrapper_malloc(D * sizeof(COMPLEX));
+    if (q_spectrum == NULL)
+        return E_NOMEM;
+
+    ret_code = misc_resample_spectrum(D, eps_t, q, q_spectrum);
+    CHECK_RETCODE(ret_code, release_mem);
+    ret_code = misc_resample_multi_shift(D, eps_t, q_spectrum, 1, &delta, 1,
+                                         q_new);
+    CHECK_RETCODE(ret_code, release_mem);
+
+release_mem:
+    fft_wrapper_free(q_spectrum);
+    return ret_code;
+}
+
+INT misc_resample_spectrum(const UINT D, const REAL eps_t,
+    COMPLEX const * const q, COMPLEX * const q_spectrum)
+{
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (D <= 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q_spectrum == NULL)
+        return E_INVALID_ARGUMENT(q_spectrum);
+    if (eps_t == 0)
+        return E_INVALID_ARGUMENT(eps_t);
+
     fft_wrapper_plan_t plan_fwd = fft_wrapper_safe_plan_init();
-    fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
-    COMPLEX *buf0 = NULL, *buf1 = NULL;
-    REAL *freq = NULL;
+    COMPLEX *buf0 = NULL;
     INT ret_code;
     UINT i;
-    // Allocate memory
-
 
-    const UINT lenmem = D * sizeof(COMPLEX);
-    buf0 = fft_wrapper_malloc(lenmem);
-    buf1 = fft_wrapper_malloc(lenmem);
-    freq = malloc(D * sizeof(REAL));
-    if (buf0 == NULL || buf1 == NULL || freq == NULL) {
+    buf0 = fft_wrapper_malloc(D * sizeof(COMPLEX));
+    if (buf0 == NULL) {
         ret_code = E_NOMEM;
         goto release_mem;
     }
 
-    ret_code = fft_wrapper_create_plan(&plan_fwd, D, buf0, buf1, -1);
-    CHECK_RETCODE(ret_code, release_mem);
-
-
-    ret_code = fft_wrapper_create_plan(&plan_inv, D, buf0, buf1, 1);
+    ret_code = fft_wrapper_create_plan(&plan_fwd, D, buf0, q_spectrum, -1);
     CHECK_RETCODE(ret_code, release_mem);
 
     // Continuing the signal periodically
     for (i = 0; i < D; i++)
         buf0[i] = q[i];
 
-    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, buf1);
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, q_spectrum);
     CHECK_RETCODE(ret_code, release_mem);
 
     // Check that the signal spectrum decays sufficiently to ensure accurate interpolation
     
-    // D samples of buf1 correspond to 100% bandwidth. Find the total l2-norm
-    // of buf1 and compare it to l2-norm of 90% bandwidth. To prevent repeated 
-    // computation, the two norms of the 5% bandwidths on both ends of the
-    // spectrum are computed instead.
+    // D samples of q_spectrum correspond to 100% bandwidth. Find the total
+    // l2-norm of q_spectrum and compare it to l2-norm of 90% bandwidth. To
+    // prevent repeated computation, the two norms of the 5% bandwidths on
+    // both ends of the spectrum are computed instead.
     UINT Dlp = D/20;
-    REAL tmp = SQRT(misc_l2norm2(Dlp, buf1+D/2-1-Dlp, 0, Dlp*eps_t) + 
-            misc_l2norm2(Dlp, buf1+D/2+1, 0, Dlp*eps_t))/SQRT(misc_l2norm2(D, buf1, 0, D*eps_t));
+    REAL tmp = SQRT(misc_l2norm2(Dlp, q_spectrum+D/2-1-Dlp, 0, Dlp*eps_t) + 
+            misc_l2norm2(Dlp, q_spectrum+D/2+1, 0, Dlp*eps_t))/SQRT(misc_l2norm2(D, q_spectrum, 0, D*eps_t));
     if (tmp > SQRT(EPSILON))
         WARN("Signal does not appear to be bandlimited. Interpolation step may be inaccurate. Try to reduce the step size, or switch to a discretization that does not require interpolation");
-    
+
+release_mem:  
+    fft_wrapper_destroy_plan(&plan_fwd);
+    fft_wrapper_free(buf0);
+    return ret_code;
+}
+
+INT misc_resample_multi_shift(const UINT D, const REAL eps_t,
+    COMPLEX const * const q_spectrum, const UINT nshifts,
+    REAL const * const delta, const UINT nskip, COMPLEX * const q_new)
+{
+    if (q_spectrum == NULL)
+        return E_INVALID_ARGUMENT(q_spectrum);
+    if (D <= 2)
+        return E_INVALID_ARGUMENT(D);
+    if (nshifts > 0 && delta == NULL)
+        return E_INVALID_ARGUMENT(delta);
+    if (nskip == 0 || nskip > D)
+        return E_INVALID_ARGUMENT(nskip);
+    if (q_new == NULL)
+        return E_INVALID_ARGUMENT(q_new);
+    if (eps_t == 0)
+        return E_INVALID_ARGUMENT(eps_t);
+
+    fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
+    COMPLEX *buf0 = NULL, *buf1 = NULL;
+    REAL *freq = NULL;
+    INT ret_code = SUCCESS;
+    UINT i, j, k;
+
+    // If nskip divides D, the samples at t_0, t_nskip, t_2*nskip, ... are
+    // obtained from an inverse FFT of length D/nskip of the aliased
+    // spectrum. Otherwise, a full-length inverse FFT is computed and every
+    // nskip-th sample is picked.
+    const UINT Dout = (D + nskip - 1)/nskip;
+    const UINT L = (D % nskip == 0) ? Dout : D;
+    const UINT stride = (L == D) ? nskip : 1;
+
+    buf0 = fft_wrapper_malloc(L * sizeof(COMPLEX));
+    buf1 = fft_wrapper_malloc(L * sizeof(COMPLEX));
+    freq = fnft__aligned_malloc(D * sizeof(REAL));
+    if (buf0 == NULL || buf1 == NULL || freq == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    ret_code = fft_wrapper_create_plan(&plan_inv, L, buf0, buf1, 1);
+    CHECK_RETCODE(ret_code, release_mem);
+
     const REAL scl_factor = (REAL)D*eps_t;
-    // Applying phase shift
     for (i = 0; i <D/2; i++)
         freq[i] = i/scl_factor;
     for (i = D/2; i < D; i++)
         freq[i] = ((REAL)i - (REAL)D)/scl_factor;
 
-    for (i = 0; i < D; i++) {
-        buf1[i] *= CEXP(2*I*PI*delta*freq[i]);
-    }
+    for (j = 0; j < nshifts; j++) {
 
-    // Inverse FFT and truncation
-    ret_code = fft_wrapper_execute_plan(plan_inv, buf1, buf0);
-    CHECK_RETCODE(ret_code, release_mem);
-    for (i = 0; i < D; i++)
-        q_new[i] = buf0[i]/D;
+        // Applying phase shift (and folding the spectrum if L < D)
+        for (k = 0; k < L; k++)
+            buf0[k] = 0.0;
+        k = 0;
+        for (i = 0; i < D; i++) {
+            buf0[k] += q_spectrum[i] * CEXP(2*I*PI*delta[j]*freq[i]);
+            if (++k == L)
+                k = 0;
+        }
 
+        // Inverse FFT and truncation
+        ret_code = fft_wrapper_execute_plan(plan_inv, buf0, buf1);
+        CHECK_RETCODE(ret_code, release_mem);
+        for (i = 0; i < Dout; i++)
+            q_new[j*Dout + i] = buf1[i*stride]/D;
+    }
 
 release_mem:  
-    fft_wrapper_destroy_plan(&plan_fwd);
     fft_wrapper_destroy_plan(&plan_inv);
     fft_wrapper_free(buf0);
     fft_wrapper_free(buf1);
-    free(freq);
+    fnft__aligned_free(freq);
     return ret_code;
 }
@@ -21,6 +21,7 @@
 
 #include "fnft__nse_discretization.h"
 #include "fnft__akns_discretization.h"
+#include "fnft__allocator.h"
 
 /**
  * Returns the max degree of the polynomials in a single scattering
@@ -379,6 +380,45 @@ INT fnft__nse_discretization_phase_factor_b(const REAL eps_t, const UINT D, REAL
 }
 
 
+// Computes q(t_{n*nskip_per_step} + delta[j]) for j=0,...,nshifts-1 and
+// n=0,1,...,ceil(D/nskip_per_step)-1. The forward FFT of q is computed only
+// once and reused in later calls if q_spectrum_ptr is not NULL.
+static INT resample(const UINT D, COMPLEX const * const q, const REAL eps_t,
+        const UINT nshifts, REAL const * const delta,
+        const UINT nskip_per_step, COMPLEX ** const q_spectrum_ptr,
+        COMPLEX ** const q_shifted_ptr)
+{
+    INT ret_code = SUCCESS;
+    COMPLEX *q_spectrum = NULL;
+
+    if (q_spectrum_ptr != NULL && *q_spectrum_ptr != NULL) {
+        q_spectrum = *q_spectrum_ptr;
+    } else {
+        q_spectrum = fnft__aligned_malloc(D * sizeof(COMPLEX));
+        if (q_spectrum == NULL)
+            return E_NOMEM;
+        ret_code = misc_resample_spectrum(D, eps_t, q, q_spectrum);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+    const UINT Dout = (D + nskip_per_step - 1)/nskip_per_step;
+    *q_shifted_ptr = fnft__aligned_malloc(nshifts * Dout * sizeof(COMPLEX));
+    if (*q_shifted_ptr == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    ret_code = misc_resample_multi_shift(D, eps_t, q_spectrum, nshifts, delta,
+            nskip_per_step, *q_shifted_ptr);
+    CHECK_RETCODE(ret_code, release_mem);
+
+release_mem:
+    if (q_spectrum_ptr != NULL && ret_code == SUCCESS)
+        *q_spectrum_ptr = q_spectrum;
+    else if (q_spectrum_ptr == NULL || q_spectrum != *q_spectrum_ptr)
+        fnft__aligned_free(q_spectrum);
+    return ret_code;
+}
+
 /**
  * This routine preprocess the signal by resampling and subsampling based on the discretization.
  * The preprocessing is necessary for higher-order methods.
@@ -386,19 +426,20 @@ INT fnft__nse_discretization_phase_factor_b(const REAL eps_t, const UINT D, REAL
 INT fnft__nse_discretization_preprocess_signal(const UINT D, COMPLEX const * const q,
         REAL const eps_t, const INT kappa,
         UINT * const Dsub_ptr, COMPLEX **q_preprocessed_ptr, COMPLEX **r_preprocessed_ptr,
-        UINT * const first_last_index,  nse_discretization_t discretization)
+        UINT * const first_last_index,  nse_discretization_t discretization,
+        COMPLEX ** const q_spectrum_ptr)
 {
     
-    UINT i, D_effective, isub;
+    UINT i, j, D_effective, isub;
     INT ret_code = SUCCESS;
+    COMPLEX *q_shifted = NULL;
     COMPLEX *q_1 = NULL;
     COMPLEX *q_2 = NULL;
     COMPLEX *q_3 = NULL;
-    
-    COMPLEX *r_1 = NULL;
-    COMPLEX *r_2 = NULL;
-    COMPLEX *r_3 = NULL;
+    REAL delta[2];
     COMPLEX *weights = NULL;
+    COMPLEX *q_preprocessed = NULL;
+    COMPLEX *r_preprocessed = NULL;
     
     // Check inputs
     if (D < 2)
@@ -435,13 +476,15 @@ INT fnft__nse_discretization_preprocess_signal(const UINT D, COMPLEX const * con
         goto release_mem;
     }
     D_effective = Dsub * upsampling_factor;
-    COMPLEX * const q_preprocessed = malloc(D_effective * sizeof(COMPLEX));
-    COMPLEX * const r_preprocessed = malloc(D_effective * sizeof(COMPLEX));
-    if (q_preprocessed == NULL || r_preprocessed == NULL) {
+    q_preprocessed = fnft__aligned_malloc(D_effective * sizeof(COMPLEX));
+    if (q_preprocessed == NULL) {
         ret_code = E_NOMEM;
         goto release_mem;
     }
 
+    // The resampled signals q_1 and q_3 (resp. q_1 and q_2) below only
+    // contain the samples that are needed, i.e., q_1[j] corresponds to
+    // q[j*nskip_per_step].
     switch (discretization) {
         
         case nse_discretization_BO: // Bofetta-Osborne scheme
@@ -467,143 +510,87 @@ INT fnft__nse_discretization_preprocess_signal(const UINT D, COMPLEX const * con
             i = 0;
             for (isub=0; isub<D_effective; isub++) {
                 q_preprocessed[isub] = q[i];
-                r_preprocessed[isub] = -kappa*CONJ(q[i]);
                 i += nskip_per_step;
             }
             break;
         case nse_discretization_CF4_2:
         case nse_discretization_4SPLIT4A:
         case nse_discretization_4SPLIT4B:    
-            q_1 = malloc(D * sizeof(COMPLEX));
-            q_2 = malloc(D * sizeof(COMPLEX));
-            if (q_1 == NULL || q_2 == NULL) {
-                ret_code = E_NOMEM;
-                goto release_mem;
-            }
-            REAL scl_factor = SQRT(3.0)/6.0;
-            ret_code = misc_resample(D, eps_t, q, -eps_t*scl_factor*nskip_per_step, q_1);
+            delta[0] = -eps_t*SQRT(3.0)/6.0*nskip_per_step;
+            delta[1] = eps_t*SQRT(3.0)/6.0*nskip_per_step;
+            ret_code = resample(D, q, eps_t, 2, delta, nskip_per_step,
+                    q_spectrum_ptr, &q_shifted);
             CHECK_RETCODE(ret_code, release_mem);
-            ret_code = misc_resample(D, eps_t, q, eps_t*scl_factor*nskip_per_step, q_2);
-            CHECK_RETCODE(ret_code, release_mem);
-            
+            q_1 = q_shifted;
+            q_2 = q_shifted + (D + nskip_per_step - 1)/nskip_per_step;
             
             ret_code = nse_discretization_method_weights(&weights,discretization);
             CHECK_RETCODE(ret_code, release_mem);
             
-             i = 0;
+            j = 0;
             for (isub=0; isub<D_effective; isub=isub+2) {
-                q_preprocessed[isub] = weights[0]*q_1[i] + weights[1]*q_2[i];
-                q_preprocessed[isub+1] = weights[2]*q_1[i] + weights[3]*q_2[i];
-                r_preprocessed[isub] = -kappa*CONJ(q_preprocessed[isub]);
-                r_preprocessed[isub+1] = -kappa*CONJ(q_preprocessed[isub+1]);
-                i += nskip_per_step;
+                q_preprocessed[isub] = weights[0]*q_1[j] + weights[1]*q_2[j];
+                q_preprocessed[isub+1] = weights[2]*q_1[j] + weights[3]*q_2[j];
+                j++;
             }
-             
-             
             break;
         case nse_discretization_CF4_3:
-            q_1 = malloc(D * sizeof(COMPLEX));
-            q_3 = malloc(D * sizeof(COMPLEX));
-            if (q_1 == NULL || q_3 == NULL) {
-                ret_code = E_NOMEM;
-                goto release_mem;
-            }
-            
-            ret_code = misc_resample(D, eps_t, q, -eps_t*SQRT(3.0/20.0)*nskip_per_step, q_1);
-            CHECK_RETCODE(ret_code, release_mem);
-            ret_code = misc_resample(D, eps_t, q, eps_t*SQRT(3.0/20.0)*nskip_per_step, q_3);
+            delta[0] = -eps_t*SQRT(3.0/20.0)*nskip_per_step;
+            delta[1] = eps_t*SQRT(3.0/20.0)*nskip_per_step;
+            ret_code = resample(D, q, eps_t, 2, delta, nskip_per_step,
+                    q_spectrum_ptr, &q_shifted);
             CHECK_RETCODE(ret_code, release_mem);
+            q_1 = q_shifted;
+            q_3 = q_shifted + (D + nskip_per_step - 1)/nskip_per_step;
 
             ret_code = nse_discretization_method_weights(&weights,discretization);
             CHECK_RETCODE(ret_code, release_mem);
 
             i = 0;
+            j = 0;
             for (isub=0; isub<D_effective; isub=isub+3) {
-                q_preprocessed[isub] = weights[0]*q_1[i] + weights[1]*q[i] + weights[2]*q_3[i];
-                q_preprocessed[isub+1] = weights[3]*q_1[i] + weights[4]*q[i] + weights[5]*q_3[i];
-                q_preprocessed[isub+2] = weights[6]*q_1[i] + weights[7]*q[i] + weights[8]*q_3[i];
-                r_preprocessed[isub] = -kappa*CONJ(q_preprocessed[isub]);
-                r_preprocessed[isub+1] = -kappa*CONJ(q_preprocessed[isub+1]);
-                r_preprocessed[isub+2] = -kappa*CONJ(q_preprocessed[isub+2]);
+                q_preprocessed[isub] = weights[0]*q_1[j] + weights[1]*q[i] + weights[2]*q_3[j];
+                q_preprocessed[isub+1] = weights[3]*q_1[j] + weights[4]*q[i] + weights[5]*q_3[j];
+                q_preprocessed[isub+2] = weights[6]*q_1[j] + weights[7]*q[i] + weights[8]*q_3[j];
                 i += nskip_per_step;
+                j++;
             }
             break;
         case nse_discretization_CF5_3:
-            q_1 = malloc(D * sizeof(COMPLEX));
-            q_3 = malloc(D * sizeof(COMPLEX));
-            r_1 = malloc(D * sizeof(COMPLEX));
-            r_2 = malloc(D * sizeof(COMPLEX));
-            r_3 = malloc(D * sizeof(COMPLEX));
-            if (q_1 == NULL || q_3 == NULL || r_1 == NULL || r_2 == NULL || r_3 == NULL) {
-                ret_code = E_NOMEM;
-                goto release_mem;
-            }
-            
-            ret_code = misc_resample(D, eps_t, q, -eps_t*SQRT(15.0)/10.0*nskip_per_step, q_1);
-            CHECK_RETCODE(ret_code, release_mem);
-            ret_code = misc_resample(D, eps_t, q, eps_t*SQRT(15.0)/10.0*nskip_per_step, q_3);
-            CHECK_RETCODE(ret_code, release_mem);
-            
-            for (i=0; i < D; i++){
-                r_1[i] = -kappa*CONJ(q_1[i]);
-                r_2[i] = -kappa*CONJ(q[i]);
-                r_3[i] = -kappa*CONJ(q_3[i]);
-            }
-            
-            
-            ret_code = nse_discretization_method_weights(&weights,discretization);
-            CHECK_RETCODE(ret_code, release_mem);
-          
-            
-            i = 0;
-            for (isub=0; isub<D_effective; isub=isub+3) {
-                q_preprocessed[isub] = weights[0]*q_1[i]  + weights[1]*q[i] + weights[2]*q_3[i];
-                r_preprocessed[isub] = weights[0]*r_1[i]  + weights[1]*r_2[i] + weights[2]*r_3[i];
-                q_preprocessed[isub+1] = weights[3]*q_1[i]+ weights[4]*q[i] + weights[5]*q_3[i];
-                r_preprocessed[isub+1] = weights[3]*r_1[i]+ weights[4]*r_2[i] + weights[5]*r_3[i];
-                q_preprocessed[isub+2] = weights[6]*q_1[i] + weights[7]*q[i] +  weights[8]*q_3[i];
-                r_preprocessed[isub+2] = weights[6]*r_1[i] + weights[7]*r_2[i] +  weights[8]*r_3[i];
-                i += nskip_per_step;
-            }
-            
-            
-            break;
         case nse_discretization_CF6_4:
-            q_1 = malloc(D * sizeof(COMPLEX));
-            q_3 = malloc(D * sizeof(COMPLEX));
-            r_1 = malloc(D * sizeof(COMPLEX));
-            r_2 = malloc(D * sizeof(COMPLEX));
-            r_3 = malloc(D * sizeof(COMPLEX));
-            if (q_1 == NULL || q_3 == NULL || r_1 == NULL || r_2 == NULL || r_3 == NULL) {
+            delta[0] = -eps_t*SQRT(15.0)/10.0*nskip_per_step;
+            delta[1] = eps_t*SQRT(15.0)/10.0*nskip_per_step;
+            ret_code = resample(D, q, eps_t, 2, delta, nskip_per_step,
+                    q_spectrum_ptr, &q_shifted);
+            CHECK_RETCODE(ret_code, release_mem);
+            q_1 = q_shifted;
+            q_3 = q_shifted + (D + nskip_per_step - 1)/nskip_per_step;
+            // The weights are complex, so r_preprocessed differs from
+            // -kappa*conj(q_preprocessed) and has to be stored explicitly
+            r_preprocessed = fnft__aligned_malloc(D_effective * sizeof(COMPLEX));
+            if (r_preprocessed == NULL) {
                 ret_code = E_NOMEM;
                 goto release_mem;
             }
             
-            ret_code = misc_resample(D, eps_t, q, -eps_t*nskip_per_step*SQRT(15.0)/10.0, q_1);
-            CHECK_RETCODE(ret_code, release_mem);
-            ret_code = misc_resample(D, eps_t, q, eps_t*nskip_per_step*SQRT(15.0)/10.0, q_3);
-            CHECK_RETCODE(ret_code, release_mem);
-            
-            for (i=0; i < D; i++){
-                r_1[i] = -kappa*CONJ(q_1[i]);
-                r_2[i] = -kappa*CONJ(q[i]);
-                r_3[i] = -kappa*CONJ(q_3[i]);
-            }
-            
             ret_code = nse_discretization_method_weights(&weights,discretization);
             CHECK_RETCODE(ret_code, release_mem);
             
+            // Each group of upsampling_factor samples is a linear
+            // combination of q_1, q and q_3 (resp. of r_1, r_2 and r_3,
+            // where r_k = -kappa*conj(q_k))
             i = 0;
-            for (isub=0; isub<D_effective; isub=isub+4) {
-                q_preprocessed[isub] = weights[0]*q_1[i]  + weights[1]*q[i] + weights[2]*q_3[i];
-                r_preprocessed[isub] = weights[0]*r_1[i]  + weights[1]*r_2[i] + weights[2]*r_3[i];
-                q_preprocessed[isub+1] = weights[3]*q_1[i]+ weights[4]*q[i] + weights[5]*q_3[i];
-                r_preprocessed[isub+1] = weights[3]*r_1[i]+ weights[4]*r_2[i] + weights[5]*r_3[i];
-                q_preprocessed[isub+2] = weights[6]*q_1[i] + weights[7]*q[i] + weights[8]*q_3[i];
-                r_preprocessed[isub+2] = weights[6]*r_1[i] + weights[7]*r_2[i] +  weights[8]*r_3[i];
-                q_preprocessed[isub+3] = weights[9]*q_1[i] + weights[10]*q[i] +  weights[11]*q_3[i];
-                r_preprocessed[isub+3] = weights[9]*r_1[i] + weights[10]*r_2[i] +  weights[11]*r_3[i];
+            j = 0;
+            for (isub=0; isub<D_effective; isub=isub+upsampling_factor) {
+                const COMPLEX r_1 = -kappa*CONJ(q_1[j]);
+                const COMPLEX r_2 = -kappa*CONJ(q[i]);
+                const COMPLEX r_3 = -kappa*CONJ(q_3[j]);
+                for (UINT k=0; k<upsampling_factor; k++) {
+                    q_preprocessed[isub+k] = weights[3*k]*q_1[j] + weights[3*k+1]*q[i] + weights[3*k+2]*q_3[j];
+                    r_preprocessed[isub+k] = weights[3*k]*r_1 + weights[3*k+1]*r_2 + weights[3*k+2]*r_3;
+                }
                 i += nskip_per_step;
+                j++;
             }
             break;
         case nse_discretization_ES4:
@@ -626,10 +613,6 @@ INT fnft__nse_discretization_preprocess_signal(const UINT D, COMPLEX const * con
                 q_preprocessed[isub+1] = (q_preprocessed[isub+3]-q_preprocessed[isub-3])/(2*eps_t_sub); 
                 q_preprocessed[isub+2] = (q_preprocessed[isub+3]-2*q_preprocessed[isub]+q_preprocessed[isub-3])/eps_t_sub_2;
             }
-
-            for (i=0; i<D_effective; i++) {
-                r_preprocessed[i] = -kappa*CONJ(q_preprocessed[i]);
-            }
             break;
         default: // Unknown discretization
             
@@ -645,12 +628,11 @@ INT fnft__nse_discretization_preprocess_signal(const UINT D, COMPLEX const * con
     *Dsub_ptr = Dsub;
     
     release_mem:
-        free(q_1);
-        free(q_2);
-        free(q_3);
-        free(r_1);
-        free(r_2);
-        free(r_3);
-        free(weights);
+        if (ret_code != SUCCESS) {
+            fnft__aligned_free(q_preprocessed);
+            fnft__aligned_free(r_preprocessed);
+        }
+        fnft__aligned_free(q_shifted);
+        fnft__aligned_free(weights);
         return ret_code;
 }
\ No newline at end of file
@@ -47,9 +47,7 @@ INT nse_fscatter(const UINT D, COMPLEX const * const q,
         INT * const W_ptr, nse_discretization_t discretization)
 {
     INT ret_code = SUCCESS;
-    UINT i;
     akns_discretization_t akns_discretization;
-    COMPLEX *r = NULL;
     
     // Check inputs
     if (D == 0)
@@ -68,24 +66,9 @@ INT nse_fscatter(const UINT D, COMPLEX const * const q,
     ret_code = nse_discretization_to_akns_discretization(discretization, &akns_discretization);
     CHECK_RETCODE(ret_code, leave_fun);   
     
-    r = malloc(D*sizeof(COMPLEX));
-    if (r == NULL) {
-        ret_code = E_NOMEM;
-        goto leave_fun;
-    }
-    
-    if (kappa == 1){
-        for (i = 0; i < D; i++)
-            r[i] = -CONJ(q[i]);
-        }
-    else{
-        for (i = 0; i < D; i++)
-            r[i] = CONJ(q[i]);
-        }
-    
-    ret_code = akns_fscatter(D, q, r, eps_t, result, deg_ptr, W_ptr, akns_discretization);
+    ret_code = akns_fscatter_nse(D, q, kappa, eps_t, result, deg_ptr, W_ptr,
+                                 akns_discretization);
 
 leave_fun:
-    free(r);
     return ret_code;
 }
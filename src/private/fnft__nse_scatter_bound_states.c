@@ -21,13 +21,23 @@
 #define FNFT_ENABLE_SHORT_NAMES
 
 #include "fnft__nse_scatter.h"
+#include "fnft__allocator.h"
+
+// Bound states only exist in the focusing case, in which r = -conj(q). When
+// no r is passed it is therefore derived from q on the fly instead of being
+// stored in a separate buffer.
+static inline COMPLEX bound_states_r(COMPLEX const * const q,
+    COMPLEX const * const r, const UINT n)
+{
+    return r != NULL ? r[n] : -CONJ(q[n]);
+}
 
 
 /**
  * Returns the a, a_prime and b computed using the chosen scheme.
  */
 INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
-        COMPLEX *r, REAL const *const T, UINT K,
+        COMPLEX const *const r, REAL const *const T, UINT K,
         COMPLEX *bound_states, COMPLEX *a_vals,
         COMPLEX *aprime_vals, COMPLEX *b,
         nse_discretization_t discretization, UINT skip_b_flag)
@@ -45,6 +55,7 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
     
     COMPLEX a1, a2, a3, s, c, w;
     COMPLEX *tmp1 = NULL, *tmp2 = NULL, *tmp3 = NULL, *tmp4 = NULL;
+    COMPLEX *weights = NULL;
     COMPLEX w_d, s_d, c_d, TM[2][2] = {{0}}, TMD[2][2] = {{0}}, UD[2][2] = {{0}}, UN[2][2] = {{0}};
     UINT disc_flag = 0;
     
@@ -67,18 +78,7 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
         return E_INVALID_ARGUMENT(b);
     
     
-    if (r == NULL) {
-        r = malloc(D*sizeof(COMPLEX));
-        if (r == NULL) {
-            ret_code = E_NOMEM;
-            goto leave_fun;
-        }
-        
-        for (n = 0; n < D; n++)
-            r[n] = -CONJ(q[n]);
-        
-    }
-    l = malloc(D*sizeof(COMPLEX));
+    l = fnft__aligned_malloc(D*sizeof(COMPLEX));
     if (l == NULL) {
         ret_code = E_NOMEM;
         goto leave_fun;
@@ -93,10 +93,10 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
     
     // Allocating memory for storing PHI and PSI at all D_given points as
     // there are required to find the right value of b.
-    PHI1 = malloc((D_given+1) * sizeof(COMPLEX));
-    PHI2 = malloc((D_given+1) * sizeof(COMPLEX));
-    PSI1 = malloc((D_given+1) * sizeof(COMPLEX));
-    PSI2 = malloc((D_given+1) * sizeof(COMPLEX));
+    PHI1 = fnft__aligned_malloc((D_given+1) * sizeof(COMPLEX));
+    PHI2 = fnft__aligned_malloc((D_given+1) * sizeof(COMPLEX));
+    PSI1 = fnft__aligned_malloc((D_given+1) * sizeof(COMPLEX));
+    PSI2 = fnft__aligned_malloc((D_given+1) * sizeof(COMPLEX));
     if (PHI1 == NULL || PHI2 == NULL || PSI1 == NULL || PSI2 == NULL) {
         ret_code = E_NOMEM;
         goto leave_fun;
@@ -115,7 +115,6 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
         goto leave_fun;
     }
     
-    COMPLEX *weights = NULL;
     COMPLEX l_weights[4] = {0};
     UINT M = 0, N = 0, j = 0, i = 0;
 
@@ -131,19 +130,19 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
         // in terms of Pauli matrices.
         case akns_discretization_ES4:
             scl_factor = 1.0;
-            tmp1 = malloc(D*sizeof(COMPLEX));
-            tmp2 = malloc(D*sizeof(COMPLEX));
+            tmp1 = fnft__aligned_malloc(D*sizeof(COMPLEX));
+            tmp2 = fnft__aligned_malloc(D*sizeof(COMPLEX));
             if (tmp1 == NULL ||tmp2 == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
             }
             for (n = 0; n < D; n=n+3){
-                tmp1[n] = eps_t_3*(q[n+2]+r[n+2])/48.0 + (eps_t*(q[n]+r[n]))*0.5;
-                tmp1[n+1] = (eps_t*(q[n]-r[n])*I)*0.5 + (eps_t_3*(q[n+2]-r[n+2])*I)/48.0;
-                tmp1[n+2] = -eps_t_3*(q[n]*r[n+1]- q[n+1]*r[n])/12.0;
+                tmp1[n] = eps_t_3*(q[n+2]+bound_states_r(q, r, n+2))/48.0 + (eps_t*(q[n]+bound_states_r(q, r, n)))*0.5;
+                tmp1[n+1] = (eps_t*(q[n]-bound_states_r(q, r, n))*I)*0.5 + (eps_t_3*(q[n+2]-bound_states_r(q, r, n+2))*I)/48.0;
+                tmp1[n+2] = -eps_t_3*(q[n]*bound_states_r(q, r, n+1)- q[n+1]*bound_states_r(q, r, n))/12.0;
                 
-                tmp2[n] = I*eps_t_3*(q[n+1]-r[n+1])/12.0;
-                tmp2[n+1] = -eps_t_3*(q[n+1]+r[n+1])/12.0;
+                tmp2[n] = I*eps_t_3*(q[n+1]-bound_states_r(q, r, n+1))/12.0;
+                tmp2[n+1] = -eps_t_3*(q[n+1]+bound_states_r(q, r, n+1))/12.0;
                 tmp2[n+2] = -I*eps_t;
             }
             
@@ -156,30 +155,30 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
             // in terms of Pauli matrices.
         case akns_discretization_TES4:
             scl_factor = 1.0;
-            tmp1 = malloc(D*sizeof(COMPLEX));
-            tmp2 = malloc(D*sizeof(COMPLEX));
+            tmp1 = fnft__aligned_malloc(D*sizeof(COMPLEX));
+            tmp2 = fnft__aligned_malloc(D*sizeof(COMPLEX));
             if (tmp1 == NULL || tmp2 == NULL) {
                 ret_code = E_NOMEM;
                 goto leave_fun;
             }
             for (n = 0; n < D; n=n+3){
-                tmp1[n] = (eps_t_3*(q[n+2]+r[n+2]))/96.0 - (eps_t_2*(q[n+1]+r[n+1]))/24.0;
-                tmp1[n+1] = (eps_t_3*(q[n+2]-r[n+2])*I)/96.0 + (eps_t_2*(r[n+1]-q[n+1])*I)/24.0;
-                tmp2[n] = (eps_t_3*(q[n+2]+r[n+2]))/96.0 + (eps_t_2*(q[n+1]+r[n+1]))/24.0;
-                tmp2[n+1] = (eps_t_3*(q[n+2]-r[n+2])*I)/96.0 + (eps_t_2*(q[n+1]-r[n+1])*I)/24.0;
+                tmp1[n] = (eps_t_3*(q[n+2]+bound_states_r(q, r, n+2)))/96.0 - (eps_t_2*(q[n+1]+bound_states_r(q, r, n+1)))/24.0;
+                tmp1[n+1] = (eps_t_3*(q[n+2]-bound_states_r(q, r, n+2))*I)/96.0 + (eps_t_2*(bound_states_r(q, r, n+1)-q[n+1])*I)/24.0;
+                tmp2[n] = (eps_t_3*(q[n+2]+bound_states_r(q, r, n+2)))/96.0 + (eps_t_2*(q[n+1]+bound_states_r(q, r, n+1)))/24.0;
+                tmp2[n+1] = (eps_t_3*(q[n+2]-bound_states_r(q, r, n+2))*I)/96.0 + (eps_t_2*(q[n+1]-bound_states_r(q, r, n+1))*I)/24.0;
             }
             if (skip_b_flag == 0){
-                tmp3 = malloc(D*sizeof(COMPLEX));
-                tmp4 = malloc(D*sizeof(COMPLEX));
+                tmp3 = fnft__aligned_malloc(D*sizeof(COMPLEX));
+                tmp4 = fnft__aligned_malloc(D*sizeof(COMPLEX));
                 if (tmp3 == NULL || tmp4 == NULL) {
                     ret_code = E_NOMEM;
                     goto leave_fun;
                 }
                 for (n = 0; n < D; n=n+3){
-                    tmp3[n] = (-eps_t_3*(q[n+2]+r[n+2]))/96.0 - (eps_t_2*(q[n+1]+r[n+1]))/24.0;
-                    tmp3[n+1] = (-eps_t_3*(q[n+2]-r[n+2])*I)/96.0 + (eps_t_2*(r[n+1]-q[n+1])*I)/24.0;
-                    tmp4[n] = (-eps_t_3*(q[n+2]+r[n+2]))/96.0  + (eps_t_2*(q[n+1]+r[n+1]))/24.0;
-                    tmp4[n+1] = (-eps_t_3*(q[n+2]-r[n+2])*I)/96.0  + (eps_t_2*(q[n+1]-r[n+1])*I)/24.0;
+                    tmp3[n] = (-eps_t_3*(q[n+2]+bound_states_r(q, r, n+2)))/96.0 - (eps_t_2*(q[n+1]+bound_states_r(q, r, n+1)))/24.0;
+                    tmp3[n+1] = (-eps_t_3*(q[n+2]-bound_states_r(q, r, n+2))*I)/96.0 + (eps_t_2*(bound_states_r(q, r, n+1)-q[n+1])*I)/24.0;
+                    tmp4[n] = (-eps_t_3*(q[n+2]+bound_states_r(q, r, n+2)))/96.0  + (eps_t_2*(q[n+1]+bound_states_r(q, r, n+1)))/24.0;
+                    tmp4[n+1] = (-eps_t_3*(q[n+2]-bound_states_r(q, r, n+2))*I)/96.0  + (eps_t_2*(q[n+1]-bound_states_r(q, r, n+1))*I)/24.0;
                 }
             }
             disc_flag = 1;
@@ -296,8 +295,8 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                 phi2 = PHI2[0];
                 for (n = 0; n < D; n++){
                     qn = q[n];
-                    rn = r[n];
-                    ks = ((q[n]*r[n])-(l[n]*l[n]));
+                    rn = bound_states_r(q, r, n);
+                    ks = ((q[n]*rn)-(l[n]*l[n]));
                     k = CSQRT(ks);
                     ch = CCOSH(k*eps_t);
                     chi = ch/ks;
@@ -342,8 +341,8 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                 // in terms of Pauli matrices.
             case akns_discretization_ES4:
                 for (n = 0; n < D; n=n+3){
-                    a1 = tmp1[n]+ eps_t_3*(l_curr*I*(q[n+1]-r[n+1]))/12.0;
-                    a2 = tmp1[n+1] - eps_t_3*l_curr*(q[n+1]+r[n+1])/12.0;
+                    a1 = tmp1[n]+ eps_t_3*(l_curr*I*(q[n+1]-bound_states_r(q, r, n+1)))/12.0;
+                    a2 = tmp1[n+1] - eps_t_3*l_curr*(q[n+1]+bound_states_r(q, r, n+1))/12.0;
                     a3 = - eps_t*I*l_curr +tmp1[n+2];
                     w = CSQRT(-(a1*a1)-(a2*a2)-(a3*a3));
                     if (w != 0)
@@ -399,8 +398,8 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                     TMD[1][0] = TM[1][0];
                     TMD[1][1] = TM[1][1];
                     
-                    a1 = (eps_t*(q[n] + r[n]))*0.5;
-                    a2 = (eps_t*(q[n]*I - r[n]*I))*0.5;
+                    a1 = (eps_t*(q[n] + bound_states_r(q, r, n)))*0.5;
+                    a2 = (eps_t*(q[n]*I - bound_states_r(q, r, n)*I))*0.5;
                     a3 = -eps_t*l_curr*I;
                     w = CSQRT(-(a1*a1)-(a2*a2)-(a3*a3));
                     if (w != 0)
@@ -417,7 +416,7 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                     w_d = l_curr*(eps_t*w*CCOS(w*eps_t)-CSIN(w*eps_t))/(w*w*w);
                     UD[0][0] = c_d-I*s_d;
                     UD[0][1] = w_d*q[n];
-                    UD[1][0] = w_d*r[n];
+                    UD[1][0] = w_d*bound_states_r(q, r, n);
                     UD[1][1] = c_d+I*s_d;
                     
                     misc_mat_mult_2x2(&UN[0][0], &TM[0][0]);
@@ -499,8 +498,8 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                     do{
                         n--;
                         qn = q[n];
-                        rn = r[n];
-                        ks = ((q[n]*r[n])-(l[n]*l[n]));
+                        rn = bound_states_r(q, r, n);
+                        ks = ((q[n]*rn)-(l[n]*l[n]));
                         k = CSQRT(ks);
                         ch = CCOSH(k*eps_t_n);
                         chi = ch/ks;
@@ -537,8 +536,8 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                     n_given = D_given;
                     do{
                         n = n-3;
-                        a1 = -tmp1[n]- eps_t_3*(l_curr*I*(q[n+1]-r[n+1]))/12.0;
-                        a2 = -tmp1[n+1] + eps_t_3*l_curr*(q[n+1]+r[n+1])/12.0;
+                        a1 = -tmp1[n]- eps_t_3*(l_curr*I*(q[n+1]-bound_states_r(q, r, n+1)))/12.0;
+                        a2 = -tmp1[n+1] + eps_t_3*l_curr*(q[n+1]+bound_states_r(q, r, n+1))/12.0;
                         a3 =  eps_t*I*l_curr -tmp1[n+2];
                         w = CSQRT(-(a1*a1)-(a2*a2)-(a3*a3));
                         if (w != 0)
@@ -584,8 +583,8 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                         TM[1][0] = s*(a1+I*a2);
                         TM[1][1] = c;
 
-                        a1 = (eps_t_n*(q[n] + r[n]))*0.5;
-                        a2 = (eps_t_n*(q[n]*I - r[n]*I))*0.5;
+                        a1 = (eps_t_n*(q[n] + bound_states_r(q, r, n)))*0.5;
+                        a2 = (eps_t_n*(q[n]*I - bound_states_r(q, r, n)*I))*0.5;
                         a3 = -eps_t_n*l_curr*I;
                         w = CSQRT(-(a1*a1)-(a2*a2)-(a3*a3));
                         if (w != 0)
@@ -655,14 +654,16 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
         
     }
     leave_fun:
-        free(PHI1);
-        free(PSI1);
-        free(PHI2);
-        free(PSI2);
-        free(tmp1);
-        free(tmp2);
-        free(l);
-        free(weights);
+        fnft__aligned_free(PHI1);
+        fnft__aligned_free(PSI1);
+        fnft__aligned_free(PHI2);
+        fnft__aligned_free(PSI2);
+        fnft__aligned_free(tmp1);
+        fnft__aligned_free(tmp2);
+        fnft__aligned_free(tmp3);
+        fnft__aligned_free(tmp4);
+        fnft__aligned_free(l);
+        fnft__aligned_free(weights);
         return ret_code;
 }
 
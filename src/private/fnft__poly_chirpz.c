@@ -23,6 +23,8 @@
 #include "fnft__poly_chirpz.h"
 #include "fnft__poly_fmult.h"
 #include "fnft__fft_wrapper.h"
+#include "fnft__kernels.h"
+#include "fnft__parallel.h"
 
 /*
  * result should be of length M
@@ -34,72 +36,186 @@ INT poly_chirpz(const UINT deg, COMPLEX const * const p,
     const COMPLEX A, const COMPLEX W, const UINT M,
     COMPLEX * const result)
 {
-    COMPLEX *Y, *V, *buf;
-    fft_wrapper_plan_t plan_fwd = fft_wrapper_safe_plan_init();
-    fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
-    INT ret_code = SUCCESS;
-    UINT n;
+    return poly_chirpz_rings(deg, p, 1, &A, W, M, result);
+}
+
+/*
+ * result should be of length nrings*M
+ * Z = A(j) * W.^-(0:(M-1)); result((j-1)*M+(1:M)) = polyval(p, 1./Z).'
+ */
+INT poly_chirpz_rings(const UINT deg, COMPLEX const * const p,
+    const UINT nrings, COMPLEX const * const A, const COMPLEX W,
+    const UINT M, COMPLEX * const result)
+{
+    poly_chirpz_plan_t plan;
+    INT ret_code;
 
     // Check inputs
     if (p == NULL)
         return E_INVALID_ARGUMENT(p);
-    if (M == 0)
-        return E_INVALID_ARGUMENT(M);
+    if (A == NULL)
+        return E_INVALID_ARGUMENT(A);
     if (result == NULL)
         return E_INVALID_ARGUMENT(result);
 
-    // Allocate memory
+    ret_code = poly_chirpz_create_plan(deg, nrings, W, M, &plan);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    ret_code = poly_chirpz_execute_plan(&plan, p, A, result);
+    CHECK_RETCODE(ret_code, release_mem);
+
+release_mem:
+    poly_chirpz_destroy_plan(&plan);
+    return ret_code;
+}
+
+// The FFT of the kernel vn and the chirp only depend on W and M. They are
+// computed once here and shared by all spirals and executions of the plan.
+INT poly_chirpz_create_plan(const UINT deg, const UINT nrings,
+    const COMPLEX W, const UINT M, poly_chirpz_plan_t * const plan)
+{
+    INT ret_code = SUCCESS;
+    UINT n;
+
+    // Check inputs
+    if (plan == NULL)
+        return E_INVALID_ARGUMENT(plan);
+    plan->V = NULL;
+    plan->chirp = NULL;
+    plan->Y = NULL;
+    plan->buf = NULL;
+    plan->plan_fwd = fft_wrapper_safe_plan_init();
+    plan->plan_inv = fft_wrapper_safe_plan_init();
+    if (nrings == 0)
+        return E_INVALID_ARGUMENT(nrings);
+    if (M == 0)
+        return E_INVALID_ARGUMENT(M);
+
+    // Allocate memory. Every spiral has its own pair of buffers, which start
+    // at multiples of four elements so that they are aligned like the ones
+    // for which the FFT plans are created.
     const UINT N = deg + 1;
     const UINT L = fft_wrapper_next_fft_length(N + M - 1);
-    Y = fft_wrapper_malloc(L * sizeof(COMPLEX));
-    V = fft_wrapper_malloc(L * sizeof(COMPLEX));
-    buf = fft_wrapper_malloc(L * sizeof(COMPLEX));
-    if (Y == NULL || V == NULL || buf == NULL) {
+    const UINT L_stride = (L + 3)/4*4;
+    const UINT len_chirp = N > M ? N : M;
+    plan->deg = deg;
+    plan->nrings = nrings;
+    plan->M = M;
+    plan->L = L;
+    plan->L_stride = L_stride;
+    plan->Y = fft_wrapper_malloc(nrings*L_stride * sizeof(COMPLEX));
+    plan->V = fft_wrapper_malloc(L * sizeof(COMPLEX));
+    plan->buf = fft_wrapper_malloc(nrings*L_stride * sizeof(COMPLEX));
+    plan->chirp = fft_wrapper_malloc(len_chirp * sizeof(COMPLEX));
+    if (plan->Y == NULL || plan->V == NULL || plan->buf == NULL
+        || plan->chirp == NULL) {
         ret_code = E_NOMEM;
-        goto release_mem;
+        goto leave_fun;
     }
 
-    ret_code = fft_wrapper_create_plan(&plan_fwd, L, buf, Y, -1);
-    CHECK_RETCODE(ret_code, release_mem);
-    ret_code = fft_wrapper_create_plan(&plan_inv, L, buf, Y, 1);
-    CHECK_RETCODE(ret_code, release_mem);
+    ret_code = fft_wrapper_create_plan(&plan->plan_fwd, L, plan->buf,
+                                       plan->Y, -1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fft_wrapper_create_plan(&plan->plan_inv, L, plan->buf,
+                                       plan->Y, 1);
+    CHECK_RETCODE(ret_code, leave_fun);
 
-    // Setup yn and compute Yr = fft(yn)
-    for (n=0; n<=N-1; n++)
-        buf[n] = p[deg - n] * CPOW(A, -1.0*n) * CPOW(W, 0.5*n*n);
-    for (n=N; n<L; n++) 
-        buf[n] = 0;
-    ret_code = fft_wrapper_execute_plan(plan_fwd, buf, Y);
-    CHECK_RETCODE(ret_code, release_mem);
+    // Precompute the chirp W^(n^2/2), which is needed in the pre- as well as
+    // in the post-multiplication
+    for (n=0; n<len_chirp; n++)
+        plan->chirp[n] = CPOW(W, 0.5*n*n);
 
     // Setup vn and compute Vr = fft(vn)
+    COMPLEX * const buf = plan->buf;
     for (n=0; n<=M-1; n++)
         buf[n] = CPOW(W, -0.5*n*n);
     for (n=M; n<=L-N; n++)
         buf[n] = 0;
     for (n=L-N+1; n<L; n++)
          buf[n] = CPOW(W, -0.5*(L - n)*(L - n));
-    ret_code = fft_wrapper_execute_plan(plan_fwd, buf, V);
-    CHECK_RETCODE(ret_code, release_mem);
+    ret_code = fft_wrapper_execute_plan(plan->plan_fwd, buf, plan->V);
+    CHECK_RETCODE(ret_code, leave_fun);
 
-    // Multiply V and Y
-    for (n=0; n<L; n++)
-        buf[n] = V[n] * Y[n];
-    
-    // Compute inverse FFT of the product and store it in V
-    ret_code = fft_wrapper_execute_plan(plan_inv, buf, V);
-    CHECK_RETCODE(ret_code, release_mem);
+leave_fun:
+    if (ret_code != SUCCESS)
+        poly_chirpz_destroy_plan(plan);
+    return ret_code;
+}
 
-    // Form the final result
-    for (n=0; n<M; n++)
-        result[n] = CPOW(W, 0.5*n*n) * V[n] / L;
+// The spirals are processed concurrently (OpenMP).
+INT poly_chirpz_execute_plan(poly_chirpz_plan_t * const plan,
+    COMPLEX const * const p, COMPLEX const * const A,
+    COMPLEX * const result)
+{
+    INT ret_code = SUCCESS;
+    INT j;
 
-    // Release memory and return
-release_mem:
-    fft_wrapper_destroy_plan(&plan_fwd);
-    fft_wrapper_destroy_plan(&plan_inv);
-    fft_wrapper_free(Y);
-    fft_wrapper_free(V);
-    fft_wrapper_free(buf);
-    return ret_code;
+    // Check inputs
+    if (plan == NULL || plan->V == NULL)
+        return E_INVALID_ARGUMENT(plan);
+    if (p == NULL)
+        return E_INVALID_ARGUMENT(p);
+    if (A == NULL)
+        return E_INVALID_ARGUMENT(A);
+    if (result == NULL)
+        return E_INVALID_ARGUMENT(result);
+
+    const UINT deg = plan->deg;
+    const UINT N = deg + 1;
+    const UINT M = plan->M;
+    const UINT L = plan->L;
+    COMPLEX const * const V = plan->V;
+    COMPLEX const * const chirp = plan->chirp;
+
+    FNFT__OMP(parallel for if(plan->nrings > 1))
+    for (j=0; j<(INT)plan->nrings; j++) {
+        COMPLEX * const buf_j = plan->buf + j*plan->L_stride;
+        COMPLEX * const Y_j = plan->Y + j*plan->L_stride;
+        COMPLEX * const result_j = result + j*M;
+        INT ret_code_j;
+        UINT m;
+
+        // Setup yn and compute Yr = fft(yn)
+        for (m=0; m<=N-1; m++)
+            buf_j[m] = p[deg - m] * CPOW(A[j], -1.0*m);
+        kernels_cmul(N, buf_j, chirp, buf_j);
+        for (m=N; m<L; m++)
+            buf_j[m] = 0;
+        ret_code_j = fft_wrapper_execute_plan(plan->plan_fwd, buf_j, Y_j);
+
+        if (ret_code_j == SUCCESS) {
+            // Multiply V and Y, compute the inverse FFT of the product and
+            // store it in Y
+            kernels_cmul(L, V, Y_j, buf_j);
+            ret_code_j = fft_wrapper_execute_plan(plan->plan_inv, buf_j, Y_j);
+        }
+
+        if (ret_code_j == SUCCESS) {
+            // Form the final result
+            kernels_cmul(M, Y_j, chirp, result_j);
+            kernels_cscale(M, 1.0/L, result_j, result_j);
+        } else {
+            FNFT__OMP(critical)
+            ret_code = ret_code_j;
+        }
+    }
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    return SUCCESS;
+}
+
+void poly_chirpz_destroy_plan(poly_chirpz_plan_t * const plan)
+{
+    if (plan == NULL)
+        return;
+    fft_wrapper_destroy_plan(&plan->plan_fwd);
+    fft_wrapper_destroy_plan(&plan->plan_inv);
+    fft_wrapper_free(plan->Y);
+    fft_wrapper_free(plan->V);
+    fft_wrapper_free(plan->buf);
+    fft_wrapper_free(plan->chirp);
+    plan->Y = NULL;
+    plan->V = NULL;
+    plan->buf = NULL;
+    plan->chirp = NULL;
 }
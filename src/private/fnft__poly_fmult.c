@@ -27,6 +27,7 @@
 #include "fnft__poly_fmult.h"
 #include "fnft__misc.h"
 #include "fnft__fft_wrapper.h"
+#include "fnft__kernels.h"
 
 #ifdef HAVE_PRAGMA_GCC_OPTIMIZE_OFAST
 #pragma GCC optimize("Ofast")
@@ -59,7 +60,6 @@ inline INT poly_fmult_two_polys(
     COMPLEX * const buf2,
     const UINT mode)
 {
-    UINT i;
     INT ret_code = SUCCESS;
 
     // Zero-pad polynomials
@@ -80,21 +80,21 @@ inline INT poly_fmult_two_polys(
         CHECK_RETCODE(ret_code, leave_fun);
     }
 
-    // Multiply FFT's
-    for (i = 0; i < len; i++)
-        buf0[i] = buf1[i] * buf2[i];
-
     if (mode == 2) {
 
         // Temporarily store product of FFT's in result
-        memcpy(result, buf0, len*sizeof(COMPLEX));
+        kernels_cmul(len, buf1, buf2, result);
 
     } else if (mode == 3) {
 
         // Add product of FFT's to previously stored product in result to
         // current product
-        for (i = 0; i < len; i++)
-            buf0[i] += result[i];
+        kernels_cmul_add(len, buf1, buf2, result, buf0);
+
+    } else {
+
+        // Multiply FFT's
+        kernels_cmul(len, buf1, buf2, buf0);
     }
 
     if (mode != 2) {
@@ -107,13 +107,11 @@ inline INT poly_fmult_two_polys(
     if (mode == 0 || mode == 3) {
 
         // Store relevant part of scaled result of inverse FFT in result
-        for (i = 0; i < 2*deg + 1; i++)
-            result[i] = buf1[i]/len;
+        kernels_cscale(2*deg + 1, 1.0/len, buf1, result);
 
     } else if (mode == 1) {
 
-        for (i = 0; i < 2*deg + 1; i++)
-            result[i] += buf1[i]/len;
+        kernels_cscale_add(2*deg + 1, 1.0/len, buf1, result);
     }
 
 leave_fun:
@@ -122,19 +120,14 @@ leave_fun:
 
 static inline INT poly_rescale(const UINT d, COMPLEX * const p)
 {
-    UINT i;
     INT a;
     REAL scl;
-    REAL cur_abs;
-    REAL max_abs = 0.0;
-
-    // Find max of absolute values of coefficients
-    max_abs = 0.0;
-    for (i=0; i<=d; i++) {
-        cur_abs = CABS( p[i] );
-        if (cur_abs > max_abs)
-            max_abs = cur_abs;
-    }
+    REAL max_abs;
+
+    // Find max of absolute values of the real and imaginary parts of the
+    // coefficients (this avoids square roots and is, up to a factor of
+    // sqrt(2), equal to the max of the absolute values)
+    max_abs = kernels_max_abs_re_im(d+1, p);
 
     // Return if polynomial is identical to zero
     if (max_abs == 0.0)
@@ -143,8 +136,7 @@ static inline INT poly_rescale(const UINT d, COMPLEX * const p)
     // Otherwise, rescale
     a = FLOOR( LOG2(max_abs) );
     scl = POW( 2.0, -a );
-    for (i=0; i<=d; i++)
-        p[i] *= scl;
+    kernels_cscale(d+1, scl, p, p);
 
     return a;
 }
@@ -152,28 +144,21 @@ static inline INT poly_rescale(const UINT d, COMPLEX * const p)
 INT fnft__poly_fmult(UINT * const d, UINT n, COMPLEX * const p,
     INT * const W_ptr)
 {
-    UINT i, j, deg, len, lenmem;
+    UINT i, deg, len, lenmem;
+    UINT deg_excess = 0;
     COMPLEX *p1, *p2, *result;
     fft_wrapper_plan_t plan_fwd = fft_wrapper_safe_plan_init();
     fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
     COMPLEX *buf0 = NULL, *buf1 = NULL, *buf2 = NULL;
     INT W = 0;
-    INT ret_code;
+    INT ret_code = SUCCESS;
 
-    // Pad with z^deg if n is not a power of two
-    const UINT n_excess = misc_nextpowerof2(n) - n;
+    // Allocate memory for calls to poly_fmult_two_polys. If n is not a power
+    // of two, the degree of the last product can be as high as if n had been
+    // padded to the next power of two (see below).
     deg = *d;
-    p1 = p + n*(deg + 1);
-    for (i = 0; !(i >= n_excess); i++) { // "<" does not work because of UINT
-        p1[0] = 1.0;
-        for (j = 1; j<=deg; j++)
-            p1[j] = 0.0;
-        p1 += deg + 1;
-    }
-    n += n_excess;
-
-    // Allocate memory for calls to poly_fmult_two_polys
-    lenmem = poly_fmult_two_polys_len(deg * n/2) * sizeof(COMPLEX);
+    lenmem = poly_fmult_two_polys_len(deg * misc_nextpowerof2(n)/2)
+        * sizeof(COMPLEX);
     buf0 = fft_wrapper_malloc(lenmem);
     buf1 = fft_wrapper_malloc(lenmem);
     buf2 = fft_wrapper_malloc(lenmem);
@@ -198,7 +183,7 @@ INT fnft__poly_fmult(UINT * const d, UINT n, COMPLEX * const p,
         result = p;
 
         // Multiply all pairs of polynomials, normalize if desired
-        for (i=0; i<n; i+=2) {
+        for (i=0; i+1<n; i+=2) {
             ret_code = poly_fmult_two_polys(deg, p1, p2, result, plan_fwd,
                 plan_inv, buf0, buf1, buf2, 0);
             CHECK_RETCODE(ret_code, release_mem);
@@ -211,20 +196,26 @@ INT fnft__poly_fmult(UINT * const d, UINT n, COMPLEX * const p,
             result += 2*deg + 1;
         }
 
+        // If n is odd, the last polynomial has no partner. Instead of padding
+        // the input with z^deg's, the last polynomial is multiplied with
+        // z^deg, which only appends zeros to its coefficients. These zeros
+        // end up at the end of the final result and are removed there.
+        if (n%2 != 0) {
+            memmove(result, p1, (deg+1)*sizeof(COMPLEX));
+            memset(result + deg + 1, 0, deg*sizeof(COMPLEX));
+            deg_excess += deg;
+        }
+
         fft_wrapper_destroy_plan(&plan_fwd);
         fft_wrapper_destroy_plan(&plan_inv);
 
         // Double degrees and half the number of polynomials
         deg *= 2;
-        if (n%2 != 0) { // n was no power of two
-            ret_code = E_INVALID_ARGUMENT(n);
-            goto release_mem;
-        }
-        n /= 2;
+        n = (n + 1)/2;
     }
 
     // Set degree of final result, free memory and return w/o error
-    *d = deg - n_excess*(*d);
+    *d = deg - deg_excess;
     if (W_ptr != NULL)
         *W_ptr = W;
 release_mem:
@@ -236,6 +227,11 @@ release_mem:
     return ret_code;
 }
 
+UINT poly_fmult_two_polys2x2_soa_buf_numel(const UINT deg)
+{
+    return 16*poly_fmult_two_polys_len(deg);
+}
+
 inline INT poly_fmult_two_polys2x2(const UINT deg,
     COMPLEX const * const p1_11,
     const UINT p1_stride,
@@ -247,80 +243,241 @@ inline INT poly_fmult_two_polys2x2(const UINT deg,
     fft_wrapper_plan_t plan_inv,
     COMPLEX * const buf0,
     COMPLEX * const buf1,
-    COMPLEX * const buf2,
-    const UINT mode_offset)
+    REAL * const soa_buf)
 {
-    INT ret_code;
-
-    COMPLEX const * const p1_12 = p1_11 + p1_stride;
-    COMPLEX const * const p1_21 = p1_12 + p1_stride;
-    COMPLEX const * const p1_22 = p1_21 + p1_stride;
-
-    COMPLEX const * const p2_12 = p2_11 + p2_stride;
-    COMPLEX const * const p2_21 = p2_12 + p2_stride;
-    COMPLEX const * const p2_22 = p2_21 + p2_stride;
-
-    COMPLEX * const result_12 = result_11 + result_stride;
-    COMPLEX * const result_21 = result_12 + result_stride;
-    COMPLEX * const result_22 = result_21 + result_stride;
+    INT ret_code = SUCCESS;
+    UINT i, j;
 
     // We compute the matrix product
     //
-    //  [a b ; c d][e f ; g h]=[ae af ; ce cf]+[bg bh ; dg dh],
+    //  [a b ; c d][e f ; g h]=[ae+bg af+bh ; ce+dg cf+dh],
     //
-    // where a=p1_11, b=p1_12, etc.
+    // where a=p1_11, b=p1_12, etc., in the frequency domain. The FFT's of
+    // e, f, g and h are computed once and used for both rows. The sums of
+    // products are formed before the inverse FFT's are taken, so that only
+    // four inverse FFT's are needed. The FFT's are stored with split real
+    // and imaginary parts (see kernels_soa_cmul2_add).
 
-    UINT mode = mode_offset;
+    const UINT len = poly_fmult_two_polys_len(deg);
+    REAL * const e_re = soa_buf;
+    REAL * const e_im = e_re + len;
+    REAL * const f_re = e_im + len;
+    REAL * const f_im = f_re + len;
+    REAL * const g_re = f_im + len;
+    REAL * const g_im = g_re + len;
+    REAL * const h_re = g_im + len;
+    REAL * const h_im = h_re + len;
+    REAL * const a_re = h_im + len;
+    REAL * const a_im = a_re + len;
+    REAL * const b_re = a_im + len;
+    REAL * const b_im = b_re + len;
+
+    // FFT's of the second matrix
+    REAL * const p2_re[4] = { e_re, f_re, g_re, h_re };
+    REAL * const p2_im[4] = { e_im, f_im, g_im, h_im };
+    memset(&buf0[deg+1], 0, (len - (deg+1))*sizeof(COMPLEX));
+    for (j=0; j<4; j++) {
+        memcpy(buf0, p2_11 + j*p2_stride, (deg+1)*sizeof(COMPLEX));
+        ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, buf1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        kernels_deinterleave(len, buf1, p2_re[j], p2_im[j]);
+    }
 
-    // If mode_offset==0:
-    //
-    //   Store ae, af, ce and cf in result_11, result_12, result_21 and
-    //   result_22, respectively
-    //
-    // If mode_offset==2:
-    //
-    //   Store FFT's of ae, af, ce and cf in result_11, result_12, result_21 and
-    //   result_22, respectively. This saves us performing some inverse FFT's,
-    //   but since the polynomials are zero-padded before the FFT is taken, it
-    //   is only possible if the result_* arrays are larger than strictly
-    //   necessary. See the doc of this fun.
-
-    ret_code = poly_fmult_two_polys(deg, p1_11, p2_11, result_11,
-                                    plan_fwd, plan_inv, buf0, buf1, buf2, mode);
-    CHECK_RETCODE(ret_code, leave_fun);
-    ret_code = poly_fmult_two_polys(deg, NULL /*p2_11*/, p1_21, result_21,
-                                    plan_fwd, plan_inv, buf0, buf2, buf1, mode);
-    CHECK_RETCODE(ret_code, leave_fun);
-    ret_code = poly_fmult_two_polys(deg, NULL /*p1_21*/, p2_12, result_22,
-                                    plan_fwd, plan_inv, buf0, buf1, buf2, mode);
+    // Rows of the product
+    for (i=0; i<2; i++) {
+
+        COMPLEX const * const p1_i1 = p1_11 + 2*i*p1_stride;
+        COMPLEX const * const p1_i2 = p1_i1 + p1_stride;
+        COMPLEX * const result_i1 = result_11 + 2*i*result_stride;
+        COMPLEX * const result_i2 = result_i1 + result_stride;
+
+        // FFT's of the current row of the first matrix (buf0 has been
+        // overwritten with a product in the previous row, so zero-pad again)
+        if (i > 0)
+            memset(&buf0[deg+1], 0, (len - (deg+1))*sizeof(COMPLEX));
+        memcpy(buf0, p1_i1, (deg+1)*sizeof(COMPLEX));
+        ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, buf1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        kernels_deinterleave(len, buf1, a_re, a_im);
+        memcpy(buf0, p1_i2, (deg+1)*sizeof(COMPLEX));
+        ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, buf1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        kernels_deinterleave(len, buf1, b_re, b_im);
+
+        // First column: ae+bg (resp. ce+dg)
+        kernels_soa_cmul2_add(len, a_re, a_im, e_re, e_im, b_re, b_im,
+                              g_re, g_im, buf0);
+        ret_code = fft_wrapper_execute_plan(plan_inv, buf0, buf1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        kernels_cscale(2*deg + 1, 1.0/len, buf1, result_i1);
+
+        // Second column: af+bh (resp. cf+dh)
+        kernels_soa_cmul2_add(len, a_re, a_im, f_re, f_im, b_re, b_im,
+                              h_re, h_im, buf0);
+        ret_code = fft_wrapper_execute_plan(plan_inv, buf0, buf1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        kernels_cscale(2*deg + 1, 1.0/len, buf1, result_i2);
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+static inline REAL poly_fmult_max(const REAL x, const REAL y)
+{
+    return x > y ? x : y;
+}
+
+// Auxiliary function: Returns the power of two that is closest to x/y, or
+// one if x or y is zero.
+static inline REAL poly_fmult_pow2_ratio(const REAL x, const REAL y)
+{
+    if (x == 0.0 || y == 0.0)
+        return 1.0;
+    return POW(2.0, ROUND(LOG2(x/y)));
+}
+
+// Auxiliary function: Computes the FFTs x_hat and y_hat of two real arrays x
+// and y of length deg+1 (given by the real parts of complex arrays with
+// the largest absolute values mx and my) with a single complex FFT. The FFT
+// z_hat of z=x+j*s*y is split using that z_hat[k] and conj(z_hat[len-k]) are
+// x_hat[k]+j*s*y_hat[k] and x_hat[k]-j*s*y_hat[k]. The power of two s is
+// chosen such that x and s*y are of similar magnitude, since the rounding
+// errors of the FFT are relative to the largest entry.
+static inline INT poly_fmult_fft_of_two_reals(const UINT deg,
+    COMPLEX const * const x, const REAL mx,
+    COMPLEX const * const y, const REAL my,
+    fft_wrapper_plan_t plan_fwd, COMPLEX * const buf0, COMPLEX * const buf1,
+    REAL * const x_re, REAL * const x_im,
+    REAL * const y_re, REAL * const y_im)
+{
+    const UINT len = poly_fmult_two_polys_len(deg);
+    const REAL s = poly_fmult_pow2_ratio(mx, my);
+    const REAL scl = 0.5/s;
+    COMPLEX zk, zm;
+    UINT k;
+    INT ret_code;
+
+    for (k=0; k<=deg; k++)
+        buf0[k] = CREAL(x[k]) + I*(s*CREAL(y[k]));
+    memset(&buf0[deg+1], 0, (len - (deg+1))*sizeof(COMPLEX));
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, buf1);
     CHECK_RETCODE(ret_code, leave_fun);
-    ret_code = poly_fmult_two_polys(deg, NULL /*p2_12*/, p1_11, result_12,
-                                    plan_fwd, plan_inv, buf0, buf2, buf1, mode);
+
+    for (k=0; k<len; k++) {
+        zk = buf1[k];
+        zm = CONJ(buf1[k == 0 ? 0 : len - k]);
+        x_re[k] = 0.5*(CREAL(zk) + CREAL(zm));
+        x_im[k] = 0.5*(CIMAG(zk) + CIMAG(zm));
+        y_re[k] = scl*(CIMAG(zk) - CIMAG(zm));
+        y_im[k] = -scl*(CREAL(zk) - CREAL(zm));
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Computes the real polynomials x and y from their FFTs
+// x_hat and y_hat (stored in x_hat and buf1) with a single inverse FFT of
+// x_hat+j*s*y_hat. The power of two s is chosen as the ratio of the
+// estimated magnitudes mx and my of x and y (see
+// poly_fmult_fft_of_two_reals). The array x_hat is overwritten.
+static inline INT poly_fmult_ifft_of_two_reals(const UINT deg,
+    COMPLEX * const x_hat, const REAL mx, const REAL my,
+    fft_wrapper_plan_t plan_inv, COMPLEX * const buf1,
+    COMPLEX * const x, COMPLEX * const y)
+{
+    const UINT len = poly_fmult_two_polys_len(deg);
+    const REAL s = poly_fmult_pow2_ratio(mx, my);
+    UINT k;
+    INT ret_code;
+
+    for (k=0; k<len; k++)
+        x_hat[k] += I*s*buf1[k];
+    ret_code = fft_wrapper_execute_plan(plan_inv, x_hat, buf1);
     CHECK_RETCODE(ret_code, leave_fun);
+    for (k=0; k<2*deg + 1; k++) {
+        x[k] = CREAL(buf1[k])/len;
+        y[k] = CIMAG(buf1[k])/(s*len);
+    }
 
-    mode = mode_offset + 1;
+leave_fun:
+    return ret_code;
+}
 
-    // If mode_offset==0:
-    //
-    //   Add bg, bh, dg and dg to result_11, result_12, result_21 and
-    //   result_22, respectively
-    //
-    // If mode_offset==2:
-    //
-    //   Add result_11, result_12, result_21 and result_22 to the FFT's of ae,
-    //   af, ce and cf, respectively, and perform inverse FFT's.
+INT poly_fmult_two_polys2x2_real(const UINT deg,
+    COMPLEX const * const p1_11,
+    const UINT p1_stride,
+    COMPLEX const * const p2_11,
+    const UINT p2_stride,
+    COMPLEX * const result_11,
+    const UINT result_stride,
+    fft_wrapper_plan_t plan_fwd,
+    fft_wrapper_plan_t plan_inv,
+    COMPLEX * const buf0,
+    COMPLEX * const buf1,
+    REAL * const soa_buf)
+{
+    INT ret_code = SUCCESS;
+    UINT j;
+
+    // We compute the same product as poly_fmult_two_polys2x2, but use that
+    // all coefficients are real. The FFTs of two real arrays are obtained
+    // from one complex FFT, and two real entries of the product are obtained
+    // from one complex inverse FFT. Overall, four forward and two inverse
+    // FFTs are needed instead of eight and four. The arrays are paired as
+    // a,d and e,h (diagonal entries) and b,c and f,g (off-diagonal entries).
+
+    const UINT len = poly_fmult_two_polys_len(deg);
+    REAL * const re[8] = { soa_buf, soa_buf + 2*len, soa_buf + 4*len,
+        soa_buf + 6*len, soa_buf + 8*len, soa_buf + 10*len, soa_buf + 12*len,
+        soa_buf + 14*len };
+    REAL * const im[8] = { soa_buf + len, soa_buf + 3*len, soa_buf + 5*len,
+        soa_buf + 7*len, soa_buf + 9*len, soa_buf + 11*len, soa_buf + 13*len,
+        soa_buf + 15*len };
+    COMPLEX const * p[8];
+    REAL m[8];
+
+    // p[0..7] are a, b, c, d, e, f, g, h as in poly_fmult_two_polys2x2
+    for (j=0; j<4; j++) {
+        p[j] = p1_11 + j*p1_stride;
+        p[j+4] = p2_11 + j*p2_stride;
+    }
+    for (j=0; j<8; j++)
+        m[j] = kernels_max_abs_re_im(deg+1, p[j]);
 
-    ret_code = poly_fmult_two_polys(deg, p1_12, p2_21, result_11,
-                                    plan_fwd, plan_inv, buf0, buf1, buf2, mode);
+    // FFTs of the pairs a,d and b,c and e,h and f,g
+    ret_code = poly_fmult_fft_of_two_reals(deg, p[0], m[0], p[3], m[3],
+        plan_fwd, buf0, buf1, re[0], im[0], re[3], im[3]);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = poly_fmult_fft_of_two_reals(deg, p[1], m[1], p[2], m[2],
+        plan_fwd, buf0, buf1, re[1], im[1], re[2], im[2]);
     CHECK_RETCODE(ret_code, leave_fun);
-    ret_code = poly_fmult_two_polys(deg, NULL /*p2_21*/, p1_22, result_21,
-                                    plan_fwd, plan_inv, buf0, buf2, buf1, mode);
+    ret_code = poly_fmult_fft_of_two_reals(deg, p[4], m[4], p[7], m[7],
+        plan_fwd, buf0, buf1, re[4], im[4], re[7], im[7]);
     CHECK_RETCODE(ret_code, leave_fun);
-    ret_code = poly_fmult_two_polys(deg, NULL /*p1_22*/, p2_22, result_22,
-                                    plan_fwd, plan_inv, buf0, buf1, buf2, mode);
+    ret_code = poly_fmult_fft_of_two_reals(deg, p[5], m[5], p[6], m[6],
+        plan_fwd, buf0, buf1, re[5], im[5], re[6], im[6]);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Diagonal entries ae+bg and cf+dh
+    kernels_soa_cmul2_add(len, re[0], im[0], re[4], im[4], re[1], im[1],
+                          re[6], im[6], buf0);
+    kernels_soa_cmul2_add(len, re[2], im[2], re[5], im[5], re[3], im[3],
+                          re[7], im[7], buf1);
+    ret_code = poly_fmult_ifft_of_two_reals(deg, buf0,
+        poly_fmult_max(m[0]*m[4], m[1]*m[6]), poly_fmult_max(m[2]*m[5], m[3]*m[7]), plan_inv,
+        buf1, result_11, result_11 + 3*result_stride);
     CHECK_RETCODE(ret_code, leave_fun);
-    ret_code = poly_fmult_two_polys(deg, NULL /*p2_22*/, p1_12, result_12,
-                                    plan_fwd, plan_inv, buf0, buf2, buf1, mode);
+
+    // Off-diagonal entries af+bh and ce+dg
+    kernels_soa_cmul2_add(len, re[0], im[0], re[5], im[5], re[1], im[1],
+                          re[7], im[7], buf0);
+    kernels_soa_cmul2_add(len, re[2], im[2], re[4], im[4], re[3], im[3],
+                          re[6], im[6], buf1);
+    ret_code = poly_fmult_ifft_of_two_reals(deg, buf0,
+        poly_fmult_max(m[0]*m[5], m[1]*m[7]), poly_fmult_max(m[2]*m[4], m[3]*m[6]), plan_inv,
+        buf1, result_11 + result_stride, result_11 + 2*result_stride);
     CHECK_RETCODE(ret_code, leave_fun);
 
 leave_fun:
@@ -333,28 +490,23 @@ static inline INT poly_rescale2x2(const UINT d,
     COMPLEX * const p21,
     COMPLEX * const p22)
 {
-    UINT i;
     INT a;
     REAL scl;
     REAL cur_abs;
-    REAL max_abs = 0.0;
-
-    // Find max of absolute values of coefficients
-    max_abs = 0.0;
-    for (i=0; i<=d; i++) {
-        cur_abs = CABS( p11[i] );
-        if (cur_abs > max_abs)
-            max_abs = cur_abs;
-        cur_abs = CABS( p12[i] );
-        if (cur_abs > max_abs)
-            max_abs = cur_abs;
-        cur_abs = CABS( p21[i] );
-        if (cur_abs > max_abs)
-            max_abs = cur_abs;
-        cur_abs = CABS( p22[i] );
-        if (cur_abs > max_abs)
-            max_abs = cur_abs;
-    }
+    REAL max_abs;
+
+    // Find max of absolute values of the real and imaginary parts of the
+    // coefficients (see poly_rescale)
+    max_abs = kernels_max_abs_re_im(d+1, p11);
+    cur_abs = kernels_max_abs_re_im(d+1, p12);
+    if (cur_abs > max_abs)
+        max_abs = cur_abs;
+    cur_abs = kernels_max_abs_re_im(d+1, p21);
+    if (cur_abs > max_abs)
+        max_abs = cur_abs;
+    cur_abs = kernels_max_abs_re_im(d+1, p22);
+    if (cur_abs > max_abs)
+        max_abs = cur_abs;
 
     // Return if polynomials are all identical to zero
     if (max_abs == 0.0)
@@ -363,12 +515,10 @@ static inline INT poly_rescale2x2(const UINT d,
     // Otherwise, rescale
     a = FLOOR( LOG2(max_abs) );
     scl = POW( 2.0, -a );
-    for (i=0; i<=d; i++) {
-        p11[i] *= scl;
-        p12[i] *= scl;
-        p21[i] *= scl;
-        p22[i] *= scl;
-    }
+    kernels_cscale(d+1, scl, p11, p11);
+    kernels_cscale(d+1, scl, p12, p12);
+    kernels_cscale(d+1, scl, p21, p21);
+    kernels_cscale(d+1, scl, p22, p22);
 
     return a;
 }
@@ -378,84 +528,59 @@ static inline INT poly_rescale2x2(const UINT d,
 * length of result = m*m*(n/2)*(2*deg+1)
 * WARNING: p is overwritten
 */
-INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
-    COMPLEX * const result, INT * const W_ptr)
+typedef INT (*poly_fmult_two_polys2x2_t)(const UINT, COMPLEX const * const,
+    const UINT, COMPLEX const * const, const UINT, COMPLEX * const,
+    const UINT, fft_wrapper_plan_t, fft_wrapper_plan_t,
+    COMPLEX * const, COMPLEX * const, REAL * const);
+
+static INT poly_fmult2x2_base(UINT * const d, UINT n, COMPLEX * const p,
+    COMPLEX * const result, INT * const W_ptr,
+    poly_fmult_two_polys2x2_t mult2x2)
 {
     UINT i, j, deg, lenmem, len;
+    UINT deg_excess = 0;
     UINT o1, o2, or; // pointer offsets
     COMPLEX *p11, *p12, *p21, *p22;
-    COMPLEX *p11_pad, *p12_pad, *p21_pad, *p22_pad;
     COMPLEX *r11 = NULL, *r12 = NULL, *r21 = NULL, *r22 = NULL;
     COMPLEX *r12_pad, *r21_pad, *r22_pad;
     fft_wrapper_plan_t plan_fwd = fft_wrapper_safe_plan_init();
     fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
-    COMPLEX *buf0 = NULL, *buf1 = NULL, *buf2 = NULL;
+    COMPLEX *buf0 = NULL, *buf1 = NULL;
+    REAL *soa_buf = NULL;
     INT W = 0;
-    INT ret_code;
+    INT ret_code = SUCCESS;
 
-    // Setup pointers to the individual polynomials in p
     deg = *d;
-    p11 = p;
-    p12 = p11 + n*(deg+1);
-    p21 = p12 + n*(deg+1);
-    p22 = p21 + n*(deg+1);
-
-    // Pad if n is not a power of two
-    const UINT n_excess = misc_nextpowerof2(n) - n;
-    if (n_excess > 0) {
-
-        // Pointers to beginning of polynomials after padding
-        p11_pad = p;
-        p12_pad = p11_pad + (n+n_excess)*(deg+1);
-        p21_pad = p12_pad + (n+n_excess)*(deg+1);
-        p22_pad = p21_pad + (n+n_excess)*(deg+1);
-
-        memmove(p22_pad, p22, n*(deg+1)*sizeof(COMPLEX));
-        memmove(p21_pad, p21, n*(deg+1)*sizeof(COMPLEX));
-        memmove(p12_pad, p12, n*(deg+1)*sizeof(COMPLEX));
-
-        // Reuse orig points as buffers to new poly's that are padded
-        p11 = p11_pad + n*(deg + 1);
-        p12 = p12_pad + n*(deg + 1);
-        p21 = p21_pad + n*(deg + 1);
-        p22 = p22_pad + n*(deg + 1);
-        for (i = 0; !(i >= n_excess); i++) {
-            // We pad with z^deg*[1 0; 0 1]
-            p11[0] = 1.0;
-            p12[0] = 0.0;
-            p21[0] = 0.0;
-            p22[0] = 1.0;
-            for (j = 1; j<=deg; j++) {
-                p11[j] = 0.0;
-                p12[j] = 0.0;
-                p21[j] = 0.0;
-                p22[j] = 0.0;
-            }
-            p11 += deg + 1;
-            p12 += deg + 1;
-            p21 += deg + 1;
-            p22 += deg + 1;
-        }
 
-        p11 = p11_pad;
-        p12 = p12_pad;
-        p21 = p21_pad;
-        p22 = p22_pad;
-        n += n_excess;
+    // If n is not a power of two, the polynomials are not padded. Instead,
+    // the last polynomial is carried over to the next level of the product
+    // tree whenever the current number of polynomials is odd (see below).
+    // The products of every level still fit into blocks of the length that
+    // the padded polynomials would have had, so the individual polynomials
+    // in p are moved such that they are that far apart.
+    const UINT n_max = misc_nextpowerof2(n);
+    const UINT p_stride = n_max*(deg + 1);
+    if (n < n_max) {
+        memmove(p + 3*p_stride, p + 3*n*(deg+1), n*(deg+1)*sizeof(COMPLEX));
+        memmove(p + 2*p_stride, p + 2*n*(deg+1), n*(deg+1)*sizeof(COMPLEX));
+        memmove(p + p_stride, p + n*(deg+1), n*(deg+1)*sizeof(COMPLEX));
     }
-    
+    p11 = p;
+    p12 = p11 + p_stride;
+    p21 = p12 + p_stride;
+    p22 = p21 + p_stride;
+
     // Allocate memory for calls to poly_fmult_two_polys2x2
-    lenmem = poly_fmult_two_polys_len(deg * n/2) * sizeof(COMPLEX);
+    lenmem = poly_fmult_two_polys_len(deg * n_max/2) * sizeof(COMPLEX);
     buf0 = fft_wrapper_malloc(lenmem);
     buf1 = fft_wrapper_malloc(lenmem);
-    buf2 = fft_wrapper_malloc(lenmem);
-    if (buf0 == NULL || buf1 == NULL || buf2 == NULL) {
+    soa_buf = fft_wrapper_malloc(poly_fmult_two_polys2x2_soa_buf_numel(
+                                 deg * n_max/2) * sizeof(REAL));
+    if (buf0 == NULL || buf1 == NULL || soa_buf == NULL) {
         ret_code = E_NOMEM;
         goto release_mem;
     }
 
-    const UINT p_stride = n*(deg + 1);
-
     // Main loop, n is the current number of polynomials, deg is their degree
     while (n >= 2) {
 
@@ -463,7 +588,7 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
         len = poly_fmult_two_polys_len(deg);
         ret_code = fft_wrapper_create_plan(&plan_fwd, len, buf0, buf1, -1);
         CHECK_RETCODE(ret_code, release_mem);
-        ret_code = fft_wrapper_create_plan(&plan_inv, len, buf0, buf2, 1);
+        ret_code = fft_wrapper_create_plan(&plan_inv, len, buf0, buf1, 1);
         CHECK_RETCODE(ret_code, release_mem);
 
         // Offsets for the current pair of polynomials and their product
@@ -472,20 +597,19 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
         or = 0;
 
         // Setup pointers to the individual polynomials in result
-        const UINT r_stride = (n/2)*(2*deg+1);
+        const UINT n_next = (n + 1)/2;
+        const UINT r_stride = n_next*(2*deg+1);
         r11 = result;
         r12 = r11 + r_stride;
         r21 = r12 + r_stride;
         r22 = r21 + r_stride;
 
         // Multiply all pairs of polynomials, normalize if desired
-        for (i=0; i<n; i+=2) {
+        for (i=0; i+1<n; i+=2) {
 
-            const UINT mode_offset  = r_stride - or < len ? 0 : 2;
-            ret_code = poly_fmult_two_polys2x2(deg, p+o1, p_stride, p+o2,
-                                               p_stride, result+or, r_stride,
-                                               plan_fwd, plan_inv, buf0, buf1,
-                                               buf2, mode_offset);
+            ret_code = mult2x2(deg, p+o1, p_stride, p+o2, p_stride,
+                               result+or, r_stride, plan_fwd, plan_inv, buf0,
+                               buf1, soa_buf);
             CHECK_RETCODE(ret_code, release_mem);
 
             // Normalize if desired
@@ -498,13 +622,23 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
             or += 2*deg + 1;
         }
 
-        // Update degrees and number of polynomials
-        deg *= 2;
+        // If n is odd, the last polynomial has no partner. It is multiplied
+        // with z^deg*[1 0; 0 1], which only appends zeros to its
+        // coefficients. These zeros end up at the end of the final result
+        // and are removed there.
         if (n%2 != 0) {
-            ret_code = E_INVALID_ARGUMENT(n); // n was no power of two
-            goto release_mem;
+            for (j=0; j<4; j++) {
+                memcpy(result + or + j*r_stride, p + o1 + j*p_stride,
+                       (deg+1)*sizeof(COMPLEX));
+                memset(result + or + j*r_stride + deg + 1, 0,
+                       deg*sizeof(COMPLEX));
+            }
+            deg_excess += deg;
         }
-        n /= 2;
+
+        // Update degrees and number of polynomials
+        deg *= 2;
+        n = n_next;
 
         fft_wrapper_destroy_plan(&plan_fwd);
         fft_wrapper_destroy_plan(&plan_inv);
@@ -518,12 +652,12 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
         }
     }
 
-    // If padding was applied, reduce degree of the result
-    if (n_excess > 0) {
+    // If polynomials were carried over, reduce degree of the result
+    if (deg_excess > 0) {
         r12_pad = r12;
         r21_pad = r21;
         r22_pad = r22;
-        deg -= n_excess*(*d);
+        deg -= deg_excess;
         r12 = r11 + (deg+1);
         r21 = r12 + (deg+1);
         r22 = r21 + (deg+1);
@@ -541,6 +675,22 @@ release_mem:
     fft_wrapper_destroy_plan(&plan_inv);
     fft_wrapper_free(buf0);
     fft_wrapper_free(buf1);
-    fft_wrapper_free(buf2);
+    fft_wrapper_free(soa_buf);
     return ret_code;
 }
+
+INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
+    COMPLEX * const result, INT * const W_ptr)
+{
+    return poly_fmult2x2_base(d, n, p, result, W_ptr,
+                              fnft__poly_fmult_two_polys2x2);
+}
+
+// If all coefficients are real (e.g., for the KdV equation), so are all
+// products, which can then be computed with half the number of FFTs
+INT fnft__poly_fmult2x2_real(UINT * const d, UINT n, COMPLEX * const p,
+    COMPLEX * const result, INT * const W_ptr)
+{
+    return poly_fmult2x2_base(d, n, p, result, W_ptr,
+                              fnft__poly_fmult_two_polys2x2_real);
+}
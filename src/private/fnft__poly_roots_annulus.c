@@ -0,0 +1,246 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__errwarn.h"
+#include "fnft__poly_roots_annulus.h"
+#include "fnft__poly_roots_fasteigen.h"
+#include "fnft__poly_roots_count.h"
+#include "fnft__poly_eval.h"
+#include "fnft__fft_wrapper.h"
+
+#define NMOM (POLY_ROOTS_ANNULUS_MAX_ROOTS + 1)
+
+// Adds sign*(1/N)*sum_k z_k^j*z_k*p'(z_k)/p(z_k), where z_k = rho*exp(2*pi*
+// j*k/N), to s[j] for j=0,...,NMOM-1. This is the trapezoidal rule for the
+// contour integral of z^j*p'(z)/p(z) along the circle |z|=rho. *ok_ptr is
+// set to 0 if p vanishes at one of the points.
+static INT add_circle_moments(const UINT deg, COMPLEX const * const p,
+    const REAL rho, const REAL sign, const UINT N,
+    fft_wrapper_plan_t plan, COMPLEX * const buf0, COMPLEX * const buf1,
+    COMPLEX * const buf2, COMPLEX * const s, INT * const ok_ptr)
+{
+    UINT i, j;
+    REAL rho_pow;
+    INT ret_code;
+
+    // buf1[k] = p(z_k)
+    rho_pow = 1.0;
+    for (i = 0; i <= deg; i++) {
+        buf0[i] = p[deg - i]*rho_pow;
+        rho_pow *= rho;
+    }
+    for (i = deg + 1; i < N; i++)
+        buf0[i] = 0.0;
+    ret_code = fft_wrapper_execute_plan(plan, buf0, buf1);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // buf2[k] = z_k*p'(z_k)
+    rho_pow = 1.0;
+    for (i = 0; i <= deg; i++) {
+        buf0[i] = i*p[deg - i]*rho_pow;
+        rho_pow *= rho;
+    }
+    ret_code = fft_wrapper_execute_plan(plan, buf0, buf2);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (i = 0; i < N; i++) {
+        if (buf1[i] == 0.0) {
+            *ok_ptr = 0;
+            return SUCCESS;
+        }
+        const COMPLEX z = rho*CEXP(2*PI*I*(REAL)i/N);
+        COMPLEX f = sign*buf2[i]/buf1[i]/N;
+        for (j = 0; j < NMOM; j++) {
+            s[j] += f;
+            f *= z;
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Roots inside an annulus. See the header file for details.
+INT poly_roots_annulus(const UINT deg, COMPLEX const * const p,
+    const REAL r_min, const REAL r_max, UINT * const K_ptr,
+    COMPLEX * const roots)
+{
+    fft_wrapper_plan_t plan = fft_wrapper_safe_plan_init();
+    COMPLEX *buf0 = NULL, *buf1 = NULL, *buf2 = NULL;
+    COMPLEX s[NMOM], s_prev[NMOM], e[NMOM], c[NMOM];
+    COMPLEX vals[NMOM], deriv[NMOM];
+    UINT i, j, k, N, K = 0, K_count;
+    INT converged = 0, ok = 1;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (p == NULL)
+        return E_INVALID_ARGUMENT(p);
+    if (!(r_min >= 0.0 && r_min < r_max && r_max <= 1.0))
+        return E_INVALID_ARGUMENT(r_min);
+    if (K_ptr == NULL)
+        return E_INVALID_ARGUMENT(K_ptr);
+    if (roots == NULL)
+        return E_INVALID_ARGUMENT(roots);
+
+    if (deg == 0) {
+        *K_ptr = 0;
+        return SUCCESS;
+    }
+
+    // Count the roots inside the annulus first. This requires only one FFT
+    // per circle, so that the moments are not computed in vain if there are
+    // too many roots. (If roots are too close to the circles, the count is
+    // deg.)
+    ret_code = poly_roots_count_annulus(deg, p, r_min, r_max, PI, &K_count);
+    CHECK_RETCODE(ret_code, release_mem);
+    if (K_count > POLY_ROOTS_ANNULUS_MAX_ROOTS)
+        goto fallback;
+
+    // Evaluate the contour integrals with an increasing number of points
+    // until the power sums no longer change
+    const UINT N_min = fft_wrapper_next_fft_length(4*(deg + 1));
+    const UINT N_max = 64*(deg + 1);
+    for (N = N_min; N <= N_max; N = fft_wrapper_next_fft_length(2*N)) {
+
+        buf0 = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        buf1 = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        buf2 = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        if (buf0 == NULL || buf1 == NULL || buf2 == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        ret_code = fft_wrapper_create_plan(&plan, N, buf0, buf1, 1);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        for (j = 0; j < NMOM; j++)
+            s[j] = 0.0;
+        ret_code = add_circle_moments(deg, p, r_max, 1.0, N, plan, buf0,
+            buf1, buf2, s, &ok);
+        CHECK_RETCODE(ret_code, release_mem);
+        if (ok && r_min > 0.0) {
+            ret_code = add_circle_moments(deg, p, r_min, -1.0, N, plan,
+                buf0, buf1, buf2, s, &ok);
+            CHECK_RETCODE(ret_code, release_mem);
+        }
+
+        fft_wrapper_destroy_plan(&plan);
+        fft_wrapper_free(buf0);
+        fft_wrapper_free(buf1);
+        fft_wrapper_free(buf2);
+        buf0 = NULL;
+        buf1 = NULL;
+        buf2 = NULL;
+        if (!ok)
+            goto fallback;
+
+        if (N > N_min) {
+            REAL diff = 0.0;
+            for (j = 0; j < NMOM; j++) {
+                if (CABS(s[j] - s_prev[j]) > diff)
+                    diff = CABS(s[j] - s_prev[j]);
+            }
+            if (diff <= 1e-8*(1.0 + CABS(s[0]))) {
+                converged = 1;
+                break;
+            }
+        }
+        for (j = 0; j < NMOM; j++)
+            s_prev[j] = s[j];
+    }
+    if (!converged)
+        goto fallback;
+
+    // The zeroth moment is the number of roots inside the annulus
+    K = (UINT)ROUND(FABS(CREAL(s[0])));
+    if (FABS(CREAL(s[0]) - K) > 1e-3 || K != K_count)
+        goto fallback;
+    if (K == 0) {
+        *K_ptr = 0;
+        goto release_mem;
+    }
+
+    // Newton's identities give the coefficients of the polynomial whose
+    // roots have the power sums s[1],...,s[K]
+    e[0] = 1.0;
+    c[0] = 1.0;
+    for (k = 1; k <= K; k++) {
+        e[k] = 0.0;
+        for (i = 1; i <= k; i++)
+            e[k] += ((i % 2) ? 1.0 : -1.0)*e[k-i]*s[i];
+        e[k] /= k;
+        c[k] = (k % 2) ? -e[k] : e[k];
+    }
+    if (K == 1) {
+        roots[0] = s[1];
+    } else {
+        ret_code = poly_roots_fasteigen(K, c, roots);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+    // Refine the roots with Newton's method on p
+    REAL max_step = INFINITY;
+    for (k = 0; k < 50 && max_step > 100*EPSILON; k++) {
+        for (i = 0; i < K; i++)
+            vals[i] = roots[i];
+        ret_code = poly_evalderiv(deg, p, K, vals, deriv);
+        CHECK_RETCODE(ret_code, release_mem);
+        max_step = 0.0;
+        for (i = 0; i < K; i++) {
+            if (deriv[i] == 0.0) {
+                if (vals[i] == 0.0)
+                    continue;
+                goto fallback;
+            }
+            const COMPLEX step = vals[i]/deriv[i];
+            roots[i] -= step;
+            if (CABS(step) > max_step)
+                max_step = CABS(step);
+        }
+    }
+
+    // Sanity checks: the refined roots have to be distinct and lie inside
+    // the annulus. Otherwise, Newton's method has converged to wrong roots.
+    if (max_step > SQRT(EPSILON))
+        goto fallback;
+    for (i = 0; i < K; i++) {
+        const REAL r = CABS(roots[i]);
+        if (r < r_min*(1.0 - 1e-6) || r > r_max*(1.0 + 1e-6))
+            goto fallback;
+        for (j = 0; j < i; j++) {
+            if (CABS(roots[i] - roots[j]) <= SQRT(EPSILON))
+                goto fallback;
+        }
+    }
+    *K_ptr = K;
+    goto release_mem;
+
+fallback:
+    ret_code = poly_roots_fasteigen(deg, p, roots);
+    CHECK_RETCODE(ret_code, release_mem);
+    *K_ptr = deg;
+
+release_mem:
+    fft_wrapper_destroy_plan(&plan);
+    fft_wrapper_free(buf0);
+    fft_wrapper_free(buf1);
+    fft_wrapper_free(buf2);
+    return ret_code;
+}
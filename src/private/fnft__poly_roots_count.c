@@ -0,0 +1,320 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__errwarn.h"
+#include "fnft__poly_roots_count.h"
+#include "fnft__fft_wrapper.h"
+
+// Auxiliary function: Counts the roots inside the circle |z|=radius. Sets
+// *resolved_ptr to zero if the winding number could not be determined.
+static INT count_in_disk(const UINT deg, COMPLEX const * const p,
+    const REAL radius, UINT * const count_ptr, INT * const resolved_ptr)
+{
+    fft_wrapper_plan_t plan = fft_wrapper_safe_plan_init();
+    COMPLEX *buf0 = NULL, *buf1 = NULL;
+    UINT i, N;
+    INT ret_code = SUCCESS;
+
+    *count_ptr = deg;
+    *resolved_ptr = 0;
+    if (deg == 0 || radius == 0.0) {
+        *count_ptr = 0;
+        *resolved_ptr = 1;
+        return SUCCESS;
+    }
+
+    // Start with four evaluation points per degree and refine up to 64
+    const UINT N_max = 64*(deg + 1);
+    for (N = fft_wrapper_next_fft_length(4*(deg + 1)); N <= N_max;
+         N = fft_wrapper_next_fft_length(2*N)) {
+
+        buf0 = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        buf1 = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        if (buf0 == NULL || buf1 == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        ret_code = fft_wrapper_create_plan(&plan, N, buf0, buf1, 1);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        // buf1[k] = p(radius*exp(2*pi*j*k/N)) for k=0,1,...,N-1
+        REAL scl = 1.0;
+        for (i = 0; i <= deg; i++) {
+            buf0[i] = p[deg - i]*scl;
+            scl *= radius;
+        }
+        for (i = deg + 1; i < N; i++)
+            buf0[i] = 0.0;
+        ret_code = fft_wrapper_execute_plan(plan, buf0, buf1);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        // Accumulate the phase changes between neighbouring points. The
+        // winding is only trusted if none of them is large.
+        REAL winding = 0.0;
+        for (i = 0; i < N; i++) {
+            const COMPLEX prev = buf1[i];
+            const COMPLEX next = buf1[(i + 1) % N];
+            if (prev == 0.0 || next == 0.0)
+                break;
+            const REAL dphi = CARG(next/prev);
+            if (FABS(dphi) > PI/2)
+                break;
+            winding += dphi;
+        }
+
+        fft_wrapper_destroy_plan(&plan);
+        fft_wrapper_free(buf0);
+        fft_wrapper_free(buf1);
+        buf0 = NULL;
+        buf1 = NULL;
+
+        if (i == N) {
+            winding /= 2*PI;
+            const REAL count = ROUND(winding);
+            if (count >= 0 && count <= deg && FABS(winding - count) < 0.25) {
+                *count_ptr = (UINT)count;
+                *resolved_ptr = 1;
+            }
+            break;
+        }
+    }
+
+release_mem:
+    fft_wrapper_destroy_plan(&plan);
+    fft_wrapper_free(buf0);
+    fft_wrapper_free(buf1);
+    return ret_code;
+}
+
+// Counts the roots inside the unit circle. See the header file for details.
+INT poly_roots_count_unit_disk(const UINT deg,
+    COMPLEX const * const p, UINT * const count_ptr)
+{
+    INT resolved;
+
+    // Check inputs
+    if (p == NULL)
+        return E_INVALID_ARGUMENT(p);
+    if (count_ptr == NULL)
+        return E_INVALID_ARGUMENT(count_ptr);
+
+    return count_in_disk(deg, p, 1.0, count_ptr, &resolved);
+}
+
+// Auxiliary function: Evaluates p at z using Horner's scheme.
+static inline COMPLEX horner(const UINT deg, COMPLEX const * const p,
+    const COMPLEX z)
+{
+    COMPLEX val = p[0];
+    UINT i;
+    for (i = 1; i <= deg; i++)
+        val = val*z + p[i];
+    return val;
+}
+
+// Auxiliary function: Adds the phase change from *prev_ptr to next to the
+// winding and updates *prev_ptr. Returns zero if the change is too large to
+// be resolved.
+static inline INT add_phase(COMPLEX * const prev_ptr, const COMPLEX next,
+    REAL * const winding_ptr)
+{
+    if (*prev_ptr == 0.0 || next == 0.0)
+        return 0;
+    const REAL dphi = CARG(next / *prev_ptr);
+    if (FABS(dphi) > PI/2)
+        return 0;
+    *winding_ptr += dphi;
+    *prev_ptr = next;
+    return 1;
+}
+
+// Auxiliary function: Counts the roots inside the annular sector
+// r_min<|z|<r_max, |arg z|<phi_max<pi by following the boundary of the
+// sector counter-clockwise. The values on the two arcs are obtained with
+// FFTs, the values on the two radial segments with Horner's scheme. Since
+// each Horner evaluation costs O(deg), the radial segments are sampled more
+// coarsely than the arcs. Like the number of points on the arcs, the number
+// of points on the segments is doubled until the winding is resolved.
+static INT count_in_sector(const UINT deg, COMPLEX const * const p,
+    const REAL r_min, const REAL r_max, const REAL phi_max,
+    UINT * const count_ptr, INT * const resolved_ptr)
+{
+    fft_wrapper_plan_t plan = fft_wrapper_safe_plan_init();
+    COMPLEX *buf0 = NULL, *outer = NULL, *inner = NULL;
+    UINT i, k, N, Nr, Nr_max, k_max;
+    INT ret_code = SUCCESS;
+
+    *count_ptr = deg;
+    *resolved_ptr = 0;
+
+    const UINT N_max = 64*(deg + 1);
+    for (N = fft_wrapper_next_fft_length(4*(deg + 1)), Nr_max = 64;
+         N <= N_max; N = fft_wrapper_next_fft_length(2*N), Nr_max *= 2) {
+
+        buf0 = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        outer = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        inner = fft_wrapper_malloc(N * sizeof(COMPLEX));
+        if (buf0 == NULL || outer == NULL || inner == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        ret_code = fft_wrapper_create_plan(&plan, N, buf0, outer, 1);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        // outer[k] = p(r_max*exp(2*pi*j*k/N)), inner[k] = p(r_min*...)
+        REAL scl = 1.0;
+        for (i = 0; i <= deg; i++) {
+            buf0[i] = p[deg - i]*scl;
+            scl *= r_max;
+        }
+        for (i = deg + 1; i < N; i++)
+            buf0[i] = 0.0;
+        ret_code = fft_wrapper_execute_plan(plan, buf0, outer);
+        CHECK_RETCODE(ret_code, release_mem);
+        scl = 1.0;
+        for (i = 0; i <= deg; i++) {
+            buf0[i] = p[deg - i]*scl;
+            scl *= r_min;
+        }
+        ret_code = fft_wrapper_execute_plan(plan, buf0, inner);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        // Samples with |arg z|<phi_max have indices k=-k_max,...,k_max. The
+        // radial segments are sampled with the same spacing as the outer arc
+        // if that does not require more than Nr_max points.
+        k_max = (UINT)CEIL(phi_max*N/(2*PI)) - 1;
+        Nr = (UINT)CEIL((r_max - r_min)*N/(2*PI*r_max)) + 16;
+        if (Nr > Nr_max)
+            Nr = Nr_max;
+        const COMPLEX e_plus = CEXP(I*phi_max);
+        const COMPLEX e_minus = CEXP(-I*phi_max);
+
+        REAL winding = 0.0;
+        const COMPLEX start = horner(deg, p, r_max*e_minus);
+        COMPLEX prev = start;
+        INT ok = 1;
+
+        // Outer arc from -phi_max to phi_max
+        for (k = 0; ok && k <= 2*k_max; k++)
+            ok = add_phase(&prev, outer[(N - k_max + k) % N], &winding);
+        if (ok)
+            ok = add_phase(&prev, horner(deg, p, r_max*e_plus), &winding);
+
+        // Radial segment at phi_max from r_max to r_min
+        for (k = 1; ok && k <= Nr; k++) {
+            const REAL r = r_max + (r_min - r_max)*k/Nr;
+            ok = add_phase(&prev, horner(deg, p, r*e_plus), &winding);
+        }
+
+        // Inner arc from phi_max to -phi_max (a single point if r_min=0)
+        if (r_min > 0.0) {
+            for (k = 0; ok && k <= 2*k_max; k++)
+                ok = add_phase(&prev, inner[(k_max + N - k) % N], &winding);
+            if (ok)
+                ok = add_phase(&prev, horner(deg, p, r_min*e_minus),
+                               &winding);
+        }
+
+        // Radial segment at -phi_max from r_min to r_max
+        for (k = 1; ok && k < Nr; k++) {
+            const REAL r = r_min + (r_max - r_min)*k/Nr;
+            ok = add_phase(&prev, horner(deg, p, r*e_minus), &winding);
+        }
+        if (ok)
+            ok = add_phase(&prev, start, &winding);
+
+        fft_wrapper_destroy_plan(&plan);
+        fft_wrapper_free(buf0);
+        fft_wrapper_free(outer);
+        fft_wrapper_free(inner);
+        buf0 = NULL;
+        outer = NULL;
+        inner = NULL;
+
+        if (ok) {
+            winding /= 2*PI;
+            const REAL count = ROUND(winding);
+            if (count >= 0 && count <= deg && FABS(winding - count) < 0.25) {
+                *count_ptr = (UINT)count;
+                *resolved_ptr = 1;
+            }
+            break;
+        }
+    }
+
+release_mem:
+    fft_wrapper_destroy_plan(&plan);
+    fft_wrapper_free(buf0);
+    fft_wrapper_free(outer);
+    fft_wrapper_free(inner);
+    return ret_code;
+}
+
+// Counts the roots inside an annular sector. See the header file for
+// details.
+INT poly_roots_count_annulus(const UINT deg, COMPLEX const * const p,
+    const REAL r_min, const REAL r_max, const REAL phi_max,
+    UINT * const count_ptr)
+{
+    UINT count_inner, count_outer;
+    INT resolved_inner, resolved_outer;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (p == NULL)
+        return E_INVALID_ARGUMENT(p);
+    if (!(r_min >= 0.0))
+        return E_INVALID_ARGUMENT(r_min);
+    if (!(r_max > r_min) || r_max == INFINITY)
+        return E_INVALID_ARGUMENT(r_max);
+    if (!(phi_max > 0.0))
+        return E_INVALID_ARGUMENT(phi_max);
+    if (count_ptr == NULL)
+        return E_INVALID_ARGUMENT(count_ptr);
+
+    if (deg == 0) {
+        *count_ptr = 0;
+        return SUCCESS;
+    }
+
+    if (phi_max < PI) {
+        ret_code = count_in_sector(deg, p, r_min, r_max, phi_max,
+                                   count_ptr, &resolved_outer);
+        CHECK_RETCODE(ret_code, leave_fun);
+        if (!resolved_outer)
+            *count_ptr = deg;
+    } else {
+        // Full annulus: Difference of the counts for the two disks
+        ret_code = count_in_disk(deg, p, r_max, &count_outer,
+                                 &resolved_outer);
+        CHECK_RETCODE(ret_code, leave_fun);
+        ret_code = count_in_disk(deg, p, r_min, &count_inner,
+                                 &resolved_inner);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        if (resolved_inner && resolved_outer && count_inner <= count_outer)
+            *count_ptr = count_outer - count_inner;
+        else
+            *count_ptr = deg;
+    }
+
+leave_fun:
+    return ret_code;
+}
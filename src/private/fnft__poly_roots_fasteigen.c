@@ -20,10 +20,15 @@
 
 #include "fnft__errwarn.h"
 #include "fnft__poly_roots_fasteigen.h"
+#include "fnft__allocator.h"
 
-// Interface to the EISCOR root finding routine
+// Interface to the EISCOR root finding routine. The work arrays are passed
+// in so that they are allocated by FNFT. The logical array P is declared as
+// INT since the default Fortran logical has the size of a default integer.
 extern INT z_poly_roots_modified_(INT *N, double complex const * const coeffs,
-    double complex * const roots, INT *info);
+    double complex * const roots, INT * const P, INT * const ITS,
+    double * const Q, double * const D1, double * const C1, double * const B1,
+    double complex * const V, INT *info);
 
 // Fast computation of polynomial roots. See the header file for details.
 INT poly_roots_fasteigen(const UINT deg,
@@ -37,9 +42,28 @@ INT poly_roots_fasteigen(const UINT deg,
   if (roots == NULL)
     return E_INVALID_ARGUMENT(roots);
 
+    // Allocate the work arrays in one block, ordered by decreasing alignment
+    // requirements: V has deg complex entries, Q, D1, C1 and B1 have
+    // 3*(deg-1), 2*(deg+1), 3*deg and 3*deg real entries, and P and ITS have
+    // deg-2 and deg-1 integer entries (a few entries more are reserved).
+    const UINT nreals = 11*deg + 2;
+    const UINT nints = 2*deg;
+    double complex * const V = fnft__aligned_malloc(deg*sizeof(double complex)
+        + nreals*sizeof(double) + nints*sizeof(INT));
+    if (V == NULL)
+        return E_NOMEM;
+    double * const Q = (double *)(V + deg);
+    double * const D1 = Q + 3*deg;
+    double * const C1 = D1 + 2*(deg + 1);
+    double * const B1 = C1 + 3*deg;
+    INT * const P = (INT *)(Q + nreals);
+    INT * const ITS = P + deg;
+
     // Call Fortran root finding routine
     int_deg = (int)deg;
-    z_poly_roots_modified_(&int_deg, p, roots, &info);
+    z_poly_roots_modified_(&int_deg, p, roots, P, ITS, Q, D1, C1, B1, V,
+                           &info);
+    fnft__aligned_free(V);
 
     if (info == 0)
         return SUCCESS;
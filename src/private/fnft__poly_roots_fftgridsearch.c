@@ -22,11 +22,120 @@
 #include "fnft__errwarn.h"
 #include "fnft__poly_roots_fftgridsearch.h"
 #include "fnft__poly_chirpz.h"
+#include "fnft__kernels.h"
+#include "fnft__fft_wrapper.h"
+#include "fnft__allocator.h"
 #ifdef DEBUG
 #include "fnft__misc.h" // for misc_filter
 #include <stdio.h> // for printf
 #endif
 
+// Number of grid points per block in the search for local minima
+#define SCAN_BLOCK_SIZE 256
+
+// Auxiliary function: Searches for roots around the len test points with the
+// grid indices first,...,first+len-1. The values of the polynomial on the
+// three rings are stored in vals with leading dimension ld, where
+// vals[k*ld] belongs to the grid index first-1. Detected roots are appended to
+// roots, which provides space for max_roots values, and *nroots_ptr is
+// increased accordingly. Roots that do not fit into roots anymore are
+// counted, but not stored.
+static INT find_roots_in_segment(const REAL PHI0, const REAL eps,
+    const UINT first, const UINT len, const UINT ld,
+    COMPLEX const * const vals, UINT * const nroots_ptr,
+    const UINT max_roots, COMPLEX * const roots)
+{
+    COMPLEX c, zi, z0, yi, y0, zr;
+    UINT i, j, b, n, ncand, nroots = *nroots_ptr;
+    INT k;
+    REAL tmp;
+    REAL abs2[3][SCAN_BLOCK_SIZE + 2];
+    UINT cand[SCAN_BLOCK_SIZE];
+
+    // The test points are processed in blocks of SCAN_BLOCK_SIZE points
+    for (b=0; b<len; b+=SCAN_BLOCK_SIZE) {
+        const UINT len_b = (len-b < SCAN_BLOCK_SIZE) ? len-b : SCAN_BLOCK_SIZE;
+
+        // Squared absolute values of the test points in the block and of
+        // their neighbours on all three rings
+        for (k=0; k<3; k++)
+            kernels_abs2(len_b + 2, vals + k*ld + b, abs2[k]);
+
+        // Minimum modulus theorem => minimum absolute value must be on the
+        // boundary of a domain around the current test point unless there
+        // is a root. A test point is thus only a candidate if its absolute
+        // value is not larger than those of its eight neighbours. The tests
+        // are combined without branches, and the indices of the candidates
+        // are collected in cand.
+        ncand = 0;
+        for (n=0; n<len_b; n++) {
+            const REAL center = abs2[1][n+1];
+            const UINT is_min = (center <= abs2[0][n])
+                & (center <= abs2[0][n+1]) & (center <= abs2[0][n+2])
+                & (center <= abs2[1][n]) & (center <= abs2[1][n+2])
+                & (center <= abs2[2][n]) & (center <= abs2[2][n+1])
+                & (center <= abs2[2][n+2]);
+            cand[ncand] = b + n;
+            ncand += is_min;
+        }
+
+        for (n=0; n<ncand; n++) {
+            i = first + cand[n]; // grid index of the candidate
+            COMPLEX const * const vals_i = vals + cand[n] + 1;
+
+            // Let z0 be the center point of the current grid such that
+            // y0 = p(z0) = vals_i[ld]. We approximate p(z) locally around z0
+            // with a linear function: p(z) ~= y0 + c(z-z0). The coefficient
+            // c is found via a least squares fit w.r.t. the other vals, i.e.,
+            // by minimizing ||[y1-y0 ... yn-y0]-c[z1-z0 ... zn-z0]||^2.
+            z0 = CEXP(I*(PHI0 + i*eps));
+            c = 0.0;
+            tmp = 0.0;
+            y0 = vals_i[ld];
+            for (j=i-1; j<i+2; j++) {
+                for (k=-1; k<2; k++) {
+
+                    if (j == 0 && k == 0)
+                        continue; // Skip the center point
+
+                    zi = (1 - k*eps)*CEXP(I*(PHI0 + j*eps));
+                    yi = vals_i[(k + 1)*ld + j - i];
+                    c += CONJ( zi - z0 )*( yi - y0 );
+                    tmp += CABS( zi - z0 )*CABS( zi - z0 );
+                }
+            }
+            if (tmp == 0.0) // This should never happen ...
+                return E_DIV_BY_ZERO;
+            c /= tmp;
+
+            // Find the root zr of the linear approximation y0+c(z-z0)
+            if (c == 0.0) { // Pathologic case: linear apprimation has no roots
+                            // at all or is zero everywhere
+
+                if (y0 != 0.0)
+                    continue;
+                zr = z0;
+
+            } else { // Linear approximation has a unique root
+
+                // We solve 0=y0+c(z-z0) for z.
+                zr = z0 - y0/c;
+                if ( CABS(zr - z0) > eps )
+                    continue; // root estimate is too far from center
+
+            }
+
+            // Save the root
+            if (nroots < max_roots)
+                roots[nroots] = zr;
+            nroots++;
+        }
+    }
+
+    *nroots_ptr = nroots;
+    return SUCCESS;
+}
+
 // Computation of polynomial roots on the unit circle via gridsearch.
 // *M_ptr is the number of points in the grid. The array roots
 // must be preallocated by the user with *M_ptr entries. Upon exit, *M_ptr
@@ -37,119 +146,105 @@ INT poly_roots_fftgridsearch(const UINT deg,
     REAL const * const PHI, COMPLEX * const roots)  
 {
     INT ret_code;
-    COMPLEX A, W, c, zi, z0, yi, y0, zr;
-    UINT i, j, M, nroots = 0;
+    UINT K;
+
+    if (M_ptr == NULL || *M_ptr < 2)
+ 	return E_INVALID_ARGUMENT(M_ptr);      
+
+    // All test points are processed in a single block, i.e., the polynomial
+    // is evaluated on the whole grid at once
+    K = *M_ptr;
+    ret_code = poly_roots_fftgridsearch_blocked(deg, p, *M_ptr, PHI,
+        *M_ptr > 2 ? *M_ptr - 2 : 1, &K, roots);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    *M_ptr = K;
+    return SUCCESS;
+}
+
+// Computation of polynomial roots on the unit circle via gridsearch. The grid
+// of M points is processed in angular segments of block_size test points. The
+// polynomial is evaluated on the segment plus one neighbouring grid point on
+// each side (the halo), so that the local minimum test of the test points at
+// the boundaries of a segment sees all of their neighbours. Since all
+// segments have the same length, they share one chirp transform plan.
+INT poly_roots_fftgridsearch_blocked(const UINT deg,
+    COMPLEX const * const p, const UINT M, REAL const * const PHI,
+    UINT block_size, UINT * const K_ptr, COMPLEX * const roots)
+{
+    INT ret_code = SUCCESS;
+    poly_chirpz_plan_t plan;
+    COMPLEX A[3], W;
+    COMPLEX * vals = NULL;
+    UINT b, nroots = 0;
     INT k;
-    COMPLEX * vals;
-    REAL tmp;
 
 	// Check inputs
     if ( deg < 2 )
         return E_INVALID_ARGUMENT(deg);
     if (p == NULL)
 	return E_INVALID_ARGUMENT(p);
-    if (M_ptr == NULL || *M_ptr < 2)
- 	return E_INVALID_ARGUMENT(M_ptr);      
+    if (M < 2)
+ 	return E_INVALID_ARGUMENT(M);
     if (PHI == NULL || !(PHI[0] < PHI[1]) || PHI[0] == -INFINITY
     || PHI[1] == INFINITY)
         return E_INVALID_ARGUMENT(PHI);
-    if (roots == NULL)
+    if (K_ptr == NULL)
+ 	return E_INVALID_ARGUMENT(K_ptr);
+    if (roots == NULL && *K_ptr > 0)
 	return E_INVALID_ARGUMENT(roots);
 
-    // Allocate memory
-    M = *M_ptr;
-    vals = malloc(3*M * sizeof(COMPLEX));
-    if (vals == NULL) {
-        ret_code = E_NOMEM;
-        goto release_mem;
+    // The first and the last grid point are no test points
+    if (M < 3) {
+        *K_ptr = 0;
+        return SUCCESS;
+    }
+
+    // Choose the block size such that the length of the FFTs in the chirp
+    // transform is about twice the number of coefficients
+    if (block_size == 0) {
+        const UINT L = fft_wrapper_next_fft_length(2*(deg + 1));
+        block_size = L - (deg + 1) - 1;
     }
+    if (block_size > M - 2)
+        block_size = M - 2;
 
-    // Evaluate polynomial using the Chirp transform on three rings
+    // Allocate memory for the values on one segment of the three rings
+    const UINT ld = block_size + 2;
     const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
     W = CEXP(I*eps);
-    for (k=-1; k<=1; k++) {
-
-        A = (1.0 + k*eps) * CEXP(-I*PHI[0]);
-        ret_code = poly_chirpz(deg, p, A, W, M, vals + (k+1)*M);
-        CHECK_RETCODE(ret_code, release_mem);
+    ret_code = poly_chirpz_create_plan(deg, 3, W, ld, &plan);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    vals = fnft__aligned_malloc(3*ld * sizeof(COMPLEX));
+    if (vals == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
     }
-   
-    // Approximate the roots
-    for (i=1; i<M-1; i++) {
-
-        // Minimum modulus theorem => minimum absolute value must be on the
-        // boundary of a domain around the current test point unless there is a
-        // root. Keep track of absolute values of moving grid of nine points.
-        tmp = CABS( vals[M + i] );
-        if ( tmp > CABS(vals[i - 1]) )
-            continue;
-        if ( tmp > CABS(vals[i]) )
-            continue;
-        if ( tmp > CABS(vals[i + 1]) )
-            continue;
-        if ( tmp > CABS(vals[M + i - 1]) )
-            continue;
-        if ( tmp > CABS(vals[M + i + 1]) )
-            continue;
-        if ( tmp > CABS(vals[2*M + i - 1]) )
-            continue;
-        if ( tmp > CABS(vals[2*M + i]) )
-            continue;
-        if ( tmp > CABS(vals[2*M + i + 1]) )
-            continue;
-
-        // Let z0 be the center point of the current grid such that
-        // y0 = p(z0) = vals[M+i]. We approximate p(z) locally around z0 with
-        // a linear function: p(z) ~= y0 + c(z-z0). The coefficient c
-        // is found via a least squares fit w.r.t. the other vals, i.e., by
-        // minimizing ||[y1-y0 ... yn-y0]-c[z1-z0 ... zn-z0]||^2.
-        z0 = CEXP(I*(PHI[0] + i*eps));
-        c = 0.0;
-        tmp = 0.0;
-        y0 = vals[M + i];
-        for (j=i-1; j<i+2; j++) {
-            for (k=-1; k<2; k++) {
-
-                if (j == 0 && k == 0)
-                    continue; // Skip the center point
-
-                zi = (1 - k*eps)*CEXP(I*(PHI[0] + j*eps));
-                yi = vals[(k + 1)*M + j];
-                c += CONJ( zi - z0 )*( yi - y0 );
-                tmp += CABS( zi - z0 )*CABS( zi - z0 );
-            }
-        }
-        if (tmp == 0.0) { // This should never happen ...
-            ret_code = E_DIV_BY_ZERO;
-            goto release_mem;
-        }
-        c /= tmp;
-
-        // Find the root zr of the linear approximation y0+c(z-z0)
-        if (c == 0.0) { // Pathologic case: linear apprimation has no roots
-                        // at all or is zero everywhere
-
-            if (y0 != 0.0)
-                continue;
-            zr = z0;
-
-        } else { // Linear approximation has a unique root
 
-            // We solve 0=y0+c(z-z0) for z.
-            zr = z0 - y0/c;
-            if ( CABS(zr - z0) > eps )
-                continue; // root estimate is too far from center
+    // Process the segments. The segment of the test points b,...,b+len-1
+    // starts at the grid point b-1. The last segment may extend beyond the
+    // grid, the additional values are not used.
+    for (b=1; b<M-1; b+=block_size) {
+        const UINT len = (M-1-b < block_size) ? M-1-b : block_size;
 
-        }
+        // Evaluate polynomial using the Chirp transform on three rings
+        for (k=-1; k<=1; k++)
+            A[k+1] = (1.0 + k*eps) * CEXP(-I*(PHI[0] + (b - 1)*eps));
+        ret_code = poly_chirpz_execute_plan(&plan, p, A, vals);
+        CHECK_RETCODE(ret_code, release_mem);
 
-        // Save the root
-        roots[nroots++] = zr;
+        // Approximate the roots
+        ret_code = find_roots_in_segment(PHI[0], eps, b, len, ld, vals,
+            &nroots, *K_ptr, roots);
+        CHECK_RETCODE(ret_code, release_mem);
     }
     // Save the number of detected roots
-    *M_ptr = nroots;
+    *K_ptr = nroots;
 
 release_mem:
-    free(vals);
+    poly_chirpz_destroy_plan(&plan);
+    fnft__aligned_free(vals);
     return ret_code;
 }
 
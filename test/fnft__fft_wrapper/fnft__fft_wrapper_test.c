@@ -68,8 +68,8 @@ static INT fft_wrapper_test()
 
 leave_fun:
     fft_wrapper_destroy_plan(&plan);
-    free(in);
-    free(out);
+    fft_wrapper_free(in);
+    fft_wrapper_free(out);
     return ret_code;
 }
 
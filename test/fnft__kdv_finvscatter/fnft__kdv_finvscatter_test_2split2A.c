@@ -0,0 +1,32 @@
+/*
+ * This file is part of FNFT.  
+ *                                                                  
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *                                                                      
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+#include "fnft__kdv_finvscatter_test.inc"
+
+int main()
+{
+    const REAL error_bound = 2e-10;
+    const kdv_discretization_t discretization
+        = fnft_kdv_discretization_2SPLIT2A;
+
+    if (kdv_finvscatter_test(error_bound, discretization) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
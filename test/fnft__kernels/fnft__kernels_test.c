@@ -0,0 +1,110 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__kernels.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Compares the kernels with straight-forward loops. An odd length is used
+// so that the remainder loops of the vectorized code are exercised as well.
+static INT kernels_test()
+{
+    const UINT n = 37;
+    const REAL scl = 0.3;
+    COMPLEX a[37], b[37], c[37], d[37], d_exact[37];
+    UINT i;
+
+    for (i=0; i<n; i++) {
+        a[i] = SIN(0.7*i) + I*COS(1.3*i + 0.2);
+        b[i] = 0.5*i - I*SIN(2.1*i);
+        c[i] = -1.0/(i + 1.0) + 0.25*I;
+    }
+
+    kernels_cmul(n, a, b, d);
+    for (i=0; i<n; i++)
+        d_exact[i] = a[i]*b[i];
+    if (misc_rel_err(n, d, d_exact) > 10*EPSILON)
+        return E_TEST_FAILED;
+
+    kernels_cmul_add(n, a, b, c, d);
+    for (i=0; i<n; i++)
+        d_exact[i] = a[i]*b[i] + c[i];
+    if (misc_rel_err(n, d, d_exact) > 10*EPSILON)
+        return E_TEST_FAILED;
+
+    // In-place operation
+    for (i=0; i<n; i++)
+        d[i] = a[i];
+    kernels_cmul(n, d, b, d);
+    for (i=0; i<n; i++)
+        d_exact[i] = a[i]*b[i];
+    if (misc_rel_err(n, d, d_exact) > 10*EPSILON)
+        return E_TEST_FAILED;
+
+    kernels_cscale(n, scl, a, d);
+    for (i=0; i<n; i++)
+        d_exact[i] = scl*a[i];
+    if (misc_rel_err(n, d, d_exact) > 10*EPSILON)
+        return E_TEST_FAILED;
+
+    kernels_cscale_add(n, scl, b, d);
+    for (i=0; i<n; i++)
+        d_exact[i] += scl*b[i];
+    if (misc_rel_err(n, d, d_exact) > 10*EPSILON)
+        return E_TEST_FAILED;
+
+    REAL a_re[37], a_im[37], b_re[37], b_im[37];
+    kernels_abs2(n, a, a_re);
+    for (i=0; i<n; i++) {
+        if (FABS(a_re[i] - CABS(a[i])*CABS(a[i])) > 10*EPSILON*a_re[i])
+            return E_TEST_FAILED;
+    }
+
+    kernels_deinterleave(n, a, a_re, a_im);
+    kernels_deinterleave(n, b, b_re, b_im);
+    for (i=0; i<n; i++) {
+        if (a_re[i] != CREAL(a[i]) || a_im[i] != CIMAG(a[i]))
+            return E_TEST_FAILED;
+    }
+    kernels_soa_cmul2_add(n, a_re, a_im, b_re, b_im, b_re, b_im, a_re, a_im,
+                          d);
+    for (i=0; i<n; i++)
+        d_exact[i] = 2.0*a[i]*b[i];
+    if (misc_rel_err(n, d, d_exact) > 10*EPSILON)
+        return E_TEST_FAILED;
+
+    // The maximum is located in the imaginary part of an element in the
+    // remainder of the vectorized loop
+    c[n-1] = 0.1 - 7.5*I;
+    if (kernels_max_abs_re_im(n, c) != 7.5)
+        return E_TEST_FAILED;
+    if (kernels_max_abs_re_im(0, c) != 0.0)
+        return E_TEST_FAILED;
+
+    return SUCCESS;
+}
+
+INT main()
+{
+    if (kernels_test() != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
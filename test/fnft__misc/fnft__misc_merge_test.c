@@ -0,0 +1,233 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include <string.h>
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+#define N_MAX 5000
+
+// Reference implementations that compare all pairs
+static void merge_direct(UINT * const N_ptr, COMPLEX * const vals,
+    const REAL tol)
+{
+    REAL dist = -1.0;
+    UINT i, j, N_filtered = 1;
+    for (i=1; i<*N_ptr; i++) {
+        for (j=0; j<i; j++) {
+            dist = CABS(vals[j] - vals[i]);
+            if (dist < tol)
+                break;
+        }
+        if (dist < tol)
+            continue;
+        vals[N_filtered++] = vals[i];
+    }
+    *N_ptr = N_filtered;
+}
+
+static void match_direct(const UINT N, COMPLEX const * const vals,
+    const UINT N_ref, COMPLEX const * const vals_ref, const REAL rel_tol,
+    UINT * const loc)
+{
+    UINT i, j;
+    for (i=0; i<N; i++) {
+        REAL err_thres = rel_tol;
+        loc[i] = N_ref;
+        for (j=0; j<N_ref; j++) {
+            const REAL err = CABS(vals[i] - vals_ref[j])/CABS(vals[i]);
+            if (err < err_thres) {
+                err_thres = err;
+                loc[i] = j;
+            }
+        }
+    }
+}
+
+// Uniform random number in [0,1)
+static REAL rnd(UINT * const state)
+{
+    *state = *state * 1103515245 + 12345;
+    return (REAL)((*state >> 8) & 0xffffff) / 16777216.0;
+}
+
+// Fills vals with clusters of values. The distances within a cluster are
+// close to tol, so that chains of values that are merged partially occur.
+static void set_vals(const UINT N, COMPLEX * const vals, const REAL tol,
+    const INT imag_only, UINT * const state)
+{
+    UINT i;
+    COMPLEX center = 0.0;
+    for (i=0; i<N; i++) {
+        if (i % 7 == 0)
+            center = 10.0*(rnd(state) - 0.5) + I*10.0*(rnd(state) - 0.5);
+        vals[i] = center + 2*tol*(rnd(state) - 0.5)
+            + I*2*tol*(rnd(state) - 0.5);
+        if (imag_only)
+            vals[i] = I*CIMAG(vals[i]);
+        // Exact duplicates and values exactly tol apart
+        if (i % 11 == 5)
+            vals[i] = vals[i-1];
+        if (i % 13 == 6)
+            vals[i] = vals[i-1] + tol;
+    }
+    if (N > 3) {
+        vals[1] = NAN;
+        vals[2] = INFINITY + I*1.0;
+        vals[3] = NAN;
+    }
+}
+
+static INT misc_merge_test(const UINT N, const REAL tol,
+    const INT imag_only, UINT * const state)
+{
+    UINT i, N1 = N, N2 = N;
+    COMPLEX *vals1 = NULL, *vals2 = NULL;
+    INT ret_code = SUCCESS;
+
+    vals1 = malloc(N * sizeof(COMPLEX));
+    vals2 = malloc(N * sizeof(COMPLEX));
+    if (vals1 == NULL || vals2 == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    set_vals(N, vals1, tol, imag_only, state);
+    memcpy(vals2, vals1, N * sizeof(COMPLEX));
+
+    ret_code = misc_merge(&N1, vals1, tol);
+    CHECK_RETCODE(ret_code, leave_fun);
+    merge_direct(&N2, vals2, tol);
+#ifdef DEBUG
+    printf("N = %zu, tol = %g: %zu / %zu values kept\n", N, tol, N1, N2);
+#endif
+    if (N1 != N2 || N1 == N || N1 == 1) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    // Bitwise identical, also for NaNs
+    if (memcmp(vals1, vals2, N1 * sizeof(COMPLEX)) != 0) {
+        for (i=0; i<N1; i++) {
+            if (vals1[i] != vals2[i] && !(isnan(CREAL(vals1[i]))
+                                          && isnan(CREAL(vals2[i])))) {
+                ret_code = E_TEST_FAILED;
+                goto leave_fun;
+            }
+        }
+    }
+
+leave_fun:
+    free(vals1);
+    free(vals2);
+    return ret_code;
+}
+
+static INT misc_match_nearest_test(const UINT N, const REAL rel_tol,
+    const INT imag_only, UINT * const state)
+{
+    UINT i, N_ref = N - N/3;
+    COMPLEX *vals = NULL, *vals_ref = NULL;
+    UINT *loc1 = NULL, *loc2 = NULL;
+    UINT nmatched = 0;
+    INT ret_code = SUCCESS;
+
+    vals = malloc(N * sizeof(COMPLEX));
+    vals_ref = malloc(N_ref * sizeof(COMPLEX));
+    loc1 = malloc(N * sizeof(UINT));
+    loc2 = malloc(N * sizeof(UINT));
+    if (vals == NULL || vals_ref == NULL || loc1 == NULL || loc2 == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    set_vals(N, vals, rel_tol, imag_only, state);
+    vals[N-1] = 0.0;
+    // The reference values are perturbations of a subset of the values,
+    // some of which are duplicated to test the resolution of ties
+    for (i=0; i<N_ref; i++) {
+        vals_ref[i] = vals[(7*i) % N]*(1.0 + 2*rel_tol*(rnd(state) - 0.5));
+        if (i % 17 == 3)
+            vals_ref[i] = vals_ref[i-1];
+    }
+
+    ret_code = misc_match_nearest(N, vals, N_ref, vals_ref, rel_tol, loc1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    match_direct(N, vals, N_ref, vals_ref, rel_tol, loc2);
+    for (i=0; i<N; i++) {
+        if (loc1[i] != loc2[i]) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        if (loc1[i] < N_ref)
+            nmatched++;
+    }
+#ifdef DEBUG
+    printf("N = %zu, rel_tol = %g: %zu values matched\n", N, rel_tol,
+           nmatched);
+#endif
+    if (nmatched == 0 || nmatched == N)
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(vals);
+    free(vals_ref);
+    free(loc1);
+    free(loc2);
+    return ret_code;
+}
+
+INT main()
+{
+    UINT state = 1;
+    const UINT Ns[4] = { 20, 100, 1000, N_MAX };
+    const REAL tols[3] = { 1e-8, 1e-3, 0.3 };
+    UINT i, j;
+    INT imag_only;
+
+    for (i=0; i<4; i++) {
+        for (j=0; j<3; j++) {
+            for (imag_only=0; imag_only<=1; imag_only++) {
+                if (misc_merge_test(Ns[i], tols[j], imag_only, &state)
+                    != SUCCESS)
+                    return EXIT_FAILURE;
+                if (misc_match_nearest_test(Ns[i], tols[j], imag_only, &state)
+                    != SUCCESS)
+                    return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Invalid arguments and trivial cases
+    {
+        COMPLEX vals[3] = { 1.0, 1.0, 2.0 };
+        UINT N = 3, loc[3];
+        if (misc_merge(&N, vals, -1.0) == SUCCESS)
+            return EXIT_FAILURE;
+        if (misc_merge(&N, vals, 0.0) != SUCCESS || N != 3)
+            return EXIT_FAILURE;
+        if (misc_match_nearest(3, vals, 0, NULL, 0.1, loc) != SUCCESS
+            || loc[0] != 0 || loc[2] != 0)
+            return EXIT_FAILURE;
+        if (misc_match_nearest(3, vals, 3, vals, -0.1, loc) == SUCCESS)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -70,10 +70,75 @@ leave_fun:
     return ret_code;
 }
 
+// Resamples with several shifts at once. D is divisible by nskip=4 but not by
+// nskip=3, so that both the aliased short inverse FFT and the full-length
+// fallback are exercised.
+static INT misc_resample_multi_shift_test()
+{
+    UINT i, j, k, D = 1256;
+    const UINT nskip[3] = {1, 3, 4};
+    COMPLEX *q = NULL;
+    COMPLEX *q_spectrum = NULL;
+    COMPLEX *q_s = NULL;
+    COMPLEX *q_s_exact = NULL;
+    REAL *t = NULL;
+    REAL delta[4] = {-0.25,0.1387,0.036,-0.015};
+
+    INT ret_code = SUCCESS;
+    t = malloc(D * sizeof(REAL));
+    q = malloc(D * sizeof(COMPLEX));
+    q_spectrum = fft_wrapper_malloc(D * sizeof(COMPLEX));
+    q_s = malloc(4*D * sizeof(COMPLEX));
+    q_s_exact = malloc(4*D * sizeof(COMPLEX));
+    if (q == NULL || q_spectrum == NULL || q_s == NULL || q_s_exact == NULL
+        || t == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    REAL eps_t = 64.0/(D-1);
+    for (i=0; i<D; i++) {
+        t[i] = -32.0 + i*eps_t;
+        q[i] = 5.23345*misc_sech(t[i])*CEXP(I*5.72254*t[i]);
+    }
+
+    ret_code = misc_resample_spectrum(D, eps_t, q, q_spectrum);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (k=0; k<3; k++) {
+        const UINT Dout = (D + nskip[k] - 1)/nskip[k];
+        ret_code = misc_resample_multi_shift(D, eps_t, q_spectrum, 4, delta,
+                                             nskip[k], q_s);
+        CHECK_RETCODE(ret_code, leave_fun);
+        for (j=0; j<4; j++) {
+            for (i=0; i<Dout; i++) {
+                const REAL t_s = t[i*nskip[k]] + delta[j];
+                q_s_exact[j*Dout + i] = 5.23345*misc_sech(t_s)*CEXP(I*5.72254*t_s);
+            }
+        }
+        REAL err = misc_rel_err(4*Dout, q_s, q_s_exact);
+#ifdef DEBUG
+    printf("nskip = %zu, error = %g\n", nskip[k], err);
+#endif
+        if (err > 3e-7)
+           return E_TEST_FAILED;
+    }
+
+leave_fun:
+    free(q);
+    fft_wrapper_free(q_spectrum);
+    free(q_s);
+    free(q_s_exact);
+    free(t);
+    return ret_code;
+}
+
 INT main()
 {
     if ( misc_resample_test() != SUCCESS )
         return EXIT_FAILURE;
+    if ( misc_resample_multi_shift_test() != SUCCESS )
+        return EXIT_FAILURE;
 
     return EXIT_SUCCESS;
 }
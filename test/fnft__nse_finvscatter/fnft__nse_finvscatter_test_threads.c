@@ -0,0 +1,96 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h>
+#include "fnft__errwarn.h"
+#include "fnft__nse_fscatter.h"
+#include "fnft__nse_finvscatter.h"
+#include "fnft__parallel.h"
+
+// The samples recovered by nse_finvscatter must be bitwise identical for
+// different numbers of threads. The degree is large enough for the products
+// to be split into concurrent tasks.
+static INT nse_finvscatter_test_threads(const INT kappa,
+    nse_discretization_t discretization)
+{
+    INT ret_code = SUCCESS;
+
+#ifdef HAVE_OPENMP
+    const UINT D = 8192;
+    const int nthreads[3] = { 1, 2, 4 };
+    const int max_threads = omp_get_max_threads();
+    COMPLEX * q = NULL, * q_ref = NULL, * q_exact = NULL, * result = NULL;
+    REAL eps_t = 0.12;
+    UINT deg, i;
+
+    const UINT len = nse_fscatter_numel(D, discretization);
+
+    q = malloc(D * sizeof(COMPLEX));
+    q_ref = malloc(D * sizeof(COMPLEX));
+    q_exact = malloc(D * sizeof(COMPLEX));
+    result = malloc(len * sizeof(COMPLEX));
+    if (q == NULL || q_ref == NULL || q_exact == NULL || result == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    for (i=0; i<D; i++)
+        q_exact[i] = ((REAL)(i+1)/(D+1)/D)*CEXP(I*(REAL)i/D);
+
+    ret_code = nse_fscatter(D, q_exact, eps_t, kappa, result, &deg, NULL,
+        discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (i=0; i<3; i++) {
+        omp_set_num_threads(nthreads[i]);
+        ret_code = nse_finvscatter(deg, result, i == 0 ? q_ref : q, eps_t,
+            kappa, discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+        if (i > 0 && memcmp(q, q_ref, D * sizeof(COMPLEX)) != 0) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    omp_set_num_threads(max_threads);
+    free(q);
+    free(q_ref);
+    free(q_exact);
+    free(result);
+#else
+    (void)kappa;
+    (void)discretization;
+#endif
+    return ret_code;
+}
+
+int main()
+{
+    if (nse_finvscatter_test_threads(+1, nse_discretization_2SPLIT2A)
+        != SUCCESS)
+        return EXIT_FAILURE;
+    if (nse_finvscatter_test_threads(-1, nse_discretization_2SPLIT2_MODAL)
+        != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -67,6 +67,24 @@ INT poly_chirpz_test()
     if (misc_rel_err(M, result, result_exactM6) > 100*EPSILON)
         return E_TEST_FAILED;
 
+    // Three rings at once have to give the same results as three separate
+    // evaluations
+    COMPLEX A_rings[3] = { 0.95, 1.0, 1.05*CEXP(0.1*I) };
+    COMPLEX result_rings[18];
+    UINT j;
+    ret_code = poly_chirpz_rings(deg, p, 3, A_rings, W, M, result_rings);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    for (j=0; j<3; j++) {
+        ret_code = poly_chirpz(deg, p, A_rings[j], W, M, result);
+        if (ret_code != SUCCESS)
+            return E_SUBROUTINE(ret_code);
+        if (misc_rel_err(M, result_rings + j*M, result) > 10*EPSILON)
+            return E_TEST_FAILED;
+    }
+    if (misc_rel_err(M, result_rings, result_exactM6) > 100*EPSILON)
+        return E_TEST_FAILED;
+
     return SUCCESS;
 }
 
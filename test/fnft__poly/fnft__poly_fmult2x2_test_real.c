@@ -0,0 +1,131 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__poly_fmult.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+#define N 5
+#define DEG 2
+#define DEG_EXACT (N*DEG)
+
+// Multiplies the 2x2 matrices of polynomials a and b (degrees deg_a and
+// deg_b, the entries are deg_a+1 resp. deg_b+1 apart) directly.
+static void mult2x2_direct(const UINT deg_a, COMPLEX const * const a,
+    const UINT deg_b, COMPLEX const * const b, COMPLEX * const c)
+{
+    const UINT deg_c = deg_a + deg_b;
+    UINT i, j, k, m, n;
+
+    for (i=0; i<4*(deg_c+1); i++)
+        c[i] = 0.0;
+    for (i=0; i<2; i++) {
+        for (j=0; j<2; j++) {
+            for (k=0; k<2; k++) {
+                for (m=0; m<=deg_a; m++) {
+                    for (n=0; n<=deg_b; n++)
+                        c[(2*i+j)*(deg_c+1) + m+n] +=
+                            a[(2*i+k)*(deg_a+1) + m]*b[(2*k+j)*(deg_b+1) + n];
+                }
+            }
+        }
+    }
+}
+
+static INT poly_fmult2x2_test_real(REAL const * const scl_entries,
+    INT normalize_flag)
+{
+    UINT deg = DEG;
+    UINT i, j, k;
+    INT W, *W_ptr = NULL;
+    REAL scl;
+    INT ret_code;
+    const UINT memsize = poly_fmult2x2_numel(deg, N);
+    COMPLEX p[memsize], result[memsize];
+    COMPLEX result_exact[4*(DEG_EXACT+1)], tmp[4*(DEG_EXACT+1)];
+    COMPLEX factor[4*(DEG+1)];
+
+    // Real polynomials whose entries differ in magnitude
+    for (i=0; i<N; i++) {
+        for (j=0; j<4; j++) {
+            for (k=0; k<=DEG; k++) {
+                factor[j*(DEG+1) + k] = scl_entries[j]*COS(i + 0.7*j + 1.3*k);
+                p[j*N*(DEG+1) + i*(DEG+1) + k] = factor[j*(DEG+1) + k];
+            }
+        }
+        if (i == 0) {
+            memcpy(result_exact, factor, sizeof(factor));
+        } else {
+            mult2x2_direct(i*DEG, result_exact, DEG, factor, tmp);
+            memcpy(result_exact, tmp, 4*((i+1)*DEG+1)*sizeof(COMPLEX));
+        }
+    }
+
+    if (normalize_flag)
+        W_ptr = &W;
+    ret_code = poly_fmult2x2_real(&deg, N, p, result, W_ptr);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    if (deg != DEG_EXACT)
+        return E_TEST_FAILED;
+    if (normalize_flag) {
+        scl = POW(2.0, W);
+        for (i=0; i<4*(deg+1); i++)
+            result[i] *= scl;
+    }
+    for (i=0; i<4*(deg+1); i++) {
+        if (CIMAG(result[i]) != 0.0)
+            return E_TEST_FAILED;
+    }
+    for (j=0; j<4; j++) {
+        if (!(misc_rel_err(deg+1, result + j*(deg+1),
+                           result_exact + j*(deg+1)) <= 100*EPSILON))
+            return E_TEST_FAILED;
+    }
+
+    return SUCCESS;
+}
+
+INT main(void)
+{
+    INT ret_code, normalize_flag;
+    UINT i;
+    // Magnitudes of the entries of the factors. The second row resembles
+    // the KdV equation, where the upper right entries are of order u*eps_t
+    // and the lower left entries of order eps_t.
+    const REAL scl_entries[2][4] = {
+        { 1.0, 1e3, 1e-3, 1.0 },
+        { 1.0, 1e-1, 1e-3, 1.0 }
+    };
+
+    for (i=0; i<2; i++) {
+        for (normalize_flag=0; normalize_flag<2; normalize_flag++) {
+            ret_code = poly_fmult2x2_test_real(scl_entries[i],
+                                               normalize_flag);
+            if (ret_code != SUCCESS) {
+                E_SUBROUTINE(ret_code);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
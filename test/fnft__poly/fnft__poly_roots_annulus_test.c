@@ -0,0 +1,94 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__poly_roots_annulus.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+#define DEG 60
+
+// Coefficients (descending order) of the monic polynomial with the given
+// roots
+static void poly_from_roots(const UINT deg, COMPLEX const * const roots,
+    COMPLEX * const p)
+{
+    UINT i, j;
+    p[0] = 1.0;
+    for (i = 0; i < deg; i++) {
+        p[i+1] = 0.0;
+        for (j = i+1; j > 0; j--)
+            p[j] -= roots[i]*p[j-1];
+    }
+}
+
+INT poly_roots_annulus_test()
+{
+    COMPLEX roots_exact[DEG], p[DEG+1], roots[DEG];
+    COMPLEX roots_in[3];
+    UINT i, K;
+    INT ret_code;
+
+    // Most roots lie on circles with radius 0.5 and 1.5. Three roots lie
+    // inside the annulus 0.8<|z|<1.
+    for (i = 0; i < DEG-3; i++) {
+        const REAL r = (i % 2) ? 0.5 : 1.5;
+        roots_exact[i] = r*CEXP(2*PI*I*(i + 0.3)/(DEG-3));
+    }
+    roots_in[0] = 0.9*CEXP(0.4*I);
+    roots_in[1] = 0.95*CEXP(-2.1*I);
+    roots_in[2] = 0.85*CEXP(3.0*I);
+    for (i = 0; i < 3; i++)
+        roots_exact[DEG-3+i] = roots_in[i];
+    poly_from_roots(DEG, roots_exact, p);
+
+    ret_code = poly_roots_annulus(DEG, p, 0.8, 1.0, &K, roots);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K != 3)
+        return E_TEST_FAILED;
+    if (!(misc_hausdorff_dist(K, roots, 3, roots_in) <= 1e-10))
+        return E_TEST_FAILED;
+
+    // The whole unit disk contains the roots on the inner circle as well.
+    // There are too many to be computed from contour integrals, so all roots
+    // have to be returned.
+    ret_code = poly_roots_annulus(DEG, p, 0.0, 1.0, &K, roots);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K != DEG)
+        return E_TEST_FAILED;
+    if (!(misc_hausdorff_dist(K, roots, DEG, roots_exact) <= 1e-6))
+        return E_TEST_FAILED;
+
+    // No roots in 0.6<|z|<0.8
+    ret_code = poly_roots_annulus(DEG, p, 0.6, 0.8, &K, roots);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K != 0)
+        return E_TEST_FAILED;
+
+leave_fun:
+    return ret_code;
+}
+
+INT main()
+{
+    if ( poly_roots_annulus_test() != SUCCESS )
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
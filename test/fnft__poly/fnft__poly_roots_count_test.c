@@ -0,0 +1,146 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * agent 2026.
+ */
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__poly_roots_count.h"
+#include "fnft__errwarn.h"
+
+// Builds the coefficients (descending order) of the monic polynomial with
+// the given roots
+static void build_poly(const UINT deg, COMPLEX const * const roots,
+    COMPLEX * const p)
+{
+    UINT i, j;
+
+    p[0] = 1.0;
+    for (i = 0; i < deg; i++) {
+        p[i+1] = 0.0;
+        for (j = i+1; j > 0; j--)
+            p[j] -= roots[i]*p[j-1];
+    }
+}
+
+// Compares the count with the number of roots inside the unit circle
+static INT check_count(const UINT deg, COMPLEX const * const roots,
+    const UINT count_exact)
+{
+    COMPLEX p[16];
+    UINT count;
+    INT ret_code;
+
+    build_poly(deg, roots, p);
+    ret_code = poly_roots_count_unit_disk(deg, p, &count);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    if (count != count_exact)
+        return E_TEST_FAILED;
+    return SUCCESS;
+}
+
+// Compares the count with the number of roots inside the annular sector
+// r_min<|z|<r_max, |arg z|<phi_max
+static INT check_count_annulus(const UINT deg, COMPLEX const * const roots,
+    const REAL r_min, const REAL r_max, const REAL phi_max,
+    const UINT count_exact)
+{
+    COMPLEX p[16];
+    UINT count;
+    INT ret_code;
+
+    build_poly(deg, roots, p);
+    ret_code = poly_roots_count_annulus(deg, p, r_min, r_max, phi_max,
+                                        &count);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    if (count != count_exact)
+        return E_TEST_FAILED;
+    return SUCCESS;
+}
+
+INT poly_roots_count_test()
+{
+    COMPLEX roots[8] = { 0.3+0.4*I, -0.5*I, 0.9, -0.2+0.1*I,
+                         1.7-0.2*I, 3.0+2.0*I, -1.2, 0.1-1.5*I };
+    COMPLEX outside[4] = { 1.1, -2.0+I, 5.0*I, -1.01-0.3*I };
+    COMPLEX close[2] = { 0.3, 1.0 - 1e-9 };
+    UINT count;
+    INT ret_code;
+
+    ret_code = check_count(8, roots, 4);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count(4, outside, 0);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // A constant polynomial has no roots
+    ret_code = poly_roots_count_unit_disk(0, roots, &count);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (count != 0)
+        return E_TEST_FAILED;
+
+    // Leading zero coefficients correspond to roots at infinity
+    COMPLEX p[4] = { 0.0, 0.0, 1.0, -0.5 };
+    ret_code = poly_roots_count_unit_disk(3, p, &count);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (count != 1)
+        return E_TEST_FAILED;
+
+    // A root almost on the unit circle cannot be resolved. The routine has
+    // to return the trivial upper bound.
+    ret_code = check_count(2, close, 2);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Annuli. The magnitudes of the roots are 0.5, 0.5, 0.9, 0.22, 1.71,
+    // 3.61, 1.2 and 1.50.
+    ret_code = check_count_annulus(8, roots, 0.3, 1.0, PI, 3);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(8, roots, 0.6, 2.0, PI, 4);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(8, roots, 0.0, 1.0, PI, 4);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(8, roots, 1.8, 3.0, PI, 0);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(2, close, 0.1, 1.0, PI, 2);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (poly_roots_count_annulus(3, p, 1.0, 0.5, PI, &count) == SUCCESS)
+        return E_TEST_FAILED;
+
+    // Annular sectors. The arguments of the roots are 53, -90, 0, 153,
+    // -7, 34, 180 and -86 degrees.
+    ret_code = check_count_annulus(8, roots, 0.3, 2.0, PI/4, 2);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(8, roots, 0.3, 2.0, 0.45*PI, 3);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(8, roots, 0.0, 1.0, 0.6*PI, 3);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(8, roots, 1.0, 4.0, 0.9*PI, 3);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_count_annulus(2, close, 0.1, 1.0, 0.5*PI, 2);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    return ret_code;
+}
+
+INT main()
+{
+    if ( poly_roots_count_test() != SUCCESS )
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+#include "fnft__poly_roots_fftgridsearch.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// The polynomial from the deg_odd test, whose roots exp(0.4j) and exp(-2.1j)
+// are located on the unit circle. The blocked grid search has to give the
+// same results as the unblocked one, independently of the block size.
+INT poly_roots_fftgridsearch_test_blocked(const UINT M, const REAL eb)
+{
+    const UINT deg = 3;
+    COMPLEX p[4] = {
+                          1 +                     0*I,
+          -1.58378511059697 +      2.52620897565978*I,
+           0.46009879991909 +      1.20456190643706*I,
+           3.23268341994846 +      1.59679613801836*I };
+    const UINT nroots_exact = 2;
+    COMPLEX roots_exact[2] = {
+          0.504846104599857 +     0.863209366648873*I,
+         -0.921060994002885 -      0.38941834230865*I };
+    const UINT block_sizes[5] = { 0, 1, 7, 64, 1000 };
+    COMPLEX roots_ref[256];
+    COMPLEX roots[3];
+    REAL PHI[2] = { 0, 2.0*PI };
+    UINT i, nroots, nroots_ref;
+    INT ret_code;
+
+    nroots_ref = M;
+    ret_code = poly_roots_fftgridsearch(deg, p, &nroots_ref, PHI, roots_ref);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (nroots_ref != nroots_exact) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    for (i=0; i<5; i++) {
+        // Only space for the roots that are actually found
+        nroots = 3;
+        ret_code = poly_roots_fftgridsearch_blocked(deg, p, M, PHI,
+            block_sizes[i], &nroots, roots);
+        CHECK_RETCODE(ret_code, leave_fun);
+        if (nroots != nroots_ref) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        if (!(misc_hausdorff_dist(nroots, roots, nroots_ref, roots_ref)
+              <= 100*EPSILON)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        if (!(misc_hausdorff_dist(nroots, roots, nroots_exact, roots_exact)
+              <= eb)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+    // If there is too little space, all roots are counted, but only the
+    // first one is stored
+    nroots = 1;
+    roots[1] = 0.0;
+    ret_code = poly_roots_fftgridsearch_blocked(deg, p, M, PHI, 7, &nroots,
+        roots);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (nroots != nroots_ref || roots[1] != 0.0
+        || !(CABS(roots[0] - roots_ref[0]) <= 100*EPSILON)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+int main()
+{
+    if (poly_roots_fftgridsearch_test_blocked(128, 0.0003) != SUCCESS)
+        return EXIT_FAILURE;
+    if (poly_roots_fftgridsearch_test_blocked(256, 0.0003/4) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
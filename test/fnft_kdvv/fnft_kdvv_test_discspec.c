@@ -0,0 +1,83 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__kdvv_testcases.h"
+#include "fnft__errwarn.h"
+
+INT main()
+{
+    INT ret_code, i;
+    kdvv_opts_t opts = fnft_kdvv_default_opts();
+    opts.discretization = kdv_discretization_2SPLIT4B;
+    opts.discspec_type = kdvv_dstype_BOTH;
+    UINT D = 1024;
+    REAL eb[6] = {  // error bounds
+        5.78e-5,     // continuous spectrum
+        FNFT_INF,   // a(xi)
+        FNFT_INF,   // b(xi)
+        3.9e-5,     // bound states
+        1e-12,      // norming constants
+        6.3e-5      // residues
+    };
+    REAL eb_rect[6] = {
+        FNFT_INF,   // continuous spectrum
+        FNFT_INF,   // a(xi)
+        FNFT_INF,   // b(xi)
+        1e-10,      // bound states
+        1e-10,      // norming constants
+        1e-10       // residues
+    };
+
+    ret_code = kdvv_testcases_test_fnft(kdvv_testcases_SECH, D, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The bound states are localized independently of the initial guesses
+    // in the default mode, refining the exact values has to work as well
+    opts.bound_state_localization = kdvv_bsloc_NEWTON;
+    ret_code = kdvv_testcases_test_fnft(kdvv_testcases_SECH, D, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    opts.bound_state_localization = kdvv_bsloc_GRIDSEARCH_AND_REFINE;
+
+    // Signals that are piecewise constant on the grid are treated exactly
+    ret_code = kdvv_testcases_test_fnft(kdvv_testcases_RECT, D, eb_rect,
+        &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (i=3; i<6; i++)
+        eb_rect[i] = 0.0;
+    ret_code = kdvv_testcases_test_fnft(kdvv_testcases_NEGATIVE_RECT, D,
+        eb_rect, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // check for quadratic error decay (the norming constants of this
+    // signal are already exact up to rounding errors)
+    D *= 2;
+    for (i=0; i<6; i++) {
+        if (i != 4)
+            eb[i] /= 4.0;
+    }
+    ret_code = kdvv_testcases_test_fnft(kdvv_testcases_SECH, D, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+	    return EXIT_SUCCESS;
+}
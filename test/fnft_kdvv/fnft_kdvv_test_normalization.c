@@ -0,0 +1,87 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__kdvv_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+#define D_TRAIN 8192
+#define M_TRAIN 64
+
+INT main()
+{
+    INT ret_code;
+    UINT i;
+    REAL t, eps_t;
+    kdvv_opts_t opts = fnft_kdvv_default_opts();
+    opts.discretization = kdv_discretization_2SPLIT4B;
+    REAL eb[6] = {  // error bounds
+        5.78e-5,     // continuous spectrum
+        FNFT_INF,   // a(xi)
+        FNFT_INF,   // b(xi)
+        FNFT_INF,   // bound states
+        FNFT_INF,   // norming constants
+        FNFT_INF    // residues
+    };
+    COMPLEX *u = NULL, *contspec = NULL;
+    REAL T[2] = { -800.0, 800.0 };
+    REAL XI[2] = { -2.0, 2.0 };
+
+    // Normalization must not change the results for small signals
+   
+    ret_code = kdvv_testcases_test_fnft(kdvv_testcases_SECH, 1024, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    opts.normalization_flag = 1;
+    ret_code = kdvv_testcases_test_fnft(kdvv_testcases_SECH, 1024, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // A long train of 200 solitons, for which the coefficients of the
+    // transfer matrix overflow without normalization
+    u = malloc(D_TRAIN * sizeof(COMPLEX));
+    contspec = malloc(M_TRAIN * sizeof(COMPLEX));
+    if (u == NULL || contspec == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    eps_t = (T[1] - T[0])/(D_TRAIN - 1);
+    for (i = 0; i < D_TRAIN; i++) {
+        t = T[0] + i*eps_t;
+        u[i] = misc_sech(t - 8.0*FLOOR(t/8.0) - 4.0);
+        u[i] = 20.0*u[i]*u[i];
+    }
+    opts.discretization = kdv_discretization_2SPLIT8B;
+    ret_code = fnft_kdvv(D_TRAIN, u, T, M_TRAIN, contspec, XI, NULL, NULL,
+        NULL, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (i = 0; i < M_TRAIN; i++) {
+        if (!isfinite(CREAL(contspec[i])) || !isfinite(CIMAG(contspec[i]))) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    free(u);
+    free(contspec);
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+	    return EXIT_SUCCESS;
+}
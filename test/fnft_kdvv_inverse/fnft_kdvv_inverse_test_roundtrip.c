@@ -0,0 +1,106 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft_kdvv.h"
+#include "fnft_kdvv_inverse.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Computes the continuous spectrum of a signal without bound states with
+// fnft_kdvv, inverts it with fnft_kdvv_inverse and compares the result with
+// the original signal.
+static INT kdvv_inverse_test_roundtrip(const UINT D, const UINT M,
+    const REAL A, const REAL B, const kdv_discretization_t discretization,
+    const REAL error_bound)
+{
+    INT ret_code = SUCCESS;
+    COMPLEX *u_exact = NULL, *u = NULL, *contspec = NULL;
+    REAL T[2] = { -20.0, 20.0 };
+    REAL XI[2];
+    REAL t, eps_t, error;
+    UINT i;
+    kdvv_opts_t opts = fnft_kdvv_default_opts();
+    kdvv_inverse_opts_t opts_inv = fnft_kdvv_inverse_default_opts();
+    opts.discretization = discretization;
+    opts_inv.discretization = discretization;
+
+    u_exact = malloc(D * sizeof(COMPLEX));
+    u = malloc(D * sizeof(COMPLEX));
+    contspec = malloc(M * sizeof(COMPLEX));
+    if (u_exact == NULL || u == NULL || contspec == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // A reflecting, but not trapping, well with an oscillating tail
+    eps_t = (T[1] - T[0])/(D - 1);
+    for (i = 0; i < D; i++) {
+        t = T[0] + i*eps_t;
+        u_exact[i] = A*misc_sech(t)*misc_sech(t)
+            - B*COS(2.0*t)*misc_sech(0.2*t);
+    }
+
+    ret_code = fnft_kdvv_inverse_XI(D, T, M, XI, discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_kdvv(D, u_exact, T, M, contspec, XI, NULL, NULL, NULL,
+        &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_kdvv_inverse(M, contspec, XI, D, u, T, &opts_inv);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    error = misc_rel_err(D, u, u_exact);
+#ifdef DEBUG
+    printf("kdvv_inverse_test_roundtrip: error = %g\n", error);
+#endif
+    if (!(error <= error_bound))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(u_exact);
+    free(u);
+    free(contspec);
+    return ret_code;
+}
+
+INT main()
+{
+    INT ret_code;
+
+    // Weak signal
+    ret_code = kdvv_inverse_test_roundtrip(1024, 4096, -0.2, 0.1,
+        kdv_discretization_2SPLIT1B, 8e-11);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = kdvv_inverse_test_roundtrip(1024, 4096, -0.2, 0.1,
+        kdv_discretization_2SPLIT2A, 8e-11);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Strong signal, for which the errors in the continuous spectrum
+    // dominate
+    ret_code = kdvv_inverse_test_roundtrip(1024, 16384, -2.0, 0.5,
+        kdv_discretization_2SPLIT2A, 4.3e-8);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__nsep_testcases.h"
+#include "fnft__errwarn.h"
+
+INT main()
+{
+    INT ret_code, i;
+    const fnft__nsep_testcases_t tc = nsep_testcases_PLANE_WAVE_FOCUSING;
+    UINT D = 768; // = 3*2^8, not a power of two
+    REAL error_bounds[3] = {
+        1.8e-4, // main spectrum
+        7.9e-5, // aux spectrum
+        0.0     // sheet indices (zero since not yet implemented)
+    };
+    fnft_nsep_opts_t opts;
+
+    opts = fnft_nsep_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+    opts.localization = fnft_nsep_loc_MIXED;
+    opts.filtering = fnft_nsep_filt_MANUAL;
+    opts.bounding_box[0] = -10;
+    opts.bounding_box[1] = 10;
+    opts.bounding_box[2] = -10;
+    opts.bounding_box[3] = 10;
+
+    ret_code = nsep_testcases_test_fnft(tc, D, error_bounds, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Repeat tests without real spectrum, so that only the subsample and
+    // refine method is used. The automatically chosen Dsub=512 is no factor
+    // of D and is replaced by Dsub=384.
+    opts.bounding_box[2] = 0.1;
+    error_bounds[0] = 8.4e-5;
+    error_bounds[1] = 7.9e-5;
+    ret_code = nsep_testcases_test_fnft(tc, D, error_bounds, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Error decay should be quadratic
+    D *= 2;
+    for (i=0; i<3; i++)
+        error_bounds[i] /= 4.0;
+    ret_code = nsep_testcases_test_fnft(tc, D, error_bounds, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // User-provided Dsub that is no factor of D
+    opts.Dsub = 100;
+    ret_code = nsep_testcases_test_fnft(tc, D, error_bounds, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Odd number of samples have to be rejected
+    opts.Dsub = 0;
+    if (nsep_testcases_test_fnft(tc, D+1, error_bounds, &opts) == SUCCESS) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    if (ret_code == SUCCESS)
+        return EXIT_SUCCESS;
+    else
+        return EXIT_FAILURE;
+}
@@ -0,0 +1,153 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft_nsep.h"
+#include "fnft__errwarn.h"
+#ifdef DEBUG
+#include <stdio.h>
+#endif
+
+#define D 512
+#define PPS 16
+#define K_MAX (PPS*D)
+
+// Returns the largest distance of a point in a to the closest point in b
+static REAL max_min_dist(const UINT Ka, COMPLEX const * const a,
+    const UINT Kb, COMPLEX const * const b)
+{
+    UINT i, j;
+    REAL max_dist = 0.0;
+
+    for (i=0; i<Ka; i++) {
+        REAL min_dist = INFINITY;
+        for (j=0; j<Kb; j++) {
+            if (CABS(a[i] - b[j]) < min_dist)
+                min_dist = CABS(a[i] - b[j]);
+        }
+        if (!(min_dist <= max_dist))
+            max_dist = min_dist;
+    }
+    return max_dist;
+}
+
+// Removes the points whose real part is larger than re_max in magnitude
+static void remove_outer_points(UINT * const K_ptr, COMPLEX * const pts,
+    const REAL re_max)
+{
+    UINT i, K = 0;
+
+    for (i=0; i<*K_ptr; i++) {
+        if (FABS(CREAL(pts[i])) <= re_max)
+            pts[K++] = pts[i];
+    }
+    *K_ptr = K;
+}
+
+// Computes the spines with and without spine tracing and compares the points
+// whose real part is at most re_max in magnitude. Tracing can pick up points
+// close to the boundary of the bounding box that the initial guesses of the
+// reference miss.
+static INT nsep_test_spine_tracing(COMPLEX const * const q,
+    REAL const * const T, fnft_nsep_opts_t * const opts_ptr,
+    const REAL re_max)
+{
+    INT ret_code = SUCCESS;
+    UINT K_ref, K_traced, M;
+    static COMPLEX spines_ref[K_MAX];
+    static COMPLEX spines_traced[K_MAX];
+
+    opts_ptr->spine_tracing = 0;
+    K_ref = K_MAX;
+    M = 0;
+    ret_code = fnft_nsep(D, q, T, 0, &K_ref, spines_ref, &M, NULL, NULL, +1,
+                         opts_ptr);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The traced spines have to consist of the same points
+    opts_ptr->spine_tracing = 1;
+    K_traced = K_MAX;
+    M = 0;
+    ret_code = fnft_nsep(D, q, T, 0, &K_traced, spines_traced, &M, NULL, NULL,
+                         +1, opts_ptr);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    remove_outer_points(&K_ref, spines_ref, re_max);
+    remove_outer_points(&K_traced, spines_traced, re_max);
+
+#ifdef DEBUG
+    printf("K_ref = %zu, K_traced = %zu\n", K_ref, K_traced);
+#endif
+    if (K_ref == 0 || K_traced != K_ref) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    if (!(max_min_dist(K_ref, spines_ref, K_traced, spines_traced) < 1e-8)
+        || !(max_min_dist(K_traced, spines_traced, K_ref, spines_ref) < 1e-8)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+INT main()
+{
+    INT ret_code = SUCCESS;
+    UINT i;
+    static COMPLEX q[D];
+    REAL T[2] = { 0.0, 2*PI };
+    fnft_nsep_opts_t opts;
+
+    // Multi-band signal whose spines partly leave the real line at critical
+    // points of the Floquet discriminant
+    for (i=0; i<D; i++) {
+        const REAL t = T[0] + i*(T[1] - T[0])/D;
+        q[i] = 2.0*CEXP(3*I*t) + 1.5*CEXP(-5*I*t) + 0.7*COS(11*t);
+    }
+
+    // Upper half plane only
+    opts = fnft_nsep_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+    opts.localization = fnft_nsep_loc_SUBSAMPLE_AND_REFINE;
+    opts.filtering = fnft_nsep_filt_MANUAL;
+    opts.bounding_box[0] = -20;
+    opts.bounding_box[1] = 20;
+    opts.bounding_box[2] = 0.05;
+    opts.bounding_box[3] = 20;
+    opts.points_per_spine = PPS;
+    ret_code = nsep_test_spine_tracing(q, T, &opts, INFINITY);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Default bounding box, which includes the points on the real line. It
+    // is chosen by the routine and covers |Re(lam)| <= 115.2 here.
+    opts = fnft_nsep_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+    opts.localization = fnft_nsep_loc_SUBSAMPLE_AND_REFINE;
+    opts.points_per_spine = PPS;
+    ret_code = nsep_test_spine_tracing(q, T, &opts, 110.0);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code == SUCCESS)
+        return EXIT_SUCCESS;
+    else
+        return EXIT_FAILURE;
+}
@@ -0,0 +1,104 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft_nsep.h"
+#include "fnft__errwarn.h"
+#ifdef DEBUG
+#include <stdio.h>
+#endif
+
+#define D 16
+#define K_MAX (64*D)
+
+// If the bounding box is larger than the range in which the discretization
+// can distinguish the main spectrum points, the grid search wraps around the
+// unit circle and finds more candidates than the polynomial has roots. The
+// routine has to return as many of them as possible instead of failing.
+INT main()
+{
+    INT ret_code = SUCCESS;
+    UINT i, j, K_ref, K_wide, M;
+    static COMPLEX q[D];
+    static COMPLEX main_spec_ref[K_MAX];
+    static COMPLEX main_spec_wide[K_MAX];
+    REAL T[2] = { 0.0, 1.0 };
+    const REAL re_max = 24.0;
+    fnft_nsep_opts_t opts;
+
+    // Plane wave
+    for (i=0; i<D; i++)
+        q[i] = 1.0;
+
+    opts = fnft_nsep_default_opts();
+    opts.localization = fnft_nsep_loc_GRIDSEARCH;
+    opts.discretization = nse_discretization_2SPLIT2A;
+    opts.filtering = fnft_nsep_filt_MANUAL;
+    opts.bounding_box[0] = -re_max;
+    opts.bounding_box[1] = re_max;
+    opts.bounding_box[2] = -1.0;
+    opts.bounding_box[3] = 1.0;
+
+    // Reference: the grid does not wrap around the unit circle
+    K_ref = K_MAX;
+    M = 0;
+    ret_code = fnft_nsep(D, q, T, 0, &K_ref, main_spec_ref, &M, NULL, NULL,
+                         +1, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The grid wraps around the unit circle more than twice, so that each
+    // main spectrum point is found several times
+    opts.bounding_box[0] = -60.0;
+    opts.bounding_box[1] = 60.0;
+    K_wide = K_MAX;
+    M = 0;
+    ret_code = fnft_nsep(D, q, T, 0, &K_wide, main_spec_wide, &M, NULL, NULL,
+                         +1, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+#ifdef DEBUG
+    printf("K_ref = %zu, K_wide = %zu\n", K_ref, K_wide);
+#endif
+    if (K_ref == 0 || K_wide < K_ref) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // The returned points that are inside the reference bounding box have to
+    // be reference points. The grid is coarser than for the reference, which
+    // is why the tolerance is large.
+    for (i=0; i<K_wide; i++) {
+        if (!(FABS(CREAL(main_spec_wide[i])) < re_max))
+            continue;
+        for (j=0; j<K_ref; j++) {
+            if (CABS(main_spec_wide[i] - main_spec_ref[j]) < 0.1)
+                break;
+        }
+        if (j == K_ref) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    if (ret_code == SUCCESS)
+        return EXIT_SUCCESS;
+    else
+        return EXIT_FAILURE;
+}
@@ -0,0 +1,276 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdint.h>
+#include "fnft_nsev_file.h"
+#include "fnft__errwarn.h"
+
+#define NSAMPLES 512
+#define NXI 100
+#define K_MAX NSAMPLES
+#define FILENAME_TM "fnft_nsev_test_file_tm.tmp"
+#define FILENAME_SPECTRUM "fnft_nsev_test_file_spectrum.tmp"
+#define FILENAME_CORRUPTED "fnft_nsev_test_file_corrupted.tmp"
+
+static INT is_aligned(void const * const ptr)
+{
+    return ptr == NULL || (uintptr_t)ptr % FNFT_ALIGNMENT == 0;
+}
+
+// Writes the first len bytes of the file src to dst, after flipping the
+// byte at position pos (if pos<len)
+static INT copy_file(char const * const src, char const * const dst,
+    const UINT len, const UINT pos)
+{
+    char buf[4096];
+    FILE *fp_src, *fp_dst;
+    UINT n, i = 0;
+
+    fp_src = fopen(src, "rb");
+    if (fp_src == NULL)
+        return E_TEST_FAILED;
+    fp_dst = fopen(dst, "wb");
+    if (fp_dst == NULL) {
+        fclose(fp_src);
+        return E_TEST_FAILED;
+    }
+    while (i < len) {
+        n = fread(buf, 1, len - i < sizeof(buf) ? len - i : sizeof(buf),
+                  fp_src);
+        if (n == 0)
+            break;
+        if (pos >= i && pos < i + n)
+            buf[pos - i] = ~buf[pos - i];
+        fwrite(buf, 1, n, fp_dst);
+        i += n;
+    }
+    fclose(fp_src);
+    fclose(fp_dst);
+    return SUCCESS;
+}
+
+// Queries of the loaded transfer matrix have to give the same results as
+// queries of the original one
+static INT compare_queries(fnft_nsev_transfer_matrix_t const * const tm1,
+    fnft_nsev_transfer_matrix_t const * const tm2,
+    fnft_nsev_opts_t * const opts)
+{
+    static COMPLEX contspec_1[3*NXI], contspec_2[3*NXI];
+    static COMPLEX bound_states_1[K_MAX], bound_states_2[K_MAX];
+    static COMPLEX normconsts_1[2*K_MAX], normconsts_2[2*K_MAX];
+    REAL XI[2] = { -3.0, 3.0 };
+    UINT K_1 = K_MAX, K_2 = K_MAX;
+    INT ret_code;
+
+    ret_code = fnft_nsev_from_transfer_matrix(tm1, NXI, contspec_1, XI, &K_1,
+            bound_states_1, normconsts_1, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_from_transfer_matrix(tm2, NXI, contspec_2, XI, &K_2,
+            bound_states_2, normconsts_2, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K_1 != K_2 || K_1 == 0
+        || memcmp(contspec_1, contspec_2, sizeof(contspec_1)) != 0
+        || memcmp(bound_states_1, bound_states_2, K_1*sizeof(COMPLEX)) != 0
+        || memcmp(normconsts_1, normconsts_2, 2*K_1*sizeof(COMPLEX)) != 0)
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    return ret_code;
+}
+
+static INT transfer_matrix_file_test(COMPLEX * const q, REAL const * const T)
+{
+    fnft_nsev_transfer_matrix_t tm1 = { .transfer_matrix = NULL };
+    fnft_nsev_transfer_matrix_t tm2 = { .transfer_matrix = NULL };
+    fnft_nsev_spectrum_t spectrum = { .contspec = NULL };
+    fnft_nsev_opts_t opts = fnft_nsev_default_opts();
+    INT ret_code;
+
+    opts.richardson_extrapolation_flag = 0;
+    opts.contspec_type = nsev_cstype_BOTH;
+    opts.discspec_type = nsev_dstype_BOTH;
+    ret_code = fnft_nsev_transfer_matrix(NSAMPLES, q, T, +1, &tm1, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_transfer_matrix_save(FILENAME_TM, &tm1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_transfer_matrix_load(FILENAME_TM, &tm2);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    if (tm1.D != tm2.D || tm1.T[0] != tm2.T[0] || tm1.T[1] != tm2.T[1]
+        || tm1.eps_t != tm2.eps_t || tm1.kappa != tm2.kappa
+        || tm1.discretization != tm2.discretization || tm1.deg != tm2.deg
+        || tm1.W != tm2.W || tm1.D_effective != tm2.D_effective
+        || memcmp(tm1.transfer_matrix, tm2.transfer_matrix,
+                  4*(tm1.deg + 1)*sizeof(COMPLEX)) != 0
+        || memcmp(tm1.q, tm2.q, NSAMPLES*sizeof(COMPLEX)) != 0
+        || memcmp(tm1.q_preprocessed, tm2.q_preprocessed,
+                  tm1.D_effective*sizeof(COMPLEX)) != 0
+        || (tm1.r_preprocessed == NULL) != (tm2.r_preprocessed == NULL)
+        || tm2.file_data == NULL) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    // The arrays point into the file and are aligned
+    if (!is_aligned(tm2.transfer_matrix) || !is_aligned(tm2.q)
+        || !is_aligned(tm2.q_preprocessed) || !is_aligned(tm2.r_preprocessed)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    opts.bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
+    ret_code = compare_queries(&tm1, &tm2, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    opts.bound_state_localization = nsev_bsloc_SUBSAMPLE_AND_REFINE;
+    ret_code = compare_queries(&tm1, &tm2, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The arrays can be modified without changing the file
+    tm2.transfer_matrix[0] += 1.0;
+    tm2.q_preprocessed[0] += 1.0;
+    fnft_nsev_transfer_matrix_free(&tm2);
+    ret_code = fnft_nsev_transfer_matrix_load(FILENAME_TM, &tm2);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (tm2.transfer_matrix[0] != tm1.transfer_matrix[0]
+        || tm2.q_preprocessed[0] != tm1.q_preprocessed[0]) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Truncated and corrupted files and files with other content are
+    // rejected, and nothing remains mapped afterwards
+    fnft_nsev_transfer_matrix_free(&tm2);
+    ret_code = copy_file(FILENAME_TM, FILENAME_CORRUPTED, 1000, 1000);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (fnft_nsev_transfer_matrix_load(FILENAME_CORRUPTED, &tm2) == SUCCESS
+        || tm2.file_data != NULL || tm2.transfer_matrix != NULL) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    ret_code = copy_file(FILENAME_TM, FILENAME_CORRUPTED, 4096, 2);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (fnft_nsev_transfer_matrix_load(FILENAME_CORRUPTED, &tm2) == SUCCESS
+        || tm2.file_data != NULL || tm2.transfer_matrix != NULL) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    // Flips a byte of kappa, so that only the metadata check fails
+    ret_code = copy_file(FILENAME_TM, FILENAME_CORRUPTED, (UINT)-1, 120);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (fnft_nsev_transfer_matrix_load(FILENAME_CORRUPTED, &tm2) == SUCCESS
+        || tm2.file_data != NULL || tm2.transfer_matrix != NULL) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    if (fnft_nsev_spectrum_load(FILENAME_TM, &spectrum) == SUCCESS
+        || spectrum.file_data != NULL || spectrum.contspec != NULL) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    fnft_nsev_transfer_matrix_free(&tm1);
+    fnft_nsev_transfer_matrix_free(&tm2);
+    fnft_nsev_spectrum_free(&spectrum);
+    remove(FILENAME_TM);
+    remove(FILENAME_CORRUPTED);
+    return ret_code;
+}
+
+static INT spectrum_file_test(COMPLEX * const q, REAL const * const T)
+{
+    static COMPLEX contspec[3*NXI];
+    static COMPLEX bound_states[K_MAX];
+    static COMPLEX normconsts[2*K_MAX];
+    fnft_nsev_spectrum_t spectrum = { .contspec = NULL };
+    fnft_nsev_opts_t opts = fnft_nsev_default_opts();
+    REAL XI[2] = { -3.0, 3.0 };
+    UINT K = K_MAX;
+    INT ret_code;
+
+    opts.contspec_type = nsev_cstype_BOTH;
+    opts.discspec_type = nsev_dstype_BOTH;
+    ret_code = fnft_nsev(NSAMPLES, q, T, NXI, contspec, XI, &K, bound_states,
+            normconsts, +1, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_spectrum_save(FILENAME_SPECTRUM, NXI, contspec, XI, K,
+            bound_states, normconsts, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_spectrum_load(FILENAME_SPECTRUM, &spectrum);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (spectrum.M != NXI || spectrum.K != K || K == 0
+        || spectrum.XI[0] != XI[0] || spectrum.XI[1] != XI[1]
+        || spectrum.contspec_type != nsev_cstype_BOTH
+        || spectrum.discspec_type != nsev_dstype_BOTH
+        || memcmp(spectrum.contspec, contspec, 3*NXI*sizeof(COMPLEX)) != 0
+        || memcmp(spectrum.bound_states, bound_states, K*sizeof(COMPLEX)) != 0
+        || memcmp(spectrum.normconsts_or_residues, normconsts,
+                  2*K*sizeof(COMPLEX)) != 0
+        || !is_aligned(spectrum.contspec) || !is_aligned(spectrum.bound_states)
+        || !is_aligned(spectrum.normconsts_or_residues)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    fnft_nsev_spectrum_free(&spectrum);
+
+    // Only the discrete spectrum
+    ret_code = fnft_nsev_spectrum_save(FILENAME_SPECTRUM, 0, NULL, NULL, K,
+            bound_states, NULL, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_spectrum_load(FILENAME_SPECTRUM, &spectrum);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (spectrum.M != 0 || spectrum.contspec != NULL || spectrum.K != K
+        || spectrum.normconsts_or_residues != NULL
+        || memcmp(spectrum.bound_states, bound_states, K*sizeof(COMPLEX)) != 0) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Files that do not exist are rejected
+    if (fnft_nsev_spectrum_load("fnft_nsev_test_file_missing.tmp", &spectrum)
+        == SUCCESS) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    fnft_nsev_spectrum_free(&spectrum);
+    fnft_nsev_spectrum_free(&spectrum);
+    remove(FILENAME_SPECTRUM);
+    return ret_code;
+}
+
+INT main()
+{
+    COMPLEX q[NSAMPLES];
+    REAL T[2] = { -16.0, 16.0 };
+    UINT i;
+
+    const REAL eps_t = (T[1] - T[0])/(NSAMPLES - 1);
+    for (i = 0; i < NSAMPLES; i++)
+        q[i] = 2.2*misc_sech(T[0] + i*eps_t)*CEXP(0.3*I*(T[0] + i*eps_t));
+
+    if (transfer_matrix_file_test(q, T) != SUCCESS)
+        return EXIT_FAILURE;
+    if (spectrum_file_test(q, T) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
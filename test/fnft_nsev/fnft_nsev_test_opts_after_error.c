@@ -0,0 +1,166 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft_nsev.h"
+#include "fnft_allocator.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Allocator that fails after a given number of allocations and forwards to
+// the allocator that was active before otherwise
+typedef struct {
+    fnft_allocator_t parent;
+    UINT nallocs;
+    UINT fail_at;
+} failing_t;
+
+static void * failing_malloc(UINT size, void * user_data)
+{
+    failing_t * const f = user_data;
+    if (f->nallocs++ == f->fail_at)
+        return NULL;
+    return f->parent.malloc_ptr(size, f->parent.user_data);
+}
+
+static void failing_free(void * ptr, void * user_data)
+{
+    failing_t * const f = user_data;
+    f->parent.free_ptr(ptr, f->parent.user_data);
+}
+
+static void * failing_aligned_malloc(UINT alignment, UINT size,
+    void * user_data)
+{
+    failing_t * const f = user_data;
+    if (f->nallocs++ == f->fail_at)
+        return NULL;
+    return f->parent.aligned_malloc_ptr(alignment, size, f->parent.user_data);
+}
+
+static void failing_aligned_free(void * ptr, void * user_data)
+{
+    failing_t * const f = user_data;
+    f->parent.aligned_free_ptr(ptr, f->parent.user_data);
+}
+
+static INT silent_printf(const char * format, ...)
+{
+    (void)format;
+    return 0;
+}
+
+static INT opts_equal(fnft_nsev_opts_t const * const a,
+    fnft_nsev_opts_t const * const b)
+{
+    return a->bound_state_localization == b->bound_state_localization
+        && a->niter == b->niter && a->Dsub == b->Dsub
+        && a->discspec_type == b->discspec_type;
+}
+
+// Calls fnft_nsev with the SUBSAMPLE_AND_REFINE method, where the n-th
+// allocation fails for n=0,1,..., until the call succeeds. The options of
+// the caller (or the default options if opts_ptr is NULL) must not be changed
+// by the failed calls.
+static INT nsev_test_opts_after_error(const UINT D, failing_t * const f,
+    fnft_nsev_opts_t * const opts_ptr)
+{
+    INT ret_code = SUCCESS, ret_code_nsev;
+    COMPLEX *q = NULL, *bound_states = NULL, *normconsts = NULL;
+    REAL T[2] = { -16.0, 16.0 };
+    REAL XI[2] = { -2.0, 2.0 };
+    UINT i, K;
+    const fnft_nsev_opts_t opts_before = (opts_ptr == NULL) ?
+        fnft_nsev_default_opts() : *opts_ptr;
+
+    q = malloc(D * sizeof(COMPLEX));
+    bound_states = malloc(D * sizeof(COMPLEX));
+    normconsts = malloc(D * sizeof(COMPLEX));
+    if (q == NULL || bound_states == NULL || normconsts == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Two bound states
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    for (i=0; i<D; i++)
+        q[i] = 2.2*misc_sech(T[0] + i*eps_t);
+
+    for (f->fail_at = 0; ; f->fail_at++) {
+        f->nallocs = 0;
+        K = D;
+        ret_code_nsev = fnft_nsev(D, q, T, 0, NULL, XI, &K, bound_states,
+                                  normconsts, +1, opts_ptr);
+        const fnft_nsev_opts_t opts_after = (opts_ptr == NULL) ?
+            fnft_nsev_default_opts() : *opts_ptr;
+        if (!opts_equal(&opts_before, &opts_after)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        if (ret_code_nsev == SUCCESS)
+            break;
+    }
+    if (K != 2)
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    free(bound_states);
+    free(normconsts);
+    return ret_code;
+}
+
+INT main()
+{
+    INT ret_code;
+    failing_t f = { .nallocs = 0 };
+    fnft_allocator_t allocator;
+    fnft_nsev_opts_t opts = fnft_nsev_default_opts();
+    const fnft_printf_ptr_t printf_ptr = fnft_errwarn_getprintf();
+
+    ret_code = fnft_get_allocator(&f.parent);
+    CHECK_RETCODE(ret_code, leave_fun);
+    allocator.malloc_ptr = failing_malloc;
+    allocator.free_ptr = failing_free;
+    allocator.aligned_malloc_ptr = failing_aligned_malloc;
+    allocator.aligned_free_ptr = failing_aligned_free;
+    allocator.user_data = &f;
+    ret_code = fnft_set_allocator(&allocator);
+    CHECK_RETCODE(ret_code, leave_fun);
+    fnft_errwarn_setprintf(silent_printf);
+
+    // User-defined options. Dsub is chosen such that the cascade of the
+    // SUBSAMPLE_AND_REFINE method has two intermediate levels.
+    opts.Dsub = 256;
+    ret_code = nsev_test_opts_after_error(4096, &f, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Default options, for which the cascade has one intermediate level
+    ret_code = nsev_test_opts_after_error(16384, &f, NULL);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    fnft_errwarn_setprintf(printf_ptr);
+    fnft_set_allocator(NULL);
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h>
+#include "fnft_nsev.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+#include "fnft__parallel.h"
+
+#define D 1024
+#define M 64
+
+// With Richardson extrapolation, the two approximations of the spectrum and
+// the continuous spectrum of the full signal are computed concurrently. The
+// results must be bitwise identical for different numbers of threads.
+static INT nsev_test_richardson_threads(const INT kappa)
+{
+    INT ret_code = SUCCESS;
+
+#ifdef HAVE_OPENMP
+    static COMPLEX q[D];
+    static COMPLEX contspec[2][3*M];
+    static COMPLEX bound_states[2][D];
+    static COMPLEX normconsts[2][2*D];
+    const int nthreads[3] = { 1, 2, 3 };
+    const int max_threads = omp_get_max_threads();
+    REAL T[2] = { -16.0, 16.0 };
+    REAL XI[2] = { -2.0, 2.0 };
+    UINT i, K[2];
+    fnft_nsev_opts_t opts;
+
+    // Two bound states in the focusing case
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    for (i=0; i<D; i++)
+        q[i] = 2.2*misc_sech(T[0] + i*eps_t);
+
+    opts = fnft_nsev_default_opts();
+    opts.richardson_extrapolation_flag = 1;
+    opts.contspec_type = nsev_cstype_BOTH;
+    opts.discspec_type = nsev_dstype_BOTH;
+
+    for (i=0; i<3; i++) {
+        const UINT j = (i == 0) ? 0 : 1;
+        omp_set_num_threads(nthreads[i]);
+        K[j] = D;
+        ret_code = fnft_nsev(D, q, T, M, contspec[j], XI, &K[j],
+                             kappa == +1 ? bound_states[j] : NULL,
+                             kappa == +1 ? normconsts[j] : NULL, kappa, &opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+        if (j == 0)
+            continue;
+        if (memcmp(contspec[0], contspec[1], sizeof(contspec[0])) != 0) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        if (kappa == +1 && (K[0] != K[1]
+                || memcmp(bound_states[0], bound_states[1],
+                          K[0] * sizeof(COMPLEX)) != 0
+                || memcmp(normconsts[0], normconsts[1],
+                          2*K[0] * sizeof(COMPLEX)) != 0)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    omp_set_num_threads(max_threads);
+#else
+    (void)kappa;
+#endif
+    return ret_code;
+}
+
+INT main()
+{
+    if (nsev_test_richardson_threads(+1) != SUCCESS)
+        return EXIT_FAILURE;
+    if (nsev_test_richardson_threads(-1) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
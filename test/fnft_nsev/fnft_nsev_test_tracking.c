@@ -0,0 +1,125 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft_nsev.h"
+#include "fnft__errwarn.h"
+
+#define D 1024
+#define K_MAX 8
+
+// The bound states of q(t)=A*sech(t) are j*(A-0.5-k) for k=0,1,... as long
+// as the imaginary part is positive
+static INT check_bound_states(const REAL A, const UINT K,
+    COMPLEX const * const bound_states, const REAL error_bound)
+{
+    UINT i, k;
+
+    if (K != (UINT)CEIL(A - 0.5))
+        return E_TEST_FAILED;
+    for (k = 0; k < K; k++) {
+        const COMPLEX exact = I*(A - 0.5 - k);
+        REAL error = INFINITY;
+        for (i = 0; i < K; i++) {
+            if (CABS(bound_states[i] - exact) < error)
+                error = CABS(bound_states[i] - exact);
+        }
+        if (!(error <= error_bound))
+            return E_TEST_FAILED;
+    }
+    return SUCCESS;
+}
+
+static INT set_signal(const REAL A, REAL const * const T, COMPLEX * const q)
+{
+    UINT i;
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    for (i = 0; i < D; i++)
+        q[i] = A/COSH(T[0] + i*eps_t);
+    return SUCCESS;
+}
+
+INT main()
+{
+    INT ret_code;
+    fnft_nsev_opts_t opts;
+    COMPLEX q[D];
+    COMPLEX bound_states[K_MAX];
+    COMPLEX normconsts[K_MAX];
+    REAL T[2] = { -16.0, 16.0 };
+    UINT K, n;
+    REAL A;
+
+    opts = fnft_nsev_default_opts();
+    opts.bound_state_localization = nsev_bsloc_TRACKING;
+    opts.K_tracked = 0;
+
+    // Sequence of signals in which bound states appear as the amplitude
+    // grows. The tracked bound states have to be updated accordingly.
+    for (n = 0; n < 30; n++) {
+        A = 0.35 + 0.1*n;
+        ret_code = set_signal(A, T, q);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        K = K_MAX;
+        ret_code = fnft_nsev(D, q, T, 0, NULL, NULL, &K, bound_states,
+                             normconsts, +1, &opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        ret_code = check_bound_states(A, K, bound_states, 1e-4);
+        CHECK_RETCODE(ret_code, leave_fun);
+        if (opts.K_tracked != K
+            || opts.bound_state_localization != nsev_bsloc_TRACKING) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+    // A spurious guess that converges to an existing bound state has to be
+    // detected
+    A = 2.1;
+    ret_code = set_signal(A, T, q);
+    CHECK_RETCODE(ret_code, leave_fun);
+    bound_states[0] = 1.6*I;
+    bound_states[1] = 1.55*I;
+    opts.K_tracked = 2;
+    K = K_MAX;
+    ret_code = fnft_nsev(D, q, T, 0, NULL, NULL, &K, bound_states, normconsts,
+                         +1, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = check_bound_states(A, K, bound_states, 1e-4);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // More guesses than space in bound_states
+    opts.K_tracked = K_MAX + 1;
+    K = K_MAX;
+    if (fnft_nsev(D, q, T, 0, NULL, NULL, &K, bound_states, normconsts, +1,
+                  &opts) == SUCCESS) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft_nsev.h"
+#include "fnft__errwarn.h"
+
+#define D 512
+#define M_MAX 100
+#define K_MAX D
+
+// Queries of a transfer matrix have to give the same results as fnft_nsev
+// with the same options
+static INT compare_with_nsev(fnft_nsev_transfer_matrix_t const * const tm,
+    COMPLEX * const q, REAL const * const T, const UINT M,
+    REAL const * const XI, const INT with_bound_states,
+    fnft_nsev_opts_t * const opts)
+{
+    static COMPLEX contspec_1[3*M_MAX], contspec_2[3*M_MAX];
+    static COMPLEX bound_states_1[K_MAX], bound_states_2[K_MAX];
+    static COMPLEX normconsts_1[2*K_MAX], normconsts_2[2*K_MAX];
+    UINT K_1 = K_MAX, K_2 = K_MAX;
+    INT ret_code;
+
+    ret_code = fnft_nsev(D, q, T, M, contspec_1, XI, &K_1,
+            with_bound_states ? bound_states_1 : NULL, normconsts_1,
+            tm->kappa, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_from_transfer_matrix(tm, M, contspec_2, XI, &K_2,
+            with_bound_states ? bound_states_2 : NULL, normconsts_2, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    if (misc_rel_err(3*M, contspec_2, contspec_1) > 100*EPSILON) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    if (with_bound_states) {
+        if (K_1 != K_2 || K_1 == 0
+            || misc_hausdorff_dist(K_1, bound_states_1, K_2, bound_states_2)
+               > 1e-10
+            || misc_rel_err(2*K_1, normconsts_2, normconsts_1) > 1e-8) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    } else if (K_2 != 0) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+static INT transfer_matrix_test(const nse_discretization_t discretization,
+    const INT kappa)
+{
+    COMPLEX q[D];
+    REAL T[2] = { -16.0, 16.0 };
+    REAL XI[2];
+    fnft_nsev_transfer_matrix_t tm = { .transfer_matrix = NULL };
+    fnft_nsev_opts_t opts = fnft_nsev_default_opts();
+    INT ret_code;
+    UINT i;
+
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    for (i = 0; i < D; i++)
+        q[i] = 2.2*misc_sech(T[0] + i*eps_t)*CEXP(0.3*I*(T[0] + i*eps_t));
+
+    opts.discretization = discretization;
+    opts.richardson_extrapolation_flag = 0;
+    opts.contspec_type = nsev_cstype_BOTH;
+    opts.discspec_type = nsev_dstype_BOTH;
+    ret_code = fnft_nsev_transfer_matrix(D, q, T, kappa, &tm, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Continuous spectrum on several grids
+    XI[0] = -5.0;
+    XI[1] = 5.0;
+    ret_code = compare_with_nsev(&tm, q, T, M_MAX, XI, 0, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    XI[0] = -1.0;
+    XI[1] = 2.0;
+    ret_code = compare_with_nsev(&tm, q, T, 33, XI, 0, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    if (kappa == +1) {
+        // Bound states with different localization methods and filters
+        opts.bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
+        opts.bound_state_filtering = nsev_bsfilt_BASIC;
+        ret_code = compare_with_nsev(&tm, q, T, M_MAX, XI, 1, &opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+        opts.bound_state_filtering = nsev_bsfilt_FULL;
+        ret_code = compare_with_nsev(&tm, q, T, M_MAX, XI, 1, &opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+        opts.bound_state_localization = nsev_bsloc_SUBSAMPLE_AND_REFINE;
+        ret_code = compare_with_nsev(&tm, q, T, M_MAX, XI, 1, &opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+    // Richardson extrapolation is not supported
+    opts.richardson_extrapolation_flag = 1;
+    if (fnft_nsev_from_transfer_matrix(&tm, M_MAX, q, XI, NULL, NULL, NULL,
+                                       &opts) == SUCCESS) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    fnft_nsev_transfer_matrix_free(&tm);
+    fnft_nsev_transfer_matrix_free(&tm);
+    return ret_code;
+}
+
+INT main()
+{
+    COMPLEX q[D] = { 0.0 };
+    REAL T[2] = { -16.0, 16.0 };
+    fnft_nsev_transfer_matrix_t tm;
+    fnft_nsev_opts_t opts = fnft_nsev_default_opts();
+
+    if (transfer_matrix_test(nse_discretization_2SPLIT4B, +1) != SUCCESS)
+        return EXIT_FAILURE;
+    if (transfer_matrix_test(nse_discretization_2SPLIT4B, -1) != SUCCESS)
+        return EXIT_FAILURE;
+    if (transfer_matrix_test(nse_discretization_4SPLIT4A, +1) != SUCCESS)
+        return EXIT_FAILURE;
+
+    // Discretizations without polynomial transfer matrix are rejected
+    opts.discretization = nse_discretization_BO;
+    if (fnft_nsev_transfer_matrix(D, q, T, +1, &tm, &opts) == SUCCESS)
+        return EXIT_FAILURE;
+    fnft_nsev_transfer_matrix_free(&tm);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* agent 2026.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdint.h>
+#include "fnft_allocator.h"
+#include "fnft__nsev_testcases.h"
+#include "fnft__errwarn.h"
+
+// Allocator that counts the blocks it hands out and forwards to the
+// allocator that was active before
+typedef struct {
+    fnft_allocator_t parent;
+    UINT nallocs;
+    UINT naligned_allocs;
+    UINT nlive;
+    UINT nmisaligned;
+} counters_t;
+
+static void * counting_malloc(UINT size, void * user_data)
+{
+    counters_t * const c = user_data;
+    void * const ptr = c->parent.malloc_ptr(size, c->parent.user_data);
+    if (ptr != NULL) {
+        c->nallocs++;
+        c->nlive++;
+    }
+    return ptr;
+}
+
+static void counting_free(void * ptr, void * user_data)
+{
+    counters_t * const c = user_data;
+    c->nlive--;
+    c->parent.free_ptr(ptr, c->parent.user_data);
+}
+
+static void * counting_aligned_malloc(UINT alignment, UINT size,
+    void * user_data)
+{
+    counters_t * const c = user_data;
+    void * const ptr = c->parent.aligned_malloc_ptr(alignment, size,
+                                                    c->parent.user_data);
+    if (ptr != NULL) {
+        c->naligned_allocs++;
+        c->nlive++;
+        if ((uintptr_t)ptr % alignment != 0 || alignment != FNFT_ALIGNMENT
+            || size % FNFT_ALIGNMENT != 0)
+            c->nmisaligned++;
+    }
+    return ptr;
+}
+
+static void counting_aligned_free(void * ptr, void * user_data)
+{
+    counters_t * const c = user_data;
+    c->nlive--;
+    c->parent.aligned_free_ptr(ptr, c->parent.user_data);
+}
+
+INT main()
+{
+    INT ret_code;
+    counters_t counters = { .nallocs = 0 };
+    fnft_allocator_t allocator, current;
+    fnft_nsev_opts_t opts = fnft_nsev_default_opts();
+    REAL error_bounds[6] = {
+        INFINITY,     // reflection coefficient
+        INFINITY,     // a
+        INFINITY,     // b
+        INFINITY,     // bound states
+        INFINITY,     // norming constants
+        INFINITY      // residues
+    };
+
+    ret_code = fnft_get_allocator(&counters.parent);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Incomplete allocators have to be rejected
+    allocator = counters.parent;
+    allocator.aligned_free_ptr = NULL;
+    if (fnft_set_allocator(&allocator) != FNFT_EC_INVALID_ARGUMENT)
+        return EXIT_FAILURE;
+
+    allocator.malloc_ptr = counting_malloc;
+    allocator.free_ptr = counting_free;
+    allocator.aligned_malloc_ptr = counting_aligned_malloc;
+    allocator.aligned_free_ptr = counting_aligned_free;
+    allocator.user_data = &counters;
+    ret_code = fnft_set_allocator(&allocator);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = fnft_get_allocator(&current);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (current.malloc_ptr != counting_malloc
+        || current.user_data != &counters)
+        return EXIT_FAILURE;
+
+    // The results do not matter here, only the allocations
+    ret_code = nsev_testcases_test_fnft(nsev_testcases_SECH_FOCUSING, 256,
+                                        error_bounds, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Restore the default allocator
+    ret_code = fnft_set_allocator(NULL);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_get_allocator(&current);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (current.malloc_ptr != counters.parent.malloc_ptr)
+        return EXIT_FAILURE;
+
+    // All memory has been obtained from the user-defined allocator, including
+    // the aligned and padded numerical arrays, and all of it has been released
+    // again
+    if (counters.naligned_allocs == 0)
+        return EXIT_FAILURE;
+    if (counters.nlive != 0)
+        return EXIT_FAILURE;
+    if (counters.nmisaligned != 0)
+        return EXIT_FAILURE;
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}